@@ -37,6 +37,12 @@
 
 namespace BoostNet { // namespace BoostNet begin
 
+struct BOOST_NET_API KernelTimestamp
+{
+    std::size_t            seconds;
+    std::size_t            nanoseconds;
+};
+
 class BOOST_NET_API TcpConnectionBase
 {
 public:
@@ -50,6 +56,7 @@ public:
 public:
     virtual void get_host_address(std::string & ip, unsigned short & port) = 0;
     virtual void get_peer_address(std::string & ip, unsigned short & port) = 0;
+    virtual void get_alpn_protocol(std::string & protocol) = 0;
 
 public:
     virtual const void * recv_buffer_data() = 0;
@@ -58,7 +65,9 @@ public:
     virtual bool recv_buffer_move(void * buf, std::size_t len) = 0;
     virtual bool recv_buffer_drop(std::size_t len) = 0;
     virtual void recv_buffer_water_mark(std::size_t len) = 0;
+    virtual bool recv_buffer_timestamp(KernelTimestamp & timestamp) = 0;
     virtual bool send_buffer_fill(const void * data, std::size_t len) = 0;
+    virtual bool send_timestamp(KernelTimestamp & timestamp, std::size_t & send_count) = 0;
 
 public:
     virtual void close() = 0;
@@ -83,10 +92,18 @@ public:
     virtual bool on_send(TcpConnectionSharedPtr connection) = 0;
     virtual void on_close(TcpConnectionSharedPtr connection) = 0;
     virtual void on_error(TcpConnectionSharedPtr connection, const char * operater, const char * action, int error, const char * message) = 0;
+    virtual void on_connect_summary(const void * identity, std::size_t success_count, std::size_t failure_count);
 };
 
 class TcpManagerImpl;
 
+struct BOOST_NET_API ConnectTarget
+{
+    const char * host;
+    unsigned short port;
+    const void * identity;
+};
+
 struct BOOST_NET_API Certificate
 {
     bool         pass_file_not_buffer;
@@ -96,6 +113,23 @@ struct BOOST_NET_API Certificate
     const char * password;
 };
 
+struct BOOST_NET_API SniCertificate
+{
+    const char           * server_name;
+    const Certificate    * certificate;
+};
+
+struct BOOST_NET_API Listener
+{
+    const char           * host;
+    unsigned short         port;
+    const Certificate    * certificate;
+    const char           * ciphers;
+    const char           * alpn_protocols;
+    const SniCertificate * sni_certificate_array;
+    std::size_t            sni_certificate_count;
+};
+
 class BOOST_NET_API TcpManager
 {
 public:
@@ -115,14 +149,88 @@ public:
 public:
     void get_ports(std::vector<unsigned short> & ports);
 
+public:
+    /* one more listening port on the same io threads, port 0 picks a free one */
+    bool add_listener(const Listener & listener);
+
+public:
+    /* new handshakes use the reloaded certificate, established connections keep theirs */
+    bool reload_server_certificate(const Certificate * server_certificate);
+    bool reload_client_certificate(const Certificate * client_certificate);
+    bool reload_listener_certificate(unsigned short port, const Certificate * certificate);
+
 public:
     bool create_connection(const std::string & host, const std::string & service, bool sync_connect = true, const void * identity = 0, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
     bool create_connection(const std::string & host, unsigned short port, bool sync_connect = true, const void * identity = 0, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
 
+public:
+    /* async connect races the resolved addresses attempt_delay_milliseconds apart */
+    bool set_connect_attempt(std::size_t attempt_delay_milliseconds = 250, std::size_t attempt_timeout_milliseconds = 0);
+
+public:
+    /* a released connection stays warm until acquire_connection() takes it or it expires */
+    bool set_connection_pool(std::size_t max_idle_per_key = 8, std::size_t max_idle_total = 1024, std::size_t max_idle_milliseconds = 60000);
+    bool acquire_connection(const std::string & host, const std::string & service, const void * identity = 0, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
+    bool acquire_connection(const std::string & host, unsigned short port, const void * identity = 0, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
+    bool release_connection(TcpConnectionSharedPtr connection);
+    bool prewarm_connection(const std::string & host, const std::string & service, std::size_t count, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
+    bool prewarm_connection(const std::string & host, unsigned short port, std::size_t count, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
+
+public:
+    /* on_connect_summary() reports once every target has completed */
+    bool create_connections(const ConnectTarget * target_array, std::size_t target_count, const void * identity = 0, std::size_t max_in_flight = 64, std::size_t pacing_microseconds = 0, bool pacing_jitter = false, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
+    bool create_connections(const std::string & host, unsigned short port, std::size_t count, const void * identity = 0, std::size_t max_in_flight = 64, std::size_t pacing_microseconds = 0, bool pacing_jitter = false, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
+
+public:
+    /* client ssl connections resume the last session of the same host and service */
+    bool set_ssl_session_cache(std::size_t max_session_count = 1024);
+    void get_ssl_session_statistics(std::size_t & hit_count, std::size_t & miss_count);
+
+public:
+    /* server side session cache and ticket keys of every listener, keys rotated every rotate_seconds */
+    bool set_ssl_server_session_cache(std::size_t cache_size = 20480, std::size_t timeout_seconds = 300);
+    bool set_ssl_ticket_keys(bool pass_file_not_buffer, const char * keys_file_or_buffer, std::size_t buffer_length = 0, std::size_t rotate_seconds = 3600, std::size_t key_size = 0);
+
+public:
+    /* ssl handshakes run on thread_count dedicated threads, call after init */
+    bool set_ssl_handshake_pool(std::size_t thread_count);
+
+public:
+    /* the first records after idle_milliseconds carry at most small_record_size bytes */
+    bool set_ssl_record_sizing(std::size_t small_record_size = 1369, std::size_t small_record_count = 40, std::size_t idle_milliseconds = 1000);
+
+public:
+    /* linux only, record encryption moves to the kernel after the handshake */
+    bool set_ssl_kernel_tls(bool enable = true);
+
+public:
+    /* byte rates per connection and per listening port, 0 is unlimited */
+    bool set_rate_limit(std::size_t send_bytes_per_second, std::size_t recv_bytes_per_second, std::size_t listener_send_bytes_per_second = 0, std::size_t listener_recv_bytes_per_second = 0, std::size_t burst_bytes = 64 * 1024);
+
+public:
+    /* linux only, kernel software timestamps of reads and sends */
+    bool set_timestamping(bool recv_enable = true, bool send_enable = false);
+
 private:
     TcpManagerImpl                                * m_manager_impl;
 };
 
+enum UdpDropPolicy
+{
+    udp_drop_newest,
+    udp_drop_oldest,
+    udp_drop_expired
+};
+
+struct BOOST_NET_API UdpSendStatistics
+{
+    std::size_t            queued_count;
+    std::size_t            sent_count;
+    std::size_t            dropped_count;
+    std::size_t            error_count;
+    std::size_t            recv_dropped_count;
+};
+
 class BOOST_NET_API UdpConnectionBase
 {
 public:
@@ -142,7 +250,10 @@ public:
     virtual const void * recv_buffer_data() = 0;
     virtual std::size_t recv_buffer_size() = 0;
     virtual bool recv_buffer_drop() = 0;
+    virtual bool recv_buffer_timestamp(KernelTimestamp & timestamp) = 0;
     virtual bool send_buffer_fill(const void * data, std::size_t len) = 0;
+    virtual bool send_timestamp(KernelTimestamp & timestamp, std::size_t & send_count) = 0;
+    virtual void get_send_statistics(UdpSendStatistics & statistics) = 0;
 
 public:
     virtual void close() = 0;
@@ -167,6 +278,7 @@ public:
     virtual bool on_send(UdpConnectionSharedPtr connection) = 0;
     virtual void on_close(UdpConnectionSharedPtr connection) = 0;
     virtual void on_error(UdpConnectionSharedPtr connection, const char * operater, const char * action, int error, const char * message) = 0;
+    virtual bool on_datagram(UdpConnectionSharedPtr connection, const void * data, std::size_t len);
 };
 
 class UdpManagerImpl;
@@ -192,10 +304,98 @@ public:
     bool create_connection(const std::string & host, const std::string & service, bool sync_connect = true, const void * identity = 0, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
     bool create_connection(const std::string & host, unsigned short port, bool sync_connect = true, const void * identity = 0, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
 
+public:
+    /* buffers longer than segment_size leave as segment_size datagrams */
+    bool set_segment_offload(std::size_t segment_size = 1472, bool gro_enable = true, std::size_t recv_buffer_size = 1500);
+
+public:
+    /* passive peers expire after idle_milliseconds and are capped at max_peer_count per port */
+    bool set_peer_limit(std::size_t idle_milliseconds = 60000, std::size_t max_peer_count = 65536, bool evict_when_full = true);
+
+public:
+    /* new peers must echo a cookie, connections of this manager echo one */
+    bool set_peer_cookie(bool enable = true, std::size_t max_replies_per_second = 1000);
+
+public:
+    /* passive peers are spread over all io threads by endpoint hash, datagrams a busy thread cannot take count in recv_dropped_count */
+    bool set_peer_dispatch(bool enable = true);
+
+public:
+    /* on_datagram() is called instead of on_recv() without copying the datagram */
+    bool set_datagram_callback(bool enable = true);
+
+public:
+    /* queued datagrams are bounded per socket and per peer, 0 means unlimited */
+    bool set_send_queue_limit(std::size_t max_packets = 4096, std::size_t max_bytes = 4 * 1024 * 1024, std::size_t max_peer_packets = 512, std::size_t max_peer_bytes = 512 * 1024, UdpDropPolicy drop_policy = udp_drop_newest, std::size_t max_age_milliseconds = 0);
+
+public:
+    /* send_buffer_fill() sends from the calling thread when nothing is queued */
+    bool set_direct_send(bool enable = true);
+
+public:
+    /* both ends must enable it with the same mtu, messages come back whole */
+    bool set_message_fragment(bool enable = true, std::size_t mtu = 1472, std::size_t max_message_size = 1024 * 1024, std::size_t slot_count = 4, std::size_t timeout_milliseconds = 5000);
+
+public:
+    /* listening ports bound to the any address receive the group traffic */
+    bool join_multicast_group(const char * group_ip, const char * interface_ip = "0.0.0.0");
+    bool leave_multicast_group(const char * group_ip, const char * interface_ip = "0.0.0.0");
+
+public:
+    /* ttl, loopback and interface of sends to a group address */
+    bool set_multicast_options(std::size_t ttl = 1, bool loopback = true, const char * interface_ip = "0.0.0.0");
+
+public:
+    /* created connections share socket_count unconnected sockets per io thread, disabling closes the sockets and their connections */
+    bool set_shared_socket(bool enable = true, std::size_t socket_count = 1);
+
+public:
+    /* byte rates per connection and per listening port, 0 is unlimited */
+    bool set_rate_limit(std::size_t send_bytes_per_second, std::size_t recv_bytes_per_second, std::size_t listener_send_bytes_per_second = 0, std::size_t listener_recv_bytes_per_second = 0, std::size_t burst_bytes = 64 * 1024);
+
+public:
+    /* linux only, kernel software timestamps of reads and sends */
+    bool set_timestamping(bool recv_enable = true, bool send_enable = false);
+
 private:
     UdpManagerImpl                                * m_manager_impl;
 };
 
+class RudpManagerImpl;
+
+class BOOST_NET_API RudpManager
+{
+public:
+    RudpManager();
+    ~RudpManager();
+
+public:
+    RudpManager(const RudpManager &) = delete;
+    RudpManager & operator = (const RudpManager &) = delete;
+
+public:
+    bool init(UdpServiceBase * udp_service, std::size_t thread_count = 5, const char * host = nullptr, unsigned short * port_array = nullptr, std::size_t port_count = 0, bool port_any_valid = false);
+    void exit();
+
+public:
+    void get_ports(std::vector<unsigned short> & ports);
+
+public:
+    bool create_connection(const std::string & host, const std::string & service, bool sync_connect = true, const void * identity = 0, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
+    bool create_connection(const std::string & host, unsigned short port, bool sync_connect = true, const void * identity = 0, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
+
+public:
+    /* both ends must agree, messages are delivered whole and acknowledged */
+    bool set_reliable_options(bool ordered = true, std::size_t window_size = 256, std::size_t interval_milliseconds = 10, std::size_t fast_resend = 2, std::size_t min_rto_milliseconds = 30, bool congestion_control = true, bool pacing = true, std::size_t mtu = 1400, std::size_t dead_link = 20);
+
+public:
+    /* recv_buffer_timestamp() is the arrival of the datagram completing the message */
+    bool set_timestamping(bool recv_enable = true, bool send_enable = false);
+
+private:
+    RudpManagerImpl                               * m_manager_impl;
+};
+
 } // namespace BoostNet end
 
 
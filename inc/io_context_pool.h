@@ -38,6 +38,7 @@ public:
 public:
     void run(bool blocking = false);
     io_context_type & get();
+    io_context_type & get(std::size_t index);
     std::size_t size();
 
 private:
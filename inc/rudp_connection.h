@@ -0,0 +1,72 @@
+/********************************************************
+ * Description : reliable udp connection
+ * Data        : 2026-10-20 02:30:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_RUDP_CONNECTION_H
+#define BOOST_NET_RUDP_CONNECTION_H
+
+
+#include <string>
+#include <mutex>
+#include "boost_net.h"
+#include "rudp_session.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+class RudpConnection : public UdpConnectionBase, public std::enable_shared_from_this<RudpConnection>
+{
+public:
+    RudpConnection(UdpConnectionSharedPtr udp_connection, UdpServiceBase * udp_service);
+    virtual ~RudpConnection() override;
+
+public:
+    RudpConnection(const RudpConnection &) = delete;
+    RudpConnection(RudpConnection &&) = delete;
+    RudpConnection & operator = (const RudpConnection &) = delete;
+    RudpConnection & operator = (RudpConnection &&) = delete;
+
+public:
+    virtual void get_host_address(std::string & ip, unsigned short & port) override;
+    virtual void get_peer_address(std::string & ip, unsigned short & port) override;
+
+public:
+    virtual bool recv_buffer_has_data() override;
+    virtual const void * recv_buffer_data() override;
+    virtual std::size_t recv_buffer_size() override;
+    virtual bool recv_buffer_drop() override;
+    virtual bool recv_buffer_timestamp(KernelTimestamp & timestamp) override;
+    virtual bool send_buffer_fill(const void * data, std::size_t len) override;
+    virtual bool send_timestamp(KernelTimestamp & timestamp, std::size_t & send_count) override;
+    virtual void get_send_statistics(UdpSendStatistics & statistics) override;
+
+public:
+    virtual void close() override;
+
+public:
+    bool init(const RudpOptions & options);
+    void input(const void * data, std::size_t len);
+    void update();
+
+private:
+    void output(const RudpSession::buffer_array & datagrams);
+    static uint32_t current_milliseconds();
+
+private:
+    UdpConnectionSharedPtr                          m_udp_connection;
+    UdpServiceBase                                * m_udp_service;
+    std::mutex                                      m_mutex;
+    RudpSession                                     m_session;
+    bool                                            m_send_pending;
+    bool                                            m_dead_reported;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_RUDP_CONNECTION_H
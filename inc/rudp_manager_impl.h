@@ -0,0 +1,94 @@
+/********************************************************
+ * Description : reliable udp manager implement
+ * Data        : 2026-10-20 02:30:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_RUDP_MANAGER_IMPLEMENT_H
+#define BOOST_NET_RUDP_MANAGER_IMPLEMENT_H
+
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include "boost_net.h"
+#include "rudp_connection.h"
+#include "io_context_pool.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+/*
+ * plain udp connections of an inner UdpManager carry the arq segments, this object is their service and hands reliable connections to the user's service,
+ * one extra thread ticks every connection each interval_milliseconds for retransmission and pacing
+ */
+class RudpManagerImpl : public UdpServiceBase
+{
+public:
+    typedef std::shared_ptr<RudpConnection>                     rudp_connection_ptr;
+    typedef std::unordered_map<UdpConnectionBase *, rudp_connection_ptr> rudp_connection_map;
+    typedef std::shared_ptr<boost::asio::steady_timer>          timer_ptr;
+
+public:
+    RudpManagerImpl();
+    virtual ~RudpManagerImpl() override;
+
+public:
+    RudpManagerImpl(const RudpManagerImpl &) = delete;
+    RudpManagerImpl(RudpManagerImpl &&) = delete;
+    RudpManagerImpl & operator = (const RudpManagerImpl &) = delete;
+    RudpManagerImpl & operator = (RudpManagerImpl &&) = delete;
+
+public:
+    bool init(UdpServiceBase * udp_service, std::size_t thread_count, const char * host, unsigned short port_array[], std::size_t port_count, bool port_any_valid);
+    void exit();
+
+public:
+    void get_ports(std::vector<unsigned short> & ports);
+
+public:
+    bool create_connection(const std::string & host, const std::string & service, bool sync_connect, const void * identity, const char * bind_ip, unsigned short bind_port);
+    bool create_connection(const std::string & host, unsigned short port, bool sync_connect, const void * identity, const char * bind_ip, unsigned short bind_port);
+
+public:
+    bool set_reliable_options(const RudpOptions & options);
+
+public:
+    bool set_timestamping(bool recv_enable, bool send_enable);
+
+public:
+    virtual bool on_connect(UdpConnectionSharedPtr connection, const void * identity) override;
+    virtual bool on_accept(UdpConnectionSharedPtr connection, unsigned short listener_port) override;
+    virtual bool on_recv(UdpConnectionSharedPtr connection) override;
+    virtual bool on_send(UdpConnectionSharedPtr connection) override;
+    virtual void on_close(UdpConnectionSharedPtr connection) override;
+    virtual void on_error(UdpConnectionSharedPtr connection, const char * operater, const char * action, int error, const char * message) override;
+    virtual bool on_datagram(UdpConnectionSharedPtr connection, const void * data, std::size_t len) override;
+
+private:
+    rudp_connection_ptr create_rudp_connection(UdpConnectionSharedPtr connection);
+    rudp_connection_ptr find_rudp_connection(UdpConnectionSharedPtr connection);
+    void start_timer();
+    void handle_timer(const boost::system::error_code & error);
+
+private:
+    UdpManager                                      m_udp_manager;
+    UdpServiceBase                                * m_udp_service;
+    IOServicePool                                   m_timer_pool;
+    timer_ptr                                       m_timer;
+    std::mutex                                      m_mutex;
+    RudpOptions                                     m_options;
+    rudp_connection_map                             m_connections;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_RUDP_MANAGER_IMPLEMENT_H
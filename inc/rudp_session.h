@@ -0,0 +1,168 @@
+/********************************************************
+ * Description : reliable udp session (arq state machine)
+ * Data        : 2026-10-20 02:30:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_RUDP_SESSION_H
+#define BOOST_NET_RUDP_SESSION_H
+
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace BoostNet { // namespace BoostNet begin
+
+struct RudpOptions
+{
+    bool            ordered;
+    std::size_t     window_size;
+    std::size_t     interval_milliseconds;
+    std::size_t     fast_resend;
+    std::size_t     min_rto_milliseconds;
+    bool            congestion_control;
+    bool            pacing;
+    std::size_t     mtu;
+    std::size_t     dead_link;
+};
+
+/*
+ * kcp like arq without any io, every datagram carries one or more segments of a 22 bytes header (cmd, flags, count, frg, wnd, ts, sn, una, len),
+ * acks carry una, the echoed send time of the newest data segment and up to max_sack_blocks received ranges above una,
+ * a segment passed by fast_resend acks of segments sent more than srtt / 4 after it is sent again at once, a timed out one adds half the current rto to its own (linear backoff like kcp nodelay),
+ * new reno style congestion window (slow start, halve once per window on loss, one segment after a timeout) and a pacing budget of cwnd per srtt,
+ * messages longer than mss are split into at most window_size fragments and delivered whole, in order or as soon as complete
+ */
+class RudpSession
+{
+public:
+    typedef std::vector<char>                                   buffer_type;
+    typedef std::vector<buffer_type>                            buffer_array;
+
+public:
+    RudpSession();
+    ~RudpSession();
+
+public:
+    RudpSession(const RudpSession &) = delete;
+    RudpSession(RudpSession &&) = delete;
+    RudpSession & operator = (const RudpSession &) = delete;
+    RudpSession & operator = (RudpSession &&) = delete;
+
+public:
+    bool init(const RudpOptions & options);
+    bool send(const void * data, std::size_t len);
+    bool input(const void * data, std::size_t len, uint32_t current);
+    void flush(uint32_t current, buffer_array & datagrams);
+
+public:
+    bool has_message() const;
+    const buffer_type & front_message() const;
+    bool pop_message();
+
+public:
+    bool idle() const;
+    bool dead() const;
+
+private:
+    struct send_segment_type
+    {
+        uint32_t        sn;
+        uint16_t        count;
+        uint16_t        frg;
+        uint8_t         flags;
+        bool            acked;
+        uint32_t        ts;
+        uint32_t        resend_ts;
+        uint32_t        rto;
+        uint32_t        fastack;
+        uint32_t        xmit;
+        buffer_type     data;
+    };
+
+    struct recv_segment_type
+    {
+        bool            used;
+        bool            delivered;
+        uint16_t        count;
+        uint16_t        frg;
+        buffer_type     data;
+    };
+
+    struct header_type
+    {
+        uint8_t         cmd;
+        uint8_t         flags;
+        uint16_t        count;
+        uint16_t        frg;
+        uint16_t        wnd;
+        uint32_t        ts;
+        uint32_t        sn;
+        uint32_t        una;
+        uint16_t        len;
+    };
+
+    typedef std::deque<send_segment_type>                       send_segments_type;
+    typedef std::vector<recv_segment_type>                      recv_segments_type;
+    typedef std::deque<buffer_type>                             messages_type;
+
+private:
+    void input_ack(const header_type & header, const char * blocks, std::size_t len, uint32_t current);
+    void input_push(const header_type & header, const char * data);
+    void acknowledge(uint32_t first, uint32_t last);
+    void shrink_send_buffer();
+    void update_rtt(uint32_t rtt);
+    void deliver_ordered();
+    void deliver_unordered(uint32_t sn);
+    void on_loss(bool timeout);
+    uint16_t window_unused() const;
+    std::size_t sack_blocks(char * blocks, std::size_t max_count) const;
+    void output(const header_type & header, const char * data, buffer_type & datagram, buffer_array & datagrams);
+
+private:
+    static void encode_header(const header_type & header, char * buffer);
+    static void decode_header(const char * buffer, header_type & header);
+
+private:
+    enum { cmd_push = 1, cmd_ack = 2 };
+    enum { flag_unordered = 1 };
+    enum { header_size = 22, max_sack_blocks = 16, max_rto = 60000 };
+
+private:
+    RudpOptions                                     m_options;
+    std::size_t                                     m_mss;
+    uint32_t                                        m_snd_una;
+    uint32_t                                        m_snd_nxt;
+    uint32_t                                        m_rcv_nxt;
+    uint32_t                                        m_rcv_base;
+    uint32_t                                        m_rmt_wnd;
+    uint32_t                                        m_srtt;
+    uint32_t                                        m_rttvar;
+    uint32_t                                        m_rto;
+    uint32_t                                        m_cwnd;
+    uint32_t                                        m_cwnd_acked;
+    uint32_t                                        m_ssthresh;
+    uint32_t                                        m_recover;
+    bool                                            m_loss_timeout;
+    bool                                            m_loss_fast;
+    double                                          m_pacing_budget;
+    uint32_t                                        m_pacing_ts;
+    bool                                            m_ack_pending;
+    uint32_t                                        m_ack_ts;
+    bool                                            m_dead;
+    send_segments_type                              m_snd_queue;
+    send_segments_type                              m_snd_buf;
+    recv_segments_type                              m_rcv_buf;
+    uint32_t                                        m_rcv_mask;
+    messages_type                                   m_rcv_queue;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_RUDP_SESSION_H
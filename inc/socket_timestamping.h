@@ -0,0 +1,75 @@
+/********************************************************
+ * Description : kernel socket timestamping
+ * Data        : 2026-10-20 05:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_SOCKET_TIMESTAMPING_H
+#define BOOST_NET_SOCKET_TIMESTAMPING_H
+
+
+#include <cstdint>
+#include <mutex>
+#include <boost/asio.hpp>
+#include "boost_net.h"
+
+#if defined(__linux__)
+    #include <sys/socket.h>
+    #include <linux/net_tstamp.h>
+    #include <linux/errqueue.h>
+    #if defined(SO_TIMESTAMPING) && defined(SCM_TIMESTAMPING)
+        #define BOOST_NET_TIMESTAMPING_SUPPORT
+    #endif // defined(SO_TIMESTAMPING) && defined(SCM_TIMESTAMPING)
+#endif // defined(__linux__)
+
+namespace BoostNet { // namespace BoostNet begin
+
+/*
+ * kernel software timestamps as nanoseconds since the epoch (0 is unknown), SO_TIMESTAMPING with SO_TIMESTAMPNS as a receive only fallback,
+ * receive timestamps come with the reads as control messages, send timestamps come back on the error queue keyed by the kernel's send counter (bytes for tcp, sends for udp)
+ */
+class SocketTimestamping
+{
+public:
+    typedef boost::asio::detail::socket_type                    native_handle_type;
+
+public:
+    SocketTimestamping();
+    ~SocketTimestamping();
+
+public:
+    SocketTimestamping(const SocketTimestamping &) = delete;
+    SocketTimestamping(SocketTimestamping &&) = delete;
+    SocketTimestamping & operator = (const SocketTimestamping &) = delete;
+    SocketTimestamping & operator = (SocketTimestamping &&) = delete;
+
+public:
+    bool enable(native_handle_type handle, bool recv_enable, bool send_enable);
+    bool recv_enabled() const;
+    bool send_enabled() const;
+    void read_send_timestamps(native_handle_type handle);
+    bool send_timestamp(KernelTimestamp & timestamp, std::size_t & send_count) const;
+
+public:
+    static std::size_t recv(native_handle_type handle, void * data, std::size_t len, uint64_t & timestamp, boost::system::error_code & error);
+    static bool to_timestamp(uint64_t nanoseconds, KernelTimestamp & timestamp);
+#ifdef BOOST_NET_TIMESTAMPING_SUPPORT
+    static uint64_t recv_timestamp(struct msghdr & header);
+#endif // BOOST_NET_TIMESTAMPING_SUPPORT
+
+private:
+    bool                                            m_recv_enable;
+    bool                                            m_send_enable;
+    mutable std::mutex                              m_send_mutex;
+    uint64_t                                        m_send_time;
+    std::size_t                                     m_send_count;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_SOCKET_TIMESTAMPING_H
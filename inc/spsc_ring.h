@@ -0,0 +1,126 @@
+/********************************************************
+ * Description : single producer single consumer ring
+ * Data        : 2026-10-20 00:30:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_SPSC_RING_H
+#define BOOST_NET_SPSC_RING_H
+
+
+#include <vector>
+#include <atomic>
+
+namespace BoostNet { // namespace BoostNet begin
+
+/*
+ * push() only from one thread, pop() only from one other thread, capacity is rounded up to a power of two,
+ * the two indexes sit on their own cache lines so producer and consumer do not share one
+ */
+template <typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(std::size_t capacity);
+
+public:
+    SpscRing(const SpscRing &) = delete;
+    SpscRing(SpscRing &&) = delete;
+    SpscRing & operator = (const SpscRing &) = delete;
+    SpscRing & operator = (SpscRing &&) = delete;
+
+public:
+    bool push(T & item);
+    bool pop(T & item);
+    bool empty() const;
+    std::size_t size() const;
+    std::size_t capacity() const;
+
+private:
+    static std::size_t round_capacity(std::size_t capacity);
+
+private:
+    std::vector<T>                                  m_items;
+    const std::size_t                               m_mask;
+    char                                            m_head_pad[64];
+    std::atomic<std::size_t>                        m_head;
+    char                                            m_tail_pad[64];
+    std::atomic<std::size_t>                        m_tail;
+};
+
+template <typename T>
+SpscRing<T>::SpscRing(std::size_t capacity)
+    : m_items(round_capacity(capacity))
+    , m_mask(m_items.size() - 1)
+    , m_head_pad()
+    , m_head(0)
+    , m_tail_pad()
+    , m_tail(0)
+{
+
+}
+
+template <typename T>
+std::size_t SpscRing<T>::round_capacity(std::size_t capacity)
+{
+    std::size_t size = 2;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+    return size;
+}
+
+template <typename T>
+bool SpscRing<T>::push(T & item)
+{
+    std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+    {
+        return false;
+    }
+    m_items[tail & m_mask] = std::move(item);
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool SpscRing<T>::pop(T & item)
+{
+    std::size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+    item = std::move(m_items[head & m_mask]);
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool SpscRing<T>::empty() const
+{
+    return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+}
+
+template <typename T>
+std::size_t SpscRing<T>::size() const
+{
+    std::size_t head = m_head.load(std::memory_order_acquire);
+    return m_tail.load(std::memory_order_acquire) - head;
+}
+
+template <typename T>
+std::size_t SpscRing<T>::capacity() const
+{
+    return m_items.size();
+}
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_SPSC_RING_H
@@ -0,0 +1,80 @@
+/********************************************************
+ * Description : ssl kernel tls offload
+ * Data        : 2026-10-19 19:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_SSL_KERNEL_TLS_H
+#define BOOST_NET_SSL_KERNEL_TLS_H
+
+
+#include <cstdint>
+#include <vector>
+#include <openssl/ssl.h>
+
+namespace BoostNet { // namespace BoostNet begin
+
+/*
+ * install() leaves the session in openssl unless every byte read from the socket was consumed by the ssl side of its bio,
+ * asio keeps what its bio pair could not take (reads of up to 17KB) in a buffer we cannot see, recv_drained() catches that
+ * by comparing tcpi_bytes_received minus the unread queue with BIO_number_read() of the ssl read bio
+ */
+class SslKernelTls
+{
+public:
+    typedef std::vector<unsigned char>                          secret_type;
+
+public:
+    SslKernelTls();
+    ~SslKernelTls();
+
+public:
+    SslKernelTls(const SslKernelTls &) = delete;
+    SslKernelTls(SslKernelTls &&) = delete;
+    SslKernelTls & operator = (const SslKernelTls &) = delete;
+    SslKernelTls & operator = (SslKernelTls &&) = delete;
+
+public:
+    static bool supported();
+    static bool enable(SSL_CTX * ssl_context, bool enable);
+    static bool recv_drained(SSL * ssl, int fd);
+
+public:
+    void prepare(SSL * ssl);
+    bool install(SSL * ssl, int fd, bool passive);
+    std::size_t recv(int fd, void * data, std::size_t size, int & error);
+    void shutdown(int fd);
+    bool send_offload() const;
+    bool recv_offload() const;
+
+private:
+    static int ssl_index();
+    static void handle_keylog(const SSL * ssl, const char * line);
+    static void handle_message(int write_p, int, int content_type, const void * buf, std::size_t len, SSL *, void * arg);
+
+private:
+    bool recv_control(unsigned char record_type, const unsigned char * data, std::size_t size, int & error);
+
+private:
+    bool                                            m_prepared;
+    bool                                            m_send_offload;
+    bool                                            m_recv_offload;
+    bool                                            m_send_finished;
+    bool                                            m_recv_finished;
+    uint64_t                                        m_send_records;
+    uint64_t                                        m_recv_records;
+    uint64_t                                        m_send_messages;
+    uint64_t                                        m_recv_messages;
+    secret_type                                     m_recv_handshake;
+    secret_type                                     m_client_secret;
+    secret_type                                     m_server_secret;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_SSL_KERNEL_TLS_H
@@ -0,0 +1,79 @@
+/********************************************************
+ * Description : ssl client session cache
+ * Data        : 2026-10-19 16:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_SSL_SESSION_CACHE_H
+#define BOOST_NET_SSL_SESSION_CACHE_H
+
+
+#include <string>
+#include <list>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <openssl/ssl.h>
+
+namespace BoostNet { // namespace BoostNet begin
+
+class SslSessionCache
+{
+public:
+    typedef std::list<std::string>                              ssl_session_keys;
+    typedef ssl_session_keys::iterator                          ssl_session_key_iterator;
+    typedef std::pair<SSL_SESSION *, ssl_session_key_iterator>  ssl_session_item;
+    typedef std::map<std::string, ssl_session_item>             ssl_session_map;
+    typedef std::vector<SSL_CTX *>                              ssl_contexts_type;
+
+public:
+    SslSessionCache();
+    ~SslSessionCache();
+
+public:
+    SslSessionCache(const SslSessionCache &) = delete;
+    SslSessionCache(SslSessionCache &&) = delete;
+    SslSessionCache & operator = (const SslSessionCache &) = delete;
+    SslSessionCache & operator = (SslSessionCache &&) = delete;
+
+public:
+    bool attach(SSL_CTX * ssl_context);
+    void detach();
+    void set_limit(std::size_t max_session_count);
+    void get_statistics(std::size_t & hit_count, std::size_t & miss_count);
+    void clear();
+
+public:
+    void prepare(SSL * ssl, const std::string & key);
+    void complete(SSL * ssl, bool success);
+
+public:
+    bool insert(const std::string & key, SSL_SESSION * ssl_session);
+    void remove(const std::string & key);
+
+private:
+    static int context_index();
+    static int session_index();
+    static int handle_new_session(SSL * ssl, SSL_SESSION * ssl_session);
+
+private:
+    void erase(ssl_session_map::iterator iter);
+
+private:
+    std::mutex                                      m_mutex;
+    ssl_contexts_type                               m_ssl_contexts;
+    ssl_session_map                                 m_ssl_session_map;
+    ssl_session_keys                                m_ssl_session_keys;
+    std::size_t                                     m_max_session_count;
+    std::size_t                                     m_hit_count;
+    std::size_t                                     m_miss_count;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_SSL_SESSION_CACHE_H
@@ -0,0 +1,105 @@
+/********************************************************
+ * Description : ssl session ticket key ring
+ * Data        : 2026-10-19 18:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_SSL_TICKET_KEY_RING_H
+#define BOOST_NET_SSL_TICKET_KEY_RING_H
+
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <openssl/ssl.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+namespace BoostNet { // namespace BoostNet begin
+
+/*
+ * keys use the nginx ssl_session_ticket_key layout, 48 bytes (name, hmac, aes-128) or 80 bytes (name, hmac, aes-256)
+ * a file or buffer may hold several keys of one size back to back, the first one encrypts new tickets, the others only decrypt
+ * key size 0 takes the size from the length, which fails when the length is a multiple of both (240 bytes, 480 bytes, ...)
+ * the rotate timer is created by the first start() on its io_context and kept until destruction, start() and stop() only post to it
+ */
+class SslTicketKeyRing
+{
+public:
+    struct ticket_key_type
+    {
+        unsigned char                               name[16];
+        unsigned char                               hmac_key[32];
+        unsigned char                               aes_key[32];
+        std::size_t                                 size;
+    };
+
+public:
+    typedef boost::asio::io_context                             io_context_type;
+    typedef std::vector<ticket_key_type>                        ticket_keys_type;
+    typedef std::vector<SSL_CTX *>                              ssl_contexts_type;
+    typedef std::unique_ptr<boost::asio::steady_timer>          timer_ptr;
+
+public:
+    SslTicketKeyRing();
+    ~SslTicketKeyRing();
+
+public:
+    SslTicketKeyRing(const SslTicketKeyRing &) = delete;
+    SslTicketKeyRing(SslTicketKeyRing &&) = delete;
+    SslTicketKeyRing & operator = (const SslTicketKeyRing &) = delete;
+    SslTicketKeyRing & operator = (SslTicketKeyRing &&) = delete;
+
+public:
+    bool attach(SSL_CTX * ssl_context);
+    void detach();
+    bool attached() const;
+    bool load(bool pass_file_not_buffer, const char * keys_file_or_buffer, std::size_t buffer_length, std::size_t key_size);
+    bool start(io_context_type & io_context, std::size_t rotate_seconds);
+    void stop();
+
+public:
+    static bool parse_keys(const unsigned char * data, std::size_t size, std::size_t key_size, ticket_keys_type & ticket_keys);
+
+private:
+    bool reload();
+    void rotate();
+    void arm_rotate();
+    void handle_rotate(const boost::system::error_code & error);
+    bool find_key(const unsigned char * name, ticket_key_type & ticket_key, bool & primary);
+
+private:
+    static bool generate_key(ticket_key_type & ticket_key);
+    static int context_index();
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    static int handle_ticket_key(SSL * ssl, unsigned char * key_name, unsigned char * iv, EVP_CIPHER_CTX * cipher_ctx, EVP_MAC_CTX * hmac_ctx, int encrypt);
+#else
+    static int handle_ticket_key(SSL * ssl, unsigned char * key_name, unsigned char * iv, EVP_CIPHER_CTX * cipher_ctx, HMAC_CTX * hmac_ctx, int encrypt);
+#endif // OPENSSL_VERSION_NUMBER >= 0x30000000L
+
+private:
+    enum { max_generated_keys = 3 };
+
+private:
+    mutable std::mutex                              m_mutex;
+    ssl_contexts_type                               m_ssl_contexts;
+    ticket_keys_type                                m_ticket_keys;
+    std::string                                     m_keys_file;
+    std::size_t                                     m_key_size;
+    bool                                            m_generate_keys;
+    std::atomic<std::size_t>                        m_rotate_seconds;
+    timer_ptr                                       m_rotate_timer;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_SSL_TICKET_KEY_RING_H
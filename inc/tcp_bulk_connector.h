@@ -0,0 +1,82 @@
+/********************************************************
+ * Description : tcp bulk connector
+ * Data        : 2026-10-19 14:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_TCP_BULK_CONNECTOR_H
+#define BOOST_NET_TCP_BULK_CONNECTOR_H
+
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <functional>
+#include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include "boost_net.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+class TcpBulkConnector : public std::enable_shared_from_this<TcpBulkConnector>
+{
+public:
+    struct target_type
+    {
+        std::string                                 host;
+        std::string                                 service;
+        const void                                * identity;
+    };
+
+public:
+    typedef boost::asio::io_context                             io_context_type;
+    typedef std::vector<target_type>                            targets_type;
+    typedef std::function<void(bool)>                           notify_type;
+    typedef std::function<bool(const target_type &, notify_type)> connect_type;
+
+public:
+    TcpBulkConnector(io_context_type & io_context, TcpServiceBase * tcp_service, targets_type targets, const void * identity, std::size_t max_in_flight, std::size_t pacing_microseconds, bool pacing_jitter, connect_type connect);
+    ~TcpBulkConnector();
+
+public:
+    TcpBulkConnector(const TcpBulkConnector &) = delete;
+    TcpBulkConnector(TcpBulkConnector &&) = delete;
+    TcpBulkConnector & operator = (const TcpBulkConnector &) = delete;
+    TcpBulkConnector & operator = (TcpBulkConnector &&) = delete;
+
+public:
+    void start();
+
+private:
+    void launch();
+    void handle_connect(bool success);
+    void handle_pacing(const boost::system::error_code & error);
+
+private:
+    io_context_type                               & m_io_context;
+    TcpServiceBase                                * m_tcp_service;
+    targets_type                                    m_targets;
+    const void                                    * m_identity;
+    std::size_t                                     m_max_in_flight;
+    std::size_t                                     m_pacing_microseconds;
+    bool                                            m_pacing_jitter;
+    bool                                            m_pacing_wait;
+    bool                                            m_finish;
+    connect_type                                    m_connect;
+    boost::asio::steady_timer                       m_pacing_timer;
+    std::minstd_rand                                m_random;
+    std::size_t                                     m_next_target;
+    std::size_t                                     m_in_flight;
+    std::size_t                                     m_success_count;
+    std::size_t                                     m_failure_count;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_TCP_BULK_CONNECTOR_H
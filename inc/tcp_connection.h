@@ -14,27 +14,45 @@
 
 #include <string>
 #include <vector>
+#include <deque>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <boost/asio.hpp>
 #include <boost/asio/ssl.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/core/ignore_unused.hpp>
+#include <boost/functional/factory.hpp>
 #include "boost_net.h"
 #include "tcp_recv_buffer.h"
 #include "tcp_send_buffer.h"
+#include "tcp_connection_pool.h"
+#include "ssl_session_cache.h"
+#include "ssl_kernel_tls.h"
+#include "token_bucket.h"
+#include "socket_timestamping.h"
 
 namespace BoostNet { // namespace BoostNet begin
 
 template <class Derived, class SocketType>
-class TcpConnection : public TcpConnectionBase
+class TcpConnection : public TcpPoolableConnection
 {
 public:
     typedef boost::asio::io_context                             io_context_type;
     typedef boost::asio::ssl::context                           ssl_context_type;
+    typedef std::shared_ptr<ssl_context_type>                   ssl_context_ptr;
     typedef TcpRecvBuffer                                       tcp_recv_buffer_type;
     typedef TcpSendBuffer                                       tcp_send_buffer_type;
     typedef std::shared_ptr<boost::asio::ip::tcp::resolver>     resolver_ptr;
+    typedef boost::asio::ip::tcp::socket                        connect_socket_type;
+    typedef std::shared_ptr<connect_socket_type>                connect_socket_ptr;
+    typedef std::shared_ptr<boost::asio::steady_timer>          connect_timer_ptr;
+    typedef std::vector<boost::asio::ip::tcp::endpoint>         connect_endpoints_type;
+    typedef std::vector<connect_socket_ptr>                     connect_sockets_type;
 
 public:
-    TcpConnection(io_context_type & io_context, ssl_context_type & ssl_context, TcpServiceBase * tcp_service, bool passive, const void * identity, bool use_ssl);
+    TcpConnection(io_context_type & io_context, ssl_context_ptr ssl_context, TcpServiceBase * tcp_service, bool passive, const void * identity, bool use_ssl);
     virtual ~TcpConnection() override;
 
 public:
@@ -46,6 +64,7 @@ public:
 public:
     virtual void get_host_address(std::string & ip, unsigned short & port) override;
     virtual void get_peer_address(std::string & ip, unsigned short & port) override;
+    virtual void get_alpn_protocol(std::string & protocol) override;
 
 public:
     virtual const void * recv_buffer_data() override;
@@ -54,39 +73,65 @@ public:
     virtual bool recv_buffer_move(void * buf, std::size_t len) override;
     virtual bool recv_buffer_drop(std::size_t len) override;
     virtual void recv_buffer_water_mark(std::size_t len) override;
+    virtual bool recv_buffer_timestamp(KernelTimestamp & timestamp) override;
     virtual bool send_buffer_fill(const void * data, std::size_t len) override;
+    virtual bool send_timestamp(KernelTimestamp & timestamp, std::size_t & send_count) override;
 
 public:
     virtual void close() override;
 
+public:
+    virtual bool pool_alive() override;
+    virtual bool pool_release() override;
+    virtual void pool_reuse(const void * identity, std::function<void()> fallback) override;
+
 public:
     io_context_type & io_context();
     tcp_recv_buffer_type & recv_buffer();
     tcp_send_buffer_type & send_buffer();
     void start();
+    void set_connect_attempt(std::size_t attempt_delay, std::size_t attempt_timeout);
+    void set_connection_pool(TcpConnectionPool * connection_pool, const std::string & pool_key, bool pool_prewarm);
+    void set_connect_notify(std::function<void(bool)> connect_notify);
+    void set_record_sizing(std::size_t small_record_size, std::size_t small_record_count, std::size_t idle_milliseconds);
+    void set_rate_limit(const RateLimit & limit, const TokenBucket::bucket_ptr & listener_send_bucket, const TokenBucket::bucket_ptr & listener_recv_bucket);
+    void set_timestamping(bool recv_enable, bool send_enable);
 
 public:
     void handle_resolve(const boost::system::error_code & error, const boost::asio::ip::tcp::resolver::results_type & results, boost::asio::ip::tcp::endpoint host_endpoint, resolver_ptr resolver);
-    void handle_connect(const boost::system::error_code & error, const boost::asio::ip::tcp::endpoint & peer_endpoint, std::unique_ptr<size_t> times);
+    void handle_connect(const boost::system::error_code & error, connect_socket_ptr socket, connect_timer_ptr timer);
+    void handle_connect_delay(const boost::system::error_code & error);
     void handle_handshake(const boost::system::error_code & error);
 
 private:
+    void connect();
+    void connect_failure();
+    void connect_notify(bool success);
+    void handle_pool_release();
+    void handle_pool_reuse(const void * identity, std::function<void()> fallback);
     void send();
     void recv();
     void stop();
+    std::size_t record_size();
+    bool set_pacing_rate(std::size_t bytes_per_second);
+    void wait_send_timestamps();
     void post_send_data(const void * data, std::size_t len);
     void push_send_data(std::vector<char> data);
 
 private:
     void handle_send(const boost::system::error_code & error, std::size_t bytes_transferred);
     void handle_recv(const boost::system::error_code & error, std::size_t bytes_transferred);
+    void handle_rate_wait(const boost::system::error_code & error, bool send_not_recv);
+    void handle_recv_timestamp(const boost::system::error_code & error);
+    void handle_recv_offload(const boost::system::error_code & error);
+    void handle_send_timestamps(const boost::system::error_code & error);
 
 private:
     Derived & derived();
 
 private:
     io_context_type                               & m_io_context;
-    ssl_context_type                              & m_ssl_context;
+    ssl_context_ptr                                 m_ssl_context;
     TcpServiceBase                                * m_tcp_service;
     const bool                                      m_use_ssl;
     bool                                            m_running;
@@ -99,10 +144,37 @@ private:
     tcp_recv_buffer_type                            m_recv_buffer;
     tcp_send_buffer_type                            m_send_buffer;
     std::size_t                                     m_recv_water_mark;
+    std::size_t                                     m_connect_delay;
+    std::size_t                                     m_connect_timeout;
+    boost::asio::steady_timer                       m_connect_timer;
+    boost::asio::ip::tcp::endpoint                  m_connect_bind_endpoint;
+    connect_endpoints_type                          m_connect_endpoints;
+    std::size_t                                     m_connect_index;
+    connect_sockets_type                            m_connect_sockets;
+    bool                                            m_connect_finish;
+    TcpConnectionPool                             * m_connection_pool;
+    std::string                                     m_pool_key;
+    bool                                            m_pool_prewarm;
+    std::atomic<bool>                               m_pool_idle;
+    std::function<void(bool)>                       m_connect_notify;
+    std::size_t                                     m_record_small_size;
+    std::size_t                                     m_record_small_count;
+    std::size_t                                     m_record_idle;
+    std::size_t                                     m_record_small_sent;
+    std::chrono::steady_clock::time_point           m_record_send_time;
+    TokenBucket                                     m_send_bucket;
+    TokenBucket                                     m_recv_bucket;
+    std::size_t                                     m_pacing_rate;
+    boost::asio::steady_timer                       m_send_timer;
+    boost::asio::steady_timer                       m_recv_timer;
+    bool                                            m_timestamp_recv;
+    bool                                            m_timestamp_send;
+    SocketTimestamping                              m_timestamping;
+    uint64_t                                        m_recv_timestamp;
 };
 
 template <class Derived, class SocketType>
-TcpConnection<Derived, SocketType>::TcpConnection(io_context_type & io_context, ssl_context_type & ssl_context, TcpServiceBase * tcp_service, bool passive, const void * identity, bool use_ssl)
+TcpConnection<Derived, SocketType>::TcpConnection(io_context_type & io_context, ssl_context_ptr ssl_context, TcpServiceBase * tcp_service, bool passive, const void * identity, bool use_ssl)
     : m_io_context(io_context)
     , m_ssl_context(ssl_context)
     , m_tcp_service(tcp_service)
@@ -117,6 +189,33 @@ TcpConnection<Derived, SocketType>::TcpConnection(io_context_type & io_context,
     , m_recv_buffer()
     , m_send_buffer()
     , m_recv_water_mark(1)
+    , m_connect_delay(250)
+    , m_connect_timeout(0)
+    , m_connect_timer(io_context)
+    , m_connect_bind_endpoint()
+    , m_connect_endpoints()
+    , m_connect_index(0)
+    , m_connect_sockets()
+    , m_connect_finish(false)
+    , m_connection_pool(nullptr)
+    , m_pool_key()
+    , m_pool_prewarm(false)
+    , m_pool_idle(false)
+    , m_connect_notify()
+    , m_record_small_size(0)
+    , m_record_small_count(0)
+    , m_record_idle(0)
+    , m_record_small_sent(0)
+    , m_record_send_time()
+    , m_send_bucket()
+    , m_recv_bucket()
+    , m_pacing_rate(0)
+    , m_send_timer(io_context)
+    , m_recv_timer(io_context)
+    , m_timestamp_recv(false)
+    , m_timestamp_send(false)
+    , m_timestamping()
+    , m_recv_timestamp(0)
 {
 
 }
@@ -169,76 +268,242 @@ void TcpConnection<Derived, SocketType>::stop()
 {
     if (m_running)
     {
+        m_send_timer.cancel();
+        m_recv_timer.cancel();
         derived().shutdown();
-        if (nullptr != m_tcp_service)
+        if (m_timestamping.send_enabled())
+        {
+            boost::system::error_code ignore_error_code;
+            derived().socket_lowest().cancel(ignore_error_code);
+        }
+        if (nullptr != m_tcp_service && !m_pool_idle)
         {
             m_tcp_service->on_close(derived().shared_from_this());
         }
         m_running = false;
+        m_pool_idle = false;
     }
 }
 
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::set_connect_attempt(std::size_t attempt_delay, std::size_t attempt_timeout)
+{
+    m_connect_delay = attempt_delay;
+    m_connect_timeout = attempt_timeout;
+}
+
 template <class Derived, class SocketType>
 void TcpConnection<Derived, SocketType>::handle_resolve(const boost::system::error_code & error, const boost::asio::ip::tcp::resolver::results_type & results, boost::asio::ip::tcp::endpoint host_endpoint, resolver_ptr resolver)
 {
-    if (error)
+    if (error || results.empty())
+    {
+        connect_failure();
+        return;
+    }
+
+    /* interleave address families as rfc 8305 suggests, starting with the family of the first record */
+    std::deque<boost::asio::ip::tcp::endpoint> preferred_endpoints;
+    std::deque<boost::asio::ip::tcp::endpoint> fallback_endpoints;
+    const bool prefer_v6 = results.begin()->endpoint().address().is_v6();
+    for (boost::asio::ip::tcp::resolver::results_type::iterator iter = results.begin(); results.end() != iter; ++iter)
+    {
+        if (iter->endpoint().address().is_v6() == prefer_v6)
+        {
+            preferred_endpoints.push_back(iter->endpoint());
+        }
+        else
+        {
+            fallback_endpoints.push_back(iter->endpoint());
+        }
+    }
+
+    m_connect_endpoints.clear();
+    while (!preferred_endpoints.empty() || !fallback_endpoints.empty())
     {
-        if (nullptr != m_tcp_service)
+        if (!preferred_endpoints.empty())
         {
-            m_tcp_service->on_connect(nullptr, m_identity);
+            m_connect_endpoints.push_back(preferred_endpoints.front());
+            preferred_endpoints.pop_front();
         }
+        if (!fallback_endpoints.empty())
+        {
+            m_connect_endpoints.push_back(fallback_endpoints.front());
+            fallback_endpoints.pop_front();
+        }
+    }
+
+    m_connect_bind_endpoint = host_endpoint;
+    m_connect_index = 0;
+    m_connect_sockets.clear();
+    m_connect_finish = false;
+
+    connect();
+}
+
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::connect()
+{
+    if (m_connect_finish)
+    {
         return;
     }
 
-    boost::system::error_code connect_error_code = boost::asio::error::host_not_found;
-    derived().socket_lowest().close(connect_error_code);
-    if (0 != host_endpoint.port() || !host_endpoint.address().is_unspecified())
+    if (m_connect_endpoints.size() <= m_connect_index)
     {
-        try
+        if (m_connect_sockets.empty())
         {
-            derived().socket_lowest().open(host_endpoint.protocol());
-            derived().socket_lowest().set_option(boost::asio::ip::tcp::socket::reuse_address(true));
-            derived().socket_lowest().set_option(boost::asio::ip::tcp::socket::keep_alive(true));
-            derived().socket_lowest().bind(host_endpoint);
+            m_connect_finish = true;
+            connect_failure();
         }
-        catch (boost::system::error_code &)
+        return;
+    }
+
+    const boost::asio::ip::tcp::endpoint peer_endpoint = m_connect_endpoints[m_connect_index++];
+
+    connect_socket_ptr socket = boost::factory<connect_socket_ptr>()(m_io_context);
+    boost::system::error_code error;
+    socket->open(peer_endpoint.protocol(), error);
+    if (!error && (0 != m_connect_bind_endpoint.port() || !m_connect_bind_endpoint.address().is_unspecified()))
+    {
+        if (m_connect_bind_endpoint.protocol() != peer_endpoint.protocol())
         {
-            if (nullptr != m_tcp_service)
+            error = boost::asio::error::address_family_not_supported;
+        }
+        else
+        {
+            socket->set_option(boost::asio::ip::tcp::socket::reuse_address(true), error);
+            if (!error)
             {
-                m_tcp_service->on_connect(nullptr, m_identity);
+                socket->bind(m_connect_bind_endpoint, error);
             }
-            return;
         }
     }
+    if (!error)
+    {
+        socket->set_option(boost::asio::ip::tcp::socket::keep_alive(true), error);
+    }
+    if (error)
+    {
+        connect();
+        return;
+    }
+
+    connect_timer_ptr timer;
+    if (0 != m_connect_timeout)
+    {
+        timer = boost::factory<connect_timer_ptr>()(m_io_context);
+        timer->expires_after(std::chrono::milliseconds(m_connect_timeout));
+        timer->async_wait(
+            [socket](const boost::system::error_code & error) {
+                if (!error)
+                {
+                    boost::system::error_code ignore_error_code;
+                    socket->close(ignore_error_code);
+                }
+            }
+        );
+    }
+
+    m_connect_sockets.push_back(socket);
 
-    boost::asio::async_connect(
-        derived().socket_lowest(),
-        results,
-        [self = derived().shared_from_this(), times = results.size()](const boost::system::error_code & error, const boost::asio::ip::tcp::endpoint & endpoint) mutable {
-            self->handle_connect(error, endpoint, std::make_unique<size_t>(times));
+    socket->async_connect(
+        peer_endpoint,
+        [self = derived().shared_from_this(), socket, timer](const boost::system::error_code & error) {
+            self->handle_connect(error, socket, timer);
         }
     );
+
+    if (m_connect_endpoints.size() > m_connect_index)
+    {
+        m_connect_timer.expires_after(std::chrono::milliseconds(m_connect_delay));
+        m_connect_timer.async_wait(
+            [self = derived().shared_from_this()](const boost::system::error_code & error) {
+                self->handle_connect_delay(error);
+            }
+        );
+    }
 }
 
 template <class Derived, class SocketType>
-void TcpConnection<Derived, SocketType>::handle_connect(const boost::system::error_code & error, const boost::asio::ip::tcp::endpoint & peer_endpoint, std::unique_ptr<size_t> times)
+void TcpConnection<Derived, SocketType>::connect_failure()
 {
-    if (!error)
+    connect_notify(false);
+
+    if (m_pool_prewarm)
     {
-        boost::asio::post(m_io_context, [self = derived().shared_from_this()]() { self->start(); });
         return;
     }
 
-    if (!!times && *times > 1)
+    if (nullptr != m_tcp_service)
+    {
+        m_tcp_service->on_connect(nullptr, m_identity);
+    }
+}
+
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::set_connect_notify(std::function<void(bool)> connect_notify)
+{
+    m_connect_notify = std::move(connect_notify);
+}
+
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::connect_notify(bool success)
+{
+    if (m_connect_notify)
+    {
+        std::function<void(bool)> connect_notify;
+        connect_notify.swap(m_connect_notify);
+        connect_notify(success);
+    }
+}
+
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::handle_connect_delay(const boost::system::error_code & error)
+{
+    if (error || m_connect_timer.expiry() > boost::asio::steady_timer::clock_type::now())
     {
-        --*times;
         return;
     }
 
-    if (nullptr != m_tcp_service)
+    connect();
+}
+
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::handle_connect(const boost::system::error_code & error, connect_socket_ptr socket, connect_timer_ptr timer)
+{
+    if (!!timer)
     {
-        m_tcp_service->on_connect(nullptr, m_identity);
+        timer->cancel();
+    }
+
+    m_connect_sockets.erase(std::remove(m_connect_sockets.begin(), m_connect_sockets.end(), socket), m_connect_sockets.end());
+
+    if (m_connect_finish)
+    {
+        return;
+    }
+
+    if (!error)
+    {
+        m_connect_finish = true;
+        m_connect_timer.cancel();
+        for (typename connect_sockets_type::iterator iter = m_connect_sockets.begin(); m_connect_sockets.end() != iter; ++iter)
+        {
+            boost::system::error_code ignore_error_code;
+            (*iter)->close(ignore_error_code);
+        }
+        m_connect_sockets.clear();
+        derived().socket_lowest() = std::move(*socket);
+        boost::asio::post(m_io_context, [self = derived().shared_from_this()]() { self->start(); });
+        return;
+    }
+
+    if (m_connect_endpoints.size() > m_connect_index)
+    {
+        m_connect_timer.cancel();
     }
+
+    connect();
 }
 
 template <class Derived, class SocketType>
@@ -250,11 +515,37 @@ void TcpConnection<Derived, SocketType>::handle_handshake(const boost::system::e
     m_peer_ip = derived().socket_lowest().remote_endpoint(ignore_error_code).address().to_string();
     m_peer_port = derived().socket_lowest().remote_endpoint(ignore_error_code).port();
 
+    connect_notify(!error);
+
     if (!error)
     {
         m_running = true;
 
-        if (nullptr != m_tcp_service)
+        if (0 != m_pacing_rate && set_pacing_rate(m_pacing_rate))
+        {
+            m_send_bucket.set_rate(0, 0);
+        }
+
+        if (m_timestamp_recv || m_timestamp_send)
+        {
+            m_timestamping.enable(derived().socket_lowest().native_handle(), m_timestamp_recv && !m_use_ssl, m_timestamp_send);
+            if (m_timestamping.send_enabled())
+            {
+                wait_send_timestamps();
+            }
+        }
+
+        if (m_pool_prewarm)
+        {
+            m_pool_prewarm = false;
+            m_pool_idle = true;
+            if (nullptr == m_connection_pool || !m_connection_pool->insert(m_pool_key, derived().shared_from_this()))
+            {
+                close();
+                return;
+            }
+        }
+        else if (nullptr != m_tcp_service)
         {
             if (m_passive)
             {
@@ -284,27 +575,330 @@ void TcpConnection<Derived, SocketType>::close()
     boost::asio::post(m_io_context, [self = derived().shared_from_this()]() { self->stop(); });
 }
 
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::set_connection_pool(TcpConnectionPool * connection_pool, const std::string & pool_key, bool pool_prewarm)
+{
+    m_connection_pool = connection_pool;
+    m_pool_key = pool_key;
+    m_pool_prewarm = pool_prewarm;
+}
+
+template <class Derived, class SocketType>
+bool TcpConnection<Derived, SocketType>::pool_alive()
+{
+    return m_pool_idle;
+}
+
+template <class Derived, class SocketType>
+bool TcpConnection<Derived, SocketType>::pool_release()
+{
+    if (nullptr == m_connection_pool || m_pool_key.empty())
+    {
+        return false;
+    }
+    boost::asio::post(m_io_context, [self = derived().shared_from_this()]() { self->handle_pool_release(); });
+    return true;
+}
+
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::handle_pool_release()
+{
+    if (!m_running || m_pool_idle)
+    {
+        return;
+    }
+
+    if (0 != m_recv_buffer.size())
+    {
+        close();
+        return;
+    }
+
+    m_pool_idle = true;
+
+    if (!m_connection_pool->insert(m_pool_key, derived().shared_from_this()))
+    {
+        close();
+    }
+}
+
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::pool_reuse(const void * identity, std::function<void()> fallback)
+{
+    boost::asio::post(
+        m_io_context,
+        [self = derived().shared_from_this(), identity, fallback = std::move(fallback)]() mutable {
+            self->handle_pool_reuse(identity, std::move(fallback));
+        }
+    );
+}
+
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::handle_pool_reuse(const void * identity, std::function<void()> fallback)
+{
+    boost::system::error_code error;
+    std::size_t pending_size = derived().socket_lowest().available(error);
+    if (!m_running || !m_pool_idle || error || 0 != pending_size)
+    {
+        close();
+        if (fallback)
+        {
+            fallback();
+        }
+        return;
+    }
+
+    m_pool_idle = false;
+    m_identity = identity;
+
+    if (nullptr != m_tcp_service)
+    {
+        if (!m_tcp_service->on_connect(derived().shared_from_this(), m_identity))
+        {
+            close();
+        }
+    }
+}
+
 template <class Derived, class SocketType>
 void TcpConnection<Derived, SocketType>::recv()
 {
-    derived().socket().async_read_some(
-        m_recv_buffer.prepare(),
-        [self = derived().shared_from_this()](const boost::system::error_code & error, std::size_t bytes_transferred) {
-            self->handle_recv(error, bytes_transferred);
+    if (m_recv_bucket.limited())
+    {
+        std::size_t wait_microseconds = m_recv_bucket.wait_microseconds();
+        if (0 != wait_microseconds)
+        {
+            m_recv_timer.expires_after(std::chrono::microseconds(wait_microseconds));
+            m_recv_timer.async_wait(
+                [self = derived().shared_from_this()](const boost::system::error_code & error) {
+                    self->handle_rate_wait(error, false);
+                }
+            );
+            return;
+        }
+    }
+
+    if (m_timestamping.recv_enabled())
+    {
+        derived().socket_lowest().async_wait(
+            boost::asio::socket_base::wait_read,
+            [self = derived().shared_from_this()](const boost::system::error_code & error) {
+                self->handle_recv_timestamp(error);
+            }
+        );
+        return;
+    }
+
+    auto recv_handler = [self = derived().shared_from_this()](const boost::system::error_code & error, std::size_t bytes_transferred) {
+        self->handle_recv(error, bytes_transferred);
+    };
+
+    if (derived().recv_offload())
+    {
+        derived().socket_lowest().async_wait(
+            boost::asio::socket_base::wait_read,
+            [self = derived().shared_from_this()](const boost::system::error_code & error) {
+                self->handle_recv_offload(error);
+            }
+        );
+        return;
+    }
+
+    derived().socket().async_read_some(m_recv_buffer.prepare(), std::move(recv_handler));
+}
+
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::set_record_sizing(std::size_t small_record_size, std::size_t small_record_count, std::size_t idle_milliseconds)
+{
+    m_record_small_size = small_record_size;
+    m_record_small_count = small_record_count;
+    m_record_idle = idle_milliseconds;
+}
+
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::set_rate_limit(const RateLimit & limit, const TokenBucket::bucket_ptr & listener_send_bucket, const TokenBucket::bucket_ptr & listener_recv_bucket)
+{
+    m_pacing_rate = limit.send_bytes_per_second;
+    m_send_bucket.set_rate(limit.send_bytes_per_second, limit.burst_bytes);
+    m_send_bucket.set_parent(listener_send_bucket);
+    m_recv_bucket.set_rate(limit.recv_bytes_per_second, limit.burst_bytes);
+    m_recv_bucket.set_parent(listener_recv_bucket);
+}
+
+template <class Derived, class SocketType>
+bool TcpConnection<Derived, SocketType>::set_pacing_rate(std::size_t bytes_per_second)
+{
+#ifdef SO_MAX_PACING_RATE
+    boost::system::error_code error;
+    derived().socket_lowest().set_option(boost::asio::detail::socket_option::integer<SOL_SOCKET, SO_MAX_PACING_RATE>(static_cast<int>(std::min<std::size_t>(bytes_per_second, 0x7fffffff))), error);
+    return !error;
+#else
+    boost::ignore_unused(bytes_per_second);
+    return false;
+#endif // SO_MAX_PACING_RATE
+}
+
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::set_timestamping(bool recv_enable, bool send_enable)
+{
+    m_timestamp_recv = recv_enable;
+    m_timestamp_send = send_enable;
+}
+
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::wait_send_timestamps()
+{
+    derived().socket_lowest().async_wait(
+        boost::asio::socket_base::wait_error,
+        [self = derived().shared_from_this()](const boost::system::error_code & error) {
+            self->handle_send_timestamps(error);
         }
     );
 }
 
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::handle_recv_timestamp(const boost::system::error_code & error)
+{
+    if (error)
+    {
+        handle_recv(error, 0);
+        return;
+    }
+
+    boost::asio::mutable_buffer buffer = m_recv_buffer.prepare();
+    boost::system::error_code recv_error;
+    uint64_t timestamp = 0;
+    std::size_t recv_size = SocketTimestamping::recv(derived().socket_lowest().native_handle(), buffer.data(), buffer.size(), timestamp, recv_error);
+    if (boost::asio::error::would_block == recv_error)
+    {
+        recv();
+        return;
+    }
+
+    if (0 != timestamp)
+    {
+        m_recv_timestamp = timestamp;
+    }
+
+    handle_recv(recv_error, recv_size);
+}
+
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::handle_recv_offload(const boost::system::error_code & error)
+{
+    if (error)
+    {
+        handle_recv(error, 0);
+        return;
+    }
+
+    boost::system::error_code recv_error;
+    std::size_t recv_size = derived().read_offload(m_recv_buffer.prepare(), recv_error);
+    if (boost::asio::error::would_block == recv_error)
+    {
+        recv();
+        return;
+    }
+
+    handle_recv(recv_error, recv_size);
+}
+
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::handle_send_timestamps(const boost::system::error_code & error)
+{
+    if (error || !m_running)
+    {
+        return;
+    }
+
+    wait_send_timestamps();
+    m_timestamping.read_send_timestamps(derived().socket_lowest().native_handle());
+}
+
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::handle_rate_wait(const boost::system::error_code & error, bool send_not_recv)
+{
+    if (error || !m_running)
+    {
+        return;
+    }
+
+    if (send_not_recv)
+    {
+        send();
+    }
+    else
+    {
+        recv();
+    }
+}
+
+template <class Derived, class SocketType>
+std::size_t TcpConnection<Derived, SocketType>::record_size()
+{
+    const std::size_t max_record_size = 16 * 1024;
+    if (0 == m_record_small_size || m_record_small_size >= max_record_size)
+    {
+        return max_record_size;
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - m_record_send_time >= std::chrono::milliseconds(m_record_idle))
+    {
+        m_record_small_sent = 0;
+    }
+    m_record_send_time = now;
+
+    if (m_record_small_sent < m_record_small_count)
+    {
+        ++m_record_small_sent;
+        return m_record_small_size;
+    }
+
+    return max_record_size;
+}
+
 template <class Derived, class SocketType>
 void TcpConnection<Derived, SocketType>::send()
 {
-    boost::asio::async_write(
-        derived().socket(),
-        boost::asio::buffer(m_send_buffer.data()),
-        [self = derived().shared_from_this()](const boost::system::error_code & error, std::size_t bytes_transferred) {
-            self->handle_send(error, bytes_transferred);
+    auto send_handler = [self = derived().shared_from_this()](const boost::system::error_code & error, std::size_t bytes_transferred) {
+        self->handle_send(error, bytes_transferred);
+    };
+
+    std::size_t rate_size = static_cast<std::size_t>(~0);
+    if (m_send_bucket.limited())
+    {
+        std::size_t wait_microseconds = m_send_bucket.wait_microseconds();
+        if (0 != wait_microseconds)
+        {
+            m_send_timer.expires_after(std::chrono::microseconds(wait_microseconds));
+            m_send_timer.async_wait(
+                [self = derived().shared_from_this()](const boost::system::error_code & error) {
+                    self->handle_rate_wait(error, true);
+                }
+            );
+            return;
         }
-    );
+        rate_size = m_send_bucket.burst_bytes();
+    }
+
+    if (!m_use_ssl)
+    {
+        boost::asio::async_write(derived().socket(), m_send_buffer.data(rate_size), std::move(send_handler));
+        return;
+    }
+
+    const std::size_t max_size = std::min<std::size_t>(record_size(), rate_size);
+    m_send_buffer.coalesce(max_size);
+
+    if (derived().send_offload())
+    {
+        boost::asio::async_write(derived().socket_offload(), m_send_buffer.data(max_size), std::move(send_handler));
+    }
+    else
+    {
+        boost::asio::async_write(derived().socket(), m_send_buffer.data(max_size), std::move(send_handler));
+    }
 }
 
 template <class Derived, class SocketType>
@@ -339,6 +933,13 @@ void TcpConnection<Derived, SocketType>::handle_recv(const boost::system::error_
     }
 
     m_recv_buffer.commit(bytes_transferred);
+    m_recv_bucket.consume(bytes_transferred);
+
+    if (m_pool_idle)
+    {
+        close();
+        return;
+    }
 
     if (nullptr != m_tcp_service)
     {
@@ -362,19 +963,19 @@ void TcpConnection<Derived, SocketType>::handle_recv(const boost::system::error_
 template <class Derived, class SocketType>
 void TcpConnection<Derived, SocketType>::handle_send(const boost::system::error_code & error, std::size_t bytes_transferred)
 {
-    boost::ignore_unused(bytes_transferred);
-
     if (error)
     {
         close();
         return;
     }
 
-    m_send_buffer.consume();
+    m_send_buffer.consume(bytes_transferred);
+    m_send_bucket.consume(bytes_transferred);
+    m_record_send_time = std::chrono::steady_clock::now();
 
     if (m_send_buffer.empty())
     {
-        if (nullptr != m_tcp_service)
+        if (nullptr != m_tcp_service && !m_pool_idle)
         {
             if (!m_tcp_service->on_send(derived().shared_from_this()))
             {
@@ -403,6 +1004,12 @@ void TcpConnection<Derived, SocketType>::get_peer_address(std::string & ip, unsi
     port = m_peer_port;
 }
 
+template <class Derived, class SocketType>
+void TcpConnection<Derived, SocketType>::get_alpn_protocol(std::string & protocol)
+{
+    derived().alpn_protocol(protocol);
+}
+
 template <class Derived, class SocketType>
 const void * TcpConnection<Derived, SocketType>::recv_buffer_data()
 {
@@ -449,6 +1056,12 @@ bool TcpConnection<Derived, SocketType>::recv_buffer_drop(std::size_t len)
     return true;
 }
 
+template <class Derived, class SocketType>
+bool TcpConnection<Derived, SocketType>::recv_buffer_timestamp(KernelTimestamp & timestamp)
+{
+    return SocketTimestamping::to_timestamp(m_recv_timestamp, timestamp);
+}
+
 template <class Derived, class SocketType>
 void TcpConnection<Derived, SocketType>::recv_buffer_water_mark(std::size_t len)
 {
@@ -469,20 +1082,34 @@ bool TcpConnection<Derived, SocketType>::send_buffer_fill(const void * data, std
     return true;
 }
 
+template <class Derived, class SocketType>
+bool TcpConnection<Derived, SocketType>::send_timestamp(KernelTimestamp & timestamp, std::size_t & send_count)
+{
+    return m_timestamping.send_timestamp(timestamp, send_count);
+}
+
 class TcpSession : public TcpConnection<TcpSession, boost::asio::ip::tcp::socket>, public std::enable_shared_from_this<TcpSession>
 {
 public:
     typedef boost::asio::ip::tcp::socket                            socket_type;
     typedef socket_type                                             lowest_type;
+    typedef socket_type                                             offload_type;
 
 public:
-    TcpSession(io_context_type & io_context, ssl_context_type & ssl_context, TcpServiceBase * tcp_service, bool passive, const void * identity);
+    TcpSession(io_context_type & io_context, ssl_context_ptr ssl_context, TcpServiceBase * tcp_service, bool passive, const void * identity);
 
 public:
     socket_type & socket();
     lowest_type & socket_lowest();
+    offload_type & socket_offload();
+    void set_ssl_session_cache(SslSessionCache * ssl_session_cache, const std::string & ssl_session_key);
+    void set_handshake_context(io_context_type * handshake_context);
     void handshake(bool passive);
     void shutdown();
+    bool send_offload() const;
+    bool recv_offload() const;
+    std::size_t read_offload(const boost::asio::mutable_buffer & buffer, boost::system::error_code & error);
+    void alpn_protocol(std::string & protocol);
 
 private:
     socket_type                                                     m_socket;
@@ -493,18 +1120,33 @@ class SslSession : public TcpConnection<SslSession, boost::asio::ssl::stream<boo
 public:
     typedef boost::asio::ssl::stream<boost::asio::ip::tcp::socket>  socket_type;
     typedef socket_type::lowest_layer_type                          lowest_type;
+    typedef socket_type::next_layer_type                            offload_type;
 
 public:
-    SslSession(io_context_type & io_context, ssl_context_type & ssl_context, TcpServiceBase * tcp_service, bool passive, const void * identity);
+    SslSession(io_context_type & io_context, ssl_context_ptr ssl_context, TcpServiceBase * tcp_service, bool passive, const void * identity);
 
 public:
     socket_type & socket();
     lowest_type & socket_lowest();
+    offload_type & socket_offload();
+    void set_ssl_session_cache(SslSessionCache * ssl_session_cache, const std::string & ssl_session_key);
+    void set_handshake_context(io_context_type * handshake_context);
     void handshake(bool passive);
     void shutdown();
+    bool send_offload() const;
+    bool recv_offload() const;
+    std::size_t read_offload(const boost::asio::mutable_buffer & buffer, boost::system::error_code & error);
+    void alpn_protocol(std::string & protocol);
+
+private:
+    void start_handshake(bool passive);
 
 private:
     boost::asio::ssl::stream<boost::asio::ip::tcp::socket>          m_socket;
+    SslSessionCache                                               * m_ssl_session_cache;
+    std::string                                                     m_ssl_session_key;
+    SslKernelTls                                                    m_kernel_tls;
+    io_context_type                                               * m_handshake_context;
 };
 
 } // namespace BoostNet end
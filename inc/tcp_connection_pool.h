@@ -0,0 +1,89 @@
+/********************************************************
+ * Description : tcp connection pool
+ * Data        : 2026-10-19 10:30:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_TCP_CONNECTION_POOL_H
+#define BOOST_NET_TCP_CONNECTION_POOL_H
+
+
+#include <string>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <functional>
+#include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include "boost_net.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+class TcpPoolableConnection : public TcpConnectionBase
+{
+public:
+    virtual bool pool_alive() = 0;
+    virtual bool pool_release() = 0;
+    virtual void pool_reuse(const void * identity, std::function<void()> fallback) = 0;
+};
+
+class TcpConnectionPool
+{
+public:
+    typedef std::chrono::steady_clock                           clock_type;
+    typedef std::shared_ptr<TcpPoolableConnection>              connection_ptr;
+    typedef std::pair<connection_ptr, clock_type::time_point>   idle_connection_type;
+    typedef std::deque<idle_connection_type>                    idle_connections_type;
+    typedef std::map<std::string, idle_connections_type>        idle_connection_map;
+    typedef boost::asio::io_context                             io_context_type;
+    typedef std::unique_ptr<boost::asio::steady_timer>          timer_ptr;
+
+public:
+    TcpConnectionPool();
+    ~TcpConnectionPool();
+
+public:
+    TcpConnectionPool(const TcpConnectionPool &) = delete;
+    TcpConnectionPool(TcpConnectionPool &&) = delete;
+    TcpConnectionPool & operator = (const TcpConnectionPool &) = delete;
+    TcpConnectionPool & operator = (TcpConnectionPool &&) = delete;
+
+public:
+    static std::string make_key(const std::string & host, const std::string & service, const char * bind_ip, unsigned short bind_port, bool use_ssl);
+
+public:
+    void set_limit(std::size_t max_idle_per_key, std::size_t max_idle_total, std::size_t max_idle_milliseconds);
+    bool insert(const std::string & key, connection_ptr connection);
+    connection_ptr remove(const std::string & key);
+    void clear();
+
+public:
+    bool start(io_context_type & io_context);
+    void stop();
+
+private:
+    void purge(std::deque<connection_ptr> & expired_connections);
+    void start_purge_timer();
+    void handle_purge(const boost::system::error_code & error);
+
+private:
+    std::mutex                                      m_mutex;
+    idle_connection_map                             m_idle_connection_map;
+    std::size_t                                     m_idle_count;
+    std::size_t                                     m_max_idle_per_key;
+    std::size_t                                     m_max_idle_total;
+    std::size_t                                     m_max_idle_milliseconds;
+    timer_ptr                                       m_purge_timer;
+    bool                                            m_purge_waiting;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_TCP_CONNECTION_POOL_H
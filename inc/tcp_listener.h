@@ -0,0 +1,80 @@
+/********************************************************
+ * Description : tcp listener
+ * Data        : 2026-10-19 22:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_TCP_LISTENER_H
+#define BOOST_NET_TCP_LISTENER_H
+
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <boost/asio/ssl.hpp>
+#include "boost_net.h"
+#include "ssl_ticket_key_ring.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+/*
+ * every ssl context (the default one and one per sni certificate) is built when the listener is added,
+ * so the servername callback only does one hash lookup and switches the context of the connection
+ * only the default context is replaced by a reload, accepts read it with atomic_load
+ */
+class TcpListener
+{
+public:
+    typedef boost::asio::ssl::context                           ssl_context_type;
+    typedef std::shared_ptr<ssl_context_type>                   ssl_context_ptr;
+    typedef std::vector<ssl_context_ptr>                        ssl_contexts_type;
+    typedef std::unordered_map<std::string, SSL_CTX *>          server_names_type;
+    typedef std::vector<unsigned char>                          alpn_protocols_type;
+
+public:
+    TcpListener();
+    ~TcpListener();
+
+public:
+    TcpListener(const TcpListener &) = delete;
+    TcpListener(TcpListener &&) = delete;
+    TcpListener & operator = (const TcpListener &) = delete;
+    TcpListener & operator = (TcpListener &&) = delete;
+
+public:
+    bool init(const Listener & listener);
+    bool set_kernel_tls(bool enable);
+    bool set_session_cache(std::size_t cache_size, std::size_t timeout_seconds);
+    bool set_ticket_key_ring(SslTicketKeyRing & ticket_key_ring);
+    bool ssl_enable() const;
+    ssl_context_ptr ssl_context();
+    ssl_context_ptr create_default_context(const Certificate * certificate);
+    void set_default_context(ssl_context_ptr ssl_context);
+    void set_port(unsigned short port);
+    unsigned short port() const;
+
+private:
+    ssl_context_ptr create_ssl_context(const Certificate * certificate);
+
+private:
+    static bool parse_alpn_protocols(const char * alpn_protocols, alpn_protocols_type & protocols);
+    static int handle_server_name(SSL * ssl, int * alert, void * arg);
+    static int handle_alpn_select(SSL * ssl, const unsigned char ** out, unsigned char * outlen, const unsigned char * in, unsigned int inlen, void * arg);
+
+private:
+    ssl_contexts_type                               m_ssl_contexts;
+    server_names_type                               m_server_names;
+    alpn_protocols_type                             m_alpn_protocols;
+    std::string                                     m_ciphers;
+    unsigned short                                  m_port;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_TCP_LISTENER_H
@@ -15,11 +15,20 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <map>
 #include <boost/asio.hpp>
 #include <boost/asio/ssl.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include "boost_net.h"
 #include "tcp_connection.h"
+#include "tcp_connection_pool.h"
+#include "tcp_bulk_connector.h"
+#include "tcp_listener.h"
+#include "ssl_session_cache.h"
+#include "ssl_ticket_key_ring.h"
+#include "token_bucket.h"
 #include "io_context_pool.h"
 
 namespace BoostNet { // namespace BoostNet begin
@@ -29,15 +38,20 @@ class TcpManagerImpl
 public:
     typedef boost::asio::io_context                             io_context_type;
     typedef boost::asio::ssl::context                           ssl_context_type;
+    typedef std::shared_ptr<ssl_context_type>                   ssl_context_ptr;
     typedef boost::asio::ip::tcp::endpoint                      endpoint_type;
     typedef boost::asio::ip::tcp::acceptor                      acceptor_type;
     typedef boost::ptr_vector<acceptor_type>                    acceptors_type;
+    typedef boost::ptr_vector<TcpListener>                      listeners_type;
     typedef IOServicePool                                       io_context_pool_type;
+    typedef boost::ptr_vector<io_context_pool_type>             io_context_pools_type;
     typedef TcpSession                                          tcp_session_type;
     typedef SslSession                                          ssl_session_type;
     typedef std::shared_ptr<tcp_session_type>                   tcp_session_ptr;
     typedef std::shared_ptr<ssl_session_type>                   ssl_session_ptr;
     typedef std::shared_ptr<boost::asio::ip::tcp::resolver>     resolver_ptr;
+    typedef std::pair<TokenBucket::bucket_ptr, TokenBucket::bucket_ptr>         rate_buckets_type;
+    typedef std::map<unsigned short, rate_buckets_type>         listener_rate_buckets_type;
 
 public:
     TcpManagerImpl();
@@ -56,6 +70,14 @@ public:
 public:
     void get_ports(std::vector<unsigned short> & ports);
 
+public:
+    bool add_listener(const Listener & listener);
+
+public:
+    bool reload_server_certificate(const Certificate * server_certificate);
+    bool reload_client_certificate(const Certificate * client_certificate);
+    bool reload_listener_certificate(unsigned short port, const Certificate * certificate);
+
 public:
     void run(bool blocking = false);
 
@@ -63,37 +85,114 @@ public:
     bool create_connection(const std::string & host, const std::string & service, bool sync_connect = true, const void * identity = 0, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
     bool create_connection(const std::string & host, unsigned short port, bool sync_connect = true, const void * identity = 0, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
 
+public:
+    bool set_connect_attempt(std::size_t attempt_delay_milliseconds, std::size_t attempt_timeout_milliseconds);
+
+public:
+    bool set_connection_pool(std::size_t max_idle_per_key, std::size_t max_idle_total, std::size_t max_idle_milliseconds);
+    bool acquire_connection(const std::string & host, const std::string & service, const void * identity, const char * bind_ip, unsigned short bind_port);
+    bool acquire_connection(const std::string & host, unsigned short port, const void * identity, const char * bind_ip, unsigned short bind_port);
+    bool release_connection(TcpConnectionSharedPtr connection);
+    bool prewarm_connection(const std::string & host, const std::string & service, std::size_t count, const char * bind_ip, unsigned short bind_port);
+    bool prewarm_connection(const std::string & host, unsigned short port, std::size_t count, const char * bind_ip, unsigned short bind_port);
+
+public:
+    bool create_connections(const ConnectTarget * target_array, std::size_t target_count, const void * identity, std::size_t max_in_flight, std::size_t pacing_microseconds, bool pacing_jitter, const char * bind_ip, unsigned short bind_port);
+    bool create_connections(const std::string & host, unsigned short port, std::size_t count, const void * identity, std::size_t max_in_flight, std::size_t pacing_microseconds, bool pacing_jitter, const char * bind_ip, unsigned short bind_port);
+
+public:
+    bool set_ssl_session_cache(std::size_t max_session_count);
+    void get_ssl_session_statistics(std::size_t & hit_count, std::size_t & miss_count);
+
+public:
+    bool set_ssl_server_session_cache(std::size_t cache_size, std::size_t timeout_seconds);
+    bool set_ssl_ticket_keys(bool pass_file_not_buffer, const char * keys_file_or_buffer, std::size_t buffer_length, std::size_t rotate_seconds, std::size_t key_size);
+
+public:
+    bool set_ssl_handshake_pool(std::size_t thread_count);
+
+public:
+    bool set_ssl_record_sizing(std::size_t small_record_size, std::size_t small_record_count, std::size_t idle_milliseconds);
+
+public:
+    bool set_ssl_kernel_tls(bool enable);
+
+public:
+    bool set_rate_limit(const RateLimit & limit);
+
+public:
+    bool set_timestamping(bool recv_enable, bool send_enable);
+
 private:
     template<class SessionType, class SessionPtr> bool sync_create_connection(const std::string & host, const std::string & service, const void * identity, const char * bind_ip, unsigned short bind_port);
-    template<class SessionType, class SessionPtr> bool async_create_connection(const std::string & host, const std::string & service, const void * identity, const char * bind_ip, unsigned short bind_port);
+    template<class SessionType, class SessionPtr> bool async_create_connection(const std::string & host, const std::string & service, const void * identity, const char * bind_ip, unsigned short bind_port, bool pool_prewarm, std::function<void(bool)> connect_notify = std::function<void(bool)>());
 
 private:
-    void start_accept(acceptor_type & acceptor, unsigned short port);
+    void start_accept(acceptor_type & acceptor, unsigned short port, TcpListener * listener);
 
 private:
-    template<class SessionType, class SessionPtr> void handle_accept(acceptor_type & acceptor, unsigned short port, SessionPtr session, const boost::system::error_code & error);
+    template<class SessionType, class SessionPtr> void handle_accept(acceptor_type & acceptor, unsigned short port, TcpListener * listener, SessionPtr session, const boost::system::error_code & error);
 
 private:
-    bool set_server_certificate(const Certificate * certificate);
-    bool set_client_certificate(const Certificate * certificate);
+    bool set_server_certificate(ssl_context_type & ssl_context, const Certificate * certificate);
+    bool set_client_certificate(ssl_context_type & ssl_context, const Certificate * certificate);
+    bool setup_reloaded_context(ssl_context_type & ssl_context, ssl_context_type & old_ssl_context);
 
 private:
-    const std::string & get_server_ssl_password() const;
-    const std::string & get_client_ssl_password() const;
+    io_context_type * get_handshake_context();
+    template<class SessionPtr> void apply_rate_limit(SessionPtr session, bool passive, unsigned short port);
 
 private:
+    io_context_pools_type                           m_handshake_context_pools;
     io_context_pool_type                            m_io_context_pool;
+    std::atomic<bool>                               m_handshake_pool_enable;
     acceptors_type                                  m_acceptors;
-    ssl_context_type                                m_server_ssl_context;
-    ssl_context_type                                m_client_ssl_context;
-    std::string                                     m_server_ssl_password;
-    std::string                                     m_client_ssl_password;
+    listeners_type                                  m_listeners;
+    ssl_context_ptr                                 m_server_ssl_context;
+    ssl_context_ptr                                 m_client_ssl_context;
     bool                                            m_server_ssl_enable;
     bool                                            m_client_ssl_enable;
     TcpServiceBase                                * m_tcp_service;
     std::vector<unsigned short>                     m_tcp_ports;
+    std::atomic<std::size_t>                        m_connect_attempt_delay;
+    std::atomic<std::size_t>                        m_connect_attempt_timeout;
+    TcpConnectionPool                               m_connection_pool;
+    SslSessionCache                                 m_ssl_session_cache;
+    SslTicketKeyRing                                m_ssl_ticket_key_ring;
+    std::atomic<std::size_t>                        m_server_session_cache_size;
+    std::atomic<std::size_t>                        m_server_session_timeout;
+    std::atomic<std::size_t>                        m_record_small_size;
+    std::atomic<std::size_t>                        m_record_small_count;
+    std::atomic<std::size_t>                        m_record_idle;
+    std::atomic<bool>                               m_kernel_tls_enable;
+    std::mutex                                      m_rate_limit_mutex;
+    RateLimit                                       m_rate_limit;
+    listener_rate_buckets_type                      m_listener_rate_buckets;
+    std::atomic<bool>                               m_timestamp_recv;
+    std::atomic<bool>                               m_timestamp_send;
 };
 
+template<class SessionPtr>
+void TcpManagerImpl::apply_rate_limit(SessionPtr session, bool passive, unsigned short port)
+{
+    std::lock_guard<std::mutex> locker(m_rate_limit_mutex);
+    if (!passive)
+    {
+        session->set_rate_limit(m_rate_limit, TokenBucket::bucket_ptr(), TokenBucket::bucket_ptr());
+        return;
+    }
+
+    rate_buckets_type & rate_buckets = m_listener_rate_buckets[port];
+    if (!rate_buckets.first)
+    {
+        rate_buckets.first = boost::factory<TokenBucket::bucket_ptr>()();
+        rate_buckets.first->set_rate(m_rate_limit.listener_send_bytes_per_second, m_rate_limit.burst_bytes);
+        rate_buckets.second = boost::factory<TokenBucket::bucket_ptr>()();
+        rate_buckets.second->set_rate(m_rate_limit.listener_recv_bytes_per_second, m_rate_limit.burst_bytes);
+    }
+    session->set_rate_limit(m_rate_limit, rate_buckets.first, rate_buckets.second);
+}
+
 template<class SessionType, class SessionPtr>
 bool TcpManagerImpl::sync_create_connection(const std::string & host, const std::string & service, const void * identity, const char * bind_ip, unsigned short bind_port)
 {
@@ -108,7 +207,13 @@ bool TcpManagerImpl::sync_create_connection(const std::string & host, const std:
     }
 
     bool passive = false;
-    SessionPtr session = boost::factory<SessionPtr>()(m_io_context_pool.get(), m_client_ssl_context, m_tcp_service, passive, identity);
+    SessionPtr session = boost::factory<SessionPtr>()(m_io_context_pool.get(), std::atomic_load(&m_client_ssl_context), m_tcp_service, passive, identity);
+    session->set_connection_pool(&m_connection_pool, TcpConnectionPool::make_key(host, service, bind_ip, bind_port, m_client_ssl_enable), false);
+    session->set_ssl_session_cache(&m_ssl_session_cache, host + ":" + service);
+    session->set_record_sizing(m_record_small_size, m_record_small_count, m_record_idle);
+    session->set_timestamping(m_timestamp_recv, m_timestamp_send);
+    apply_rate_limit(session, passive, 0);
+    session->set_handshake_context(get_handshake_context());
     typename SessionType::lowest_type & socket = session->socket_lowest();
 
     boost::asio::ip::tcp::resolver resolver(session->io_context());
@@ -150,7 +255,7 @@ bool TcpManagerImpl::sync_create_connection(const std::string & host, const std:
 }
 
 template<class SessionType, class SessionPtr>
-bool TcpManagerImpl::async_create_connection(const std::string & host, const std::string & service, const void * identity, const char * bind_ip, unsigned short bind_port)
+bool TcpManagerImpl::async_create_connection(const std::string & host, const std::string & service, const void * identity, const char * bind_ip, unsigned short bind_port, bool pool_prewarm, std::function<void(bool)> connect_notify)
 {
     boost::asio::ip::tcp::endpoint endpoint;
     if (nullptr == bind_ip || '\0' == *bind_ip)
@@ -163,7 +268,15 @@ bool TcpManagerImpl::async_create_connection(const std::string & host, const std
     }
 
     bool passive = false;
-    SessionPtr session = boost::factory<SessionPtr>()(m_io_context_pool.get(), m_client_ssl_context, m_tcp_service, passive, identity);
+    SessionPtr session = boost::factory<SessionPtr>()(m_io_context_pool.get(), std::atomic_load(&m_client_ssl_context), m_tcp_service, passive, identity);
+    session->set_connect_attempt(m_connect_attempt_delay, m_connect_attempt_timeout);
+    session->set_connection_pool(&m_connection_pool, TcpConnectionPool::make_key(host, service, bind_ip, bind_port, m_client_ssl_enable), pool_prewarm);
+    session->set_connect_notify(std::move(connect_notify));
+    session->set_ssl_session_cache(&m_ssl_session_cache, host + ":" + service);
+    session->set_record_sizing(m_record_small_size, m_record_small_count, m_record_idle);
+    session->set_timestamping(m_timestamp_recv, m_timestamp_send);
+    apply_rate_limit(session, passive, 0);
+    session->set_handshake_context(get_handshake_context());
 
     resolver_ptr resolver = boost::factory<resolver_ptr>()(session->io_context());
 
@@ -179,9 +292,9 @@ bool TcpManagerImpl::async_create_connection(const std::string & host, const std
 }
 
 template<class SessionType, class SessionPtr>
-void TcpManagerImpl::handle_accept(acceptor_type & acceptor, unsigned short port, SessionPtr session, const boost::system::error_code & error)
+void TcpManagerImpl::handle_accept(acceptor_type & acceptor, unsigned short port, TcpListener * listener, SessionPtr session, const boost::system::error_code & error)
 {
-    start_accept(acceptor, port);
+    start_accept(acceptor, port, listener);
 
     if (error)
     {
@@ -191,6 +304,10 @@ void TcpManagerImpl::handle_accept(acceptor_type & acceptor, unsigned short port
 
     boost::system::error_code ignore_error_code;
     session->socket_lowest().set_option(boost::asio::ip::tcp::socket::keep_alive(true), ignore_error_code);
+    session->set_record_sizing(m_record_small_size, m_record_small_count, m_record_idle);
+    session->set_timestamping(m_timestamp_recv, m_timestamp_send);
+    apply_rate_limit(session, true, port);
+    session->set_handshake_context(get_handshake_context());
     boost::asio::post(session->io_context(), [session]() { session->start(); });
 }
 
@@ -23,16 +23,21 @@ class TcpSendBuffer
 public:
     typedef std::vector<char>                       buffer_type;
     typedef std::deque<buffer_type>                 buffer_deque_type;
-    typedef const buffer_type &                     const_buffers_type;
+    typedef boost::asio::const_buffer               const_buffers_type;
+
+public:
+    TcpSendBuffer();
 
 public:
     bool empty() const;
     void commit(std::vector<char> && data);
-    const_buffers_type data() const;
-    void consume();
+    void coalesce(std::size_t max_size);
+    const_buffers_type data(std::size_t max_size = static_cast<std::size_t>(~0)) const;
+    void consume(std::size_t len);
 
 private:
     buffer_deque_type                               m_buffer_deque;
+    std::size_t                                     m_front_offset;
 };
 
 } // namespace BoostNet end
@@ -0,0 +1,77 @@
+/********************************************************
+ * Description : token bucket for byte rate limits
+ * Data        : 2026-10-20 04:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_TOKEN_BUCKET_H
+#define BOOST_NET_TOKEN_BUCKET_H
+
+
+#include <cstdint>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <memory>
+
+namespace BoostNet { // namespace BoostNet begin
+
+struct RateLimit
+{
+    std::size_t     send_bytes_per_second;
+    std::size_t     recv_bytes_per_second;
+    std::size_t     listener_send_bytes_per_second;
+    std::size_t     listener_recv_bytes_per_second;
+    std::size_t     burst_bytes;
+};
+
+/*
+ * bytes_per_second of credit up to burst_bytes, an operation may start whenever the credit is positive and may overdraw it,
+ * so large writes and datagrams are never stuck and the average rate stays exact,
+ * a bucket may have a parent (the one shared by all connections of a listener) which is charged and checked as well
+ */
+class TokenBucket
+{
+public:
+    typedef std::shared_ptr<TokenBucket>                        bucket_ptr;
+
+public:
+    TokenBucket();
+    ~TokenBucket();
+
+public:
+    TokenBucket(const TokenBucket &) = delete;
+    TokenBucket(TokenBucket &&) = delete;
+    TokenBucket & operator = (const TokenBucket &) = delete;
+    TokenBucket & operator = (TokenBucket &&) = delete;
+
+public:
+    void set_rate(std::size_t bytes_per_second, std::size_t burst_bytes);
+    void set_parent(const bucket_ptr & parent);
+    bool limited() const;
+    std::size_t burst_bytes() const;
+    std::size_t wait_microseconds();
+    void consume(std::size_t bytes);
+
+private:
+    std::size_t self_wait_microseconds();
+    void self_consume(std::size_t bytes);
+    void refill(std::chrono::steady_clock::time_point now);
+
+private:
+    std::mutex                                      m_mutex;
+    std::atomic<std::size_t>                        m_rate;
+    std::atomic<std::size_t>                        m_burst;
+    double                                          m_tokens;
+    std::chrono::steady_clock::time_point           m_time;
+    bucket_ptr                                      m_parent;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_TOKEN_BUCKET_H
@@ -15,9 +15,21 @@
 #include <string>
 #include <vector>
 #include <deque>
-#include <map>
+#include <atomic>
 #include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include "boost_net.h"
+#include "udp_batch.h"
+#include "udp_peer_table.h"
+#include "udp_peer_cookie.h"
+#include "spsc_ring.h"
+#include "udp_datagram.h"
+#include "udp_send_queue.h"
+#include "udp_direct_sender.h"
+#include "udp_fragment.h"
+#include "udp_multicast.h"
+#include "token_bucket.h"
+#include "socket_timestamping.h"
 
 namespace BoostNet { // namespace BoostNet begin
 
@@ -29,14 +41,38 @@ public:
     typedef boost::asio::ip::udp::endpoint                      endpoint_type;
     typedef boost::asio::ip::udp::socket                        socket_type;
     typedef boost::asio::io_context                             io_context_type;
-    typedef std::pair<endpoint_type, std::vector<char>>         endpoint_buffer_type;
-    typedef std::deque<endpoint_buffer_type>                    udp_send_buffer_type;
+    typedef UdpSendQueue                                        udp_send_buffer_type;
     typedef UdpPassiveConnection                                connection_type;
     typedef std::shared_ptr<connection_type>                    udp_connection_ptr;
-    typedef std::map<endpoint_type, udp_connection_ptr>         udp_connection_map;
+    typedef UdpPeerTable                                        udp_connection_map;
+    typedef boost::asio::ip::udp::resolver::results_type        resolver_results_type;
 
 public:
-    UdpAcceptor(io_context_type & io_context, UdpServiceBase * udp_service, const char * host, unsigned short port);
+    enum dispatch_action_type { dispatch_start, dispatch_recv, dispatch_stop };
+
+    struct dispatch_item_type
+    {
+        udp_connection_ptr      connection;
+        UdpDatagram             datagram;
+        dispatch_action_type    action;
+    };
+
+    struct dispatch_worker_type
+    {
+        explicit dispatch_worker_type(io_context_type & context);
+
+        io_context_type               & io_context;
+        SpscRing<dispatch_item_type>    ring;
+        std::atomic<bool>               scheduled;
+        std::deque<dispatch_item_type>  backlog;
+        std::atomic<bool>               backlogged;
+    };
+
+    typedef std::shared_ptr<dispatch_worker_type>               dispatch_worker_ptr;
+    typedef std::vector<dispatch_worker_ptr>                    dispatch_workers_type;
+
+public:
+    UdpAcceptor(io_context_type & io_context, UdpServiceBase * udp_service, const char * host, unsigned short port, std::size_t recv_buffer_size);
     ~UdpAcceptor();
 
 public:
@@ -46,10 +82,27 @@ public:
     UdpAcceptor & operator = (UdpAcceptor &&) = delete;
 
 public:
+    io_context_type & io_context();
     void get_host_address(std::string & ip, unsigned short & port);
     bool start();
     void stop();
-    void send(const endpoint_type & endpoint, const void * data, std::size_t len);
+    void set_segment_offload(std::size_t recv_buffer_size, std::size_t segment_size, bool gro_enable);
+    void set_peer_limit(std::size_t idle_milliseconds, std::size_t max_peer_count, bool evict_when_full);
+    void set_peer_cookie(bool enable, std::size_t max_replies_per_second);
+    void set_cookie_echo(bool enable);
+    void set_peer_dispatch(const std::vector<io_context_type *> & io_contexts, bool enable);
+    void set_datagram_callback(bool enable);
+    void set_send_queue_limit(const UdpSendLimit & limit);
+    void set_direct_send(bool enable);
+    void set_message_fragment(const UdpFragmentOptions & options, bool enable);
+    void set_multicast_group(const boost::asio::ip::address & group_address, const boost::asio::ip::address & interface_address, bool join);
+    void set_multicast_options(const UdpMulticastOptions & options);
+    void set_accept_peer(bool enable);
+    void connect_peer(const resolver_results_type & results, const void * identity);
+    void set_rate_limit(const RateLimit & limit);
+    void set_timestamping(bool recv_enable, bool send_enable);
+    bool send_timestamp(KernelTimestamp & timestamp, std::size_t & send_count) const;
+    void send(const endpoint_type & endpoint, const void * data, std::size_t len, const UdpSendQueue::counter_ptr & counter);
     void close(const endpoint_type & endpoint);
 
 private:
@@ -57,29 +110,67 @@ private:
     void recv();
 
 private:
-    void push_send_data(endpoint_buffer_type endpoint_data);
+    void push_send_data(const endpoint_type & endpoint, std::vector<char> data, const UdpSendQueue::counter_ptr & counter);
+    void wait_send_timestamps();
 
 private:
-    void handle_send(const boost::system::error_code & error, std::size_t bytes_transferred);
-    void handle_recv(const boost::system::error_code & error, std::size_t bytes_transferred);
+    void handle_send(const boost::system::error_code & error);
+    void handle_recv(const boost::system::error_code & error);
     void handle_close(endpoint_type endpoint);
+    void handle_connect_peer(const resolver_results_type & results, const void * identity);
+    void handle_rate_limit(const RateLimit & limit);
+    void handle_rate_wait(const boost::system::error_code & error, bool send_not_recv);
+    void handle_timestamping(bool recv_enable, bool send_enable);
+    void handle_send_timestamps(const boost::system::error_code & error);
     void handle_stop();
+    void handle_peer_limit(std::size_t idle_milliseconds, std::size_t max_peer_count, bool evict_when_full);
+    void handle_expire(const boost::system::error_code & error);
+    void handle_dispatch(dispatch_worker_ptr worker);
+    void flush_dispatch(dispatch_worker_ptr worker);
+
+private:
+    void accept_peer(const endpoint_type & endpoint, const char * data, std::size_t len, uint64_t active_time, uint64_t timestamp);
+    void start_expire_timer();
+    std::size_t select_worker(const endpoint_type & endpoint) const;
+    void dispatch_peer(const udp_connection_ptr & connection, dispatch_action_type action, const char * data, std::size_t len, uint64_t timestamp);
+    static uint64_t current_milliseconds();
 
 private:
-    enum { max_recv_payload = 1500 };
+    enum { max_batch_count = 64, dispatch_ring_size = 4096, dispatch_reserve_size = 512, dispatch_drain_count = 256 };
 
 private:
     io_context_type                               & m_io_context;
     UdpServiceBase                                * m_udp_service;
     bool                                            m_running;
     endpoint_type                                   m_host_endpoint;
-    endpoint_type                                   m_peer_endpoint;
     socket_type                                     m_socket;
     std::string                                     m_host_ip;
     unsigned short                                  m_host_port;
     udp_connection_map                              m_connection_map;
     udp_send_buffer_type                            m_send_buffer;
-    char                                            m_recv_data[max_recv_payload];
+    UdpBatch                                        m_batch;
+    UdpDirectSender                                 m_direct_sender;
+    boost::asio::steady_timer                       m_expire_timer;
+    std::size_t                                     m_idle_milliseconds;
+    std::size_t                                     m_max_peer_count;
+    bool                                            m_evict_when_full;
+    bool                                            m_cookie_enable;
+    bool                                            m_cookie_echo;
+    UdpPeerCookie                                   m_peer_cookie;
+    TokenBucket                                     m_cookie_bucket;
+    dispatch_workers_type                           m_dispatch_workers;
+    bool                                            m_dispatch_enable;
+    bool                                            m_datagram_callback;
+    bool                                            m_fragment_enable;
+    UdpFragmentOptions                              m_fragment_options;
+    bool                                            m_accept_enable;
+    RateLimit                                       m_rate_limit;
+    TokenBucket                                     m_send_bucket;
+    TokenBucket                                     m_recv_bucket;
+    boost::asio::steady_timer                       m_send_timer;
+    boost::asio::steady_timer                       m_recv_timer;
+    SocketTimestamping                              m_timestamping;
+    bool                                            m_timestamp_waiting;
     bool                                            m_good;
 };
 
@@ -15,8 +15,18 @@
 #include <string>
 #include <vector>
 #include <deque>
+#include <atomic>
 #include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include "boost_net.h"
+#include "udp_batch.h"
+#include "udp_datagram.h"
+#include "udp_send_queue.h"
+#include "udp_direct_sender.h"
+#include "udp_fragment.h"
+#include "udp_multicast.h"
+#include "token_bucket.h"
+#include "socket_timestamping.h"
 
 namespace BoostNet { // namespace BoostNet begin
 
@@ -28,12 +38,12 @@ public:
     typedef boost::asio::ip::udp::endpoint                      endpoint_type;
     typedef boost::asio::ip::udp::socket                        socket_type;
     typedef boost::asio::io_context                             io_context_type;
-    typedef std::deque<std::vector<char>>                       udp_recv_buffer_type;
-    typedef std::deque<std::vector<char>>                       udp_send_buffer_type;
+    typedef std::deque<UdpDatagram>                             udp_recv_buffer_type;
+    typedef UdpSendQueue                                        udp_send_buffer_type;
     typedef std::shared_ptr<boost::asio::ip::udp::resolver>     resolver_ptr;
 
 public:
-    UdpActiveConnection(io_context_type & io_context, UdpServiceBase * udp_service, const void * identity);
+    UdpActiveConnection(io_context_type & io_context, UdpServiceBase * udp_service, const void * identity, std::size_t recv_buffer_size);
     virtual ~UdpActiveConnection() override;
 
 public:
@@ -51,7 +61,10 @@ public:
     virtual const void * recv_buffer_data() override;
     virtual std::size_t recv_buffer_size() override;
     virtual bool recv_buffer_drop() override;
+    virtual bool recv_buffer_timestamp(KernelTimestamp & timestamp) override;
     virtual bool send_buffer_fill(const void * data, std::size_t len) override;
+    virtual bool send_timestamp(KernelTimestamp & timestamp, std::size_t & send_count) override;
+    virtual void get_send_statistics(UdpSendStatistics & statistics) override;
 
 public:
     virtual void close() override;
@@ -61,6 +74,16 @@ public:
     io_context_type & io_context();
 
 public:
+    void set_segment_offload(std::size_t recv_buffer_size, std::size_t segment_size, bool gro_enable);
+    void set_datagram_callback(bool enable);
+    void set_cookie_echo(bool enable);
+    void set_send_queue_limit(const UdpSendLimit & limit);
+    void set_direct_send(bool enable);
+    void set_message_fragment(const UdpFragmentOptions & options, bool enable);
+    void set_multicast_options(const UdpMulticastOptions & options);
+    void open_multicast(const endpoint_type & peer_endpoint, boost::system::error_code & error);
+    void set_rate_limit(const RateLimit & limit);
+    void set_timestamping(bool recv_enable, bool send_enable);
     void start();
 
 public:
@@ -68,18 +91,25 @@ public:
     void handle_connect(const boost::system::error_code & error);
 
 private:
+    void connect();
     void send();
     void recv();
     void stop();
     void post_send_data(const void * data, std::size_t len);
     void push_send_data(std::vector<char> data);
+    void wait_send_timestamps();
 
 private:
-    void handle_send(const boost::system::error_code & error, std::size_t bytes_transferred);
-    void handle_recv(const boost::system::error_code & error, std::size_t bytes_transferred);
+    void handle_send(const boost::system::error_code & error);
+    void handle_recv(const boost::system::error_code & error);
+    void handle_rate_wait(const boost::system::error_code & error, bool send_not_recv);
+    void handle_send_timestamps(const boost::system::error_code & error);
 
 private:
-    enum { max_recv_payload = 1500 };
+    bool deliver(const char * data, std::size_t len, uint64_t timestamp);
+
+public:
+    enum { max_batch_count = 16 };
 
 private:
     io_context_type                               & m_io_context;
@@ -95,7 +125,29 @@ private:
     unsigned short                                  m_peer_port;
     udp_recv_buffer_type                            m_recv_buffer;
     udp_send_buffer_type                            m_send_buffer;
-    char                                            m_recv_data[max_recv_payload];
+    UdpSendQueue::counter_ptr                       m_send_counter;
+    UdpDirectSender                                 m_direct_sender;
+    UdpBatch                                        m_batch;
+    std::size_t                                     m_recv_buffer_size;
+    std::size_t                                     m_segment_size;
+    bool                                            m_gro_enable;
+    bool                                            m_datagram_callback;
+    bool                                            m_cookie_echo;
+    bool                                            m_cookie_pending;
+    bool                                            m_direct_send;
+    bool                                            m_fragment_enable;
+    UdpFragmentOptions                              m_fragment_options;
+    std::atomic<uint32_t>                           m_fragment_message_id;
+    UdpReassembler                                  m_reassembler;
+    UdpMulticastOptions                             m_multicast_options;
+    TokenBucket                                     m_send_bucket;
+    TokenBucket                                     m_recv_bucket;
+    boost::asio::steady_timer                       m_send_timer;
+    boost::asio::steady_timer                       m_recv_timer;
+    bool                                            m_timestamp_recv;
+    bool                                            m_timestamp_send;
+    SocketTimestamping                              m_timestamping;
+    uint64_t                                        m_recv_timestamp;
 };
 
 } // namespace BoostNet end
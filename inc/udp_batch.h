@@ -0,0 +1,118 @@
+/********************************************************
+ * Description : udp batch send and receive
+ * Data        : 2026-10-19 23:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_UDP_BATCH_H
+#define BOOST_NET_UDP_BATCH_H
+
+
+#include <cstdint>
+#include <vector>
+#include <boost/asio.hpp>
+#include "socket_timestamping.h"
+
+#if defined(__linux__)
+    #include <sys/socket.h>
+    #include <netinet/udp.h>
+    #define BOOST_NET_UDP_MMSG_SUPPORT
+    #if defined(UDP_SEGMENT) && defined(UDP_GRO)
+        #define BOOST_NET_UDP_OFFLOAD_SUPPORT
+    #endif // defined(UDP_SEGMENT) && defined(UDP_GRO)
+#endif // defined(__linux__)
+
+namespace BoostNet { // namespace BoostNet begin
+
+/*
+ * one call moves up to batch_count datagrams, recvmmsg / sendmmsg on linux, a loop of non-blocking calls elsewhere
+ * nothing blocks, would_block means the socket has to be waited for again
+ * with segment offload a send entry may hold many segment_size datagrams (gso) and a received gro buffer is split back into datagrams
+ * with receive timestamps every datagram keeps the kernel timestamp of the message it came in (0 without)
+ */
+class UdpBatch
+{
+public:
+    typedef boost::asio::ip::udp::endpoint                      endpoint_type;
+    typedef boost::asio::ip::udp::socket                        socket_type;
+
+public:
+    UdpBatch(std::size_t batch_count, std::size_t payload_size);
+    ~UdpBatch();
+
+public:
+    UdpBatch(const UdpBatch &) = delete;
+    UdpBatch(UdpBatch &&) = delete;
+    UdpBatch & operator = (const UdpBatch &) = delete;
+    UdpBatch & operator = (UdpBatch &&) = delete;
+
+public:
+    std::size_t batch_count() const;
+    std::size_t payload_size() const;
+
+public:
+    void set_segment_offload(socket_type & socket, std::size_t recv_buffer_size, std::size_t segment_size, bool gro_enable);
+    std::size_t segment_size() const;
+    std::size_t send_unit_size() const;
+    void set_recv_timestamp(bool enable);
+
+public:
+    std::size_t recv(socket_type & socket, boost::system::error_code & error);
+    const char * recv_data(std::size_t index) const;
+    std::size_t recv_size(std::size_t index) const;
+    const endpoint_type & recv_endpoint(std::size_t index) const;
+    uint64_t recv_timestamp(std::size_t index) const;
+
+public:
+    bool send_push(const void * data, std::size_t len, const endpoint_type * endpoint);
+    std::size_t send(socket_type & socket, boost::system::error_code & error);
+
+private:
+    void resize(std::size_t batch_count, std::size_t payload_size);
+    void push_segments(std::size_t index, std::size_t len, std::size_t segment_size);
+
+private:
+    struct segment_type
+    {
+        std::size_t     offset;
+        std::size_t     size;
+        std::size_t     index;
+    };
+
+private:
+    enum { max_udp_payload = 65507, max_gro_payload = 65535, max_gso_segments = 64 };
+
+private:
+    const std::size_t                               m_max_batch_count;
+    const std::size_t                               m_recv_budget;
+    std::size_t                                     m_batch_count;
+    std::size_t                                     m_payload_size;
+    std::size_t                                     m_segment_size;
+    bool                                            m_gso_enable;
+    bool                                            m_gro_enable;
+    bool                                            m_timestamp_enable;
+    std::vector<char>                               m_recv_data;
+    std::vector<segment_type>                       m_recv_segments;
+    std::vector<endpoint_type>                      m_recv_endpoints;
+    std::vector<uint64_t>                           m_recv_timestamps;
+    std::vector<boost::asio::const_buffer>          m_send_buffers;
+    std::vector<endpoint_type>                      m_send_endpoints;
+    std::vector<bool>                               m_send_connected;
+#ifdef BOOST_NET_UDP_MMSG_SUPPORT
+    std::vector<struct mmsghdr>                     m_recv_headers;
+    std::vector<struct iovec>                       m_recv_iovecs;
+    std::vector<char>                               m_recv_controls;
+    std::vector<struct mmsghdr>                     m_send_headers;
+    std::vector<struct iovec>                       m_send_iovecs;
+    std::vector<char>                               m_send_controls;
+#endif // BOOST_NET_UDP_MMSG_SUPPORT
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_UDP_BATCH_H
@@ -0,0 +1,58 @@
+/********************************************************
+ * Description : pooled udp datagram buffer
+ * Data        : 2026-10-20 01:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_UDP_DATAGRAM_H
+#define BOOST_NET_UDP_DATAGRAM_H
+
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BoostNet { // namespace BoostNet begin
+
+/*
+ * move-only owner of one datagram, the storage comes from a per-thread pool of power of two slabs (256 bytes to 64KB)
+ * and goes back to the pool of whatever thread drops it, the kernel receive timestamp (0 when unknown) travels with it
+ */
+class UdpDatagram
+{
+public:
+    UdpDatagram();
+    UdpDatagram(const void * data, std::size_t len);
+    ~UdpDatagram();
+
+public:
+    UdpDatagram(UdpDatagram && other);
+    UdpDatagram & operator = (UdpDatagram && other);
+
+public:
+    UdpDatagram(const UdpDatagram &) = delete;
+    UdpDatagram & operator = (const UdpDatagram &) = delete;
+
+public:
+    const char * data() const;
+    std::size_t size() const;
+    bool empty() const;
+    void assign(const void * data, std::size_t len);
+    void clear();
+    void set_timestamp(uint64_t timestamp);
+    uint64_t timestamp() const;
+
+private:
+    char                                          * m_data;
+    std::size_t                                     m_size;
+    std::size_t                                     m_capacity;
+    uint64_t                                        m_timestamp;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_UDP_DATAGRAM_H
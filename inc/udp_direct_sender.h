@@ -0,0 +1,58 @@
+/********************************************************
+ * Description : udp direct send from the calling thread
+ * Data        : 2026-10-20 02:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_UDP_DIRECT_SENDER_H
+#define BOOST_NET_UDP_DIRECT_SENDER_H
+
+
+#include <atomic>
+#include <boost/asio.hpp>
+
+namespace BoostNet { // namespace BoostNet begin
+
+/*
+ * lets any thread hand a datagram straight to a non-blocking socket owned by an io thread,
+ * open() and close() run where the socket is opened and closed, close() waits for senders already inside send() so the descriptor is never reused under them
+ * unit_size is the plain segment size, a longer datagram needs splitting or a gso send and is left to the queue
+ * send() returns false when the direct path is not available (closed, or the datagram needs splitting), otherwise error tells how the kernel took it
+ */
+class UdpDirectSender
+{
+public:
+    typedef boost::asio::ip::udp::endpoint                      endpoint_type;
+    typedef boost::asio::ip::udp::socket                        socket_type;
+
+public:
+    UdpDirectSender();
+    ~UdpDirectSender();
+
+public:
+    UdpDirectSender(const UdpDirectSender &) = delete;
+    UdpDirectSender(UdpDirectSender &&) = delete;
+    UdpDirectSender & operator = (const UdpDirectSender &) = delete;
+    UdpDirectSender & operator = (UdpDirectSender &&) = delete;
+
+public:
+    void open(socket_type & socket, std::size_t unit_size);
+    void set_unit_size(std::size_t unit_size);
+    void close();
+    bool send(const void * data, std::size_t len, const endpoint_type * endpoint, boost::system::error_code & error);
+
+private:
+    std::atomic<bool>                               m_opened;
+    std::atomic<std::size_t>                        m_senders;
+    std::atomic<std::size_t>                        m_unit_size;
+    socket_type::native_handle_type                 m_handle;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_UDP_DIRECT_SENDER_H
@@ -0,0 +1,83 @@
+/********************************************************
+ * Description : udp message fragmentation and reassembly
+ * Data        : 2026-10-20 03:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_UDP_FRAGMENT_H
+#define BOOST_NET_UDP_FRAGMENT_H
+
+
+#include <cstdint>
+#include <vector>
+
+namespace BoostNet { // namespace BoostNet begin
+
+struct UdpFragmentOptions
+{
+    std::size_t     mtu;
+    std::size_t     max_message_size;
+    std::size_t     slot_count;
+    std::size_t     timeout_milliseconds;
+};
+
+/*
+ * every datagram starts with a 16 bytes header (message id, message size, fragment offset, fragment index, fragment count),
+ * a fragment is taken only where split() puts it: a full payload at index * (mtu - 16), the remainder in the last one,
+ * a message fitting one datagram is handed back straight from the datagram, longer ones are gathered in one of slot_count slots,
+ * a slot keeps its buffer and bitmap for the next message so the steady state does not allocate,
+ * a new message takes a free slot, else one older than timeout_milliseconds, else the oldest one (its fragments are dropped)
+ */
+class UdpReassembler
+{
+public:
+    UdpReassembler();
+    ~UdpReassembler();
+
+public:
+    UdpReassembler(const UdpReassembler &) = delete;
+    UdpReassembler(UdpReassembler &&) = delete;
+    UdpReassembler & operator = (const UdpReassembler &) = delete;
+    UdpReassembler & operator = (UdpReassembler &&) = delete;
+
+public:
+    bool init(const UdpFragmentOptions & options);
+    bool input(const void * data, std::size_t len, const char *& message, std::size_t & message_len);
+
+public:
+    static bool check_options(const UdpFragmentOptions & options);
+    static void split(const UdpFragmentOptions & options, uint32_t message_id, const void * data, std::size_t len, std::vector<char> & fragment, std::vector<std::size_t> & fragment_ends);
+
+private:
+    struct slot_type
+    {
+        bool                    used;
+        uint32_t                message_id;
+        uint32_t                message_size;
+        uint16_t                fragment_count;
+        uint16_t                received_count;
+        uint64_t                start_time;
+        std::vector<uint64_t>   received;
+        std::vector<char>       buffer;
+    };
+
+private:
+    slot_type & select_slot(uint32_t message_id, uint32_t message_size, uint16_t fragment_count, uint64_t current);
+    static uint64_t current_milliseconds();
+
+private:
+    enum { header_size = 16 };
+
+private:
+    UdpFragmentOptions                              m_options;
+    std::vector<slot_type>                          m_slots;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_UDP_FRAGMENT_H
@@ -15,10 +15,14 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <mutex>
 #include <boost/asio.hpp>
 #include "boost_net.h"
 #include "udp_acceptor.h"
 #include "udp_active_connection.h"
+#include "udp_fragment.h"
+#include "token_bucket.h"
 #include "io_context_pool.h"
 
 namespace BoostNet { // namespace BoostNet begin
@@ -58,16 +62,109 @@ public:
     bool create_connection(const std::string & host, const std::string & service, bool sync_connect = true, const void * identity = 0, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
     bool create_connection(const std::string & host, unsigned short port, bool sync_connect = true, const void * identity = 0, const char * bind_ip = "0.0.0.0", unsigned short bind_port = 0);
 
+public:
+    bool set_segment_offload(std::size_t segment_size, bool gro_enable, std::size_t recv_buffer_size);
+
+public:
+    bool set_peer_limit(std::size_t idle_milliseconds, std::size_t max_peer_count, bool evict_when_full);
+    bool set_peer_cookie(bool enable, std::size_t max_replies_per_second);
+    bool set_peer_dispatch(bool enable);
+
+public:
+    bool set_datagram_callback(bool enable);
+
+public:
+    bool set_send_queue_limit(const UdpSendLimit & limit);
+    bool set_direct_send(bool enable);
+
+public:
+    bool set_message_fragment(const UdpFragmentOptions & options, bool enable);
+
+public:
+    bool set_multicast_group(const char * group_ip, const char * interface_ip, bool join);
+    bool set_multicast_options(std::size_t ttl, bool loopback, const char * interface_ip);
+
+public:
+    bool set_shared_socket(bool enable, std::size_t socket_count);
+
+public:
+    bool set_rate_limit(const RateLimit & limit);
+
+public:
+    bool set_timestamping(bool recv_enable, bool send_enable);
+
 private:
     bool sync_create_connection(const std::string & host, const std::string & service, const void * identity, const char * bind_ip, unsigned short bind_port);
     bool async_create_connection(const std::string & host, const std::string & service, const void * identity, const char * bind_ip, unsigned short bind_port);
+    bool shared_create_connection(const std::string & host, const std::string & service, bool sync_connect, const void * identity);
+    void get_shared_acceptors(std::vector<udp_acceptor_ptr> & udp_acceptors);
+    template<class ConnectionPtr> void configure_connection(ConnectionPtr connection, bool shared);
+
+private:
+    static RateLimit shared_rate_limit(const RateLimit & limit);
+    static void stop_acceptors(std::vector<udp_acceptor_ptr> & udp_acceptors);
 
 private:
     io_context_pool_type                            m_io_context_pool;
     UdpServiceBase                                * m_udp_service;
     std::vector<unsigned short>                     m_udp_ports;
+    std::vector<udp_acceptor_ptr>                   m_udp_acceptors;
+    std::mutex                                      m_shared_mutex;
+    std::vector<udp_acceptor_ptr>                   m_shared_acceptors;
+    std::atomic<std::size_t>                        m_shared_index;
+    std::atomic<bool>                               m_shared_socket;
+    std::atomic<std::size_t>                        m_recv_buffer_size;
+    std::atomic<std::size_t>                        m_segment_size;
+    std::atomic<bool>                               m_gro_enable;
+    std::atomic<bool>                               m_datagram_callback;
+    std::atomic<bool>                               m_cookie_echo;
+    std::mutex                                      m_send_limit_mutex;
+    UdpSendLimit                                    m_send_limit;
+    std::atomic<bool>                               m_direct_send;
+    std::mutex                                      m_fragment_mutex;
+    UdpFragmentOptions                              m_fragment_options;
+    bool                                            m_fragment_enable;
+    std::mutex                                      m_multicast_mutex;
+    UdpMulticastOptions                             m_multicast_options;
+    std::mutex                                      m_rate_limit_mutex;
+    RateLimit                                       m_rate_limit;
+    std::atomic<bool>                               m_timestamp_recv;
+    std::atomic<bool>                               m_timestamp_send;
 };
 
+/* the current settings for a created connection or a shared socket, shared sockets leave the listener rates out */
+template<class ConnectionPtr>
+void UdpManagerImpl::configure_connection(ConnectionPtr connection, bool shared)
+{
+    if (0 != m_segment_size || m_gro_enable)
+    {
+        connection->set_segment_offload(m_recv_buffer_size, m_segment_size, m_gro_enable);
+    }
+    connection->set_datagram_callback(m_datagram_callback);
+    connection->set_cookie_echo(m_cookie_echo);
+    {
+        std::lock_guard<std::mutex> locker(m_send_limit_mutex);
+        connection->set_send_queue_limit(m_send_limit);
+    }
+    connection->set_direct_send(m_direct_send);
+    {
+        std::lock_guard<std::mutex> locker(m_fragment_mutex);
+        connection->set_message_fragment(m_fragment_options, m_fragment_enable);
+    }
+    {
+        std::lock_guard<std::mutex> locker(m_multicast_mutex);
+        connection->set_multicast_options(m_multicast_options);
+    }
+    {
+        std::lock_guard<std::mutex> locker(m_rate_limit_mutex);
+        connection->set_rate_limit(shared ? shared_rate_limit(m_rate_limit) : m_rate_limit);
+    }
+    if (m_timestamp_recv || m_timestamp_send)
+    {
+        connection->set_timestamping(m_timestamp_recv, m_timestamp_send);
+    }
+}
+
 } // namespace BoostNet end
 
 
@@ -0,0 +1,33 @@
+/********************************************************
+ * Description : udp multicast send options
+ * Data        : 2026-10-20 06:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_UDP_MULTICAST_H
+#define BOOST_NET_UDP_MULTICAST_H
+
+
+#include <cstddef>
+#include <boost/asio.hpp>
+
+namespace BoostNet { // namespace BoostNet begin
+
+struct UdpMulticastOptions
+{
+    std::size_t                     ttl;
+    bool                            loopback;
+    boost::asio::ip::address        interface_address;
+};
+
+/* hop limit, loopback and outbound interface of group sends, the interface is only set on ipv4 sockets */
+void apply_multicast_options(boost::asio::ip::udp::socket & socket, const UdpMulticastOptions & options, boost::system::error_code & error);
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_UDP_MULTICAST_H
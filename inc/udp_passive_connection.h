@@ -15,8 +15,13 @@
 #include <string>
 #include <vector>
 #include <deque>
+#include <atomic>
 #include <boost/asio.hpp>
 #include "boost_net.h"
+#include "udp_datagram.h"
+#include "udp_send_queue.h"
+#include "udp_fragment.h"
+#include "token_bucket.h"
 
 namespace BoostNet { // namespace BoostNet begin
 
@@ -26,10 +31,10 @@ class UdpPassiveConnection : public UdpConnectionBase, public std::enable_shared
 {
 public:
     typedef boost::asio::ip::udp::endpoint                      endpoint_type;
-    typedef std::deque<std::vector<char>>                       udp_recv_buffer_type;
+    typedef std::deque<UdpDatagram>                             udp_recv_buffer_type;
 
 public:
-    UdpPassiveConnection(UdpAcceptor & acceptor, UdpServiceBase * udp_service, unsigned short host_port, endpoint_type endpoint);
+    UdpPassiveConnection(UdpAcceptor & acceptor, UdpServiceBase * udp_service, unsigned short host_port, endpoint_type endpoint, std::size_t worker_index, bool datagram_callback);
     virtual ~UdpPassiveConnection() override;
 
 public:
@@ -47,16 +52,32 @@ public:
     virtual const void * recv_buffer_data() override;
     virtual std::size_t recv_buffer_size() override;
     virtual bool recv_buffer_drop() override;
+    virtual bool recv_buffer_timestamp(KernelTimestamp & timestamp) override;
     virtual bool send_buffer_fill(const void * data, std::size_t len) override;
+    virtual bool send_timestamp(KernelTimestamp & timestamp, std::size_t & send_count) override;
+    virtual void get_send_statistics(UdpSendStatistics & statistics) override;
 
 public:
     virtual void close() override;
 
 public:
+    void set_message_fragment(const UdpFragmentOptions & options, bool enable);
+    void set_outbound(const void * identity);
+    void set_rate_limit(const RateLimit & limit);
+    bool outbound() const;
+    bool take_cookie_pending();
     void start();
     void stop();
     void send(const void * data, std::size_t len);
-    void recv(const void * data, std::size_t len);
+    void recv(const void * data, std::size_t len, uint64_t timestamp);
+    void recv(UdpDatagram datagram);
+    void recv_dropped();
+    std::size_t worker_index() const;
+
+private:
+    bool rate_allowed(TokenBucket & bucket, std::size_t len);
+    void deliver(const char * data, std::size_t len, uint64_t timestamp);
+    void deliver(UdpDatagram datagram);
 
 private:
     UdpAcceptor                                   & m_acceptor;
@@ -64,9 +85,23 @@ private:
     bool                                            m_running;
     unsigned short                                  m_host_port;
     endpoint_type                                   m_endpoint;
+    const std::size_t                               m_worker_index;
+    const bool                                      m_datagram_callback;
+    bool                                            m_outbound;
+    bool                                            m_cookie_pending;
+    const void                                    * m_identity;
     std::string                                     m_peer_ip;
     unsigned short                                  m_peer_port;
     udp_recv_buffer_type                            m_recv_buffer;
+    UdpSendQueue::counter_ptr                       m_send_counter;
+    bool                                            m_fragment_enable;
+    UdpFragmentOptions                              m_fragment_options;
+    std::atomic<uint32_t>                           m_fragment_message_id;
+    UdpReassembler                                  m_reassembler;
+    TokenBucket                                     m_send_bucket;
+    TokenBucket                                     m_recv_bucket;
+    std::atomic<std::size_t>                        m_recv_dropped_count;
+    uint64_t                                        m_recv_timestamp;
 };
 
 } // namespace BoostNet end
@@ -0,0 +1,63 @@
+/********************************************************
+ * Description : udp peer cookie
+ * Data        : 2026-10-20 00:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_UDP_PEER_COOKIE_H
+#define BOOST_NET_UDP_PEER_COOKIE_H
+
+
+#include <cstdint>
+#include <boost/asio.hpp>
+
+namespace BoostNet { // namespace BoostNet begin
+
+/*
+ * magic (8 bytes) + time slot (8 bytes) + hmac-sha256(secret, address, port, time slot) truncated to 16 bytes,
+ * nothing is kept per peer, a cookie is accepted during its own time slot and the next one
+ */
+class UdpPeerCookie
+{
+public:
+    typedef boost::asio::ip::udp::endpoint                      endpoint_type;
+
+public:
+    enum { cookie_size = 32, slot_seconds = 30 };
+
+public:
+    UdpPeerCookie();
+    ~UdpPeerCookie();
+
+public:
+    UdpPeerCookie(const UdpPeerCookie &) = delete;
+    UdpPeerCookie(UdpPeerCookie &&) = delete;
+    UdpPeerCookie & operator = (const UdpPeerCookie &) = delete;
+    UdpPeerCookie & operator = (UdpPeerCookie &&) = delete;
+
+public:
+    bool init();
+    void make(const endpoint_type & endpoint, unsigned char cookie[cookie_size]) const;
+    bool verify(const endpoint_type & endpoint, const void * data, std::size_t len) const;
+
+public:
+    static bool is_cookie(const void * data, std::size_t len);
+
+private:
+    void sign(const endpoint_type & endpoint, uint64_t time_slot, unsigned char cookie[cookie_size]) const;
+
+private:
+    static uint64_t current_time_slot();
+
+private:
+    unsigned char                                   m_secret[32];
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_UDP_PEER_COOKIE_H
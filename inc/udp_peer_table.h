@@ -0,0 +1,99 @@
+/********************************************************
+ * Description : udp peer table
+ * Data        : 2026-10-19 23:30:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_UDP_PEER_TABLE_H
+#define BOOST_NET_UDP_PEER_TABLE_H
+
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <boost/asio.hpp>
+
+namespace BoostNet { // namespace BoostNet begin
+
+class UdpPassiveConnection;
+
+/*
+ * open addressing (linear probing, backward shift erase) keyed by the raw sockaddr packed into three integers,
+ * every slot keeps its hash so probing and growing never unpack an endpoint again, the last hit slot is tried first
+ * find() stamps the slot with the caller's time, evict() drops the stalest of a few slots after the clock hand (sampled lru)
+ */
+class UdpPeerTable
+{
+public:
+    typedef boost::asio::ip::udp::endpoint                      endpoint_type;
+    typedef std::shared_ptr<UdpPassiveConnection>               connection_ptr;
+    typedef std::vector<connection_ptr>                         connection_array;
+
+public:
+    UdpPeerTable();
+    ~UdpPeerTable();
+
+public:
+    UdpPeerTable(const UdpPeerTable &) = delete;
+    UdpPeerTable(UdpPeerTable &&) = delete;
+    UdpPeerTable & operator = (const UdpPeerTable &) = delete;
+    UdpPeerTable & operator = (UdpPeerTable &&) = delete;
+
+public:
+    std::size_t size() const;
+    const connection_ptr * find(const endpoint_type & endpoint, uint64_t active_time);
+    bool insert(const endpoint_type & endpoint, connection_ptr connection, uint64_t active_time);
+    bool erase(const endpoint_type & endpoint);
+    bool evict(connection_ptr & connection);
+    void expire(uint64_t active_time, connection_array & connections);
+    void get_connections(connection_array & connections) const;
+    void clear();
+
+public:
+    static uint64_t hash_endpoint(const endpoint_type & endpoint);
+
+private:
+    struct key_type
+    {
+        uint64_t        high;
+        uint64_t        low;
+        uint64_t        extra;
+    };
+
+    struct slot_type
+    {
+        key_type        key;
+        uint64_t        hash;
+        uint64_t        active_time;
+        connection_ptr  connection;
+    };
+
+private:
+    static void pack_key(const endpoint_type & endpoint, key_type & key);
+    static uint64_t hash_key(const key_type & key);
+    static bool equal_key(const key_type & lhs, const key_type & rhs);
+
+private:
+    std::size_t find_slot(const key_type & key, uint64_t hash) const;
+    void rehash(std::size_t slot_count);
+    void erase_slot(std::size_t hole);
+
+private:
+    enum { evict_sample_count = 8 };
+
+private:
+    std::vector<slot_type>                          m_slots;
+    std::size_t                                     m_mask;
+    std::size_t                                     m_size;
+    std::size_t                                     m_last_slot;
+    std::size_t                                     m_evict_hand;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_UDP_PEER_TABLE_H
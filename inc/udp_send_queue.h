@@ -0,0 +1,112 @@
+/********************************************************
+ * Description : bounded udp send queue
+ * Data        : 2026-10-20 01:30:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#ifndef BOOST_NET_UDP_SEND_QUEUE_H
+#define BOOST_NET_UDP_SEND_QUEUE_H
+
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <boost/asio.hpp>
+#include "boost_net.h"
+#include "udp_batch.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+struct UdpSendLimit
+{
+    std::size_t     max_packets;
+    std::size_t     max_bytes;
+    std::size_t     max_peer_packets;
+    std::size_t     max_peer_bytes;
+    UdpDropPolicy   drop_policy;
+    std::size_t     max_age_milliseconds;
+};
+
+/*
+ * totals are read by any thread, queue_bytes belongs to the thread owning the socket,
+ * posted_count (datagrams handed to that thread but not queued yet) and queue_packets tell other threads whether a direct send would overtake queued datagrams
+ */
+struct UdpSendCounter
+{
+    UdpSendCounter();
+
+    bool send_idle() const;
+
+    std::atomic<std::size_t>    queued_count;
+    std::atomic<std::size_t>    sent_count;
+    std::atomic<std::size_t>    dropped_count;
+    std::atomic<std::size_t>    error_count;
+    std::atomic<std::size_t>    posted_count;
+    std::atomic<std::size_t>    queue_packets;
+    std::size_t                 queue_bytes;
+};
+
+/*
+ * fifo of datagrams waiting for one socket, every datagram carries the counter of the peer it belongs to,
+ * 0 means unlimited, over a limit drop_newest refuses the datagram, drop_oldest makes room by dropping the oldest ones (of the peer for a peer limit),
+ * drop_expired refuses like drop_newest and also drops datagrams that waited longer than max_age_milliseconds before they are sent
+ */
+class UdpSendQueue
+{
+public:
+    typedef boost::asio::ip::udp::endpoint                      endpoint_type;
+    typedef std::shared_ptr<UdpSendCounter>                     counter_ptr;
+
+public:
+    UdpSendQueue();
+    ~UdpSendQueue();
+
+public:
+    UdpSendQueue(const UdpSendQueue &) = delete;
+    UdpSendQueue(UdpSendQueue &&) = delete;
+    UdpSendQueue & operator = (const UdpSendQueue &) = delete;
+    UdpSendQueue & operator = (UdpSendQueue &&) = delete;
+
+public:
+    void set_limit(const UdpSendLimit & limit);
+    bool empty() const;
+    bool push(const endpoint_type * endpoint, std::vector<char> data, const counter_ptr & counter);
+    std::size_t fill(UdpBatch & batch);
+    std::size_t pop_sent(std::size_t count);
+    void pop_error();
+    void clear();
+
+private:
+    struct entry_type
+    {
+        endpoint_type       endpoint;
+        bool                connected;
+        std::vector<char>   data;
+        counter_ptr         counter;
+        uint64_t            enqueue_time;
+    };
+
+    typedef std::deque<entry_type>                              entries_type;
+
+private:
+    void erase(entries_type::iterator iter);
+    void drop_expired();
+    bool make_room(std::size_t len, const counter_ptr & counter);
+    static uint64_t current_milliseconds();
+
+private:
+    entries_type                                    m_entries;
+    std::size_t                                     m_bytes;
+    UdpSendLimit                                    m_limit;
+};
+
+} // namespace BoostNet end
+
+
+#endif // BOOST_NET_UDP_SEND_QUEUE_H
@@ -70,6 +70,11 @@ IOServicePool::io_context_type & IOServicePool::get()
     return m_io_contexts[m_next_io_context++ % m_io_contexts.size()];
 }
 
+IOServicePool::io_context_type & IOServicePool::get(std::size_t index)
+{
+    return m_io_contexts[index % m_io_contexts.size()];
+}
+
 std::size_t IOServicePool::size()
 {
     return m_io_contexts.size();
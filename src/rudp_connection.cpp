@@ -0,0 +1,184 @@
+/********************************************************
+ * Description : reliable udp connection
+ * Data        : 2026-10-20 02:30:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <chrono>
+#include "rudp_connection.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+RudpConnection::RudpConnection(UdpConnectionSharedPtr udp_connection, UdpServiceBase * udp_service)
+    : m_udp_connection(udp_connection)
+    , m_udp_service(udp_service)
+    , m_mutex()
+    , m_session()
+    , m_send_pending(false)
+    , m_dead_reported(false)
+{
+
+}
+
+RudpConnection::~RudpConnection()
+{
+
+}
+
+uint32_t RudpConnection::current_milliseconds()
+{
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool RudpConnection::init(const RudpOptions & options)
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return m_session.init(options);
+}
+
+void RudpConnection::get_host_address(std::string & ip, unsigned short & port)
+{
+    m_udp_connection->get_host_address(ip, port);
+}
+
+void RudpConnection::get_peer_address(std::string & ip, unsigned short & port)
+{
+    m_udp_connection->get_peer_address(ip, port);
+}
+
+bool RudpConnection::recv_buffer_has_data()
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return m_session.has_message();
+}
+
+const void * RudpConnection::recv_buffer_data()
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return m_session.has_message() ? m_session.front_message().data() : nullptr;
+}
+
+std::size_t RudpConnection::recv_buffer_size()
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return m_session.has_message() ? m_session.front_message().size() : 0;
+}
+
+bool RudpConnection::recv_buffer_drop()
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return m_session.pop_message();
+}
+
+bool RudpConnection::recv_buffer_timestamp(KernelTimestamp & timestamp)
+{
+    return m_udp_connection->recv_buffer_timestamp(timestamp);
+}
+
+bool RudpConnection::send_buffer_fill(const void * data, std::size_t len)
+{
+    RudpSession::buffer_array datagrams;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        if (!m_session.send(data, len))
+        {
+            return false;
+        }
+        m_send_pending = true;
+        m_session.flush(current_milliseconds(), datagrams);
+    }
+    output(datagrams);
+    return true;
+}
+
+bool RudpConnection::send_timestamp(KernelTimestamp & timestamp, std::size_t & send_count)
+{
+    return m_udp_connection->send_timestamp(timestamp, send_count);
+}
+
+void RudpConnection::get_send_statistics(UdpSendStatistics & statistics)
+{
+    m_udp_connection->get_send_statistics(statistics);
+}
+
+void RudpConnection::close()
+{
+    m_udp_connection->close();
+}
+
+void RudpConnection::input(const void * data, std::size_t len)
+{
+    RudpSession::buffer_array datagrams;
+    bool has_message = false;
+    bool send_complete = false;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        if (!m_session.input(data, len, current_milliseconds()))
+        {
+            return;
+        }
+        m_session.flush(current_milliseconds(), datagrams);
+        has_message = m_session.has_message();
+        send_complete = m_send_pending && m_session.idle();
+        if (send_complete)
+        {
+            m_send_pending = false;
+        }
+    }
+
+    output(datagrams);
+
+    if (nullptr != m_udp_service)
+    {
+        if (has_message && !m_udp_service->on_recv(shared_from_this()))
+        {
+            close();
+            return;
+        }
+        if (send_complete && !m_udp_service->on_send(shared_from_this()))
+        {
+            close();
+            return;
+        }
+    }
+}
+
+void RudpConnection::update()
+{
+    RudpSession::buffer_array datagrams;
+    bool dead = false;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_session.flush(current_milliseconds(), datagrams);
+        dead = m_session.dead() && !m_dead_reported;
+        if (dead)
+        {
+            m_dead_reported = true;
+        }
+    }
+
+    output(datagrams);
+
+    if (dead)
+    {
+        if (nullptr != m_udp_service)
+        {
+            m_udp_service->on_error(shared_from_this(), "connection", "retransmit", 1, "peer does not acknowledge");
+        }
+        close();
+    }
+}
+
+void RudpConnection::output(const RudpSession::buffer_array & datagrams)
+{
+    for (RudpSession::buffer_array::const_iterator iter = datagrams.begin(); datagrams.end() != iter; ++iter)
+    {
+        m_udp_connection->send_buffer_fill(iter->data(), iter->size());
+    }
+}
+
+} // namespace BoostNet end
@@ -0,0 +1,105 @@
+/********************************************************
+ * Description : reliable udp manager class
+ * Data        : 2026-10-20 02:30:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <boost/functional/factory.hpp>
+#include <boost/checked_delete.hpp>
+#include "rudp_manager_impl.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+RudpManager::RudpManager()
+    : m_manager_impl(nullptr)
+{
+
+}
+
+RudpManager::~RudpManager()
+{
+    exit();
+}
+
+bool RudpManager::init(UdpServiceBase * udp_service, std::size_t thread_count, const char * host, unsigned short * port_array, std::size_t port_count, bool port_any_valid)
+{
+    if (nullptr == udp_service)
+    {
+        return false;
+    }
+
+    if (nullptr != m_manager_impl)
+    {
+        return false;
+    }
+
+    m_manager_impl = boost::factory<RudpManagerImpl *>()();
+    if (nullptr == m_manager_impl)
+    {
+        return false;
+    }
+
+    if (m_manager_impl->init(udp_service, thread_count, host, port_array, port_count, port_any_valid))
+    {
+        return true;
+    }
+
+    boost::checked_delete(m_manager_impl);
+    m_manager_impl = nullptr;
+
+    return false;
+}
+
+void RudpManager::exit()
+{
+    if (nullptr != m_manager_impl)
+    {
+        m_manager_impl->exit();
+        boost::checked_delete(m_manager_impl);
+        m_manager_impl = nullptr;
+    }
+}
+
+void RudpManager::get_ports(std::vector<unsigned short> & ports)
+{
+    if (nullptr != m_manager_impl)
+    {
+        m_manager_impl->get_ports(ports);
+    }
+}
+
+bool RudpManager::create_connection(const std::string & host, const std::string & service, bool sync_connect, const void * identity, const char * bind_ip, unsigned short bind_port)
+{
+    return nullptr != m_manager_impl && m_manager_impl->create_connection(host, service, sync_connect, identity, bind_ip, bind_port);
+}
+
+bool RudpManager::create_connection(const std::string & host, unsigned short port, bool sync_connect, const void * identity, const char * bind_ip, unsigned short bind_port)
+{
+    return nullptr != m_manager_impl && m_manager_impl->create_connection(host, port, sync_connect, identity, bind_ip, bind_port);
+}
+
+bool RudpManager::set_reliable_options(bool ordered, std::size_t window_size, std::size_t interval_milliseconds, std::size_t fast_resend, std::size_t min_rto_milliseconds, bool congestion_control, bool pacing, std::size_t mtu, std::size_t dead_link)
+{
+    RudpOptions options;
+    options.ordered = ordered;
+    options.window_size = window_size;
+    options.interval_milliseconds = interval_milliseconds;
+    options.fast_resend = fast_resend;
+    options.min_rto_milliseconds = min_rto_milliseconds;
+    options.congestion_control = congestion_control;
+    options.pacing = pacing;
+    options.mtu = mtu;
+    options.dead_link = dead_link;
+    return nullptr != m_manager_impl && m_manager_impl->set_reliable_options(options);
+}
+
+bool RudpManager::set_timestamping(bool recv_enable, bool send_enable)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_timestamping(recv_enable, send_enable);
+}
+
+} // namespace BoostNet end
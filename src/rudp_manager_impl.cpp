@@ -0,0 +1,247 @@
+/********************************************************
+ * Description : reliable udp manager implement
+ * Data        : 2026-10-20 02:30:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <chrono>
+#include <boost/functional/factory.hpp>
+#include "rudp_manager_impl.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+RudpManagerImpl::RudpManagerImpl()
+    : m_udp_manager()
+    , m_udp_service(nullptr)
+    , m_timer_pool()
+    , m_timer()
+    , m_mutex()
+    , m_options()
+    , m_connections()
+{
+    m_options.ordered = true;
+    m_options.window_size = 256;
+    m_options.interval_milliseconds = 10;
+    m_options.fast_resend = 2;
+    m_options.min_rto_milliseconds = 30;
+    m_options.congestion_control = true;
+    m_options.pacing = true;
+    m_options.mtu = 1400;
+    m_options.dead_link = 20;
+}
+
+RudpManagerImpl::~RudpManagerImpl()
+{
+
+}
+
+bool RudpManagerImpl::init(UdpServiceBase * udp_service, std::size_t thread_count, const char * host, unsigned short port_array[], std::size_t port_count, bool port_any_valid)
+{
+    if (nullptr == udp_service)
+    {
+        return false;
+    }
+
+    if (m_timer_pool.size() > 0)
+    {
+        return false;
+    }
+
+    m_udp_service = udp_service;
+
+    if (!m_udp_manager.init(this, thread_count, host, port_array, port_count, port_any_valid))
+    {
+        m_udp_service = nullptr;
+        return false;
+    }
+
+    m_udp_manager.set_datagram_callback(true);
+
+    if (!m_timer_pool.init(1))
+    {
+        m_udp_manager.exit();
+        m_udp_service = nullptr;
+        return false;
+    }
+
+    m_timer = boost::factory<timer_ptr>()(m_timer_pool.get());
+    start_timer();
+
+    return true;
+}
+
+void RudpManagerImpl::exit()
+{
+    m_timer_pool.exit();
+    m_timer_pool.run(true);
+    m_timer.reset();
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connections.clear();
+    }
+    m_udp_manager.exit();
+    m_udp_service = nullptr;
+}
+
+void RudpManagerImpl::get_ports(std::vector<unsigned short> & ports)
+{
+    m_udp_manager.get_ports(ports);
+}
+
+bool RudpManagerImpl::create_connection(const std::string & host, const std::string & service, bool sync_connect, const void * identity, const char * bind_ip, unsigned short bind_port)
+{
+    return m_udp_manager.create_connection(host, service, sync_connect, identity, bind_ip, bind_port);
+}
+
+bool RudpManagerImpl::create_connection(const std::string & host, unsigned short port, bool sync_connect, const void * identity, const char * bind_ip, unsigned short bind_port)
+{
+    return m_udp_manager.create_connection(host, port, sync_connect, identity, bind_ip, bind_port);
+}
+
+bool RudpManagerImpl::set_reliable_options(const RudpOptions & options)
+{
+    RudpSession session;
+    if (!session.init(options))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_options = options;
+
+    return true;
+}
+
+bool RudpManagerImpl::set_timestamping(bool recv_enable, bool send_enable)
+{
+    return m_udp_manager.set_timestamping(recv_enable, send_enable);
+}
+
+RudpManagerImpl::rudp_connection_ptr RudpManagerImpl::create_rudp_connection(UdpConnectionSharedPtr connection)
+{
+    rudp_connection_ptr rudp_connection = boost::factory<rudp_connection_ptr>()(connection, m_udp_service);
+
+    std::lock_guard<std::mutex> locker(m_mutex);
+    rudp_connection->init(m_options);
+    m_connections[connection.get()] = rudp_connection;
+
+    return rudp_connection;
+}
+
+RudpManagerImpl::rudp_connection_ptr RudpManagerImpl::find_rudp_connection(UdpConnectionSharedPtr connection)
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    rudp_connection_map::iterator iter = m_connections.find(connection.get());
+    return m_connections.end() != iter ? iter->second : rudp_connection_ptr();
+}
+
+bool RudpManagerImpl::on_connect(UdpConnectionSharedPtr connection, const void * identity)
+{
+    if (!connection)
+    {
+        return m_udp_service->on_connect(UdpConnectionSharedPtr(), identity);
+    }
+    return m_udp_service->on_connect(create_rudp_connection(connection), identity);
+}
+
+bool RudpManagerImpl::on_accept(UdpConnectionSharedPtr connection, unsigned short listener_port)
+{
+    return m_udp_service->on_accept(create_rudp_connection(connection), listener_port);
+}
+
+bool RudpManagerImpl::on_recv(UdpConnectionSharedPtr connection)
+{
+    rudp_connection_ptr rudp_connection = find_rudp_connection(connection);
+    while (connection->recv_buffer_has_data())
+    {
+        if (rudp_connection)
+        {
+            rudp_connection->input(connection->recv_buffer_data(), connection->recv_buffer_size());
+        }
+        connection->recv_buffer_drop();
+    }
+    return true;
+}
+
+bool RudpManagerImpl::on_send(UdpConnectionSharedPtr connection)
+{
+    return true;
+}
+
+void RudpManagerImpl::on_close(UdpConnectionSharedPtr connection)
+{
+    rudp_connection_ptr rudp_connection;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        rudp_connection_map::iterator iter = m_connections.find(connection.get());
+        if (m_connections.end() == iter)
+        {
+            return;
+        }
+        rudp_connection = iter->second;
+        m_connections.erase(iter);
+    }
+    m_udp_service->on_close(rudp_connection);
+}
+
+void RudpManagerImpl::on_error(UdpConnectionSharedPtr connection, const char * operater, const char * action, int error, const char * message)
+{
+    m_udp_service->on_error(connection ? find_rudp_connection(connection) : UdpConnectionSharedPtr(), operater, action, error, message);
+}
+
+bool RudpManagerImpl::on_datagram(UdpConnectionSharedPtr connection, const void * data, std::size_t len)
+{
+    rudp_connection_ptr rudp_connection = find_rudp_connection(connection);
+    if (rudp_connection)
+    {
+        rudp_connection->input(data, len);
+    }
+    return true;
+}
+
+void RudpManagerImpl::start_timer()
+{
+    std::size_t interval_milliseconds = 0;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        interval_milliseconds = m_options.interval_milliseconds;
+    }
+
+    m_timer->expires_after(std::chrono::milliseconds(interval_milliseconds));
+    m_timer->async_wait(
+        [this](const boost::system::error_code & error) {
+            handle_timer(error);
+        }
+    );
+}
+
+void RudpManagerImpl::handle_timer(const boost::system::error_code & error)
+{
+    if (error)
+    {
+        return;
+    }
+
+    std::vector<rudp_connection_ptr> connections;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        connections.reserve(m_connections.size());
+        for (rudp_connection_map::iterator iter = m_connections.begin(); m_connections.end() != iter; ++iter)
+        {
+            connections.push_back(iter->second);
+        }
+    }
+
+    for (std::vector<rudp_connection_ptr>::iterator iter = connections.begin(); connections.end() != iter; ++iter)
+    {
+        (*iter)->update();
+    }
+
+    start_timer();
+}
+
+} // namespace BoostNet end
@@ -0,0 +1,683 @@
+/********************************************************
+ * Description : reliable udp session (arq state machine)
+ * Data        : 2026-10-20 02:30:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <cstring>
+#include <algorithm>
+#include "rudp_session.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+static inline int32_t sequence_diff(uint32_t lhs, uint32_t rhs)
+{
+    return static_cast<int32_t>(lhs - rhs);
+}
+
+static inline void encode_u16(char * buffer, uint16_t value)
+{
+    buffer[0] = static_cast<char>(value & 0xff);
+    buffer[1] = static_cast<char>((value >> 8) & 0xff);
+}
+
+static inline void encode_u32(char * buffer, uint32_t value)
+{
+    encode_u16(buffer, static_cast<uint16_t>(value & 0xffff));
+    encode_u16(buffer + 2, static_cast<uint16_t>((value >> 16) & 0xffff));
+}
+
+static inline uint16_t decode_u16(const char * buffer)
+{
+    const unsigned char * bytes = reinterpret_cast<const unsigned char *>(buffer);
+    return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+static inline uint32_t decode_u32(const char * buffer)
+{
+    return static_cast<uint32_t>(decode_u16(buffer)) | (static_cast<uint32_t>(decode_u16(buffer + 2)) << 16);
+}
+
+RudpSession::RudpSession()
+    : m_options()
+    , m_mss(0)
+    , m_snd_una(0)
+    , m_snd_nxt(0)
+    , m_rcv_nxt(0)
+    , m_rcv_base(0)
+    , m_rmt_wnd(0)
+    , m_srtt(0)
+    , m_rttvar(0)
+    , m_rto(0)
+    , m_cwnd(0)
+    , m_cwnd_acked(0)
+    , m_ssthresh(0)
+    , m_recover(0)
+    , m_loss_timeout(false)
+    , m_loss_fast(false)
+    , m_pacing_budget(0.0)
+    , m_pacing_ts(0)
+    , m_ack_pending(false)
+    , m_ack_ts(0)
+    , m_dead(false)
+    , m_snd_queue()
+    , m_snd_buf()
+    , m_rcv_buf()
+    , m_rcv_mask(0)
+    , m_rcv_queue()
+{
+
+}
+
+RudpSession::~RudpSession()
+{
+
+}
+
+bool RudpSession::init(const RudpOptions & options)
+{
+    if (options.mtu < header_size + 8 * 4 || options.mtu > 65507)
+    {
+        return false;
+    }
+
+    if (0 == options.window_size || options.window_size > 32768 || 0 == options.interval_milliseconds || 0 == options.dead_link)
+    {
+        return false;
+    }
+
+    m_options = options;
+    m_mss = options.mtu - header_size;
+    m_rmt_wnd = static_cast<uint32_t>(options.window_size);
+    m_rto = std::max<uint32_t>(200, static_cast<uint32_t>(options.min_rto_milliseconds));
+    m_cwnd = (options.congestion_control ? 2 : static_cast<uint32_t>(options.window_size));
+    m_ssthresh = static_cast<uint32_t>(options.window_size);
+
+    std::size_t slot_count = 2;
+    while (slot_count < options.window_size)
+    {
+        slot_count <<= 1;
+    }
+    m_rcv_buf.assign(slot_count, recv_segment_type());
+    m_rcv_mask = static_cast<uint32_t>(slot_count - 1);
+
+    return true;
+}
+
+bool RudpSession::send(const void * data, std::size_t len)
+{
+    if (nullptr == data && 0 != len)
+    {
+        return false;
+    }
+
+    std::size_t count = (0 == len ? 1 : (len + m_mss - 1) / m_mss);
+    if (count > m_options.window_size)
+    {
+        return false;
+    }
+
+    const char * bytes = reinterpret_cast<const char *>(data);
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        std::size_t offset = index * m_mss;
+        std::size_t size = std::min<std::size_t>(m_mss, len - offset);
+        send_segment_type segment;
+        segment.sn = 0;
+        segment.count = static_cast<uint16_t>(count);
+        segment.frg = static_cast<uint16_t>(count - 1 - index);
+        segment.flags = (m_options.ordered ? 0 : flag_unordered);
+        segment.acked = false;
+        segment.ts = 0;
+        segment.resend_ts = 0;
+        segment.rto = 0;
+        segment.fastack = 0;
+        segment.xmit = 0;
+        if (0 != size)
+        {
+            segment.data.assign(bytes + offset, bytes + offset + size);
+        }
+        m_snd_queue.emplace_back(std::move(segment));
+    }
+
+    return true;
+}
+
+bool RudpSession::input(const void * data, std::size_t len, uint32_t current)
+{
+    if (nullptr == data || len < header_size)
+    {
+        return false;
+    }
+
+    const char * buffer = reinterpret_cast<const char *>(data);
+    while (len >= header_size)
+    {
+        header_type header;
+        decode_header(buffer, header);
+        if (static_cast<std::size_t>(header_size) + header.len > len)
+        {
+            return false;
+        }
+        if (cmd_push != header.cmd && cmd_ack != header.cmd)
+        {
+            return false;
+        }
+
+        m_rmt_wnd = header.wnd;
+        if (sequence_diff(header.una, m_snd_una) > 0 && sequence_diff(header.una, m_snd_nxt) <= 0)
+        {
+            acknowledge(m_snd_una, header.una);
+        }
+
+        if (cmd_ack == header.cmd)
+        {
+            input_ack(header, buffer + header_size, header.len, current);
+        }
+        else
+        {
+            if (header.len > m_mss)
+            {
+                return false;
+            }
+            input_push(header, buffer + header_size);
+        }
+
+        buffer += header_size + header.len;
+        len -= header_size + header.len;
+    }
+
+    shrink_send_buffer();
+    deliver_ordered();
+
+    return true;
+}
+
+void RudpSession::input_ack(const header_type & header, const char * blocks, std::size_t len, uint32_t current)
+{
+    if (sequence_diff(current, header.ts) >= 0)
+    {
+        update_rtt(current - header.ts);
+    }
+
+    bool sacked = false;
+    uint32_t max_end = m_snd_una;
+    for (std::size_t offset = 0; offset + 8 <= len; offset += 8)
+    {
+        uint32_t first = decode_u32(blocks + offset);
+        uint32_t last = decode_u32(blocks + offset + 4);
+        if (sequence_diff(last, first) <= 0 || sequence_diff(first, m_snd_una) < 0 || sequence_diff(last, m_snd_nxt) > 0)
+        {
+            continue;
+        }
+        acknowledge(first, last);
+        if (sequence_diff(last, max_end) > 0)
+        {
+            max_end = last;
+        }
+        sacked = true;
+    }
+
+    if (!sacked)
+    {
+        return;
+    }
+
+    int32_t reorder_window = static_cast<int32_t>(m_srtt / 4);
+    for (send_segments_type::iterator iter = m_snd_buf.begin(); m_snd_buf.end() != iter; ++iter)
+    {
+        if (sequence_diff(iter->sn, max_end) >= 0)
+        {
+            break;
+        }
+        if (!iter->acked && 0 != iter->xmit && sequence_diff(header.ts, iter->ts) > reorder_window)
+        {
+            ++iter->fastack;
+        }
+    }
+}
+
+void RudpSession::input_push(const header_type & header, const char * data)
+{
+    m_ack_pending = true;
+    m_ack_ts = header.ts;
+
+    if (sequence_diff(header.sn, m_rcv_nxt) < 0 || sequence_diff(header.sn, m_rcv_base) >= static_cast<int32_t>(m_options.window_size))
+    {
+        return;
+    }
+
+    if (0 == header.count || header.frg >= header.count || header.count > m_options.window_size)
+    {
+        return;
+    }
+
+    recv_segment_type & slot = m_rcv_buf[header.sn & m_rcv_mask];
+    if (slot.used)
+    {
+        return;
+    }
+
+    slot.used = true;
+    slot.delivered = false;
+    slot.count = header.count;
+    slot.frg = header.frg;
+    slot.data.assign(data, data + header.len);
+
+    while (sequence_diff(m_rcv_nxt, m_rcv_base) < static_cast<int32_t>(m_options.window_size) && m_rcv_buf[m_rcv_nxt & m_rcv_mask].used)
+    {
+        ++m_rcv_nxt;
+    }
+
+    if (0 != (header.flags & flag_unordered))
+    {
+        deliver_unordered(header.sn);
+    }
+}
+
+void RudpSession::acknowledge(uint32_t first, uint32_t last)
+{
+    std::size_t begin = static_cast<std::size_t>(first - m_snd_una);
+    std::size_t end = std::min<std::size_t>(static_cast<std::size_t>(last - m_snd_una), m_snd_buf.size());
+    uint32_t acked_count = 0;
+    for (std::size_t index = begin; index < end; ++index)
+    {
+        send_segment_type & segment = m_snd_buf[index];
+        if (!segment.acked)
+        {
+            segment.acked = true;
+            buffer_type().swap(segment.data);
+            ++acked_count;
+        }
+    }
+
+    if (0 == acked_count || !m_options.congestion_control)
+    {
+        return;
+    }
+
+    uint32_t max_cwnd = static_cast<uint32_t>(m_options.window_size);
+    if (m_cwnd < m_ssthresh)
+    {
+        m_cwnd = std::min(m_cwnd + acked_count, max_cwnd);
+    }
+    else
+    {
+        m_cwnd_acked += acked_count;
+        while (m_cwnd_acked >= m_cwnd)
+        {
+            m_cwnd_acked -= m_cwnd;
+            m_cwnd = std::min(m_cwnd + 1, max_cwnd);
+        }
+    }
+}
+
+void RudpSession::shrink_send_buffer()
+{
+    while (!m_snd_buf.empty() && m_snd_buf.front().acked)
+    {
+        m_snd_buf.pop_front();
+        ++m_snd_una;
+    }
+}
+
+void RudpSession::update_rtt(uint32_t rtt)
+{
+    if (0 == m_srtt)
+    {
+        m_srtt = std::max<uint32_t>(rtt, 1);
+        m_rttvar = rtt / 2;
+    }
+    else
+    {
+        uint32_t delta = (rtt > m_srtt ? rtt - m_srtt : m_srtt - rtt);
+        m_rttvar = (3 * m_rttvar + delta) / 4;
+        m_srtt = std::max<uint32_t>((7 * m_srtt + rtt) / 8, 1);
+    }
+
+    uint32_t rto = m_srtt + std::max<uint32_t>(static_cast<uint32_t>(m_options.interval_milliseconds), 4 * m_rttvar);
+    m_rto = std::min<uint32_t>(std::max<uint32_t>(rto, static_cast<uint32_t>(m_options.min_rto_milliseconds)), max_rto);
+}
+
+void RudpSession::deliver_ordered()
+{
+    while (m_rcv_queue.size() < m_options.window_size)
+    {
+        recv_segment_type & slot = m_rcv_buf[m_rcv_base & m_rcv_mask];
+        if (!slot.used)
+        {
+            break;
+        }
+
+        if (slot.delivered)
+        {
+            slot.used = false;
+            slot.delivered = false;
+            ++m_rcv_base;
+            continue;
+        }
+
+        if (slot.frg + 1 != slot.count)
+        {
+            break;
+        }
+
+        std::size_t count = slot.count;
+        std::size_t size = 0;
+        std::size_t index = 0;
+        for (index = 0; index < count; ++index)
+        {
+            const recv_segment_type & fragment = m_rcv_buf[(m_rcv_base + index) & m_rcv_mask];
+            if (!fragment.used || fragment.delivered || fragment.count != count || fragment.frg + 1 + index != count)
+            {
+                break;
+            }
+            size += fragment.data.size();
+        }
+        if (index != count)
+        {
+            break;
+        }
+
+        buffer_type message;
+        message.reserve(size);
+        for (index = 0; index < count; ++index)
+        {
+            recv_segment_type & fragment = m_rcv_buf[(m_rcv_base + index) & m_rcv_mask];
+            message.insert(message.end(), fragment.data.begin(), fragment.data.end());
+            buffer_type().swap(fragment.data);
+            fragment.used = false;
+        }
+        m_rcv_queue.emplace_back(std::move(message));
+        m_rcv_base += static_cast<uint32_t>(count);
+    }
+}
+
+void RudpSession::deliver_unordered(uint32_t sn)
+{
+    const recv_segment_type & slot = m_rcv_buf[sn & m_rcv_mask];
+    std::size_t count = slot.count;
+    uint32_t first = sn - static_cast<uint32_t>(count - 1 - slot.frg);
+    if (sequence_diff(first, m_rcv_base) < 0 || sequence_diff(first + static_cast<uint32_t>(count), m_rcv_base) > static_cast<int32_t>(m_options.window_size))
+    {
+        return;
+    }
+
+    std::size_t size = 0;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const recv_segment_type & fragment = m_rcv_buf[(first + index) & m_rcv_mask];
+        if (!fragment.used || fragment.delivered || fragment.count != count || fragment.frg + 1 + index != count)
+        {
+            return;
+        }
+        size += fragment.data.size();
+    }
+
+    buffer_type message;
+    message.reserve(size);
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        recv_segment_type & fragment = m_rcv_buf[(first + index) & m_rcv_mask];
+        message.insert(message.end(), fragment.data.begin(), fragment.data.end());
+        buffer_type().swap(fragment.data);
+        fragment.delivered = true;
+    }
+    m_rcv_queue.emplace_back(std::move(message));
+}
+
+void RudpSession::on_loss(bool timeout)
+{
+    if (!m_options.congestion_control)
+    {
+        return;
+    }
+
+    m_ssthresh = std::max<uint32_t>((m_snd_nxt - m_snd_una) / 2, 2);
+    m_cwnd = (timeout ? 1 : m_ssthresh);
+    m_cwnd_acked = 0;
+    m_recover = m_snd_nxt;
+}
+
+uint16_t RudpSession::window_unused() const
+{
+    std::size_t used = static_cast<std::size_t>(m_rcv_nxt - m_rcv_base) + m_rcv_queue.size();
+    if (used >= m_options.window_size)
+    {
+        return 0;
+    }
+    return static_cast<uint16_t>(m_options.window_size - used);
+}
+
+std::size_t RudpSession::sack_blocks(char * blocks, std::size_t max_count) const
+{
+    std::size_t count = 0;
+    bool in_block = false;
+    uint32_t first = 0;
+    uint32_t window = static_cast<uint32_t>(m_options.window_size);
+    for (uint32_t sn = m_rcv_nxt + 1; sn - m_rcv_base <= window && count < max_count; ++sn)
+    {
+        bool used = (sn - m_rcv_base < window && m_rcv_buf[sn & m_rcv_mask].used);
+        if (used && !in_block)
+        {
+            first = sn;
+            in_block = true;
+        }
+        else if (!used && in_block)
+        {
+            encode_u32(blocks + count * 8, first);
+            encode_u32(blocks + count * 8 + 4, sn);
+            ++count;
+            in_block = false;
+        }
+    }
+    return count;
+}
+
+void RudpSession::output(const header_type & header, const char * data, buffer_type & datagram, buffer_array & datagrams)
+{
+    if (!datagram.empty() && datagram.size() + header_size + header.len > m_options.mtu)
+    {
+        datagrams.emplace_back(std::move(datagram));
+        datagram.clear();
+        datagram.reserve(m_options.mtu);
+    }
+
+    std::size_t offset = datagram.size();
+    datagram.resize(offset + header_size + header.len);
+    encode_header(header, &datagram[offset]);
+    if (0 != header.len)
+    {
+        memcpy(&datagram[offset + header_size], data, header.len);
+    }
+}
+
+void RudpSession::flush(uint32_t current, buffer_array & datagrams)
+{
+    buffer_type datagram;
+    datagram.reserve(m_options.mtu);
+
+    header_type header;
+    header.wnd = window_unused();
+    header.una = m_rcv_nxt;
+
+    if (m_ack_pending)
+    {
+        char blocks[max_sack_blocks * 8];
+        std::size_t block_count = sack_blocks(blocks, std::min<std::size_t>(max_sack_blocks, m_mss / 8));
+        header.cmd = cmd_ack;
+        header.flags = 0;
+        header.count = 0;
+        header.frg = 0;
+        header.ts = m_ack_ts;
+        header.sn = 0;
+        header.len = static_cast<uint16_t>(block_count * 8);
+        output(header, blocks, datagram, datagrams);
+        m_ack_pending = false;
+    }
+
+    uint32_t window = std::min<uint32_t>(static_cast<uint32_t>(m_options.window_size), m_rmt_wnd);
+    if (m_options.congestion_control)
+    {
+        window = std::min<uint32_t>(window, m_cwnd);
+    }
+    if (0 == window && m_snd_nxt == m_snd_una)
+    {
+        window = 1;
+    }
+
+    while (!m_snd_queue.empty() && m_snd_nxt - m_snd_una < window)
+    {
+        send_segment_type & segment = m_snd_queue.front();
+        segment.sn = m_snd_nxt++;
+        m_snd_buf.emplace_back(std::move(segment));
+        m_snd_queue.pop_front();
+    }
+
+    bool pacing = m_options.pacing && 0 != m_srtt;
+    if (pacing)
+    {
+        uint32_t pacing_window = (m_options.congestion_control ? m_cwnd : static_cast<uint32_t>(m_options.window_size));
+        double rate = 1.25 * pacing_window * (m_mss + header_size) / m_srtt;
+        double burst = std::max<double>(rate * m_options.interval_milliseconds * 2, 2.0 * m_options.mtu);
+        m_pacing_budget = std::min<double>(m_pacing_budget + rate * static_cast<uint32_t>(current - m_pacing_ts), burst);
+    }
+    m_pacing_ts = current;
+
+    for (send_segments_type::iterator iter = m_snd_buf.begin(); m_snd_buf.end() != iter; ++iter)
+    {
+        send_segment_type & segment = *iter;
+        if (segment.acked)
+        {
+            continue;
+        }
+
+        bool first_send = (0 == segment.xmit);
+        bool timeout = (!first_send && sequence_diff(current, segment.resend_ts) >= 0);
+        bool fast = (!first_send && !timeout && 0 != m_options.fast_resend && segment.fastack >= m_options.fast_resend);
+        if (!first_send && !timeout && !fast)
+        {
+            continue;
+        }
+
+        if (pacing && m_pacing_budget < static_cast<double>(header_size + segment.data.size()))
+        {
+            break;
+        }
+
+        if (first_send)
+        {
+            segment.rto = m_rto;
+        }
+        else if (timeout)
+        {
+            segment.rto = std::min<uint32_t>(segment.rto + m_rto / 2, max_rto);
+            m_loss_timeout = true;
+        }
+        else if (sequence_diff(segment.sn, m_recover) >= 0)
+        {
+            m_loss_fast = true;
+        }
+
+        segment.fastack = 0;
+        segment.ts = current;
+        segment.resend_ts = current + segment.rto;
+        if (++segment.xmit > m_options.dead_link)
+        {
+            m_dead = true;
+        }
+
+        header.cmd = cmd_push;
+        header.flags = segment.flags;
+        header.count = segment.count;
+        header.frg = segment.frg;
+        header.ts = segment.ts;
+        header.sn = segment.sn;
+        header.len = static_cast<uint16_t>(segment.data.size());
+        output(header, segment.data.data(), datagram, datagrams);
+
+        if (pacing)
+        {
+            m_pacing_budget -= static_cast<double>(header_size + segment.data.size());
+        }
+    }
+
+    if (!datagram.empty())
+    {
+        datagrams.emplace_back(std::move(datagram));
+    }
+
+    if (m_loss_timeout)
+    {
+        on_loss(true);
+    }
+    else if (m_loss_fast)
+    {
+        on_loss(false);
+    }
+    m_loss_timeout = false;
+    m_loss_fast = false;
+}
+
+bool RudpSession::has_message() const
+{
+    return !m_rcv_queue.empty();
+}
+
+const RudpSession::buffer_type & RudpSession::front_message() const
+{
+    return m_rcv_queue.front();
+}
+
+bool RudpSession::pop_message()
+{
+    if (m_rcv_queue.empty())
+    {
+        return false;
+    }
+    m_rcv_queue.pop_front();
+    deliver_ordered();
+    return true;
+}
+
+bool RudpSession::idle() const
+{
+    return m_snd_queue.empty() && m_snd_buf.empty();
+}
+
+bool RudpSession::dead() const
+{
+    return m_dead;
+}
+
+void RudpSession::encode_header(const header_type & header, char * buffer)
+{
+    buffer[0] = static_cast<char>(header.cmd);
+    buffer[1] = static_cast<char>(header.flags);
+    encode_u16(buffer + 2, header.count);
+    encode_u16(buffer + 4, header.frg);
+    encode_u16(buffer + 6, header.wnd);
+    encode_u32(buffer + 8, header.ts);
+    encode_u32(buffer + 12, header.sn);
+    encode_u32(buffer + 16, header.una);
+    encode_u16(buffer + 20, header.len);
+}
+
+void RudpSession::decode_header(const char * buffer, header_type & header)
+{
+    header.cmd = static_cast<uint8_t>(buffer[0]);
+    header.flags = static_cast<uint8_t>(buffer[1]);
+    header.count = decode_u16(buffer + 2);
+    header.frg = decode_u16(buffer + 4);
+    header.wnd = decode_u16(buffer + 6);
+    header.ts = decode_u32(buffer + 8);
+    header.sn = decode_u32(buffer + 12);
+    header.una = decode_u32(buffer + 16);
+    header.len = decode_u16(buffer + 20);
+}
+
+} // namespace BoostNet end
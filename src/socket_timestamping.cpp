@@ -0,0 +1,221 @@
+/********************************************************
+ * Description : kernel socket timestamping
+ * Data        : 2026-10-20 05:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <cerrno>
+#include <cstring>
+#include <boost/core/ignore_unused.hpp>
+#include "socket_timestamping.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+#ifdef BOOST_NET_TIMESTAMPING_SUPPORT
+static uint64_t timespec_nanoseconds(const struct timespec & time)
+{
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000 + static_cast<uint64_t>(time.tv_nsec);
+}
+#endif // BOOST_NET_TIMESTAMPING_SUPPORT
+
+SocketTimestamping::SocketTimestamping()
+    : m_recv_enable(false)
+    , m_send_enable(false)
+    , m_send_mutex()
+    , m_send_time(0)
+    , m_send_count(0)
+{
+
+}
+
+SocketTimestamping::~SocketTimestamping()
+{
+
+}
+
+bool SocketTimestamping::enable(native_handle_type handle, bool recv_enable, bool send_enable)
+{
+#ifdef BOOST_NET_TIMESTAMPING_SUPPORT
+    int flags = 0;
+    if (recv_enable)
+    {
+        flags |= SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    }
+    if (send_enable)
+    {
+        flags |= SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+    }
+
+    if (0 == ::setsockopt(handle, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)))
+    {
+        m_recv_enable = recv_enable;
+        m_send_enable = send_enable;
+    }
+    else
+    {
+        int timestamp_ns = (recv_enable ? 1 : 0);
+        m_recv_enable = 0 == ::setsockopt(handle, SOL_SOCKET, SO_TIMESTAMPNS, &timestamp_ns, sizeof(timestamp_ns)) && recv_enable;
+        m_send_enable = false;
+    }
+#else
+    boost::ignore_unused(handle);
+#endif // BOOST_NET_TIMESTAMPING_SUPPORT
+
+    return recv_enable == m_recv_enable && send_enable == m_send_enable;
+}
+
+bool SocketTimestamping::recv_enabled() const
+{
+    return m_recv_enable;
+}
+
+bool SocketTimestamping::send_enabled() const
+{
+    return m_send_enable;
+}
+
+void SocketTimestamping::read_send_timestamps(native_handle_type handle)
+{
+#ifdef BOOST_NET_TIMESTAMPING_SUPPORT
+    while (true)
+    {
+        char control[CMSG_SPACE(sizeof(struct scm_timestamping)) + CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in6))];
+        struct msghdr header;
+        memset(&header, 0x0, sizeof(header));
+        header.msg_control = control;
+        header.msg_controllen = sizeof(control);
+
+        if (::recvmsg(handle, &header, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            break;
+        }
+
+        uint64_t send_time = 0;
+        bool send_key_found = false;
+        uint32_t send_key = 0;
+        for (struct cmsghdr * cmsg = CMSG_FIRSTHDR(&header); nullptr != cmsg; cmsg = CMSG_NXTHDR(&header, cmsg))
+        {
+            if (SOL_SOCKET == cmsg->cmsg_level && SCM_TIMESTAMPING == cmsg->cmsg_type)
+            {
+                struct scm_timestamping stamps;
+                memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+                send_time = timespec_nanoseconds(stamps.ts[0]);
+            }
+            else if ((IPPROTO_IP == cmsg->cmsg_level && IP_RECVERR == cmsg->cmsg_type) || (IPPROTO_IPV6 == cmsg->cmsg_level && IPV6_RECVERR == cmsg->cmsg_type))
+            {
+                struct sock_extended_err extended_error;
+                memcpy(&extended_error, CMSG_DATA(cmsg), sizeof(extended_error));
+                if (ENOMSG == extended_error.ee_errno && SO_EE_ORIGIN_TIMESTAMPING == extended_error.ee_origin)
+                {
+                    send_key_found = true;
+                    send_key = extended_error.ee_data;
+                }
+            }
+        }
+
+        if (0 != send_time && send_key_found)
+        {
+            std::lock_guard<std::mutex> locker(m_send_mutex);
+            m_send_time = send_time;
+            m_send_count += static_cast<int32_t>(send_key + 1 - static_cast<uint32_t>(m_send_count));
+        }
+    }
+#else
+    boost::ignore_unused(handle);
+#endif // BOOST_NET_TIMESTAMPING_SUPPORT
+}
+
+bool SocketTimestamping::send_timestamp(KernelTimestamp & timestamp, std::size_t & send_count) const
+{
+    std::lock_guard<std::mutex> locker(m_send_mutex);
+    send_count = m_send_count;
+    return to_timestamp(m_send_time, timestamp);
+}
+
+std::size_t SocketTimestamping::recv(native_handle_type handle, void * data, std::size_t len, uint64_t & timestamp, boost::system::error_code & error)
+{
+    error.clear();
+    timestamp = 0;
+
+#ifdef BOOST_NET_TIMESTAMPING_SUPPORT
+    struct iovec iov;
+    iov.iov_base = data;
+    iov.iov_len = len;
+
+    char control[CMSG_SPACE(sizeof(struct scm_timestamping))];
+    struct msghdr header;
+    memset(&header, 0x0, sizeof(header));
+    header.msg_iov = &iov;
+    header.msg_iovlen = 1;
+    header.msg_control = control;
+    header.msg_controllen = sizeof(control);
+
+    ssize_t recv_size = -1;
+    do
+    {
+        recv_size = ::recvmsg(handle, &header, MSG_DONTWAIT);
+    } while (recv_size < 0 && EINTR == errno);
+
+    if (recv_size < 0)
+    {
+        error = boost::system::error_code(errno, boost::asio::error::get_system_category());
+        return 0;
+    }
+
+    if (0 == recv_size && 0 != len)
+    {
+        error = boost::asio::error::eof;
+        return 0;
+    }
+
+    timestamp = recv_timestamp(header);
+
+    return static_cast<std::size_t>(recv_size);
+#else
+    boost::ignore_unused(handle);
+    boost::ignore_unused(data);
+    boost::ignore_unused(len);
+    error = boost::asio::error::operation_not_supported;
+    return 0;
+#endif // BOOST_NET_TIMESTAMPING_SUPPORT
+}
+
+bool SocketTimestamping::to_timestamp(uint64_t nanoseconds, KernelTimestamp & timestamp)
+{
+    timestamp.seconds = static_cast<std::size_t>(nanoseconds / 1000000000);
+    timestamp.nanoseconds = static_cast<std::size_t>(nanoseconds % 1000000000);
+    return 0 != nanoseconds;
+}
+
+#ifdef BOOST_NET_TIMESTAMPING_SUPPORT
+uint64_t SocketTimestamping::recv_timestamp(struct msghdr & header)
+{
+    uint64_t timestamp = 0;
+    for (struct cmsghdr * cmsg = CMSG_FIRSTHDR(&header); nullptr != cmsg; cmsg = CMSG_NXTHDR(&header, cmsg))
+    {
+        if (SOL_SOCKET == cmsg->cmsg_level && SCM_TIMESTAMPING == cmsg->cmsg_type)
+        {
+            struct scm_timestamping stamps;
+            memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+            timestamp = timespec_nanoseconds(stamps.ts[0]);
+        }
+        else if (SOL_SOCKET == cmsg->cmsg_level && SCM_TIMESTAMPNS == cmsg->cmsg_type)
+        {
+            struct timespec stamp;
+            memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+            timestamp = timespec_nanoseconds(stamp);
+        }
+    }
+    return timestamp;
+}
+#endif // BOOST_NET_TIMESTAMPING_SUPPORT
+
+} // namespace BoostNet end
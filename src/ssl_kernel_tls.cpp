@@ -0,0 +1,603 @@
+/********************************************************
+ * Description : ssl kernel tls offload
+ * Data        : 2026-10-19 19:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <boost/core/ignore_unused.hpp>
+#include "ssl_kernel_tls.h"
+
+#if defined(__linux__) && OPENSSL_VERSION_NUMBER >= 0x30000000L
+    #define BOOST_NET_KERNEL_TLS_SUPPORT
+#endif // defined(__linux__) && OPENSSL_VERSION_NUMBER >= 0x30000000L
+
+#ifdef BOOST_NET_KERNEL_TLS_SUPPORT
+    #include <cstddef>
+    #include <sys/socket.h>
+    #include <sys/uio.h>
+    #include <sys/ioctl.h>
+    #include <netinet/in.h>
+    #include <linux/tcp.h>
+    #include <linux/sockios.h>
+    #include <linux/tls.h>
+    #include <openssl/evp.h>
+    #include <openssl/hmac.h>
+    #include <openssl/kdf.h>
+    #include <openssl/core_names.h>
+    #include <openssl/params.h>
+    #ifndef SOL_TLS
+        #define SOL_TLS 282
+    #endif // SOL_TLS
+#endif // BOOST_NET_KERNEL_TLS_SUPPORT
+
+namespace BoostNet { // namespace BoostNet begin
+
+#ifdef BOOST_NET_KERNEL_TLS_SUPPORT
+
+union kernel_crypto_info_type
+{
+    struct tls_crypto_info                          info;
+    struct tls12_crypto_info_aes_gcm_128            aes_gcm_128;
+    struct tls12_crypto_info_aes_gcm_256            aes_gcm_256;
+    struct tls12_crypto_info_chacha20_poly1305      chacha20_poly1305;
+};
+
+static bool hex_decode(const std::string & hex, SslKernelTls::secret_type & secret)
+{
+    if (hex.empty() || 0 != hex.size() % 2)
+    {
+        return false;
+    }
+
+    secret.clear();
+    for (std::size_t index = 0; index < hex.size(); index += 2)
+    {
+        int value = 0;
+        for (std::size_t offset = 0; offset < 2; ++offset)
+        {
+            const char c = hex[index + offset];
+            value <<= 4;
+            if (c >= '0' && c <= '9')
+            {
+                value |= c - '0';
+            }
+            else if (c >= 'a' && c <= 'f')
+            {
+                value |= c - 'a' + 10;
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                value |= c - 'A' + 10;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        secret.push_back(static_cast<unsigned char>(value));
+    }
+
+    return true;
+}
+
+static bool tls13_expand_label(const EVP_MD * md, const SslKernelTls::secret_type & secret, const char * label, std::size_t length, unsigned char * output)
+{
+    const std::string full_label = std::string("tls13 ") + label;
+    std::vector<unsigned char> info;
+    info.push_back(static_cast<unsigned char>(length >> 8));
+    info.push_back(static_cast<unsigned char>(length & 0xFF));
+    info.push_back(static_cast<unsigned char>(full_label.size()));
+    info.insert(info.end(), full_label.begin(), full_label.end());
+    info.push_back(0x00);
+    info.push_back(0x01);
+
+    unsigned char block[EVP_MAX_MD_SIZE] = { 0x0 };
+    unsigned int block_size = 0;
+    if (nullptr == md || secret.empty() || nullptr == HMAC(md, &secret[0], static_cast<int>(secret.size()), &info[0], info.size(), block, &block_size) || block_size < length)
+    {
+        return false;
+    }
+
+    memcpy(output, block, length);
+    OPENSSL_cleanse(block, sizeof(block));
+
+    return true;
+}
+
+static bool tls12_key_block(SSL * ssl, const EVP_MD * md, unsigned char * key_block, std::size_t length)
+{
+    unsigned char master_key[SSL_MAX_MASTER_KEY_LENGTH] = { 0x0 };
+    std::size_t master_key_size = SSL_SESSION_get_master_key(SSL_get_session(ssl), master_key, sizeof(master_key));
+    if (nullptr == md || 0 == master_key_size)
+    {
+        return false;
+    }
+
+    const char label[] = "key expansion";
+    unsigned char seed[sizeof(label) - 1 + SSL3_RANDOM_SIZE * 2] = { 0x0 };
+    memcpy(seed, label, sizeof(label) - 1);
+    SSL_get_server_random(ssl, seed + sizeof(label) - 1, SSL3_RANDOM_SIZE);
+    SSL_get_client_random(ssl, seed + sizeof(label) - 1 + SSL3_RANDOM_SIZE, SSL3_RANDOM_SIZE);
+
+    EVP_KDF * kdf = EVP_KDF_fetch(nullptr, OSSL_KDF_NAME_TLS1_PRF, nullptr);
+    EVP_KDF_CTX * kdf_ctx = EVP_KDF_CTX_new(kdf);
+    EVP_KDF_free(kdf);
+    if (nullptr == kdf_ctx)
+    {
+        OPENSSL_cleanse(master_key, sizeof(master_key));
+        return false;
+    }
+
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_utf8_string(OSSL_KDF_PARAM_DIGEST, const_cast<char *>(EVP_MD_get0_name(md)), 0),
+        OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_SECRET, master_key, master_key_size),
+        OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_SEED, seed, sizeof(seed)),
+        OSSL_PARAM_construct_end()
+    };
+    bool ret = (1 == EVP_KDF_derive(kdf_ctx, key_block, length, params));
+
+    EVP_KDF_CTX_free(kdf_ctx);
+    OPENSSL_cleanse(master_key, sizeof(master_key));
+
+    return ret;
+}
+
+static std::size_t make_crypto_info(kernel_crypto_info_type & crypto_info, int version, int cipher_nid, const unsigned char * key, const unsigned char * iv, uint64_t sequence)
+{
+    unsigned char record_sequence[8] = { 0x0 };
+    for (std::size_t index = 0; index < sizeof(record_sequence); ++index)
+    {
+        record_sequence[index] = static_cast<unsigned char>(sequence >> (8 * (sizeof(record_sequence) - 1 - index)));
+    }
+
+    memset(&crypto_info, 0x0, sizeof(crypto_info));
+    crypto_info.info.version = (TLS1_3_VERSION == version ? TLS_1_3_VERSION : TLS_1_2_VERSION);
+
+    if (NID_aes_128_gcm == cipher_nid)
+    {
+        crypto_info.info.cipher_type = TLS_CIPHER_AES_GCM_128;
+        memcpy(crypto_info.aes_gcm_128.key, key, TLS_CIPHER_AES_GCM_128_KEY_SIZE);
+        memcpy(crypto_info.aes_gcm_128.salt, iv, TLS_CIPHER_AES_GCM_128_SALT_SIZE);
+        memcpy(crypto_info.aes_gcm_128.iv, TLS1_3_VERSION == version ? iv + TLS_CIPHER_AES_GCM_128_SALT_SIZE : record_sequence, TLS_CIPHER_AES_GCM_128_IV_SIZE);
+        memcpy(crypto_info.aes_gcm_128.rec_seq, record_sequence, TLS_CIPHER_AES_GCM_128_REC_SEQ_SIZE);
+        return sizeof(crypto_info.aes_gcm_128);
+    }
+    else if (NID_aes_256_gcm == cipher_nid)
+    {
+        crypto_info.info.cipher_type = TLS_CIPHER_AES_GCM_256;
+        memcpy(crypto_info.aes_gcm_256.key, key, TLS_CIPHER_AES_GCM_256_KEY_SIZE);
+        memcpy(crypto_info.aes_gcm_256.salt, iv, TLS_CIPHER_AES_GCM_256_SALT_SIZE);
+        memcpy(crypto_info.aes_gcm_256.iv, TLS1_3_VERSION == version ? iv + TLS_CIPHER_AES_GCM_256_SALT_SIZE : record_sequence, TLS_CIPHER_AES_GCM_256_IV_SIZE);
+        memcpy(crypto_info.aes_gcm_256.rec_seq, record_sequence, TLS_CIPHER_AES_GCM_256_REC_SEQ_SIZE);
+        return sizeof(crypto_info.aes_gcm_256);
+    }
+    else if (NID_chacha20_poly1305 == cipher_nid)
+    {
+        crypto_info.info.cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+        memcpy(crypto_info.chacha20_poly1305.key, key, TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE);
+        memcpy(crypto_info.chacha20_poly1305.iv, iv, TLS_CIPHER_CHACHA20_POLY1305_IV_SIZE);
+        memcpy(crypto_info.chacha20_poly1305.rec_seq, record_sequence, TLS_CIPHER_CHACHA20_POLY1305_REC_SEQ_SIZE);
+        return sizeof(crypto_info.chacha20_poly1305);
+    }
+
+    return 0;
+}
+
+#endif // BOOST_NET_KERNEL_TLS_SUPPORT
+
+SslKernelTls::SslKernelTls()
+    : m_prepared(false)
+    , m_send_offload(false)
+    , m_recv_offload(false)
+    , m_send_finished(false)
+    , m_recv_finished(false)
+    , m_send_records(0)
+    , m_recv_records(0)
+    , m_send_messages(0)
+    , m_recv_messages(0)
+    , m_recv_handshake()
+    , m_client_secret()
+    , m_server_secret()
+{
+
+}
+
+SslKernelTls::~SslKernelTls()
+{
+    if (!m_client_secret.empty())
+    {
+        OPENSSL_cleanse(&m_client_secret[0], m_client_secret.size());
+    }
+    if (!m_server_secret.empty())
+    {
+        OPENSSL_cleanse(&m_server_secret[0], m_server_secret.size());
+    }
+}
+
+bool SslKernelTls::supported()
+{
+#ifdef BOOST_NET_KERNEL_TLS_SUPPORT
+    return true;
+#else
+    return false;
+#endif // BOOST_NET_KERNEL_TLS_SUPPORT
+}
+
+bool SslKernelTls::enable(SSL_CTX * ssl_context, bool enable)
+{
+    if (nullptr == ssl_context || (enable && !supported()))
+    {
+        return false;
+    }
+
+    SSL_CTX_set_keylog_callback(ssl_context, enable ? &SslKernelTls::handle_keylog : nullptr);
+
+    return true;
+}
+
+int SslKernelTls::ssl_index()
+{
+    static const int s_ssl_index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return s_ssl_index;
+}
+
+void SslKernelTls::prepare(SSL * ssl)
+{
+    if (nullptr == ssl || ssl_index() < 0 || &SslKernelTls::handle_keylog != SSL_CTX_get_keylog_callback(SSL_get_SSL_CTX(ssl)))
+    {
+        return;
+    }
+
+    if (0 == SSL_set_ex_data(ssl, ssl_index(), this))
+    {
+        return;
+    }
+
+    SSL_set_msg_callback(ssl, &SslKernelTls::handle_message);
+    SSL_set_msg_callback_arg(ssl, this);
+    SSL_set_options(ssl, SSL_OP_NO_RENEGOTIATION);
+
+    m_prepared = true;
+}
+
+/* returns false only when the socket was left half offloaded and the session has to be closed */
+bool SslKernelTls::install(SSL * ssl, int fd, bool passive)
+{
+    if (!m_prepared || nullptr == ssl)
+    {
+        return true;
+    }
+
+    SSL_set_msg_callback(ssl, nullptr);
+    SSL_set_ex_data(ssl, ssl_index(), nullptr);
+    m_prepared = false;
+
+#ifdef BOOST_NET_KERNEL_TLS_SUPPORT
+    const int version = SSL_version(ssl);
+    const SSL_CIPHER * cipher = SSL_get_current_cipher(ssl);
+    if (!m_send_finished || !m_recv_finished || (TLS1_2_VERSION != version && TLS1_3_VERSION != version) || nullptr == cipher)
+    {
+        return true;
+    }
+
+    const int cipher_nid = SSL_CIPHER_get_cipher_nid(cipher);
+    std::size_t key_size = 0;
+    std::size_t iv_size = 0;
+    if (NID_aes_128_gcm == cipher_nid)
+    {
+        key_size = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+        iv_size = (TLS1_3_VERSION == version ? 12 : TLS_CIPHER_AES_GCM_128_SALT_SIZE);
+    }
+    else if (NID_aes_256_gcm == cipher_nid)
+    {
+        key_size = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+        iv_size = (TLS1_3_VERSION == version ? 12 : TLS_CIPHER_AES_GCM_256_SALT_SIZE);
+    }
+    else if (NID_chacha20_poly1305 == cipher_nid)
+    {
+        key_size = TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE;
+        iv_size = TLS_CIPHER_CHACHA20_POLY1305_IV_SIZE;
+    }
+    else
+    {
+        return true;
+    }
+
+    const EVP_MD * md = SSL_CIPHER_get_handshake_digest(cipher);
+    unsigned char key_block[(32 + 12) * 2] = { 0x0 };
+    unsigned char * client_key = key_block;
+    unsigned char * server_key = key_block + key_size;
+    unsigned char * client_iv = key_block + key_size * 2;
+    unsigned char * server_iv = key_block + key_size * 2 + iv_size;
+
+    bool derived = false;
+    if (TLS1_3_VERSION == version)
+    {
+        derived = tls13_expand_label(md, m_client_secret, "key", key_size, client_key) && tls13_expand_label(md, m_server_secret, "key", key_size, server_key) && tls13_expand_label(md, m_client_secret, "iv", iv_size, client_iv) && tls13_expand_label(md, m_server_secret, "iv", iv_size, server_iv);
+    }
+    else
+    {
+        derived = tls12_key_block(ssl, md, key_block, (key_size + iv_size) * 2);
+    }
+
+    const uint64_t sequence_base = (TLS1_2_VERSION == version ? 1 : 0);
+    kernel_crypto_info_type send_crypto_info;
+    kernel_crypto_info_type recv_crypto_info;
+    std::size_t send_crypto_size = make_crypto_info(send_crypto_info, version, cipher_nid, passive ? server_key : client_key, passive ? server_iv : client_iv, sequence_base + m_send_records);
+    std::size_t recv_crypto_size = make_crypto_info(recv_crypto_info, version, cipher_nid, passive ? client_key : server_key, passive ? client_iv : server_iv, sequence_base + m_recv_records);
+    OPENSSL_cleanse(key_block, sizeof(key_block));
+
+    /* every record since finished must be a handshake message we saw, else the sequence numbers are unknown */
+    const bool sequence_verified = (m_send_records == m_send_messages && m_recv_records == m_recv_messages);
+
+    bool installed = true;
+    if (derived && sequence_verified && recv_drained(ssl, fd) && 0 != send_crypto_size && 0 != recv_crypto_size && 0 == setsockopt(fd, IPPROTO_TCP, TCP_ULP, "tls", sizeof("tls")))
+    {
+        /* until both directions are set the ulp passes bytes through, so a failed rx leaves the session in userspace */
+        if (0 == setsockopt(fd, SOL_TLS, TLS_RX, &recv_crypto_info, static_cast<socklen_t>(recv_crypto_size)))
+        {
+            installed = (0 == setsockopt(fd, SOL_TLS, TLS_TX, &send_crypto_info, static_cast<socklen_t>(send_crypto_size)));
+            m_send_offload = installed;
+            m_recv_offload = installed;
+        }
+    }
+
+    OPENSSL_cleanse(&send_crypto_info, sizeof(send_crypto_info));
+    OPENSSL_cleanse(&recv_crypto_info, sizeof(recv_crypto_info));
+
+    return installed;
+#else
+    boost::ignore_unused(fd);
+    boost::ignore_unused(passive);
+    return true;
+#endif // BOOST_NET_KERNEL_TLS_SUPPORT
+}
+
+bool SslKernelTls::recv_drained(SSL * ssl, int fd)
+{
+#ifdef BOOST_NET_KERNEL_TLS_SUPPORT
+    BIO * rbio = (nullptr != ssl ? SSL_get_rbio(ssl) : nullptr);
+    if (nullptr == rbio || SSL_has_pending(ssl) || 0 != BIO_ctrl_pending(rbio))
+    {
+        return false;
+    }
+
+    /* the unread queue is taken first, so a segment arriving in between can only make the counts differ */
+    int unread_size = 0;
+    if (0 != ioctl(fd, SIOCINQ, &unread_size) || unread_size < 0)
+    {
+        return false;
+    }
+
+    struct tcp_info info;
+    memset(&info, 0x0, sizeof(info));
+    socklen_t info_size = sizeof(info);
+    if (0 != getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &info_size) || info_size < offsetof(struct tcp_info, tcpi_bytes_received) + sizeof(info.tcpi_bytes_received))
+    {
+        return false;
+    }
+
+    return info.tcpi_bytes_received == BIO_number_read(rbio) + static_cast<uint64_t>(unread_size);
+#else
+    boost::ignore_unused(ssl);
+    boost::ignore_unused(fd);
+    return false;
+#endif // BOOST_NET_KERNEL_TLS_SUPPORT
+}
+
+std::size_t SslKernelTls::recv(int fd, void * data, std::size_t size, int & error)
+{
+    error = 0;
+
+#ifdef BOOST_NET_KERNEL_TLS_SUPPORT
+    while (true)
+    {
+        struct iovec iov;
+        iov.iov_base = data;
+        iov.iov_len = size;
+        char control[CMSG_SPACE(sizeof(unsigned char))] = { 0x0 };
+        struct msghdr msg;
+        memset(&msg, 0x0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        ssize_t recv_size = ::recvmsg(fd, &msg, MSG_DONTWAIT);
+        if (recv_size < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            error = errno;
+            return 0;
+        }
+
+        unsigned char record_type = SSL3_RT_APPLICATION_DATA;
+        for (struct cmsghdr * cmsg = CMSG_FIRSTHDR(&msg); nullptr != cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            if (SOL_TLS == cmsg->cmsg_level && TLS_GET_RECORD_TYPE == cmsg->cmsg_type)
+            {
+                record_type = *CMSG_DATA(cmsg);
+            }
+        }
+
+        if (SSL3_RT_APPLICATION_DATA == record_type)
+        {
+            return static_cast<std::size_t>(recv_size);
+        }
+
+        if (!recv_control(record_type, static_cast<const unsigned char *>(data), static_cast<std::size_t>(recv_size), error))
+        {
+            return 0;
+        }
+    }
+#else
+    boost::ignore_unused(fd);
+    boost::ignore_unused(data);
+    boost::ignore_unused(size);
+    error = EOPNOTSUPP;
+    return 0;
+#endif // BOOST_NET_KERNEL_TLS_SUPPORT
+}
+
+bool SslKernelTls::recv_control(unsigned char record_type, const unsigned char * data, std::size_t size, int & error)
+{
+    if (SSL3_RT_ALERT == record_type)
+    {
+        error = (2 == size && SSL3_AD_CLOSE_NOTIFY == data[1] ? 0 : ECONNRESET);
+        return false;
+    }
+
+    if (SSL3_RT_HANDSHAKE != record_type)
+    {
+        error = EPROTO;
+        return false;
+    }
+
+    /* tickets are dropped, a key update or anything else cannot be followed by the kernel and ends the session */
+    m_recv_handshake.insert(m_recv_handshake.end(), data, data + size);
+    std::size_t offset = 0;
+    while (m_recv_handshake.size() - offset >= SSL3_HM_HEADER_LENGTH)
+    {
+        const unsigned char * message = &m_recv_handshake[offset];
+        const std::size_t message_size = SSL3_HM_HEADER_LENGTH + ((static_cast<std::size_t>(message[1]) << 16) | (static_cast<std::size_t>(message[2]) << 8) | message[3]);
+        if (SSL3_MT_NEWSESSION_TICKET != message[0] || message_size > SSL3_RT_MAX_PLAIN_LENGTH)
+        {
+            error = EPROTO;
+            return false;
+        }
+        if (m_recv_handshake.size() - offset < message_size)
+        {
+            break;
+        }
+        offset += message_size;
+    }
+    m_recv_handshake.erase(m_recv_handshake.begin(), m_recv_handshake.begin() + offset);
+
+    return true;
+}
+
+void SslKernelTls::shutdown(int fd)
+{
+#ifdef BOOST_NET_KERNEL_TLS_SUPPORT
+    if (!m_send_offload)
+    {
+        return;
+    }
+
+    unsigned char alert[2] = { SSL3_AL_WARNING, SSL3_AD_CLOSE_NOTIFY };
+    char control[CMSG_SPACE(sizeof(unsigned char))] = { 0x0 };
+    struct iovec iov;
+    iov.iov_base = alert;
+    iov.iov_len = sizeof(alert);
+    struct msghdr msg;
+    memset(&msg, 0x0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    struct cmsghdr * cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_TLS;
+    cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(unsigned char));
+    *CMSG_DATA(cmsg) = SSL3_RT_ALERT;
+    sendmsg(fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+#endif // BOOST_NET_KERNEL_TLS_SUPPORT
+}
+
+bool SslKernelTls::send_offload() const
+{
+    return m_send_offload;
+}
+
+bool SslKernelTls::recv_offload() const
+{
+    return m_recv_offload;
+}
+
+void SslKernelTls::handle_keylog(const SSL * ssl, const char * line)
+{
+    SslKernelTls * kernel_tls = static_cast<SslKernelTls *>(SSL_get_ex_data(ssl, ssl_index()));
+    if (nullptr == kernel_tls || nullptr == line)
+    {
+        return;
+    }
+
+#ifdef BOOST_NET_KERNEL_TLS_SUPPORT
+    const std::string record(line);
+    const std::string::size_type label_end = record.find(' ');
+    const std::string::size_type random_end = (std::string::npos == label_end ? std::string::npos : record.find(' ', label_end + 1));
+    if (std::string::npos == random_end)
+    {
+        return;
+    }
+
+    const std::string label = record.substr(0, label_end);
+    if ("CLIENT_TRAFFIC_SECRET_0" == label)
+    {
+        hex_decode(record.substr(random_end + 1), kernel_tls->m_client_secret);
+    }
+    else if ("SERVER_TRAFFIC_SECRET_0" == label)
+    {
+        hex_decode(record.substr(random_end + 1), kernel_tls->m_server_secret);
+    }
+#endif // BOOST_NET_KERNEL_TLS_SUPPORT
+}
+
+void SslKernelTls::handle_message(int write_p, int, int content_type, const void * buf, std::size_t len, SSL *, void * arg)
+{
+    SslKernelTls * kernel_tls = static_cast<SslKernelTls *>(arg);
+    if (nullptr == kernel_tls)
+    {
+        return;
+    }
+
+    if (SSL3_RT_HEADER == content_type)
+    {
+        if (write_p)
+        {
+            ++kernel_tls->m_send_records;
+        }
+        else
+        {
+            ++kernel_tls->m_recv_records;
+        }
+    }
+    else if (SSL3_RT_HANDSHAKE == content_type && len > 0 && SSL3_MT_FINISHED == *static_cast<const unsigned char *>(buf))
+    {
+        if (write_p)
+        {
+            kernel_tls->m_send_finished = true;
+            kernel_tls->m_send_records = 0;
+            kernel_tls->m_send_messages = 0;
+        }
+        else
+        {
+            kernel_tls->m_recv_finished = true;
+            kernel_tls->m_recv_records = 0;
+            kernel_tls->m_recv_messages = 0;
+        }
+    }
+    else if (SSL3_RT_HANDSHAKE == content_type)
+    {
+        if (write_p)
+        {
+            ++kernel_tls->m_send_messages;
+        }
+        else
+        {
+            ++kernel_tls->m_recv_messages;
+        }
+    }
+}
+
+} // namespace BoostNet end
@@ -0,0 +1,239 @@
+/********************************************************
+ * Description : ssl client session cache
+ * Data        : 2026-10-19 16:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <ctime>
+#include <algorithm>
+#include "ssl_session_cache.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+SslSessionCache::SslSessionCache()
+    : m_mutex()
+    , m_ssl_contexts()
+    , m_ssl_session_map()
+    , m_ssl_session_keys()
+    , m_max_session_count(1024)
+    , m_hit_count(0)
+    , m_miss_count(0)
+{
+
+}
+
+SslSessionCache::~SslSessionCache()
+{
+    detach();
+    clear();
+}
+
+int SslSessionCache::context_index()
+{
+    static const int s_context_index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return s_context_index;
+}
+
+int SslSessionCache::session_index()
+{
+    static const int s_session_index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return s_session_index;
+}
+
+bool SslSessionCache::attach(SSL_CTX * ssl_context)
+{
+    if (nullptr == ssl_context || context_index() < 0 || session_index() < 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> locker(m_mutex);
+
+    if (m_ssl_contexts.end() != std::find(m_ssl_contexts.begin(), m_ssl_contexts.end(), ssl_context))
+    {
+        return true;
+    }
+
+    if (0 == SSL_CTX_set_ex_data(ssl_context, context_index(), this))
+    {
+        return false;
+    }
+
+    SSL_CTX_set_session_cache_mode(ssl_context, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ssl_context, &SslSessionCache::handle_new_session);
+
+    SSL_CTX_up_ref(ssl_context);
+    m_ssl_contexts.push_back(ssl_context);
+
+    return true;
+}
+
+void SslSessionCache::detach()
+{
+    ssl_contexts_type ssl_contexts;
+
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        ssl_contexts.swap(m_ssl_contexts);
+    }
+
+    for (ssl_contexts_type::iterator iter = ssl_contexts.begin(); ssl_contexts.end() != iter; ++iter)
+    {
+        SSL_CTX_sess_set_new_cb(*iter, nullptr);
+        SSL_CTX_set_ex_data(*iter, context_index(), nullptr);
+        SSL_CTX_free(*iter);
+    }
+}
+
+void SslSessionCache::set_limit(std::size_t max_session_count)
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_max_session_count = max_session_count;
+    while (m_ssl_session_map.size() > m_max_session_count)
+    {
+        erase(m_ssl_session_map.find(m_ssl_session_keys.back()));
+    }
+}
+
+void SslSessionCache::get_statistics(std::size_t & hit_count, std::size_t & miss_count)
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    hit_count = m_hit_count;
+    miss_count = m_miss_count;
+}
+
+void SslSessionCache::clear()
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    for (ssl_session_map::iterator iter = m_ssl_session_map.begin(); m_ssl_session_map.end() != iter; ++iter)
+    {
+        SSL_SESSION_free(iter->second.first);
+    }
+    m_ssl_session_map.clear();
+    m_ssl_session_keys.clear();
+}
+
+void SslSessionCache::prepare(SSL * ssl, const std::string & key)
+{
+    if (nullptr == ssl || key.empty())
+    {
+        return;
+    }
+
+    SSL_set_ex_data(ssl, session_index(), const_cast<std::string *>(&key));
+
+    std::lock_guard<std::mutex> locker(m_mutex);
+    ssl_session_map::iterator iter = m_ssl_session_map.find(key);
+    if (m_ssl_session_map.end() == iter)
+    {
+        return;
+    }
+
+    SSL_SESSION * ssl_session = iter->second.first;
+    if (static_cast<long>(time(nullptr)) >= static_cast<long>(SSL_SESSION_get_time(ssl_session) + SSL_SESSION_get_timeout(ssl_session)))
+    {
+        erase(iter);
+        return;
+    }
+
+    m_ssl_session_keys.splice(m_ssl_session_keys.begin(), m_ssl_session_keys, iter->second.second);
+
+    SSL_set_session(ssl, ssl_session);
+}
+
+void SslSessionCache::complete(SSL * ssl, bool success)
+{
+    if (nullptr == ssl)
+    {
+        return;
+    }
+
+    const std::string * key = static_cast<const std::string *>(SSL_get_ex_data(ssl, session_index()));
+
+    if (!success)
+    {
+        if (nullptr != key)
+        {
+            remove(*key);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> locker(m_mutex);
+    if (SSL_session_reused(ssl))
+    {
+        ++m_hit_count;
+    }
+    else
+    {
+        ++m_miss_count;
+    }
+}
+
+int SslSessionCache::handle_new_session(SSL * ssl, SSL_SESSION * ssl_session)
+{
+    SslSessionCache * ssl_session_cache = static_cast<SslSessionCache *>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), context_index()));
+    const std::string * key = static_cast<const std::string *>(SSL_get_ex_data(ssl, session_index()));
+    if (nullptr == ssl_session_cache || nullptr == key || key->empty())
+    {
+        return 0;
+    }
+    return ssl_session_cache->insert(*key, ssl_session) ? 1 : 0;
+}
+
+bool SslSessionCache::insert(const std::string & key, SSL_SESSION * ssl_session)
+{
+    if (!SSL_SESSION_is_resumable(ssl_session))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> locker(m_mutex);
+
+    ssl_session_map::iterator iter = m_ssl_session_map.find(key);
+    if (m_ssl_session_map.end() != iter)
+    {
+        SSL_SESSION_free(iter->second.first);
+        iter->second.first = ssl_session;
+        m_ssl_session_keys.splice(m_ssl_session_keys.begin(), m_ssl_session_keys, iter->second.second);
+        return true;
+    }
+
+    if (0 == m_max_session_count)
+    {
+        return false;
+    }
+
+    if (m_ssl_session_map.size() >= m_max_session_count)
+    {
+        erase(m_ssl_session_map.find(m_ssl_session_keys.back()));
+    }
+
+    m_ssl_session_keys.push_front(key);
+    m_ssl_session_map.insert(std::make_pair(key, std::make_pair(ssl_session, m_ssl_session_keys.begin())));
+
+    return true;
+}
+
+void SslSessionCache::remove(const std::string & key)
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    ssl_session_map::iterator iter = m_ssl_session_map.find(key);
+    if (m_ssl_session_map.end() != iter)
+    {
+        erase(iter);
+    }
+}
+
+void SslSessionCache::erase(ssl_session_map::iterator iter)
+{
+    SSL_SESSION_free(iter->second.first);
+    m_ssl_session_keys.erase(iter->second.second);
+    m_ssl_session_map.erase(iter);
+}
+
+} // namespace BoostNet end
@@ -0,0 +1,402 @@
+/********************************************************
+ * Description : ssl session ticket key ring
+ * Data        : 2026-10-19 18:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <openssl/rand.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#endif // OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include "ssl_ticket_key_ring.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+SslTicketKeyRing::SslTicketKeyRing()
+    : m_mutex()
+    , m_ssl_contexts()
+    , m_ticket_keys()
+    , m_keys_file()
+    , m_key_size(0)
+    , m_generate_keys(false)
+    , m_rotate_seconds(0)
+    , m_rotate_timer()
+{
+
+}
+
+SslTicketKeyRing::~SslTicketKeyRing()
+{
+    m_rotate_seconds = 0;
+    detach();
+}
+
+int SslTicketKeyRing::context_index()
+{
+    static const int s_context_index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return s_context_index;
+}
+
+bool SslTicketKeyRing::attach(SSL_CTX * ssl_context)
+{
+    if (nullptr == ssl_context || context_index() < 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> locker(m_mutex);
+
+    if (m_ssl_contexts.end() != std::find(m_ssl_contexts.begin(), m_ssl_contexts.end(), ssl_context))
+    {
+        return true;
+    }
+
+    if (0 == SSL_CTX_set_ex_data(ssl_context, context_index(), this))
+    {
+        return false;
+    }
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(ssl_context, &SslTicketKeyRing::handle_ticket_key);
+#else
+    SSL_CTX_set_tlsext_ticket_key_cb(ssl_context, &SslTicketKeyRing::handle_ticket_key);
+#endif // OPENSSL_VERSION_NUMBER >= 0x30000000L
+
+    SSL_CTX_up_ref(ssl_context);
+    m_ssl_contexts.push_back(ssl_context);
+
+    return true;
+}
+
+void SslTicketKeyRing::detach()
+{
+    ssl_contexts_type ssl_contexts;
+
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        ssl_contexts.swap(m_ssl_contexts);
+    }
+
+    for (ssl_contexts_type::iterator iter = ssl_contexts.begin(); ssl_contexts.end() != iter; ++iter)
+    {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        SSL_CTX_set_tlsext_ticket_key_evp_cb(*iter, nullptr);
+#else
+        SSL_CTX_set_tlsext_ticket_key_cb(*iter, nullptr);
+#endif // OPENSSL_VERSION_NUMBER >= 0x30000000L
+        SSL_CTX_set_ex_data(*iter, context_index(), nullptr);
+        SSL_CTX_free(*iter);
+    }
+}
+
+bool SslTicketKeyRing::attached() const
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return !m_ssl_contexts.empty();
+}
+
+bool SslTicketKeyRing::parse_keys(const unsigned char * data, std::size_t size, std::size_t key_size, ticket_keys_type & ticket_keys)
+{
+    if (0 == key_size)
+    {
+        if (0 == size % 48 && 0 != size % 80)
+        {
+            key_size = 48;
+        }
+        else if (0 == size % 80 && 0 != size % 48)
+        {
+            key_size = 80;
+        }
+    }
+
+    if (48 != key_size && 80 != key_size)
+    {
+        return false;
+    }
+
+    if (0 == size || 0 != size % key_size)
+    {
+        return false;
+    }
+
+    ticket_keys.clear();
+    for (std::size_t offset = 0; offset < size; offset += key_size)
+    {
+        const std::size_t secret_size = (key_size - 16) / 2;
+        ticket_key_type ticket_key;
+        memset(&ticket_key, 0x0, sizeof(ticket_key));
+        memcpy(ticket_key.name, data + offset, 16);
+        memcpy(ticket_key.hmac_key, data + offset + 16, secret_size);
+        memcpy(ticket_key.aes_key, data + offset + 16 + secret_size, secret_size);
+        ticket_key.size = secret_size;
+        ticket_keys.push_back(ticket_key);
+    }
+
+    return true;
+}
+
+bool SslTicketKeyRing::generate_key(ticket_key_type & ticket_key)
+{
+    memset(&ticket_key, 0x0, sizeof(ticket_key));
+    ticket_key.size = 32;
+    return 1 == RAND_bytes(ticket_key.name, sizeof(ticket_key.name)) && 1 == RAND_bytes(ticket_key.hmac_key, sizeof(ticket_key.hmac_key)) && 1 == RAND_bytes(ticket_key.aes_key, sizeof(ticket_key.aes_key));
+}
+
+bool SslTicketKeyRing::load(bool pass_file_not_buffer, const char * keys_file_or_buffer, std::size_t buffer_length, std::size_t key_size)
+{
+    if (nullptr == keys_file_or_buffer)
+    {
+        ticket_key_type ticket_key;
+        if (!generate_key(ticket_key))
+        {
+            return false;
+        }
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_keys_file.clear();
+        m_generate_keys = true;
+        m_ticket_keys.assign(1, ticket_key);
+        return true;
+    }
+
+    if (pass_file_not_buffer)
+    {
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_keys_file = keys_file_or_buffer;
+            m_key_size = key_size;
+            m_generate_keys = false;
+        }
+        return reload();
+    }
+
+    ticket_keys_type ticket_keys;
+    if (!parse_keys(reinterpret_cast<const unsigned char *>(keys_file_or_buffer), buffer_length, key_size, ticket_keys))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_keys_file.clear();
+    m_generate_keys = false;
+    m_ticket_keys.swap(ticket_keys);
+
+    return true;
+}
+
+bool SslTicketKeyRing::reload()
+{
+    std::string keys_file;
+    std::size_t key_size = 0;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        keys_file = m_keys_file;
+        key_size = m_key_size;
+    }
+
+    if (keys_file.empty())
+    {
+        return false;
+    }
+
+    std::ifstream ifs(keys_file.c_str(), std::ios::binary);
+    if (!ifs)
+    {
+        return false;
+    }
+
+    std::vector<char> data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ticket_keys_type ticket_keys;
+    if (data.empty() || !parse_keys(reinterpret_cast<const unsigned char *>(&data[0]), data.size(), key_size, ticket_keys))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_ticket_keys.swap(ticket_keys);
+
+    return true;
+}
+
+void SslTicketKeyRing::rotate()
+{
+    bool generate_keys = false;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        generate_keys = m_generate_keys;
+    }
+
+    if (!generate_keys)
+    {
+        reload();
+        return;
+    }
+
+    ticket_key_type ticket_key;
+    if (!generate_key(ticket_key))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_ticket_keys.insert(m_ticket_keys.begin(), ticket_key);
+    if (m_ticket_keys.size() > max_generated_keys)
+    {
+        m_ticket_keys.resize(max_generated_keys);
+    }
+}
+
+bool SslTicketKeyRing::start(io_context_type & io_context, std::size_t rotate_seconds)
+{
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        if (!m_rotate_timer)
+        {
+            m_rotate_timer.reset(new boost::asio::steady_timer(io_context));
+        }
+    }
+
+    m_rotate_seconds = rotate_seconds;
+    boost::asio::post(m_rotate_timer->get_executor(), [this]() { this->arm_rotate(); });
+
+    return true;
+}
+
+void SslTicketKeyRing::stop()
+{
+    m_rotate_seconds = 0;
+
+    std::lock_guard<std::mutex> locker(m_mutex);
+    if (m_rotate_timer)
+    {
+        boost::asio::post(m_rotate_timer->get_executor(), [this]() { this->arm_rotate(); });
+    }
+}
+
+void SslTicketKeyRing::arm_rotate()
+{
+    const std::size_t rotate_seconds = m_rotate_seconds;
+    if (0 == rotate_seconds)
+    {
+        m_rotate_timer->cancel();
+        return;
+    }
+
+    m_rotate_timer->expires_after(std::chrono::seconds(rotate_seconds));
+    m_rotate_timer->async_wait([this](const boost::system::error_code & error) { this->handle_rotate(error); });
+}
+
+void SslTicketKeyRing::handle_rotate(const boost::system::error_code & error)
+{
+    if (error || 0 == m_rotate_seconds)
+    {
+        return;
+    }
+
+    rotate();
+    arm_rotate();
+}
+
+bool SslTicketKeyRing::find_key(const unsigned char * name, ticket_key_type & ticket_key, bool & primary)
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+
+    if (m_ticket_keys.empty())
+    {
+        return false;
+    }
+
+    if (nullptr == name)
+    {
+        ticket_key = m_ticket_keys.front();
+        primary = true;
+        return true;
+    }
+
+    for (ticket_keys_type::const_iterator iter = m_ticket_keys.begin(); m_ticket_keys.end() != iter; ++iter)
+    {
+        if (0 == memcmp(iter->name, name, sizeof(iter->name)))
+        {
+            ticket_key = *iter;
+            primary = (m_ticket_keys.begin() == iter);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+int SslTicketKeyRing::handle_ticket_key(SSL * ssl, unsigned char * key_name, unsigned char * iv, EVP_CIPHER_CTX * cipher_ctx, EVP_MAC_CTX * hmac_ctx, int encrypt)
+#else
+int SslTicketKeyRing::handle_ticket_key(SSL * ssl, unsigned char * key_name, unsigned char * iv, EVP_CIPHER_CTX * cipher_ctx, HMAC_CTX * hmac_ctx, int encrypt)
+#endif // OPENSSL_VERSION_NUMBER >= 0x30000000L
+{
+    SslTicketKeyRing * ticket_key_ring = static_cast<SslTicketKeyRing *>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), context_index()));
+    if (nullptr == ticket_key_ring)
+    {
+        return encrypt ? -1 : 0;
+    }
+
+    ticket_key_type ticket_key;
+    bool primary = false;
+    if (!ticket_key_ring->find_key(encrypt ? nullptr : key_name, ticket_key, primary))
+    {
+        return encrypt ? -1 : 0;
+    }
+
+    const EVP_CIPHER * cipher = (16 == ticket_key.size) ? EVP_aes_128_cbc() : EVP_aes_256_cbc();
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    char digest[] = "SHA256";
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, ticket_key.hmac_key, ticket_key.size),
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest, 0),
+        OSSL_PARAM_construct_end()
+    };
+#endif // OPENSSL_VERSION_NUMBER >= 0x30000000L
+
+    if (encrypt)
+    {
+        memcpy(key_name, ticket_key.name, sizeof(ticket_key.name));
+        if (1 != RAND_bytes(iv, EVP_CIPHER_iv_length(cipher)))
+        {
+            return -1;
+        }
+        if (1 != EVP_EncryptInit_ex(cipher_ctx, cipher, nullptr, ticket_key.aes_key, iv))
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        if (1 != EVP_DecryptInit_ex(cipher_ctx, cipher, nullptr, ticket_key.aes_key, iv))
+        {
+            return -1;
+        }
+    }
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    if (1 != EVP_MAC_CTX_set_params(hmac_ctx, params))
+    {
+        return -1;
+    }
+#else
+    if (1 != HMAC_Init_ex(hmac_ctx, ticket_key.hmac_key, static_cast<int>(ticket_key.size), EVP_sha256(), nullptr))
+    {
+        return -1;
+    }
+#endif // OPENSSL_VERSION_NUMBER >= 0x30000000L
+
+    return (encrypt || primary) ? 1 : 2;
+}
+
+} // namespace BoostNet end
@@ -0,0 +1,131 @@
+/********************************************************
+ * Description : tcp bulk connector
+ * Data        : 2026-10-19 14:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <chrono>
+#include "tcp_bulk_connector.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+TcpBulkConnector::TcpBulkConnector(io_context_type & io_context, TcpServiceBase * tcp_service, targets_type targets, const void * identity, std::size_t max_in_flight, std::size_t pacing_microseconds, bool pacing_jitter, connect_type connect)
+    : m_io_context(io_context)
+    , m_tcp_service(tcp_service)
+    , m_targets(std::move(targets))
+    , m_identity(identity)
+    , m_max_in_flight(max_in_flight)
+    , m_pacing_microseconds(pacing_microseconds)
+    , m_pacing_jitter(pacing_jitter)
+    , m_pacing_wait(false)
+    , m_finish(false)
+    , m_connect(std::move(connect))
+    , m_pacing_timer(io_context)
+    , m_random(static_cast<std::minstd_rand::result_type>(std::chrono::steady_clock::now().time_since_epoch().count()))
+    , m_next_target(0)
+    , m_in_flight(0)
+    , m_success_count(0)
+    , m_failure_count(0)
+{
+
+}
+
+TcpBulkConnector::~TcpBulkConnector()
+{
+
+}
+
+void TcpBulkConnector::start()
+{
+    boost::asio::post(m_io_context, [self = shared_from_this()]() { self->launch(); });
+}
+
+void TcpBulkConnector::launch()
+{
+    while (!m_pacing_wait && m_in_flight < m_max_in_flight && m_next_target < m_targets.size())
+    {
+        const target_type & target = m_targets[m_next_target++];
+
+        ++m_in_flight;
+
+        bool connecting = false;
+        try
+        {
+            connecting = m_connect(
+                target,
+                [self = shared_from_this()](bool success) {
+                    boost::asio::post(self->m_io_context, [self, success]() { self->handle_connect(success); });
+                }
+            );
+        }
+        catch (...)
+        {
+            connecting = false;
+        }
+
+        if (!connecting)
+        {
+            --m_in_flight;
+            ++m_failure_count;
+        }
+
+        if (0 != m_pacing_microseconds && m_next_target < m_targets.size())
+        {
+            std::size_t pacing_microseconds = m_pacing_microseconds;
+            if (m_pacing_jitter)
+            {
+                pacing_microseconds = std::uniform_int_distribution<std::size_t>(m_pacing_microseconds / 2, m_pacing_microseconds + m_pacing_microseconds / 2)(m_random);
+            }
+            m_pacing_wait = true;
+            m_pacing_timer.expires_after(std::chrono::microseconds(pacing_microseconds));
+            m_pacing_timer.async_wait(
+                [self = shared_from_this()](const boost::system::error_code & error) {
+                    self->handle_pacing(error);
+                }
+            );
+        }
+    }
+
+    if (!m_finish && m_targets.size() == m_next_target && 0 == m_in_flight)
+    {
+        m_finish = true;
+        if (nullptr != m_tcp_service)
+        {
+            m_tcp_service->on_connect_summary(m_identity, m_success_count, m_failure_count);
+        }
+    }
+}
+
+void TcpBulkConnector::handle_connect(bool success)
+{
+    --m_in_flight;
+
+    if (success)
+    {
+        ++m_success_count;
+    }
+    else
+    {
+        ++m_failure_count;
+    }
+
+    launch();
+}
+
+void TcpBulkConnector::handle_pacing(const boost::system::error_code & error)
+{
+    m_pacing_wait = false;
+
+    if (error)
+    {
+        return;
+    }
+
+    launch();
+}
+
+} // namespace BoostNet end
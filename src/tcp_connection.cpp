@@ -33,7 +33,7 @@ void * TcpConnectionBase::get_user_data()
     return m_user_data;
 }
 
-TcpSession::TcpSession(io_context_type & io_context, ssl_context_type & ssl_context, TcpServiceBase * tcp_service, bool passive, const void * identity)
+TcpSession::TcpSession(io_context_type & io_context, ssl_context_ptr ssl_context, TcpServiceBase * tcp_service, bool passive, const void * identity)
     : TcpConnection(io_context, ssl_context, tcp_service, passive, identity, false)
     , m_socket(io_context)
 {
@@ -50,6 +50,21 @@ TcpSession::lowest_type & TcpSession::socket_lowest()
     return m_socket;
 }
 
+TcpSession::offload_type & TcpSession::socket_offload()
+{
+    return m_socket;
+}
+
+void TcpSession::set_ssl_session_cache(SslSessionCache * ssl_session_cache, const std::string & ssl_session_key)
+{
+
+}
+
+void TcpSession::set_handshake_context(io_context_type * handshake_context)
+{
+
+}
+
 void TcpSession::handshake(bool passive)
 {
 
@@ -62,9 +77,33 @@ void TcpSession::shutdown()
     m_socket.close(ignore_error_code);
 }
 
-SslSession::SslSession(io_context_type & io_context, ssl_context_type & ssl_context, TcpServiceBase * tcp_service, bool passive, const void * identity)
+bool TcpSession::send_offload() const
+{
+    return false;
+}
+
+bool TcpSession::recv_offload() const
+{
+    return false;
+}
+
+std::size_t TcpSession::read_offload(const boost::asio::mutable_buffer & buffer, boost::system::error_code & error)
+{
+    return m_socket.read_some(buffer, error);
+}
+
+void TcpSession::alpn_protocol(std::string & protocol)
+{
+    protocol.clear();
+}
+
+SslSession::SslSession(io_context_type & io_context, ssl_context_ptr ssl_context, TcpServiceBase * tcp_service, bool passive, const void * identity)
     : TcpConnection(io_context, ssl_context, tcp_service, passive, identity, true)
-    , m_socket(io_context, ssl_context)
+    , m_socket(io_context, *ssl_context)
+    , m_ssl_session_cache(nullptr)
+    , m_ssl_session_key()
+    , m_kernel_tls()
+    , m_handshake_context(nullptr)
 {
     if (!passive)
     {
@@ -82,20 +121,126 @@ SslSession::lowest_type & SslSession::socket_lowest()
     return m_socket.lowest_layer();
 }
 
+SslSession::offload_type & SslSession::socket_offload()
+{
+    return m_socket.next_layer();
+}
+
+void SslSession::set_ssl_session_cache(SslSessionCache * ssl_session_cache, const std::string & ssl_session_key)
+{
+    m_ssl_session_cache = ssl_session_cache;
+    m_ssl_session_key = ssl_session_key;
+}
+
+void SslSession::set_handshake_context(io_context_type * handshake_context)
+{
+    m_handshake_context = handshake_context;
+}
+
 void SslSession::handshake(bool passive)
 {
-    m_socket.async_handshake(
-        passive ? boost::asio::ssl::stream_base::server : boost::asio::ssl::stream_base::client,
-        [self = shared_from_this()](const boost::system::error_code & error) {
-            self->handle_handshake(error);
+    SslSessionCache * ssl_session_cache = passive ? nullptr : m_ssl_session_cache;
+    if (nullptr != ssl_session_cache)
+    {
+        ssl_session_cache->prepare(m_socket.native_handle(), m_ssl_session_key);
+    }
+
+    m_kernel_tls.prepare(m_socket.native_handle());
+
+    if (nullptr == m_handshake_context)
+    {
+        start_handshake(passive);
+    }
+    else
+    {
+        boost::asio::post(*m_handshake_context, [self = shared_from_this(), passive]() { self->start_handshake(passive); });
+    }
+}
+
+void SslSession::start_handshake(bool passive)
+{
+    SslSessionCache * ssl_session_cache = passive ? nullptr : m_ssl_session_cache;
+    auto handshake_handler = [self = shared_from_this(), ssl_session_cache, passive](const boost::system::error_code & error) {
+        if (nullptr != ssl_session_cache)
+        {
+            ssl_session_cache->complete(self->m_socket.native_handle(), !error);
+        }
+        boost::system::error_code handshake_error = error;
+        if (!handshake_error && !self->m_kernel_tls.install(self->m_socket.native_handle(), self->m_socket.lowest_layer().native_handle(), passive))
+        {
+            handshake_error = boost::asio::error::operation_not_supported;
+        }
+        if (nullptr == self->m_handshake_context)
+        {
+            self->handle_handshake(handshake_error);
+        }
+        else
+        {
+            boost::asio::post(self->io_context(), [self, handshake_error]() { self->handle_handshake(handshake_error); });
         }
-    );
+    };
+
+    boost::asio::ssl::stream_base::handshake_type handshake_type = (passive ? boost::asio::ssl::stream_base::server : boost::asio::ssl::stream_base::client);
+    if (nullptr == m_handshake_context)
+    {
+        m_socket.async_handshake(handshake_type, std::move(handshake_handler));
+    }
+    else
+    {
+        m_socket.async_handshake(handshake_type, boost::asio::bind_executor(*m_handshake_context, std::move(handshake_handler)));
+    }
 }
 
 void SslSession::shutdown()
 {
     boost::system::error_code ignore_error_code;
-    m_socket.shutdown(ignore_error_code);
+    if (m_kernel_tls.send_offload())
+    {
+        m_kernel_tls.shutdown(m_socket.lowest_layer().native_handle());
+        m_socket.lowest_layer().shutdown(lowest_type::shutdown_both, ignore_error_code);
+        m_socket.lowest_layer().close(ignore_error_code);
+    }
+    else
+    {
+        m_socket.shutdown(ignore_error_code);
+    }
+}
+
+bool SslSession::send_offload() const
+{
+    return m_kernel_tls.send_offload();
+}
+
+bool SslSession::recv_offload() const
+{
+    return m_kernel_tls.recv_offload();
+}
+
+std::size_t SslSession::read_offload(const boost::asio::mutable_buffer & buffer, boost::system::error_code & error)
+{
+    int recv_error = 0;
+    std::size_t recv_size = m_kernel_tls.recv(m_socket.lowest_layer().native_handle(), buffer.data(), buffer.size(), recv_error);
+    if (0 != recv_error)
+    {
+        error = boost::system::error_code(recv_error, boost::asio::error::get_system_category());
+    }
+    else if (0 == recv_size && 0 != buffer.size())
+    {
+        error = boost::asio::error::eof;
+    }
+    else
+    {
+        error.clear();
+    }
+    return recv_size;
+}
+
+void SslSession::alpn_protocol(std::string & protocol)
+{
+    const unsigned char * data = nullptr;
+    unsigned int size = 0;
+    SSL_get0_alpn_selected(m_socket.native_handle(), &data, &size);
+    protocol.assign(reinterpret_cast<const char *>(data), nullptr == data ? 0 : size);
 }
 
 } // namespace BoostNet end
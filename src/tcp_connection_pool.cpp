@@ -0,0 +1,240 @@
+/********************************************************
+ * Description : tcp connection pool
+ * Data        : 2026-10-19 10:30:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <boost/lexical_cast.hpp>
+#include "tcp_connection_pool.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+TcpConnectionPool::TcpConnectionPool()
+    : m_mutex()
+    , m_idle_connection_map()
+    , m_idle_count(0)
+    , m_max_idle_per_key(8)
+    , m_max_idle_total(1024)
+    , m_max_idle_milliseconds(60000)
+    , m_purge_timer()
+    , m_purge_waiting(false)
+{
+
+}
+
+TcpConnectionPool::~TcpConnectionPool()
+{
+    stop();
+    clear();
+}
+
+std::string TcpConnectionPool::make_key(const std::string & host, const std::string & service, const char * bind_ip, unsigned short bind_port, bool use_ssl)
+{
+    std::string key(use_ssl ? "ssl://" : "tcp://");
+    key += host;
+    key += ":";
+    key += service;
+    key += "@";
+    key += (nullptr == bind_ip || '\0' == *bind_ip) ? "0.0.0.0" : bind_ip;
+    key += ":";
+    key += boost::lexical_cast<std::string>(bind_port);
+    return key;
+}
+
+void TcpConnectionPool::set_limit(std::size_t max_idle_per_key, std::size_t max_idle_total, std::size_t max_idle_milliseconds)
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_max_idle_per_key = max_idle_per_key;
+    m_max_idle_total = max_idle_total;
+    m_max_idle_milliseconds = max_idle_milliseconds;
+    m_purge_waiting = false;
+    start_purge_timer();
+}
+
+void TcpConnectionPool::purge(std::deque<connection_ptr> & expired_connections)
+{
+    const clock_type::time_point expire_time = clock_type::now() - std::chrono::milliseconds(m_max_idle_milliseconds);
+    idle_connection_map::iterator iter = m_idle_connection_map.begin();
+    while (m_idle_connection_map.end() != iter)
+    {
+        idle_connections_type & idle_connections = iter->second;
+        while (!idle_connections.empty() && (idle_connections.front().second < expire_time || !idle_connections.front().first->pool_alive()))
+        {
+            expired_connections.push_back(idle_connections.front().first);
+            idle_connections.pop_front();
+            --m_idle_count;
+        }
+        if (idle_connections.empty())
+        {
+            iter = m_idle_connection_map.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+bool TcpConnectionPool::insert(const std::string & key, connection_ptr connection)
+{
+    std::deque<connection_ptr> expired_connections;
+    bool inserted = false;
+
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        purge(expired_connections);
+        if (m_idle_count < m_max_idle_total)
+        {
+            idle_connections_type & idle_connections = m_idle_connection_map[key];
+            if (idle_connections.size() < m_max_idle_per_key)
+            {
+                idle_connections.push_back(std::make_pair(connection, clock_type::now()));
+                ++m_idle_count;
+                inserted = true;
+                start_purge_timer();
+            }
+            else if (idle_connections.empty())
+            {
+                m_idle_connection_map.erase(key);
+            }
+        }
+    }
+
+    for (std::deque<connection_ptr>::iterator iter = expired_connections.begin(); expired_connections.end() != iter; ++iter)
+    {
+        (*iter)->close();
+    }
+
+    return inserted;
+}
+
+TcpConnectionPool::connection_ptr TcpConnectionPool::remove(const std::string & key)
+{
+    std::deque<connection_ptr> expired_connections;
+    connection_ptr connection;
+
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        purge(expired_connections);
+        idle_connection_map::iterator iter = m_idle_connection_map.find(key);
+        if (m_idle_connection_map.end() != iter)
+        {
+            idle_connections_type & idle_connections = iter->second;
+            while (!idle_connections.empty() && !connection)
+            {
+                if (idle_connections.back().first->pool_alive())
+                {
+                    connection = idle_connections.back().first;
+                }
+                else
+                {
+                    expired_connections.push_back(idle_connections.back().first);
+                }
+                idle_connections.pop_back();
+                --m_idle_count;
+            }
+            if (idle_connections.empty())
+            {
+                m_idle_connection_map.erase(iter);
+            }
+        }
+    }
+
+    for (std::deque<connection_ptr>::iterator iter = expired_connections.begin(); expired_connections.end() != iter; ++iter)
+    {
+        (*iter)->close();
+    }
+
+    return connection;
+}
+
+void TcpConnectionPool::clear()
+{
+    idle_connection_map idle_connection_map;
+
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        idle_connection_map.swap(m_idle_connection_map);
+        m_idle_count = 0;
+    }
+
+    for (idle_connection_map::iterator iter = idle_connection_map.begin(); idle_connection_map.end() != iter; ++iter)
+    {
+        for (idle_connections_type::iterator iter_connection = iter->second.begin(); iter->second.end() != iter_connection; ++iter_connection)
+        {
+            iter_connection->first->close();
+        }
+    }
+}
+
+bool TcpConnectionPool::start(io_context_type & io_context)
+{
+    stop();
+
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_purge_timer.reset(new boost::asio::steady_timer(io_context));
+    m_purge_waiting = false;
+    start_purge_timer();
+
+    return true;
+}
+
+void TcpConnectionPool::stop()
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    if (m_purge_timer)
+    {
+        m_purge_timer->cancel();
+        m_purge_timer.reset();
+    }
+    m_purge_waiting = false;
+}
+
+void TcpConnectionPool::start_purge_timer()
+{
+    if (!m_purge_timer || m_purge_waiting || 0 == m_idle_count)
+    {
+        return;
+    }
+
+    clock_type::time_point oldest_time = clock_type::time_point::max();
+    for (idle_connection_map::const_iterator iter = m_idle_connection_map.begin(); m_idle_connection_map.end() != iter; ++iter)
+    {
+        if (!iter->second.empty() && iter->second.front().second < oldest_time)
+        {
+            oldest_time = iter->second.front().second;
+        }
+    }
+
+    m_purge_waiting = true;
+    m_purge_timer->expires_at(oldest_time + std::chrono::milliseconds(m_max_idle_milliseconds + 1));
+    m_purge_timer->async_wait([this](const boost::system::error_code & error) { this->handle_purge(error); });
+}
+
+void TcpConnectionPool::handle_purge(const boost::system::error_code & error)
+{
+    if (error)
+    {
+        return;
+    }
+
+    std::deque<connection_ptr> expired_connections;
+
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_purge_waiting = false;
+        purge(expired_connections);
+        start_purge_timer();
+    }
+
+    for (std::deque<connection_ptr>::iterator iter = expired_connections.begin(); expired_connections.end() != iter; ++iter)
+    {
+        (*iter)->close();
+    }
+}
+
+} // namespace BoostNet end
@@ -0,0 +1,331 @@
+/********************************************************
+ * Description : tcp listener
+ * Data        : 2026-10-19 22:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+#include <boost/core/ignore_unused.hpp>
+#include <boost/functional/factory.hpp>
+#include "tcp_listener.h"
+#include "ssl_kernel_tls.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+static std::string lower_server_name(const char * server_name)
+{
+    std::string name(server_name);
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return name;
+}
+
+TcpListener::TcpListener()
+    : m_ssl_contexts()
+    , m_server_names()
+    , m_alpn_protocols()
+    , m_ciphers()
+    , m_port(0)
+{
+
+}
+
+TcpListener::~TcpListener()
+{
+
+}
+
+bool TcpListener::init(const Listener & listener)
+{
+    if (nullptr == listener.certificate)
+    {
+        return 0 == listener.sni_certificate_count;
+    }
+
+    if (nullptr == listener.sni_certificate_array && 0 != listener.sni_certificate_count)
+    {
+        return false;
+    }
+
+    if (!parse_alpn_protocols(listener.alpn_protocols, m_alpn_protocols))
+    {
+        return false;
+    }
+
+    m_ciphers = (nullptr != listener.ciphers ? listener.ciphers : "");
+
+    ssl_context_ptr ssl_context = create_ssl_context(listener.certificate);
+    if (!ssl_context)
+    {
+        return false;
+    }
+    m_ssl_contexts.push_back(ssl_context);
+
+    for (std::size_t index = 0; index < listener.sni_certificate_count; ++index)
+    {
+        const SniCertificate & sni_certificate = listener.sni_certificate_array[index];
+        if (nullptr == sni_certificate.server_name || '\0' == *sni_certificate.server_name)
+        {
+            return false;
+        }
+        ssl_context_ptr sni_context = create_ssl_context(sni_certificate.certificate);
+        if (!sni_context)
+        {
+            return false;
+        }
+        m_ssl_contexts.push_back(sni_context);
+        m_server_names[lower_server_name(sni_certificate.server_name)] = sni_context->native_handle();
+    }
+
+    if (!m_server_names.empty())
+    {
+        SSL_CTX * ssl_context = m_ssl_contexts.front()->native_handle();
+        SSL_CTX_set_tlsext_servername_callback(ssl_context, &TcpListener::handle_server_name);
+        SSL_CTX_set_tlsext_servername_arg(ssl_context, this);
+    }
+
+    return true;
+}
+
+TcpListener::ssl_context_ptr TcpListener::create_ssl_context(const Certificate * certificate)
+{
+    if (nullptr == certificate || nullptr == certificate->cert_file_or_buffer || nullptr == certificate->key_file_or_buffer)
+    {
+        return ssl_context_ptr();
+    }
+
+    ssl_context_ptr ssl_context = boost::factory<ssl_context_ptr>()(boost::asio::ssl::context::sslv23_server);
+
+    boost::system::error_code error;
+
+    ssl_context->set_options(boost::asio::ssl::context::default_workarounds | boost::asio::ssl::context::no_sslv2 | (nullptr == certificate->dh_file_or_buffer ? 0 : boost::asio::ssl::context::single_dh_use), error);
+
+    if (nullptr != certificate->password)
+    {
+        std::string password(certificate->password);
+        ssl_context->set_password_callback(
+            [password](std::size_t max_length, boost::asio::ssl::context::password_purpose purpose) {
+                boost::ignore_unused(max_length);
+                boost::ignore_unused(purpose);
+                return password;
+            }, error
+        );
+    }
+
+    if (certificate->pass_file_not_buffer)
+    {
+        if (!error)
+        {
+            ssl_context->use_certificate_chain_file(certificate->cert_file_or_buffer, error);
+        }
+        if (!error)
+        {
+            ssl_context->use_private_key_file(certificate->key_file_or_buffer, boost::asio::ssl::context::pem, error);
+        }
+        if (!error && nullptr != certificate->dh_file_or_buffer)
+        {
+            ssl_context->use_tmp_dh_file(certificate->dh_file_or_buffer, error);
+        }
+    }
+    else
+    {
+        if (!error)
+        {
+            ssl_context->use_certificate_chain(boost::asio::buffer(certificate->cert_file_or_buffer, strlen(certificate->cert_file_or_buffer)), error);
+        }
+        if (!error)
+        {
+            ssl_context->use_private_key(boost::asio::buffer(certificate->key_file_or_buffer, strlen(certificate->key_file_or_buffer)), boost::asio::ssl::context::pem, error);
+        }
+        if (!error && nullptr != certificate->dh_file_or_buffer)
+        {
+            ssl_context->use_tmp_dh(boost::asio::buffer(certificate->dh_file_or_buffer, strlen(certificate->dh_file_or_buffer)), error);
+        }
+    }
+
+    if (error)
+    {
+        return ssl_context_ptr();
+    }
+
+    if (!m_ciphers.empty() && 1 != SSL_CTX_set_cipher_list(ssl_context->native_handle(), m_ciphers.c_str()))
+    {
+        return ssl_context_ptr();
+    }
+
+    if (!m_alpn_protocols.empty())
+    {
+        SSL_CTX_set_alpn_select_cb(ssl_context->native_handle(), &TcpListener::handle_alpn_select, this);
+    }
+
+    return ssl_context;
+}
+
+TcpListener::ssl_context_ptr TcpListener::create_default_context(const Certificate * certificate)
+{
+    if (m_ssl_contexts.empty())
+    {
+        return ssl_context_ptr();
+    }
+
+    ssl_context_ptr ssl_context = create_ssl_context(certificate);
+    if (ssl_context && !m_server_names.empty())
+    {
+        SSL_CTX_set_tlsext_servername_callback(ssl_context->native_handle(), &TcpListener::handle_server_name);
+        SSL_CTX_set_tlsext_servername_arg(ssl_context->native_handle(), this);
+    }
+
+    return ssl_context;
+}
+
+void TcpListener::set_default_context(ssl_context_ptr ssl_context)
+{
+    if (!m_ssl_contexts.empty() && ssl_context)
+    {
+        std::atomic_store(&m_ssl_contexts.front(), ssl_context);
+    }
+}
+
+void TcpListener::set_port(unsigned short port)
+{
+    m_port = port;
+}
+
+unsigned short TcpListener::port() const
+{
+    return m_port;
+}
+
+bool TcpListener::set_kernel_tls(bool enable)
+{
+    for (ssl_contexts_type::iterator iter = m_ssl_contexts.begin(); m_ssl_contexts.end() != iter; ++iter)
+    {
+        if (!SslKernelTls::enable((*iter)->native_handle(), enable))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TcpListener::set_session_cache(std::size_t cache_size, std::size_t timeout_seconds)
+{
+    for (ssl_contexts_type::iterator iter = m_ssl_contexts.begin(); m_ssl_contexts.end() != iter; ++iter)
+    {
+        SSL_CTX * ssl_context = (*iter)->native_handle();
+        SSL_CTX_set_session_cache_mode(ssl_context, 0 == cache_size ? SSL_SESS_CACHE_OFF : SSL_SESS_CACHE_SERVER);
+        SSL_CTX_sess_set_cache_size(ssl_context, static_cast<long>(cache_size));
+        SSL_CTX_set_timeout(ssl_context, static_cast<long>(timeout_seconds));
+    }
+    return true;
+}
+
+bool TcpListener::set_ticket_key_ring(SslTicketKeyRing & ticket_key_ring)
+{
+    for (ssl_contexts_type::iterator iter = m_ssl_contexts.begin(); m_ssl_contexts.end() != iter; ++iter)
+    {
+        if (!ticket_key_ring.attach((*iter)->native_handle()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TcpListener::ssl_enable() const
+{
+    return !m_ssl_contexts.empty();
+}
+
+TcpListener::ssl_context_ptr TcpListener::ssl_context()
+{
+    return m_ssl_contexts.empty() ? ssl_context_ptr() : std::atomic_load(&m_ssl_contexts.front());
+}
+
+bool TcpListener::parse_alpn_protocols(const char * alpn_protocols, alpn_protocols_type & protocols)
+{
+    protocols.clear();
+
+    if (nullptr == alpn_protocols)
+    {
+        return true;
+    }
+
+    const char * protocol = alpn_protocols;
+    while (true)
+    {
+        const char * protocol_end = strchr(protocol, ',');
+        std::size_t protocol_size = (nullptr == protocol_end ? strlen(protocol) : static_cast<std::size_t>(protocol_end - protocol));
+        if (0 == protocol_size || protocol_size > 255)
+        {
+            return false;
+        }
+        protocols.push_back(static_cast<unsigned char>(protocol_size));
+        protocols.insert(protocols.end(), protocol, protocol + protocol_size);
+        if (nullptr == protocol_end)
+        {
+            break;
+        }
+        protocol = protocol_end + 1;
+    }
+
+    return true;
+}
+
+int TcpListener::handle_server_name(SSL * ssl, int * alert, void * arg)
+{
+    boost::ignore_unused(alert);
+
+    TcpListener * listener = reinterpret_cast<TcpListener *>(arg);
+    const char * server_name = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+    if (nullptr == listener || nullptr == server_name)
+    {
+        return SSL_TLSEXT_ERR_OK;
+    }
+
+    std::string name(lower_server_name(server_name));
+    server_names_type::const_iterator iter = listener->m_server_names.find(name);
+    if (listener->m_server_names.end() == iter)
+    {
+        std::string::size_type dot = name.find('.');
+        if (std::string::npos != dot)
+        {
+            iter = listener->m_server_names.find("*" + name.substr(dot));
+        }
+    }
+
+    if (listener->m_server_names.end() != iter)
+    {
+        SSL_set_SSL_CTX(ssl, iter->second);
+    }
+
+    return SSL_TLSEXT_ERR_OK;
+}
+
+int TcpListener::handle_alpn_select(SSL * ssl, const unsigned char ** out, unsigned char * outlen, const unsigned char * in, unsigned int inlen, void * arg)
+{
+    boost::ignore_unused(ssl);
+
+    TcpListener * listener = reinterpret_cast<TcpListener *>(arg);
+    if (nullptr == listener || listener->m_alpn_protocols.empty())
+    {
+        return SSL_TLSEXT_ERR_NOACK;
+    }
+
+    unsigned char * selected = nullptr;
+    if (OPENSSL_NPN_NEGOTIATED != SSL_select_next_proto(&selected, outlen, listener->m_alpn_protocols.data(), static_cast<unsigned int>(listener->m_alpn_protocols.size()), in, inlen))
+    {
+        return SSL_TLSEXT_ERR_NOACK;
+    }
+
+    *out = selected;
+
+    return SSL_TLSEXT_ERR_OK;
+}
+
+} // namespace BoostNet end
@@ -72,6 +72,26 @@ void TcpManager::get_ports(std::vector<unsigned short> & ports)
     }
 }
 
+bool TcpManager::add_listener(const Listener & listener)
+{
+    return nullptr != m_manager_impl && m_manager_impl->add_listener(listener);
+}
+
+bool TcpManager::reload_server_certificate(const Certificate * server_certificate)
+{
+    return nullptr != m_manager_impl && m_manager_impl->reload_server_certificate(server_certificate);
+}
+
+bool TcpManager::reload_client_certificate(const Certificate * client_certificate)
+{
+    return nullptr != m_manager_impl && m_manager_impl->reload_client_certificate(client_certificate);
+}
+
+bool TcpManager::reload_listener_certificate(unsigned short port, const Certificate * certificate)
+{
+    return nullptr != m_manager_impl && m_manager_impl->reload_listener_certificate(port, certificate);
+}
+
 bool TcpManager::create_connection(const std::string & host, const std::string & service, bool sync_connect, const void * identity, const char * bind_ip, unsigned short bind_port)
 {
     return nullptr != m_manager_impl && m_manager_impl->create_connection(host, service, sync_connect, identity, bind_ip, bind_port);
@@ -82,4 +102,103 @@ bool TcpManager::create_connection(const std::string & host, unsigned short port
     return nullptr != m_manager_impl && m_manager_impl->create_connection(host, port, sync_connect, identity, bind_ip, bind_port);
 }
 
+bool TcpManager::set_connect_attempt(std::size_t attempt_delay_milliseconds, std::size_t attempt_timeout_milliseconds)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_connect_attempt(attempt_delay_milliseconds, attempt_timeout_milliseconds);
+}
+
+bool TcpManager::set_connection_pool(std::size_t max_idle_per_key, std::size_t max_idle_total, std::size_t max_idle_milliseconds)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_connection_pool(max_idle_per_key, max_idle_total, max_idle_milliseconds);
+}
+
+bool TcpManager::acquire_connection(const std::string & host, const std::string & service, const void * identity, const char * bind_ip, unsigned short bind_port)
+{
+    return nullptr != m_manager_impl && m_manager_impl->acquire_connection(host, service, identity, bind_ip, bind_port);
+}
+
+bool TcpManager::acquire_connection(const std::string & host, unsigned short port, const void * identity, const char * bind_ip, unsigned short bind_port)
+{
+    return nullptr != m_manager_impl && m_manager_impl->acquire_connection(host, port, identity, bind_ip, bind_port);
+}
+
+bool TcpManager::release_connection(TcpConnectionSharedPtr connection)
+{
+    return nullptr != m_manager_impl && m_manager_impl->release_connection(connection);
+}
+
+bool TcpManager::prewarm_connection(const std::string & host, const std::string & service, std::size_t count, const char * bind_ip, unsigned short bind_port)
+{
+    return nullptr != m_manager_impl && m_manager_impl->prewarm_connection(host, service, count, bind_ip, bind_port);
+}
+
+bool TcpManager::prewarm_connection(const std::string & host, unsigned short port, std::size_t count, const char * bind_ip, unsigned short bind_port)
+{
+    return nullptr != m_manager_impl && m_manager_impl->prewarm_connection(host, port, count, bind_ip, bind_port);
+}
+
+bool TcpManager::create_connections(const ConnectTarget * target_array, std::size_t target_count, const void * identity, std::size_t max_in_flight, std::size_t pacing_microseconds, bool pacing_jitter, const char * bind_ip, unsigned short bind_port)
+{
+    return nullptr != m_manager_impl && m_manager_impl->create_connections(target_array, target_count, identity, max_in_flight, pacing_microseconds, pacing_jitter, bind_ip, bind_port);
+}
+
+bool TcpManager::create_connections(const std::string & host, unsigned short port, std::size_t count, const void * identity, std::size_t max_in_flight, std::size_t pacing_microseconds, bool pacing_jitter, const char * bind_ip, unsigned short bind_port)
+{
+    return nullptr != m_manager_impl && m_manager_impl->create_connections(host, port, count, identity, max_in_flight, pacing_microseconds, pacing_jitter, bind_ip, bind_port);
+}
+
+bool TcpManager::set_ssl_session_cache(std::size_t max_session_count)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_ssl_session_cache(max_session_count);
+}
+
+void TcpManager::get_ssl_session_statistics(std::size_t & hit_count, std::size_t & miss_count)
+{
+    if (nullptr != m_manager_impl)
+    {
+        m_manager_impl->get_ssl_session_statistics(hit_count, miss_count);
+    }
+}
+
+bool TcpManager::set_ssl_server_session_cache(std::size_t cache_size, std::size_t timeout_seconds)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_ssl_server_session_cache(cache_size, timeout_seconds);
+}
+
+bool TcpManager::set_ssl_ticket_keys(bool pass_file_not_buffer, const char * keys_file_or_buffer, std::size_t buffer_length, std::size_t rotate_seconds, std::size_t key_size)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_ssl_ticket_keys(pass_file_not_buffer, keys_file_or_buffer, buffer_length, rotate_seconds, key_size);
+}
+
+bool TcpManager::set_ssl_handshake_pool(std::size_t thread_count)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_ssl_handshake_pool(thread_count);
+}
+
+bool TcpManager::set_ssl_record_sizing(std::size_t small_record_size, std::size_t small_record_count, std::size_t idle_milliseconds)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_ssl_record_sizing(small_record_size, small_record_count, idle_milliseconds);
+}
+
+bool TcpManager::set_ssl_kernel_tls(bool enable)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_ssl_kernel_tls(enable);
+}
+
+bool TcpManager::set_rate_limit(std::size_t send_bytes_per_second, std::size_t recv_bytes_per_second, std::size_t listener_send_bytes_per_second, std::size_t listener_recv_bytes_per_second, std::size_t burst_bytes)
+{
+    RateLimit limit;
+    limit.send_bytes_per_second = send_bytes_per_second;
+    limit.recv_bytes_per_second = recv_bytes_per_second;
+    limit.listener_send_bytes_per_second = listener_send_bytes_per_second;
+    limit.listener_recv_bytes_per_second = listener_recv_bytes_per_second;
+    limit.burst_bytes = burst_bytes;
+    return nullptr != m_manager_impl && m_manager_impl->set_rate_limit(limit);
+}
+
+bool TcpManager::set_timestamping(bool recv_enable, bool send_enable)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_timestamping(recv_enable, send_enable);
+}
+
 } // namespace BoostNet end
@@ -17,17 +17,39 @@
 namespace BoostNet { // namespace BoostNet begin
 
 TcpManagerImpl::TcpManagerImpl()
-    : m_io_context_pool()
+    : m_handshake_context_pools()
+    , m_io_context_pool()
+    , m_handshake_pool_enable(false)
     , m_acceptors()
-    , m_server_ssl_context(boost::asio::ssl::context::sslv23_server)
-    , m_client_ssl_context(boost::asio::ssl::context::sslv23_client)
-    , m_server_ssl_password()
-    , m_client_ssl_password()
+    , m_listeners()
+    , m_server_ssl_context(boost::factory<ssl_context_ptr>()(boost::asio::ssl::context::sslv23_server))
+    , m_client_ssl_context(boost::factory<ssl_context_ptr>()(boost::asio::ssl::context::sslv23_client))
     , m_server_ssl_enable(false)
     , m_client_ssl_enable(false)
     , m_tcp_service(nullptr)
     , m_tcp_ports()
+    , m_connect_attempt_delay(250)
+    , m_connect_attempt_timeout(0)
+    , m_connection_pool()
+    , m_ssl_session_cache()
+    , m_ssl_ticket_key_ring()
+    , m_server_session_cache_size(SSL_SESSION_CACHE_MAX_SIZE_DEFAULT)
+    , m_server_session_timeout(300)
+    , m_record_small_size(0)
+    , m_record_small_count(0)
+    , m_record_idle(0)
+    , m_kernel_tls_enable(false)
+    , m_rate_limit_mutex()
+    , m_rate_limit()
+    , m_listener_rate_buckets()
+    , m_timestamp_recv(false)
+    , m_timestamp_send(false)
 {
+    m_rate_limit.send_bytes_per_second = 0;
+    m_rate_limit.recv_bytes_per_second = 0;
+    m_rate_limit.listener_send_bytes_per_second = 0;
+    m_rate_limit.listener_recv_bytes_per_second = 0;
+    m_rate_limit.burst_bytes = 0;
 
 }
 
@@ -36,17 +58,12 @@ TcpManagerImpl::~TcpManagerImpl()
 
 }
 
-const std::string & TcpManagerImpl::get_server_ssl_password() const
+TcpManagerImpl::io_context_type * TcpManagerImpl::get_handshake_context()
 {
-    return m_server_ssl_password;
+    return m_handshake_pool_enable ? &m_handshake_context_pools.back().get() : nullptr;
 }
 
-const std::string & TcpManagerImpl::get_client_ssl_password() const
-{
-    return m_client_ssl_password;
-}
-
-bool TcpManagerImpl::set_server_certificate(const Certificate * certificate)
+bool TcpManagerImpl::set_server_certificate(ssl_context_type & ssl_context, const Certificate * certificate)
 {
     if (nullptr == certificate)
     {
@@ -60,45 +77,45 @@ bool TcpManagerImpl::set_server_certificate(const Certificate * certificate)
 
     m_server_ssl_enable = true;
 
-    m_server_ssl_context.set_options(boost::asio::ssl::context::default_workarounds | boost::asio::ssl::context::no_sslv2 | (nullptr == certificate->dh_file_or_buffer ? 0 : boost::asio::ssl::context::single_dh_use));
+    ssl_context.set_options(boost::asio::ssl::context::default_workarounds | boost::asio::ssl::context::no_sslv2 | (nullptr == certificate->dh_file_or_buffer ? 0 : boost::asio::ssl::context::single_dh_use));
 
     if (nullptr != certificate->password)
     {
-        m_server_ssl_password = certificate->password;
-        m_server_ssl_context.set_password_callback(
-            [this](std::size_t max_length, boost::asio::ssl::context::password_purpose purpose) {
+        std::string password(certificate->password);
+        ssl_context.set_password_callback(
+            [password](std::size_t max_length, boost::asio::ssl::context::password_purpose purpose) {
                 boost::ignore_unused(max_length);
                 boost::ignore_unused(purpose);
-                return this->get_server_ssl_password(); 
+                return password;
             }
         );
     }
 
     if (certificate->pass_file_not_buffer)
     {
-        m_server_ssl_context.use_certificate_chain_file(certificate->cert_file_or_buffer);
-        m_server_ssl_context.use_private_key_file(certificate->key_file_or_buffer, boost::asio::ssl::context::pem);
+        ssl_context.use_certificate_chain_file(certificate->cert_file_or_buffer);
+        ssl_context.use_private_key_file(certificate->key_file_or_buffer, boost::asio::ssl::context::pem);
 
         if (nullptr != certificate->dh_file_or_buffer)
         {
-            m_server_ssl_context.use_tmp_dh_file(certificate->dh_file_or_buffer);
+            ssl_context.use_tmp_dh_file(certificate->dh_file_or_buffer);
         }
     }
     else
     {
-        m_server_ssl_context.use_certificate_chain(boost::asio::buffer(certificate->cert_file_or_buffer, strlen(certificate->cert_file_or_buffer)));
-        m_server_ssl_context.use_private_key(boost::asio::buffer(certificate->key_file_or_buffer, strlen(certificate->key_file_or_buffer)), boost::asio::ssl::context::pem);
+        ssl_context.use_certificate_chain(boost::asio::buffer(certificate->cert_file_or_buffer, strlen(certificate->cert_file_or_buffer)));
+        ssl_context.use_private_key(boost::asio::buffer(certificate->key_file_or_buffer, strlen(certificate->key_file_or_buffer)), boost::asio::ssl::context::pem);
 
         if (nullptr != certificate->dh_file_or_buffer)
         {
-            m_server_ssl_context.use_tmp_dh(boost::asio::buffer(certificate->dh_file_or_buffer, strlen(certificate->dh_file_or_buffer)));
+            ssl_context.use_tmp_dh(boost::asio::buffer(certificate->dh_file_or_buffer, strlen(certificate->dh_file_or_buffer)));
         }
     }
 
     return true;
 }
 
-bool TcpManagerImpl::set_client_certificate(const Certificate * certificate)
+bool TcpManagerImpl::set_client_certificate(ssl_context_type & ssl_context, const Certificate * certificate)
 {
     if (nullptr == certificate)
     {
@@ -114,32 +131,32 @@ bool TcpManagerImpl::set_client_certificate(const Certificate * certificate)
 
     if (nullptr != certificate->password)
     {
-        m_client_ssl_password = certificate->password;
-        m_client_ssl_context.set_password_callback(
-            [this](std::size_t max_length, boost::asio::ssl::context::password_purpose purpose) {
+        std::string password(certificate->password);
+        ssl_context.set_password_callback(
+            [password](std::size_t max_length, boost::asio::ssl::context::password_purpose purpose) {
                 boost::ignore_unused(max_length);
                 boost::ignore_unused(purpose);
-                return this->get_client_ssl_password();
+                return password;
             }
         );
     }
 
     if (certificate->pass_file_not_buffer)
     {
-        m_client_ssl_context.load_verify_file(certificate->cert_file_or_buffer);
+        ssl_context.load_verify_file(certificate->cert_file_or_buffer);
         if (nullptr != certificate->key_file_or_buffer)
         {
-            m_client_ssl_context.use_certificate_file(certificate->cert_file_or_buffer, boost::asio::ssl::context::pem);
-            m_client_ssl_context.use_private_key_file(certificate->key_file_or_buffer, boost::asio::ssl::context::pem);
+            ssl_context.use_certificate_file(certificate->cert_file_or_buffer, boost::asio::ssl::context::pem);
+            ssl_context.use_private_key_file(certificate->key_file_or_buffer, boost::asio::ssl::context::pem);
         }
     }
     else
     {
-        m_client_ssl_context.add_certificate_authority(boost::asio::buffer(certificate->cert_file_or_buffer, strlen(certificate->cert_file_or_buffer)));
+        ssl_context.add_certificate_authority(boost::asio::buffer(certificate->cert_file_or_buffer, strlen(certificate->cert_file_or_buffer)));
         if (nullptr != certificate->key_file_or_buffer)
         {
-            m_client_ssl_context.use_certificate(boost::asio::buffer(certificate->cert_file_or_buffer, strlen(certificate->cert_file_or_buffer)), boost::asio::ssl::context::pem);
-            m_client_ssl_context.use_private_key(boost::asio::buffer(certificate->key_file_or_buffer, strlen(certificate->key_file_or_buffer)), boost::asio::ssl::context::pem);
+            ssl_context.use_certificate(boost::asio::buffer(certificate->cert_file_or_buffer, strlen(certificate->cert_file_or_buffer)), boost::asio::ssl::context::pem);
+            ssl_context.use_private_key(boost::asio::buffer(certificate->key_file_or_buffer, strlen(certificate->key_file_or_buffer)), boost::asio::ssl::context::pem);
         }
     }
 
@@ -163,8 +180,13 @@ bool TcpManagerImpl::init(TcpServiceBase * tcp_service, std::size_t thread_count
         return false;
     }
 
-    set_server_certificate(server_certificate);
-    set_client_certificate(client_certificate);
+    set_server_certificate(*m_server_ssl_context, server_certificate);
+    set_client_certificate(*m_client_ssl_context, client_certificate);
+
+    if (m_client_ssl_enable)
+    {
+        m_ssl_session_cache.attach(m_client_ssl_context->native_handle());
+    }
 
     if (m_io_context_pool.size() > 0)
     {
@@ -176,6 +198,8 @@ bool TcpManagerImpl::init(TcpServiceBase * tcp_service, std::size_t thread_count
         return false;
     }
 
+    m_connection_pool.start(m_io_context_pool.get());
+
     m_tcp_service = tcp_service;
 
     m_tcp_ports.clear();
@@ -204,7 +228,7 @@ bool TcpManagerImpl::init(TcpServiceBase * tcp_service, std::size_t thread_count
                     endpoint_type endpoint(boost::asio::ip::make_address(nullptr == host ? "0.0.0.0" : host), port);
                     bool reuse_address = true;
                     m_acceptors.push_back(boost::factory<acceptor_type *>()(m_io_context_pool.get(), endpoint, reuse_address));
-                    start_accept(m_acceptors.back(), port);
+                    start_accept(m_acceptors.back(), port, nullptr);
                     m_tcp_ports.push_back(port);
                     break;
                 }
@@ -249,7 +273,7 @@ bool TcpManagerImpl::init(TcpServiceBase * tcp_service, std::size_t thread_count
                     endpoint_type endpoint(boost::asio::ip::make_address(nullptr == host ? "0.0.0.0" : host), port);
                     bool reuse_address = true;
                     m_acceptors.push_back(boost::factory<acceptor_type *>()(m_io_context_pool.get(), endpoint, reuse_address));
-                    start_accept(m_acceptors.back(), port);
+                    start_accept(m_acceptors.back(), port, nullptr);
                 }
             }
             m_tcp_ports.assign(port_array, port_array + port_count);
@@ -271,8 +295,24 @@ bool TcpManagerImpl::init(TcpServiceBase * tcp_service, std::size_t thread_count
 
 void TcpManagerImpl::exit()
 {
+    m_ssl_ticket_key_ring.stop();
+    m_connection_pool.stop();
+    m_connection_pool.clear();
+    m_handshake_pool_enable = false;
     m_io_context_pool.exit();
+    m_io_context_pool.run(true);
+    if (!m_handshake_context_pools.empty())
+    {
+        m_handshake_context_pools.back().exit();
+        m_handshake_context_pools.back().run(true);
+    }
+    m_ssl_session_cache.clear();
     m_acceptors.clear();
+    m_listeners.clear();
+    {
+        std::lock_guard<std::mutex> locker(m_rate_limit_mutex);
+        m_listener_rate_buckets.clear();
+    }
     m_tcp_service = nullptr;
     m_tcp_ports.clear();
 }
@@ -282,34 +322,225 @@ void TcpManagerImpl::get_ports(std::vector<unsigned short> & ports)
     ports = m_tcp_ports;
 }
 
+bool TcpManagerImpl::add_listener(const Listener & listener)
+{
+    if (0 == m_io_context_pool.size() || nullptr == m_tcp_service)
+    {
+        return false;
+    }
+
+    TcpListener * tcp_listener = boost::factory<TcpListener *>()();
+    m_listeners.push_back(tcp_listener);
+
+    if (!tcp_listener->init(listener) || (m_kernel_tls_enable && !tcp_listener->set_kernel_tls(true)) || !tcp_listener->set_session_cache(m_server_session_cache_size, m_server_session_timeout) || (m_ssl_ticket_key_ring.attached() && !tcp_listener->set_ticket_key_ring(m_ssl_ticket_key_ring)))
+    {
+        m_listeners.pop_back();
+        m_tcp_service->on_error(TcpConnectionSharedPtr(), "listener", "add", 1, "listener is invalid");
+        return false;
+    }
+
+    boost::system::error_code error;
+    endpoint_type endpoint(boost::asio::ip::make_address(nullptr == listener.host ? "0.0.0.0" : listener.host, error), listener.port);
+    acceptor_type * acceptor = boost::factory<acceptor_type *>()(m_io_context_pool.get());
+    m_acceptors.push_back(acceptor);
+
+    if (!error)
+    {
+        acceptor->open(endpoint.protocol(), error);
+    }
+    if (!error)
+    {
+        acceptor->set_option(acceptor_type::reuse_address(true), error);
+    }
+    if (!error)
+    {
+        acceptor->bind(endpoint, error);
+    }
+    if (!error)
+    {
+        acceptor->listen(boost::asio::socket_base::max_listen_connections, error);
+    }
+    if (error)
+    {
+        m_acceptors.pop_back();
+        m_listeners.pop_back();
+        m_tcp_service->on_error(TcpConnectionSharedPtr(), "listener", "add", error.value(), error.message().c_str());
+        return false;
+    }
+
+    unsigned short port = acceptor->local_endpoint(error).port();
+    tcp_listener->set_port(port);
+    start_accept(*acceptor, port, tcp_listener);
+    m_tcp_ports.push_back(port);
+
+    return true;
+}
+
+bool TcpManagerImpl::reload_server_certificate(const Certificate * server_certificate)
+{
+    if (!m_server_ssl_enable || nullptr == server_certificate)
+    {
+        return false;
+    }
+
+    ssl_context_ptr ssl_context = boost::factory<ssl_context_ptr>()(boost::asio::ssl::context::sslv23_server);
+
+    try
+    {
+        if (!set_server_certificate(*ssl_context, server_certificate))
+        {
+            return false;
+        }
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    if (!setup_reloaded_context(*ssl_context, *std::atomic_load(&m_server_ssl_context)))
+    {
+        return false;
+    }
+
+    std::atomic_store(&m_server_ssl_context, ssl_context);
+
+    return true;
+}
+
+bool TcpManagerImpl::reload_listener_certificate(unsigned short port, const Certificate * certificate)
+{
+    if (nullptr == certificate)
+    {
+        return false;
+    }
+
+    for (listeners_type::iterator iter = m_listeners.begin(); m_listeners.end() != iter; ++iter)
+    {
+        if (port != iter->port() || !iter->ssl_enable())
+        {
+            continue;
+        }
+
+        ssl_context_ptr ssl_context = iter->create_default_context(certificate);
+        if (!ssl_context || !setup_reloaded_context(*ssl_context, *iter->ssl_context()))
+        {
+            return false;
+        }
+
+        iter->set_default_context(ssl_context);
+
+        return true;
+    }
+
+    return false;
+}
+
+bool TcpManagerImpl::setup_reloaded_context(ssl_context_type & ssl_context, ssl_context_type & old_ssl_context)
+{
+    SSL_CTX * native_context = ssl_context.native_handle();
+    SSL_CTX_set_session_cache_mode(native_context, 0 == m_server_session_cache_size ? SSL_SESS_CACHE_OFF : SSL_SESS_CACHE_SERVER);
+    SSL_CTX_sess_set_cache_size(native_context, static_cast<long>(m_server_session_cache_size));
+    SSL_CTX_set_timeout(native_context, static_cast<long>(m_server_session_timeout));
+
+    if (m_ssl_ticket_key_ring.attached())
+    {
+        if (!m_ssl_ticket_key_ring.attach(native_context))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        /* tickets issued before the reload stay valid */
+        unsigned char ticket_keys[80];
+        if (1 == SSL_CTX_get_tlsext_ticket_keys(old_ssl_context.native_handle(), ticket_keys, sizeof(ticket_keys)))
+        {
+            SSL_CTX_set_tlsext_ticket_keys(native_context, ticket_keys, sizeof(ticket_keys));
+        }
+        OPENSSL_cleanse(ticket_keys, sizeof(ticket_keys));
+    }
+
+    if (m_kernel_tls_enable && !SslKernelTls::enable(native_context, true))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool TcpManagerImpl::reload_client_certificate(const Certificate * client_certificate)
+{
+    if (!m_client_ssl_enable || nullptr == client_certificate)
+    {
+        return false;
+    }
+
+    ssl_context_ptr ssl_context = boost::factory<ssl_context_ptr>()(boost::asio::ssl::context::sslv23_client);
+
+    try
+    {
+        if (!set_client_certificate(*ssl_context, client_certificate))
+        {
+            return false;
+        }
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    SSL_CTX * native_context = ssl_context->native_handle();
+
+    if (!m_ssl_session_cache.attach(native_context))
+    {
+        return false;
+    }
+
+    if (m_kernel_tls_enable && !SslKernelTls::enable(native_context, true))
+    {
+        return false;
+    }
+
+    std::atomic_store(&m_client_ssl_context, ssl_context);
+
+    return true;
+}
+
 void TcpManagerImpl::run(bool blocking)
 {
     m_io_context_pool.run(blocking);
 }
 
-void TcpManagerImpl::start_accept(acceptor_type & acceptor, unsigned short port)
+void TcpManagerImpl::start_accept(acceptor_type & acceptor, unsigned short port, TcpListener * listener)
 {
     bool passive = true;
     const void * identity = reinterpret_cast<const void *>(port);
-    if (m_server_ssl_enable)
+    if (nullptr != listener ? listener->ssl_enable() : m_server_ssl_enable)
     {
-        ssl_session_ptr ssl_session = boost::factory<ssl_session_ptr>()(m_io_context_pool.get(), m_server_ssl_context, m_tcp_service, passive, identity);
+        /* the ssl context is picked when the peer arrives, so the first handshake after a reload already uses the new certificate */
+        io_context_type & io_context = m_io_context_pool.get();
 
         acceptor.async_accept(
-            ssl_session->socket_lowest(),
-            [this, &acceptor, port, ssl_session](const boost::system::error_code & error) {
-                this->handle_accept<ssl_session_type, ssl_session_ptr>(acceptor, port, ssl_session, error);
+            io_context,
+            [this, &acceptor, &io_context, port, listener, passive, identity](const boost::system::error_code & error, boost::asio::ip::tcp::socket socket) {
+                ssl_context_ptr ssl_context = (nullptr != listener ? listener->ssl_context() : std::atomic_load(&m_server_ssl_context));
+                ssl_session_ptr ssl_session = boost::factory<ssl_session_ptr>()(io_context, ssl_context, m_tcp_service, passive, identity);
+                if (!error)
+                {
+                    ssl_session->socket_lowest() = std::move(socket);
+                }
+                this->handle_accept<ssl_session_type, ssl_session_ptr>(acceptor, port, listener, ssl_session, error);
             }
         );
     }
     else
     {
-        tcp_session_ptr tcp_session = boost::factory<tcp_session_ptr>()(m_io_context_pool.get(), m_server_ssl_context, m_tcp_service, passive, identity);
+        tcp_session_ptr tcp_session = boost::factory<tcp_session_ptr>()(m_io_context_pool.get(), ssl_context_ptr(), m_tcp_service, passive, identity);
 
         acceptor.async_accept(
             tcp_session->socket_lowest(),
-            [this, &acceptor, port, tcp_session](const boost::system::error_code & error) {
-                this->handle_accept<tcp_session_type, tcp_session_ptr>(acceptor, port, tcp_session, error);
+            [this, &acceptor, port, listener, tcp_session](const boost::system::error_code & error) {
+                this->handle_accept<tcp_session_type, tcp_session_ptr>(acceptor, port, listener, tcp_session, error);
             }
         );
     }
@@ -325,7 +556,7 @@ bool TcpManagerImpl::create_connection(const std::string & host, const std::stri
         }
         else
         {
-            return async_create_connection<ssl_session_type, ssl_session_ptr>(host, service, identity, bind_ip, bind_port);
+            return async_create_connection<ssl_session_type, ssl_session_ptr>(host, service, identity, bind_ip, bind_port, false);
         }
     }
     else
@@ -336,7 +567,7 @@ bool TcpManagerImpl::create_connection(const std::string & host, const std::stri
         }
         else
         {
-            return async_create_connection<tcp_session_type, tcp_session_ptr>(host, service, identity, bind_ip, bind_port);
+            return async_create_connection<tcp_session_type, tcp_session_ptr>(host, service, identity, bind_ip, bind_port, false);
         }
     }
 }
@@ -346,4 +577,269 @@ bool TcpManagerImpl::create_connection(const std::string & host, unsigned short
     return create_connection(host, boost::lexical_cast<std::string>(port), sync_connect, identity, bind_ip, bind_port);
 }
 
+bool TcpManagerImpl::set_connect_attempt(std::size_t attempt_delay_milliseconds, std::size_t attempt_timeout_milliseconds)
+{
+    m_connect_attempt_delay = attempt_delay_milliseconds;
+    m_connect_attempt_timeout = attempt_timeout_milliseconds;
+    return true;
+}
+
+bool TcpManagerImpl::set_connection_pool(std::size_t max_idle_per_key, std::size_t max_idle_total, std::size_t max_idle_milliseconds)
+{
+    m_connection_pool.set_limit(max_idle_per_key, max_idle_total, max_idle_milliseconds);
+    return true;
+}
+
+bool TcpManagerImpl::acquire_connection(const std::string & host, const std::string & service, const void * identity, const char * bind_ip, unsigned short bind_port)
+{
+    TcpConnectionPool::connection_ptr connection = m_connection_pool.remove(TcpConnectionPool::make_key(host, service, bind_ip, bind_port, m_client_ssl_enable));
+    if (!connection)
+    {
+        return create_connection(host, service, false, identity, bind_ip, bind_port);
+    }
+
+    connection->pool_reuse(
+        identity,
+        [this, host, service, identity, bind_ip = std::string(nullptr == bind_ip ? "" : bind_ip), bind_port]() {
+            this->acquire_connection(host, service, identity, bind_ip.c_str(), bind_port);
+        }
+    );
+
+    return true;
+}
+
+bool TcpManagerImpl::acquire_connection(const std::string & host, unsigned short port, const void * identity, const char * bind_ip, unsigned short bind_port)
+{
+    return acquire_connection(host, boost::lexical_cast<std::string>(port), identity, bind_ip, bind_port);
+}
+
+bool TcpManagerImpl::release_connection(TcpConnectionSharedPtr connection)
+{
+    std::shared_ptr<TcpPoolableConnection> poolable_connection = std::dynamic_pointer_cast<TcpPoolableConnection>(connection);
+    return !!poolable_connection && poolable_connection->pool_release();
+}
+
+bool TcpManagerImpl::prewarm_connection(const std::string & host, const std::string & service, std::size_t count, const char * bind_ip, unsigned short bind_port)
+{
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        if (m_client_ssl_enable)
+        {
+            if (!async_create_connection<ssl_session_type, ssl_session_ptr>(host, service, nullptr, bind_ip, bind_port, true))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            if (!async_create_connection<tcp_session_type, tcp_session_ptr>(host, service, nullptr, bind_ip, bind_port, true))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool TcpManagerImpl::prewarm_connection(const std::string & host, unsigned short port, std::size_t count, const char * bind_ip, unsigned short bind_port)
+{
+    return prewarm_connection(host, boost::lexical_cast<std::string>(port), count, bind_ip, bind_port);
+}
+
+bool TcpManagerImpl::create_connections(const ConnectTarget * target_array, std::size_t target_count, const void * identity, std::size_t max_in_flight, std::size_t pacing_microseconds, bool pacing_jitter, const char * bind_ip, unsigned short bind_port)
+{
+    if ((nullptr == target_array && 0 != target_count) || 0 == max_in_flight || 0 == m_io_context_pool.size())
+    {
+        return false;
+    }
+
+    TcpBulkConnector::targets_type targets;
+    targets.reserve(target_count);
+    for (std::size_t index = 0; index < target_count; ++index)
+    {
+        if (nullptr == target_array[index].host)
+        {
+            return false;
+        }
+        TcpBulkConnector::target_type target;
+        target.host = target_array[index].host;
+        target.service = boost::lexical_cast<std::string>(target_array[index].port);
+        target.identity = target_array[index].identity;
+        targets.push_back(target);
+    }
+
+    std::string bind_host(nullptr == bind_ip ? "" : bind_ip);
+    std::shared_ptr<TcpBulkConnector> bulk_connector = boost::factory<std::shared_ptr<TcpBulkConnector>>()(
+        m_io_context_pool.get(),
+        m_tcp_service,
+        std::move(targets),
+        identity,
+        max_in_flight,
+        pacing_microseconds,
+        pacing_jitter,
+        [this, bind_host, bind_port](const TcpBulkConnector::target_type & target, TcpBulkConnector::notify_type notify) {
+            if (m_client_ssl_enable)
+            {
+                return this->async_create_connection<ssl_session_type, ssl_session_ptr>(target.host, target.service, target.identity, bind_host.c_str(), bind_port, false, std::move(notify));
+            }
+            else
+            {
+                return this->async_create_connection<tcp_session_type, tcp_session_ptr>(target.host, target.service, target.identity, bind_host.c_str(), bind_port, false, std::move(notify));
+            }
+        }
+    );
+    bulk_connector->start();
+
+    return true;
+}
+
+bool TcpManagerImpl::create_connections(const std::string & host, unsigned short port, std::size_t count, const void * identity, std::size_t max_in_flight, std::size_t pacing_microseconds, bool pacing_jitter, const char * bind_ip, unsigned short bind_port)
+{
+    ConnectTarget target = { host.c_str(), port, identity };
+    std::vector<ConnectTarget> targets(count, target);
+    return create_connections(targets.empty() ? nullptr : &targets[0], targets.size(), identity, max_in_flight, pacing_microseconds, pacing_jitter, bind_ip, bind_port);
+}
+
+bool TcpManagerImpl::set_ssl_session_cache(std::size_t max_session_count)
+{
+    m_ssl_session_cache.set_limit(max_session_count);
+    return true;
+}
+
+void TcpManagerImpl::get_ssl_session_statistics(std::size_t & hit_count, std::size_t & miss_count)
+{
+    m_ssl_session_cache.get_statistics(hit_count, miss_count);
+}
+
+bool TcpManagerImpl::set_ssl_server_session_cache(std::size_t cache_size, std::size_t timeout_seconds)
+{
+    m_server_session_cache_size = cache_size;
+    m_server_session_timeout = timeout_seconds;
+
+    SSL_CTX * ssl_context = std::atomic_load(&m_server_ssl_context)->native_handle();
+    SSL_CTX_set_session_cache_mode(ssl_context, 0 == cache_size ? SSL_SESS_CACHE_OFF : SSL_SESS_CACHE_SERVER);
+    SSL_CTX_sess_set_cache_size(ssl_context, static_cast<long>(cache_size));
+    SSL_CTX_set_timeout(ssl_context, static_cast<long>(timeout_seconds));
+
+    for (listeners_type::iterator iter = m_listeners.begin(); m_listeners.end() != iter; ++iter)
+    {
+        iter->set_session_cache(cache_size, timeout_seconds);
+    }
+
+    return true;
+}
+
+bool TcpManagerImpl::set_ssl_ticket_keys(bool pass_file_not_buffer, const char * keys_file_or_buffer, std::size_t buffer_length, std::size_t rotate_seconds, std::size_t key_size)
+{
+    if (0 == m_io_context_pool.size())
+    {
+        return false;
+    }
+
+    if (!m_ssl_ticket_key_ring.load(pass_file_not_buffer, keys_file_or_buffer, buffer_length, key_size))
+    {
+        return false;
+    }
+
+    if (!m_ssl_ticket_key_ring.attach(std::atomic_load(&m_server_ssl_context)->native_handle()))
+    {
+        return false;
+    }
+
+    for (listeners_type::iterator iter = m_listeners.begin(); m_listeners.end() != iter; ++iter)
+    {
+        if (!iter->set_ticket_key_ring(m_ssl_ticket_key_ring))
+        {
+            return false;
+        }
+    }
+
+    return m_ssl_ticket_key_ring.start(m_io_context_pool.get(), rotate_seconds);
+}
+
+bool TcpManagerImpl::set_ssl_handshake_pool(std::size_t thread_count)
+{
+    if (m_handshake_pool_enable || 0 == thread_count)
+    {
+        return false;
+    }
+
+    /* a stopped pool is kept until the manager is destroyed, pending ssl operations still count work on it */
+    m_handshake_context_pools.push_back(boost::factory<io_context_pool_type *>()());
+    if (!m_handshake_context_pools.back().init(thread_count))
+    {
+        m_handshake_context_pools.back().exit();
+        m_handshake_context_pools.back().run(true);
+        return false;
+    }
+
+    m_handshake_pool_enable = true;
+
+    return true;
+}
+
+bool TcpManagerImpl::set_ssl_record_sizing(std::size_t small_record_size, std::size_t small_record_count, std::size_t idle_milliseconds)
+{
+    m_record_small_size = small_record_size;
+    m_record_small_count = small_record_count;
+    m_record_idle = idle_milliseconds;
+    return true;
+}
+
+bool TcpManagerImpl::set_ssl_kernel_tls(bool enable)
+{
+    if (!SslKernelTls::supported())
+    {
+        return !enable;
+    }
+
+    if (!SslKernelTls::enable(std::atomic_load(&m_server_ssl_context)->native_handle(), enable) || !SslKernelTls::enable(std::atomic_load(&m_client_ssl_context)->native_handle(), enable))
+    {
+        return false;
+    }
+
+    for (listeners_type::iterator iter = m_listeners.begin(); m_listeners.end() != iter; ++iter)
+    {
+        if (!iter->set_kernel_tls(enable))
+        {
+            return false;
+        }
+    }
+
+    m_kernel_tls_enable = enable;
+
+    return true;
+}
+
+bool TcpManagerImpl::set_rate_limit(const RateLimit & limit)
+{
+    if (0 == limit.burst_bytes)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> locker(m_rate_limit_mutex);
+
+    m_rate_limit = limit;
+
+    for (listener_rate_buckets_type::iterator iter = m_listener_rate_buckets.begin(); m_listener_rate_buckets.end() != iter; ++iter)
+    {
+        iter->second.first->set_rate(limit.listener_send_bytes_per_second, limit.burst_bytes);
+        iter->second.second->set_rate(limit.listener_recv_bytes_per_second, limit.burst_bytes);
+    }
+
+    return true;
+}
+
+bool TcpManagerImpl::set_timestamping(bool recv_enable, bool send_enable)
+{
+#ifdef BOOST_NET_TIMESTAMPING_SUPPORT
+    m_timestamp_recv = recv_enable;
+    m_timestamp_send = send_enable;
+    return true;
+#else
+    return !recv_enable && !send_enable;
+#endif // BOOST_NET_TIMESTAMPING_SUPPORT
+}
+
 } // namespace BoostNet end
@@ -8,10 +8,18 @@
  * Copyright(C): 2018 - 2020
  ********************************************************/
 
+#include <algorithm>
 #include "tcp_send_buffer.h"
 
 namespace BoostNet { // namespace BoostNet begin
 
+TcpSendBuffer::TcpSendBuffer()
+    : m_buffer_deque()
+    , m_front_offset(0)
+{
+
+}
+
 bool TcpSendBuffer::empty() const
 {
     return m_buffer_deque.empty();
@@ -22,14 +30,40 @@ void TcpSendBuffer::commit(std::vector<char> && data)
     m_buffer_deque.push_back(data);
 }
 
-TcpSendBuffer::const_buffers_type TcpSendBuffer::data() const
+void TcpSendBuffer::coalesce(std::size_t max_size)
+{
+    if (m_buffer_deque.size() < 2 || m_buffer_deque.front().size() - m_front_offset >= max_size)
+    {
+        return;
+    }
+
+    buffer_type buffer(m_buffer_deque.front().begin() + m_front_offset, m_buffer_deque.front().end());
+    m_buffer_deque.pop_front();
+    m_front_offset = 0;
+
+    while (!m_buffer_deque.empty() && buffer.size() + m_buffer_deque.front().size() <= max_size)
+    {
+        buffer.insert(buffer.end(), m_buffer_deque.front().begin(), m_buffer_deque.front().end());
+        m_buffer_deque.pop_front();
+    }
+
+    m_buffer_deque.push_front(std::move(buffer));
+}
+
+TcpSendBuffer::const_buffers_type TcpSendBuffer::data(std::size_t max_size) const
 {
-    return m_buffer_deque.front();
+    const buffer_type & buffer = m_buffer_deque.front();
+    return boost::asio::buffer(buffer.data() + m_front_offset, std::min(buffer.size() - m_front_offset, max_size));
 }
 
-void TcpSendBuffer::consume()
+void TcpSendBuffer::consume(std::size_t len)
 {
-    m_buffer_deque.pop_front();
+    m_front_offset += len;
+    if (m_front_offset >= m_buffer_deque.front().size())
+    {
+        m_buffer_deque.pop_front();
+        m_front_offset = 0;
+    }
 }
 
 } // namespace BoostNet end
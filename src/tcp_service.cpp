@@ -22,4 +22,9 @@ TcpServiceBase::~TcpServiceBase()
 
 }
 
+void TcpServiceBase::on_connect_summary(const void * identity, std::size_t success_count, std::size_t failure_count)
+{
+
+}
+
 } // namespace BoostNet end
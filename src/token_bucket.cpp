@@ -0,0 +1,123 @@
+/********************************************************
+ * Description : token bucket for byte rate limits
+ * Data        : 2026-10-20 04:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <limits>
+#include <algorithm>
+#include "token_bucket.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+TokenBucket::TokenBucket()
+    : m_mutex()
+    , m_rate(0)
+    , m_burst(0)
+    , m_tokens(0.0)
+    , m_time(std::chrono::steady_clock::now())
+    , m_parent()
+{
+
+}
+
+TokenBucket::~TokenBucket()
+{
+
+}
+
+void TokenBucket::set_rate(std::size_t bytes_per_second, std::size_t burst_bytes)
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    refill(now);
+    bool was_limited = (0 != m_rate);
+    m_rate = bytes_per_second;
+    m_burst = std::max<std::size_t>(burst_bytes, 1);
+    m_tokens = (was_limited ? std::min<double>(m_tokens, static_cast<double>(m_burst)) : static_cast<double>(m_burst));
+    m_time = now;
+}
+
+void TokenBucket::set_parent(const bucket_ptr & parent)
+{
+    m_parent = parent;
+}
+
+bool TokenBucket::limited() const
+{
+    return 0 != m_rate || (m_parent && m_parent->limited());
+}
+
+std::size_t TokenBucket::burst_bytes() const
+{
+    std::size_t burst = (0 != m_rate ? m_burst.load() : std::numeric_limits<std::size_t>::max());
+    if (m_parent && m_parent->limited())
+    {
+        burst = std::min<std::size_t>(burst, m_parent->burst_bytes());
+    }
+    return burst;
+}
+
+std::size_t TokenBucket::wait_microseconds()
+{
+    std::size_t wait = self_wait_microseconds();
+    if (m_parent)
+    {
+        wait = std::max<std::size_t>(wait, m_parent->wait_microseconds());
+    }
+    return wait;
+}
+
+void TokenBucket::consume(std::size_t bytes)
+{
+    self_consume(bytes);
+    if (m_parent)
+    {
+        m_parent->consume(bytes);
+    }
+}
+
+std::size_t TokenBucket::self_wait_microseconds()
+{
+    if (0 == m_rate)
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> locker(m_mutex);
+    refill(std::chrono::steady_clock::now());
+    if (m_tokens > 0.0)
+    {
+        return 0;
+    }
+    return static_cast<std::size_t>((1.0 - m_tokens) * 1000000.0 / static_cast<double>(m_rate)) + 1;
+}
+
+void TokenBucket::self_consume(std::size_t bytes)
+{
+    if (0 == m_rate)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> locker(m_mutex);
+    refill(std::chrono::steady_clock::now());
+    m_tokens -= static_cast<double>(bytes);
+}
+
+void TokenBucket::refill(std::chrono::steady_clock::time_point now)
+{
+    if (now <= m_time)
+    {
+        return;
+    }
+    double elapsed = std::chrono::duration<double>(now - m_time).count();
+    m_tokens = std::min<double>(m_tokens + elapsed * static_cast<double>(m_rate), static_cast<double>(m_burst));
+    m_time = now;
+}
+
+} // namespace BoostNet end
@@ -9,6 +9,8 @@
  ********************************************************/
 
 #include <cstring>
+#include <chrono>
+#include <algorithm>
 #include <boost/core/ignore_unused.hpp>
 #include <boost/functional/factory.hpp>
 #include "udp_passive_connection.h"
@@ -16,20 +18,57 @@
 
 namespace BoostNet { // namespace BoostNet begin
 
-UdpAcceptor::UdpAcceptor(io_context_type & io_context, UdpServiceBase * udp_service, const char * host, unsigned short port)
+UdpAcceptor::dispatch_worker_type::dispatch_worker_type(io_context_type & context)
+    : io_context(context)
+    , ring(dispatch_ring_size)
+    , scheduled(false)
+    , backlog()
+    , backlogged(false)
+{
+
+}
+
+UdpAcceptor::UdpAcceptor(io_context_type & io_context, UdpServiceBase * udp_service, const char * host, unsigned short port, std::size_t recv_buffer_size)
     : m_io_context(io_context)
     , m_udp_service(udp_service)
     , m_running(false)
     , m_host_endpoint(boost::asio::ip::make_address(nullptr == host ? "0.0.0.0" : host), port)
-    , m_peer_endpoint()
     , m_socket(io_context)
     , m_host_ip(nullptr == host ? "0.0.0.0" : host)
     , m_host_port(port)
     , m_connection_map()
     , m_send_buffer()
-    , m_recv_data()
+    , m_batch(max_batch_count, recv_buffer_size)
+    , m_direct_sender()
+    , m_expire_timer(io_context)
+    , m_idle_milliseconds(0)
+    , m_max_peer_count(0)
+    , m_evict_when_full(true)
+    , m_cookie_enable(false)
+    , m_cookie_echo(false)
+    , m_peer_cookie()
+    , m_cookie_bucket()
+    , m_dispatch_workers()
+    , m_dispatch_enable(false)
+    , m_datagram_callback(false)
+    , m_fragment_enable(false)
+    , m_fragment_options()
+    , m_accept_enable(true)
+    , m_rate_limit()
+    , m_send_bucket()
+    , m_recv_bucket()
+    , m_send_timer(io_context)
+    , m_recv_timer(io_context)
+    , m_timestamping()
+    , m_timestamp_waiting(false)
     , m_good(false)
 {
+    m_rate_limit.send_bytes_per_second = 0;
+    m_rate_limit.recv_bytes_per_second = 0;
+    m_rate_limit.listener_send_bytes_per_second = 0;
+    m_rate_limit.listener_recv_bytes_per_second = 0;
+    m_rate_limit.burst_bytes = 0;
+
     boost::system::error_code ec;
 
     m_socket.open(m_host_endpoint.protocol(), ec);
@@ -53,7 +92,12 @@ UdpAcceptor::UdpAcceptor(io_context_type & io_context, UdpServiceBase * udp_serv
         return;
     }
 
-    memset(m_recv_data, 0x0, sizeof(m_recv_data));
+    m_socket.non_blocking(true, ec);
+    if (ec)
+    {
+        m_udp_service->on_error(UdpConnectionSharedPtr(), "listener", "non_blocking", ec.value(), ec.message().c_str());
+        return;
+    }
 
     m_good = true;
 }
@@ -63,15 +107,26 @@ UdpAcceptor::~UdpAcceptor()
 
 }
 
+UdpAcceptor::io_context_type & UdpAcceptor::io_context()
+{
+    return m_io_context;
+}
+
 bool UdpAcceptor::start()
 {
     if (m_good)
     {
+        boost::system::error_code ignore_error_code;
         m_host_ip = m_host_endpoint.address().to_string();
-        m_host_port = m_host_endpoint.port();
+        m_host_port = m_socket.local_endpoint(ignore_error_code).port();
 
         m_running = true;
 
+        if (m_timestamping.send_enabled())
+        {
+            wait_send_timestamps();
+        }
+
         recv();
     }
 
@@ -82,38 +137,588 @@ void UdpAcceptor::stop()
 {
     if (m_running)
     {
+        m_direct_sender.close();
         boost::system::error_code ignore_error_code;
         m_socket.shutdown(socket_type::shutdown_both, ignore_error_code);
         m_socket.close(ignore_error_code);
+        m_expire_timer.cancel();
+        m_send_timer.cancel();
+        m_recv_timer.cancel();
         boost::asio::post(m_io_context, [self = shared_from_this()]() { self->handle_stop(); });
         m_running = false;
     }
 }
 
-void UdpAcceptor::handle_stop()
+void UdpAcceptor::set_segment_offload(std::size_t recv_buffer_size, std::size_t segment_size, bool gro_enable)
+{
+    boost::asio::post(
+        m_io_context,
+        [self = shared_from_this(), recv_buffer_size, segment_size, gro_enable]() {
+            self->m_batch.set_segment_offload(self->m_socket, recv_buffer_size, segment_size, gro_enable);
+            self->m_direct_sender.set_unit_size(self->m_batch.segment_size());
+        }
+    );
+}
+
+void UdpAcceptor::set_peer_limit(std::size_t idle_milliseconds, std::size_t max_peer_count, bool evict_when_full)
+{
+    boost::asio::post(
+        m_io_context,
+        [self = shared_from_this(), idle_milliseconds, max_peer_count, evict_when_full]() {
+            self->handle_peer_limit(idle_milliseconds, max_peer_count, evict_when_full);
+        }
+    );
+}
+
+void UdpAcceptor::set_peer_cookie(bool enable, std::size_t max_replies_per_second)
+{
+    boost::asio::post(
+        m_io_context,
+        [self = shared_from_this(), enable, max_replies_per_second]() {
+            if (enable && !self->m_peer_cookie.init())
+            {
+                self->m_udp_service->on_error(UdpConnectionSharedPtr(), "listener", "cookie", 1, "cookie secret init failed");
+                return;
+            }
+            self->m_cookie_bucket.set_rate(max_replies_per_second * UdpPeerCookie::cookie_size, max_replies_per_second * UdpPeerCookie::cookie_size);
+            self->m_cookie_enable = enable;
+        }
+    );
+}
+
+void UdpAcceptor::set_cookie_echo(bool enable)
+{
+    boost::asio::post(m_io_context, [self = shared_from_this(), enable]() { self->m_cookie_echo = enable; });
+}
+
+void UdpAcceptor::set_peer_dispatch(const std::vector<io_context_type *> & io_contexts, bool enable)
+{
+    boost::asio::post(
+        m_io_context,
+        [self = shared_from_this(), io_contexts, enable]() {
+            if (enable && self->m_dispatch_workers.empty())
+            {
+                for (std::vector<io_context_type *>::const_iterator iter = io_contexts.begin(); io_contexts.end() != iter; ++iter)
+                {
+                    self->m_dispatch_workers.push_back(boost::factory<dispatch_worker_ptr>()(**iter));
+                }
+            }
+            self->m_dispatch_enable = enable && !self->m_dispatch_workers.empty();
+        }
+    );
+}
+
+void UdpAcceptor::set_datagram_callback(bool enable)
+{
+    boost::asio::post(m_io_context, [self = shared_from_this(), enable]() { self->m_datagram_callback = enable; });
+}
+
+void UdpAcceptor::set_send_queue_limit(const UdpSendLimit & limit)
+{
+    boost::asio::post(m_io_context, [self = shared_from_this(), limit]() { self->m_send_buffer.set_limit(limit); });
+}
+
+void UdpAcceptor::set_direct_send(bool enable)
+{
+    boost::asio::post(
+        m_io_context,
+        [self = shared_from_this(), enable]() {
+            if (enable && self->m_running)
+            {
+                self->m_direct_sender.open(self->m_socket, self->m_batch.segment_size());
+            }
+            else
+            {
+                self->m_direct_sender.close();
+            }
+        }
+    );
+}
+
+void UdpAcceptor::set_message_fragment(const UdpFragmentOptions & options, bool enable)
+{
+    boost::asio::post(
+        m_io_context,
+        [self = shared_from_this(), options, enable]() {
+            self->m_fragment_enable = enable;
+            self->m_fragment_options = options;
+        }
+    );
+}
+
+void UdpAcceptor::set_multicast_group(const boost::asio::ip::address & group_address, const boost::asio::ip::address & interface_address, bool join)
+{
+    boost::asio::post(
+        m_io_context,
+        [self = shared_from_this(), group_address, interface_address, join]() {
+            boost::system::error_code ec;
+            if (group_address.is_v4())
+            {
+#ifdef IP_MULTICAST_ALL
+                self->m_socket.set_option(boost::asio::detail::socket_option::boolean<IPPROTO_IP, IP_MULTICAST_ALL>(false), ec);
+#endif // IP_MULTICAST_ALL
+                if (join)
+                {
+                    self->m_socket.set_option(boost::asio::ip::multicast::join_group(group_address.to_v4(), interface_address.to_v4()), ec);
+                }
+                else
+                {
+                    self->m_socket.set_option(boost::asio::ip::multicast::leave_group(group_address.to_v4(), interface_address.to_v4()), ec);
+                }
+            }
+            else
+            {
+#ifdef IPV6_MULTICAST_ALL
+                self->m_socket.set_option(boost::asio::detail::socket_option::boolean<IPPROTO_IPV6, IPV6_MULTICAST_ALL>(false), ec);
+#endif // IPV6_MULTICAST_ALL
+                if (join)
+                {
+                    self->m_socket.set_option(boost::asio::ip::multicast::join_group(group_address), ec);
+                }
+                else
+                {
+                    self->m_socket.set_option(boost::asio::ip::multicast::leave_group(group_address), ec);
+                }
+            }
+            if (ec)
+            {
+                self->m_udp_service->on_error(UdpConnectionSharedPtr(), "listener", join ? "join_multicast_group" : "leave_multicast_group", ec.value(), ec.message().c_str());
+            }
+        }
+    );
+}
+
+void UdpAcceptor::set_multicast_options(const UdpMulticastOptions & options)
+{
+    boost::asio::post(
+        m_io_context,
+        [self = shared_from_this(), options]() {
+            if (!self->m_socket.is_open())
+            {
+                return;
+            }
+            boost::system::error_code ec;
+            apply_multicast_options(self->m_socket, options, ec);
+            if (ec)
+            {
+                self->m_udp_service->on_error(UdpConnectionSharedPtr(), "listener", "set_multicast_options", ec.value(), ec.message().c_str());
+            }
+        }
+    );
+}
+
+void UdpAcceptor::set_accept_peer(bool enable)
+{
+    boost::asio::post(m_io_context, [self = shared_from_this(), enable]() { self->m_accept_enable = enable; });
+}
+
+void UdpAcceptor::connect_peer(const resolver_results_type & results, const void * identity)
+{
+    boost::asio::post(m_io_context, [self = shared_from_this(), results, identity]() { self->handle_connect_peer(results, identity); });
+}
+
+void UdpAcceptor::set_rate_limit(const RateLimit & limit)
+{
+    boost::asio::post(m_io_context, [self = shared_from_this(), limit]() { self->handle_rate_limit(limit); });
+}
+
+void UdpAcceptor::set_timestamping(bool recv_enable, bool send_enable)
+{
+    boost::asio::post(m_io_context, [self = shared_from_this(), recv_enable, send_enable]() { self->handle_timestamping(recv_enable, send_enable); });
+}
+
+bool UdpAcceptor::send_timestamp(KernelTimestamp & timestamp, std::size_t & send_count) const
+{
+    return m_timestamping.send_timestamp(timestamp, send_count);
+}
+
+void UdpAcceptor::handle_rate_limit(const RateLimit & limit)
+{
+    m_rate_limit = limit;
+    m_send_bucket.set_rate(limit.listener_send_bytes_per_second, limit.burst_bytes);
+    m_recv_bucket.set_rate(limit.listener_recv_bytes_per_second, limit.burst_bytes);
+    if (m_running)
+    {
+        m_send_timer.cancel();
+        m_recv_timer.cancel();
+    }
+}
+
+void UdpAcceptor::handle_timestamping(bool recv_enable, bool send_enable)
+{
+    if (!m_socket.is_open())
+    {
+        return;
+    }
+
+    if (!m_timestamping.enable(m_socket.native_handle(), recv_enable, send_enable))
+    {
+        m_udp_service->on_error(UdpConnectionSharedPtr(), "listener", "timestamping", 1, "kernel timestamping not available");
+    }
+    m_batch.set_recv_timestamp(m_timestamping.recv_enabled());
+
+    if (m_running && m_timestamping.send_enabled())
+    {
+        wait_send_timestamps();
+    }
+}
+
+void UdpAcceptor::wait_send_timestamps()
 {
-    for (udp_connection_map::iterator iter = m_connection_map.begin(); m_connection_map.end() != iter; ++iter)
+    if (m_timestamp_waiting)
     {
-        udp_connection_ptr udp_connection = iter->second;
-        udp_connection->stop();
+        return;
+    }
+
+    m_timestamp_waiting = true;
+    m_socket.async_wait(
+        socket_type::wait_error,
+        [self = shared_from_this()](const boost::system::error_code & error) {
+            self->handle_send_timestamps(error);
+        }
+    );
+}
+
+void UdpAcceptor::handle_send_timestamps(const boost::system::error_code & error)
+{
+    m_timestamp_waiting = false;
+
+    if (error || !m_running || !m_timestamping.send_enabled())
+    {
+        return;
+    }
+
+    wait_send_timestamps();
+    m_timestamping.read_send_timestamps(m_socket.native_handle());
+}
+
+void UdpAcceptor::handle_rate_wait(const boost::system::error_code & error, bool send_not_recv)
+{
+    if (!m_running || (error && boost::asio::error::operation_aborted != error))
+    {
+        return;
+    }
+
+    if (send_not_recv)
+    {
+        send();
+    }
+    else
+    {
+        recv();
     }
+}
+
+void UdpAcceptor::handle_connect_peer(const resolver_results_type & results, const void * identity)
+{
+    if (m_running)
+    {
+        for (resolver_results_type::iterator iter = results.begin(); results.end() != iter; ++iter)
+        {
+            const endpoint_type & endpoint = iter->endpoint();
+            if (endpoint.protocol() != m_host_endpoint.protocol())
+            {
+                continue;
+            }
+            if (nullptr != m_connection_map.find(endpoint, current_milliseconds()))
+            {
+                continue;
+            }
+            udp_connection_ptr udp_connection = boost::factory<udp_connection_ptr>()(*this, m_udp_service, m_host_port, endpoint, select_worker(endpoint), m_datagram_callback);
+            udp_connection->set_message_fragment(m_fragment_options, m_fragment_enable);
+            udp_connection->set_outbound(identity);
+            udp_connection->set_rate_limit(m_rate_limit);
+            m_connection_map.insert(endpoint, udp_connection, current_milliseconds());
+            dispatch_peer(udp_connection, dispatch_start, nullptr, 0, 0);
+            return;
+        }
+    }
+
+    if (nullptr != m_udp_service)
+    {
+        m_udp_service->on_connect(nullptr, identity);
+    }
+}
+
+std::size_t UdpAcceptor::select_worker(const endpoint_type & endpoint) const
+{
+    if (!m_dispatch_enable)
+    {
+        return m_dispatch_workers.size();
+    }
+
+    std::size_t worker_index = static_cast<std::size_t>(UdpPeerTable::hash_endpoint(endpoint) % m_dispatch_workers.size());
+    if (&m_dispatch_workers[worker_index]->io_context == &m_io_context)
+    {
+        return m_dispatch_workers.size();
+    }
+
+    return worker_index;
+}
+
+void UdpAcceptor::dispatch_peer(const udp_connection_ptr & connection, dispatch_action_type action, const char * data, std::size_t len, uint64_t timestamp)
+{
+    if (connection->worker_index() >= m_dispatch_workers.size())
+    {
+        switch (action)
+        {
+            case dispatch_start:
+                connection->start();
+                break;
+            case dispatch_recv:
+                connection->recv(data, len, timestamp);
+                break;
+            default:
+                connection->stop();
+                break;
+        }
+        return;
+    }
+
+    dispatch_worker_ptr worker = m_dispatch_workers[connection->worker_index()];
+
+    /* a datagram is dropped when the worker is too far behind, start and stop never are and wait in the backlog when the ring is full */
+    if (dispatch_recv == action && (worker->backlog.size() >= dispatch_reserve_size || (worker->backlog.empty() && worker->ring.size() + dispatch_reserve_size >= worker->ring.capacity())))
+    {
+        connection->recv_dropped();
+        return;
+    }
+
+    dispatch_item_type item;
+    item.connection = connection;
+    item.action = action;
+
+    if (dispatch_recv == action)
+    {
+        item.datagram.assign(data, len);
+        item.datagram.set_timestamp(timestamp);
+    }
+
+    /* once something waits in the backlog everything after it does too, so a connection never sees its items out of order */
+    if (!worker->backlog.empty() || !worker->ring.push(item))
+    {
+        worker->backlog.push_back(std::move(item));
+        worker->backlogged.store(true);
+    }
+
+    if (!worker->scheduled.exchange(true))
+    {
+        boost::asio::post(worker->io_context, [self = shared_from_this(), worker]() { self->handle_dispatch(worker); });
+    }
+}
+
+void UdpAcceptor::handle_dispatch(dispatch_worker_ptr worker)
+{
+    dispatch_item_type item;
+    for (std::size_t count = 0; count < dispatch_drain_count && worker->ring.pop(item); ++count)
+    {
+        switch (item.action)
+        {
+            case dispatch_start:
+                item.connection->start();
+                break;
+            case dispatch_recv:
+                item.connection->recv(std::move(item.datagram));
+                break;
+            default:
+                item.connection->stop();
+                break;
+        }
+        item.connection.reset();
+    }
+
+    /* the backlog belongs to the acceptor thread, it refills the ring now that there is room */
+    if (worker->backlogged.exchange(false))
+    {
+        boost::asio::post(m_io_context, [self = shared_from_this(), worker]() { self->flush_dispatch(worker); });
+    }
+
+    if (!worker->ring.empty())
+    {
+        boost::asio::post(worker->io_context, [self = shared_from_this(), worker]() { self->handle_dispatch(worker); });
+        return;
+    }
+
+    worker->scheduled.store(false);
+
+    if ((!worker->ring.empty() || worker->backlogged.load()) && !worker->scheduled.exchange(true))
+    {
+        boost::asio::post(worker->io_context, [self = shared_from_this(), worker]() { self->handle_dispatch(worker); });
+    }
+}
+
+void UdpAcceptor::flush_dispatch(dispatch_worker_ptr worker)
+{
+    while (!worker->backlog.empty() && worker->ring.push(worker->backlog.front()))
+    {
+        worker->backlog.pop_front();
+    }
+
+    if (!worker->backlog.empty())
+    {
+        worker->backlogged.store(true);
+    }
+
+    if (!worker->scheduled.exchange(true))
+    {
+        boost::asio::post(worker->io_context, [self = shared_from_this(), worker]() { self->handle_dispatch(worker); });
+    }
+}
+
+void UdpAcceptor::handle_peer_limit(std::size_t idle_milliseconds, std::size_t max_peer_count, bool evict_when_full)
+{
+    bool need_timer = 0 == m_idle_milliseconds && 0 != idle_milliseconds;
+
+    m_idle_milliseconds = idle_milliseconds;
+    m_max_peer_count = max_peer_count;
+    m_evict_when_full = evict_when_full;
+
+    if (need_timer && m_running)
+    {
+        start_expire_timer();
+    }
+}
+
+uint64_t UdpAcceptor::current_milliseconds()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void UdpAcceptor::start_expire_timer()
+{
+    m_expire_timer.expires_after(std::chrono::milliseconds(std::max<std::size_t>(m_idle_milliseconds / 4, 10)));
+    m_expire_timer.async_wait(
+        [self = shared_from_this()](const boost::system::error_code & error) {
+            self->handle_expire(error);
+        }
+    );
+}
+
+void UdpAcceptor::handle_expire(const boost::system::error_code & error)
+{
+    if (error || !m_running || 0 == m_idle_milliseconds)
+    {
+        return;
+    }
+
+    uint64_t now = current_milliseconds();
+    if (now > m_idle_milliseconds)
+    {
+        udp_connection_map::connection_array connections;
+        m_connection_map.expire(now - m_idle_milliseconds, connections);
+        for (udp_connection_map::connection_array::iterator iter = connections.begin(); connections.end() != iter; ++iter)
+        {
+            dispatch_peer(*iter, dispatch_stop, nullptr, 0, 0);
+        }
+    }
+
+    start_expire_timer();
+}
+
+void UdpAcceptor::accept_peer(const endpoint_type & endpoint, const char * data, std::size_t len, uint64_t active_time, uint64_t timestamp)
+{
+    if (!m_accept_enable)
+    {
+        return;
+    }
+
+    if (m_cookie_enable && !UdpPeerCookie::is_cookie(data, len))
+    {
+        /* never answer with more bytes than were received, and cap the replies so the listener cannot amplify a spoofed flood */
+        if (len >= UdpPeerCookie::cookie_size && 0 == m_cookie_bucket.wait_microseconds())
+        {
+            m_cookie_bucket.consume(UdpPeerCookie::cookie_size);
+            unsigned char cookie[UdpPeerCookie::cookie_size] = { 0x0 };
+            m_peer_cookie.make(endpoint, cookie);
+            boost::system::error_code ignore_error_code;
+            m_socket.send_to(boost::asio::buffer(cookie, sizeof(cookie)), endpoint, 0, ignore_error_code);
+        }
+        return;
+    }
+
+    if (m_cookie_enable && !m_peer_cookie.verify(endpoint, data, len))
+    {
+        return;
+    }
+
+    if (0 != m_max_peer_count && m_connection_map.size() >= m_max_peer_count)
+    {
+        udp_connection_ptr evicted_connection;
+        if (!m_evict_when_full || !m_connection_map.evict(evicted_connection))
+        {
+            return;
+        }
+        dispatch_peer(evicted_connection, dispatch_stop, nullptr, 0, 0);
+    }
+
+    udp_connection_ptr udp_connection = boost::factory<udp_connection_ptr>()(*this, m_udp_service, m_host_port, endpoint, select_worker(endpoint), m_datagram_callback);
+    udp_connection->set_message_fragment(m_fragment_options, m_fragment_enable);
+    udp_connection->set_rate_limit(m_rate_limit);
+    m_connection_map.insert(endpoint, udp_connection, active_time);
+    dispatch_peer(udp_connection, dispatch_start, nullptr, 0, 0);
+
+    if (!m_cookie_enable)
+    {
+        dispatch_peer(udp_connection, dispatch_recv, data, len, timestamp);
+    }
+}
+
+void UdpAcceptor::handle_stop()
+{
+    udp_connection_map::connection_array connections;
+    m_connection_map.get_connections(connections);
     m_connection_map.clear();
+    for (udp_connection_map::connection_array::iterator iter = connections.begin(); connections.end() != iter; ++iter)
+    {
+        dispatch_peer(*iter, dispatch_stop, nullptr, 0, 0);
+    }
 }
 
-void UdpAcceptor::send(const endpoint_type & endpoint, const void * data, std::size_t len)
+void UdpAcceptor::send(const endpoint_type & endpoint, const void * data, std::size_t len, const UdpSendQueue::counter_ptr & counter)
 {
+    if (counter->send_idle() && !m_send_bucket.limited())
+    {
+        boost::system::error_code error;
+        if (m_direct_sender.send(data, len, &endpoint, error) && boost::asio::error::would_block != error)
+        {
+            counter->queued_count += 1;
+            if (error)
+            {
+                counter->error_count += 1;
+            }
+            else
+            {
+                counter->sent_count += 1;
+            }
+            return;
+        }
+    }
+
+    counter->posted_count += 1;
     boost::asio::post(
         m_io_context,
-        [self = shared_from_this(), endpoint, pack = std::vector<char>(reinterpret_cast<const char *>(data), reinterpret_cast<const char *>(data) + len)]() mutable {
-            self->push_send_data(std::make_pair(endpoint, std::move(pack)));
+        [self = shared_from_this(), endpoint, pack = std::vector<char>(reinterpret_cast<const char *>(data), reinterpret_cast<const char *>(data) + len), counter]() mutable {
+            self->push_send_data(endpoint, std::move(pack), counter);
         }
     );
 }
 
-void UdpAcceptor::push_send_data(endpoint_buffer_type endpoint_data)
+void UdpAcceptor::push_send_data(const endpoint_type & endpoint, std::vector<char> data, const UdpSendQueue::counter_ptr & counter)
 {
     bool need_send = m_send_buffer.empty();
-    m_send_buffer.emplace_back(std::move(endpoint_data));
+    std::size_t unit_size = m_batch.send_unit_size();
+    if (0 == unit_size || data.size() <= unit_size)
+    {
+        m_send_buffer.push(&endpoint, std::move(data), counter);
+    }
+    else
+    {
+        for (std::size_t offset = 0; offset < data.size(); offset += unit_size)
+        {
+            m_send_buffer.push(&endpoint, std::vector<char>(data.begin() + offset, data.begin() + std::min<std::size_t>(offset + unit_size, data.size())), counter);
+        }
+    }
+    counter->posted_count -= 1;
     if (need_send)
     {
         send();
@@ -122,59 +727,131 @@ void UdpAcceptor::push_send_data(endpoint_buffer_type endpoint_data)
 
 void UdpAcceptor::send()
 {
-    m_socket.async_send_to(
-        boost::asio::buffer(m_send_buffer.front().second),
-        m_send_buffer.front().first,
-        [self = shared_from_this()](const boost::system::error_code & error, std::size_t bytes_transferred) {
-            self->handle_send(error, bytes_transferred);
+    while (!m_send_buffer.empty())
+    {
+        if (m_send_bucket.limited())
+        {
+            std::size_t wait_microseconds = m_send_bucket.wait_microseconds();
+            if (0 != wait_microseconds)
+            {
+                m_send_timer.expires_after(std::chrono::microseconds(wait_microseconds));
+                m_send_timer.async_wait(
+                    [self = shared_from_this()](const boost::system::error_code & error) {
+                        self->handle_rate_wait(error, true);
+                    }
+                );
+                return;
+            }
         }
-    );
-}
 
-void UdpAcceptor::handle_send(const boost::system::error_code & error, std::size_t bytes_transferred)
-{
-    boost::ignore_unused(bytes_transferred);
+        if (0 == m_send_buffer.fill(m_batch))
+        {
+            break;
+        }
 
-    BOOST_ASSERT(!m_send_buffer.empty());
+        boost::system::error_code error;
+        std::size_t send_count = m_batch.send(m_socket, error);
+        m_send_bucket.consume(m_send_buffer.pop_sent(send_count));
+        if (boost::asio::error::would_block == error)
+        {
+            m_socket.async_wait(
+                socket_type::wait_write,
+                [self = shared_from_this()](const boost::system::error_code & error) {
+                    self->handle_send(error);
+                }
+            );
+            return;
+        }
 
-    m_send_buffer.pop_front();
+        if (error)
+        {
+            m_send_buffer.pop_error();
+        }
+    }
+}
 
-    if (!m_send_buffer.empty())
+void UdpAcceptor::handle_send(const boost::system::error_code & error)
+{
+    if (error)
     {
-        send();
+        return;
     }
+
+    send();
 }
 
 void UdpAcceptor::recv()
 {
-    m_socket.async_receive_from(
-        boost::asio::buffer(m_recv_data, sizeof(m_recv_data)),
-        m_peer_endpoint,
-        [self = shared_from_this()](const boost::system::error_code & error, std::size_t bytes_transferred) {
-            self->handle_recv(error, bytes_transferred);
+    if (m_recv_bucket.limited())
+    {
+        std::size_t wait_microseconds = m_recv_bucket.wait_microseconds();
+        if (0 != wait_microseconds)
+        {
+            m_recv_timer.expires_after(std::chrono::microseconds(wait_microseconds));
+            m_recv_timer.async_wait(
+                [self = shared_from_this()](const boost::system::error_code & error) {
+                    self->handle_rate_wait(error, false);
+                }
+            );
+            return;
+        }
+    }
+
+    m_socket.async_wait(
+        socket_type::wait_read,
+        [self = shared_from_this()](const boost::system::error_code & error) {
+            self->handle_recv(error);
         }
     );
 }
 
-void UdpAcceptor::handle_recv(const boost::system::error_code & error, std::size_t bytes_transferred)
+void UdpAcceptor::handle_recv(const boost::system::error_code & error)
 {
-    udp_connection_ptr udp_connection;
+    if (error)
+    {
+        return;
+    }
 
-    udp_connection_map::iterator iter = m_connection_map.find(m_peer_endpoint);
-    if (m_connection_map.end() == iter)
+    boost::system::error_code recv_error;
+    std::size_t recv_count = m_batch.recv(m_socket, recv_error);
+    uint64_t active_time = (0 == recv_count ? 0 : current_milliseconds());
+
+    for (std::size_t index = 0; index < recv_count; ++index)
     {
-        udp_connection = boost::factory<udp_connection_ptr>()(*this, m_udp_service, m_host_port, m_peer_endpoint);
-        m_connection_map.insert(std::make_pair(m_peer_endpoint, udp_connection));
-        udp_connection->start();
+        const endpoint_type & peer_endpoint = m_batch.recv_endpoint(index);
+        m_recv_bucket.consume(m_batch.recv_size(index));
+
+        const udp_connection_ptr * connection = m_connection_map.find(peer_endpoint, active_time);
+        if (nullptr != connection)
+        {
+            if ((*connection)->outbound() && m_cookie_echo)
+            {
+                const bool cookie_pending = (*connection)->take_cookie_pending();
+                if (UdpPeerCookie::is_cookie(m_batch.recv_data(index), m_batch.recv_size(index)))
+                {
+                    if (cookie_pending)
+                    {
+                        (*connection)->send(m_batch.recv_data(index), m_batch.recv_size(index));
+                    }
+                    continue;
+                }
+            }
+            dispatch_peer(*connection, dispatch_recv, m_batch.recv_data(index), m_batch.recv_size(index), m_batch.recv_timestamp(index));
+        }
+        else
+        {
+            accept_peer(peer_endpoint, m_batch.recv_data(index), m_batch.recv_size(index), active_time, m_batch.recv_timestamp(index));
+        }
+    }
+
+    if (recv_count == m_batch.batch_count() && !m_recv_bucket.limited())
+    {
+        boost::asio::post(m_io_context, [self = shared_from_this()]() { self->handle_recv(boost::system::error_code()); });
     }
     else
     {
-        udp_connection = iter->second;
+        recv();
     }
-
-    udp_connection->recv(m_recv_data, bytes_transferred);
-
-    recv();
 }
 
 void UdpAcceptor::close(const endpoint_type & endpoint)
@@ -184,12 +861,12 @@ void UdpAcceptor::close(const endpoint_type & endpoint)
 
 void UdpAcceptor::handle_close(endpoint_type endpoint)
 {
-    udp_connection_map::iterator iter = m_connection_map.find(endpoint);
-    if (m_connection_map.end() != iter)
+    const udp_connection_ptr * connection = m_connection_map.find(endpoint, current_milliseconds());
+    if (nullptr != connection)
     {
-        udp_connection_ptr udp_connection = iter->second;
-        udp_connection->stop();
-        m_connection_map.erase(iter);
+        udp_connection_ptr udp_connection = *connection;
+        m_connection_map.erase(endpoint);
+        dispatch_peer(udp_connection, dispatch_stop, nullptr, 0, 0);
     }
 }
 
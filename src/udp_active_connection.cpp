@@ -9,12 +9,14 @@
  ********************************************************/
 
 #include <cstring>
+#include <algorithm>
 #include <boost/core/ignore_unused.hpp>
 #include "udp_active_connection.h"
+#include "udp_peer_cookie.h"
 
 namespace BoostNet { // namespace BoostNet begin
 
-UdpActiveConnection::UdpActiveConnection(io_context_type & io_context, UdpServiceBase * udp_service, const void * identity)
+UdpActiveConnection::UdpActiveConnection(io_context_type & io_context, UdpServiceBase * udp_service, const void * identity, std::size_t recv_buffer_size)
     : m_io_context(io_context)
     , m_udp_service(udp_service)
     , m_resolver_results()
@@ -28,9 +30,33 @@ UdpActiveConnection::UdpActiveConnection(io_context_type & io_context, UdpServic
     , m_peer_port(0)
     , m_recv_buffer()
     , m_send_buffer()
-    , m_recv_data()
+    , m_send_counter(std::make_shared<UdpSendCounter>())
+    , m_direct_sender()
+    , m_batch(max_batch_count, recv_buffer_size)
+    , m_recv_buffer_size(recv_buffer_size)
+    , m_segment_size(0)
+    , m_gro_enable(false)
+    , m_datagram_callback(false)
+    , m_cookie_echo(false)
+    , m_cookie_pending(true)
+    , m_direct_send(false)
+    , m_fragment_enable(false)
+    , m_fragment_options()
+    , m_fragment_message_id(0)
+    , m_reassembler()
+    , m_multicast_options()
+    , m_send_bucket()
+    , m_recv_bucket()
+    , m_send_timer(io_context)
+    , m_recv_timer(io_context)
+    , m_timestamp_recv(false)
+    , m_timestamp_send(false)
+    , m_timestamping()
+    , m_recv_timestamp(0)
 {
-    memset(m_recv_data, 0x0, sizeof(m_recv_data));
+    m_multicast_options.ttl = 1;
+    m_multicast_options.loopback = true;
+
 }
 
 UdpActiveConnection::~UdpActiveConnection()
@@ -48,6 +74,77 @@ UdpActiveConnection::io_context_type & UdpActiveConnection::io_context()
     return m_io_context;
 }
 
+void UdpActiveConnection::set_segment_offload(std::size_t recv_buffer_size, std::size_t segment_size, bool gro_enable)
+{
+    m_recv_buffer_size = recv_buffer_size;
+    m_segment_size = segment_size;
+    m_gro_enable = gro_enable;
+}
+
+void UdpActiveConnection::set_datagram_callback(bool enable)
+{
+    m_datagram_callback = enable;
+}
+
+void UdpActiveConnection::set_cookie_echo(bool enable)
+{
+    m_cookie_echo = enable;
+}
+
+void UdpActiveConnection::set_send_queue_limit(const UdpSendLimit & limit)
+{
+    m_send_buffer.set_limit(limit);
+}
+
+void UdpActiveConnection::set_direct_send(bool enable)
+{
+    m_direct_send = enable;
+}
+
+void UdpActiveConnection::set_message_fragment(const UdpFragmentOptions & options, bool enable)
+{
+    m_fragment_enable = enable && m_reassembler.init(options);
+    m_fragment_options = options;
+}
+
+void UdpActiveConnection::set_multicast_options(const UdpMulticastOptions & options)
+{
+    m_multicast_options = options;
+}
+
+void UdpActiveConnection::open_multicast(const endpoint_type & peer_endpoint, boost::system::error_code & error)
+{
+    error.clear();
+
+    if (!peer_endpoint.address().is_multicast())
+    {
+        return;
+    }
+
+    if (!m_socket.is_open())
+    {
+        m_socket.open(peer_endpoint.protocol(), error);
+        if (error)
+        {
+            return;
+        }
+    }
+
+    apply_multicast_options(m_socket, m_multicast_options, error);
+}
+
+void UdpActiveConnection::set_rate_limit(const RateLimit & limit)
+{
+    m_send_bucket.set_rate(limit.send_bytes_per_second, limit.burst_bytes);
+    m_recv_bucket.set_rate(limit.recv_bytes_per_second, limit.burst_bytes);
+}
+
+void UdpActiveConnection::set_timestamping(bool recv_enable, bool send_enable)
+{
+    m_timestamp_recv = recv_enable;
+    m_timestamp_send = send_enable;
+}
+
 void UdpActiveConnection::start()
 {
     boost::system::error_code ignore_error_code;
@@ -55,6 +152,20 @@ void UdpActiveConnection::start()
     m_host_port = m_socket.local_endpoint(ignore_error_code).port();
     m_peer_ip = m_socket.remote_endpoint(ignore_error_code).address().to_string();
     m_peer_port = m_socket.remote_endpoint(ignore_error_code).port();
+    m_socket.non_blocking(true, ignore_error_code);
+    if (m_batch.payload_size() != m_recv_buffer_size || 0 != m_segment_size || m_gro_enable)
+    {
+        m_batch.set_segment_offload(m_socket, m_recv_buffer_size, m_segment_size, m_gro_enable);
+    }
+    if (m_direct_send)
+    {
+        m_direct_sender.open(m_socket, m_batch.segment_size());
+    }
+    if (m_timestamp_recv || m_timestamp_send)
+    {
+        m_timestamping.enable(m_socket.native_handle(), m_timestamp_recv, m_timestamp_send);
+        m_batch.set_recv_timestamp(m_timestamping.recv_enabled());
+    }
 
     m_running = true;
 
@@ -67,6 +178,11 @@ void UdpActiveConnection::start()
         }
     }
 
+    if (m_timestamping.send_enabled())
+    {
+        wait_send_timestamps();
+    }
+
     recv();
 }
 
@@ -74,6 +190,9 @@ void UdpActiveConnection::stop()
 {
     if (m_running)
     {
+        m_send_timer.cancel();
+        m_recv_timer.cancel();
+        m_direct_sender.close();
         boost::system::error_code ignore_error_code;
         m_socket.shutdown(socket_type::shutdown_both, ignore_error_code);
         m_socket.close(ignore_error_code);
@@ -119,12 +238,7 @@ void UdpActiveConnection::handle_resolve(const boost::system::error_code & error
     m_resolver_results = results;
     m_resolver_iterator = m_resolver_results.begin();
 
-    m_socket.async_connect(
-        *m_resolver_iterator,
-        [self = shared_from_this()](const boost::system::error_code & error) {
-            self->handle_connect(error);
-        }
-    );
+    connect();
 }
 
 void UdpActiveConnection::handle_connect(const boost::system::error_code & error)
@@ -144,6 +258,19 @@ void UdpActiveConnection::handle_connect(const boost::system::error_code & error
         return;
     }
 
+    connect();
+}
+
+void UdpActiveConnection::connect()
+{
+    boost::system::error_code error;
+    open_multicast(m_resolver_iterator->endpoint(), error);
+    if (error)
+    {
+        handle_connect(error);
+        return;
+    }
+
     m_socket.async_connect(
         *m_resolver_iterator,
         [self = shared_from_this()](const boost::system::error_code & error) {
@@ -159,26 +286,107 @@ void UdpActiveConnection::close()
 
 void UdpActiveConnection::recv()
 {
-    m_socket.async_receive(
-        boost::asio::buffer(m_recv_data, sizeof(m_recv_data)),
-        [self = shared_from_this()](const boost::system::error_code & error, std::size_t bytes_transferred) {
-            self->handle_recv(error, bytes_transferred);
+    if (m_recv_bucket.limited())
+    {
+        std::size_t wait_microseconds = m_recv_bucket.wait_microseconds();
+        if (0 != wait_microseconds)
+        {
+            m_recv_timer.expires_after(std::chrono::microseconds(wait_microseconds));
+            m_recv_timer.async_wait(
+                [self = shared_from_this()](const boost::system::error_code & error) {
+                    self->handle_rate_wait(error, false);
+                }
+            );
+            return;
+        }
+    }
+
+    m_socket.async_wait(
+        socket_type::wait_read,
+        [self = shared_from_this()](const boost::system::error_code & error) {
+            self->handle_recv(error);
         }
     );
 }
 
 void UdpActiveConnection::send()
 {
-    m_socket.async_send(
-        boost::asio::buffer(m_send_buffer.front()),
-        [self = shared_from_this()](const boost::system::error_code & error, std::size_t bytes_transferred) {
-            self->handle_send(error, bytes_transferred);
+    while (!m_send_buffer.empty())
+    {
+        if (m_send_bucket.limited())
+        {
+            std::size_t wait_microseconds = m_send_bucket.wait_microseconds();
+            if (0 != wait_microseconds)
+            {
+                m_send_timer.expires_after(std::chrono::microseconds(wait_microseconds));
+                m_send_timer.async_wait(
+                    [self = shared_from_this()](const boost::system::error_code & error) {
+                        self->handle_rate_wait(error, true);
+                    }
+                );
+                return;
+            }
         }
-    );
+
+        if (0 == m_send_buffer.fill(m_batch))
+        {
+            break;
+        }
+
+        boost::system::error_code error;
+        std::size_t send_count = m_batch.send(m_socket, error);
+        m_send_bucket.consume(m_send_buffer.pop_sent(send_count));
+        if (boost::asio::error::would_block == error)
+        {
+            m_socket.async_wait(
+                socket_type::wait_write,
+                [self = shared_from_this()](const boost::system::error_code & error) {
+                    self->handle_send(error);
+                }
+            );
+            return;
+        }
+
+        if (error)
+        {
+            m_send_buffer.pop_error();
+            close();
+            return;
+        }
+    }
+
+    if (nullptr != m_udp_service)
+    {
+        if (!m_udp_service->on_send(shared_from_this()))
+        {
+            close();
+            return;
+        }
+    }
 }
 
 void UdpActiveConnection::post_send_data(const void * data, std::size_t len)
 {
+    if (m_send_counter->send_idle() && !m_send_bucket.limited())
+    {
+        boost::system::error_code error;
+        if (m_direct_sender.send(data, len, nullptr, error) && boost::asio::error::would_block != error)
+        {
+            m_send_counter->queued_count += 1;
+            if (error)
+            {
+                m_send_counter->error_count += 1;
+                close();
+            }
+            else
+            {
+                m_send_counter->sent_count += 1;
+            }
+            return;
+        }
+    }
+
+    m_send_counter->posted_count += 1;
     boost::asio::post(
         m_io_context,
         [self = shared_from_this(), pack = std::vector<char>(reinterpret_cast<const char *>(data), reinterpret_cast<const char *>(data) + len)]() mutable {
@@ -190,14 +398,26 @@ void UdpActiveConnection::post_send_data(const void * data, std::size_t len)
 void UdpActiveConnection::push_send_data(std::vector<char> data)
 {
     bool need_send = m_send_buffer.empty();
-    m_send_buffer.emplace_back(std::move(data));
+    std::size_t unit_size = m_batch.send_unit_size();
+    if (0 == unit_size || data.size() <= unit_size)
+    {
+        m_send_buffer.push(nullptr, std::move(data), m_send_counter);
+    }
+    else
+    {
+        for (std::size_t offset = 0; offset < data.size(); offset += unit_size)
+        {
+            m_send_buffer.push(nullptr, std::vector<char>(data.begin() + offset, data.begin() + std::min<std::size_t>(offset + unit_size, data.size())), m_send_counter);
+        }
+    }
+    m_send_counter->posted_count -= 1;
     if (need_send)
     {
         send();
     }
 }
 
-void UdpActiveConnection::handle_recv(const boost::system::error_code & error, std::size_t bytes_transferred)
+void UdpActiveConnection::handle_recv(const boost::system::error_code & error)
 {
     if (error)
     {
@@ -205,48 +425,120 @@ void UdpActiveConnection::handle_recv(const boost::system::error_code & error, s
         return;
     }
 
-    if (nullptr != m_udp_service)
+    boost::system::error_code recv_error;
+    std::size_t recv_count = m_batch.recv(m_socket, recv_error);
+    if (recv_error && boost::asio::error::would_block != recv_error)
+    {
+        close();
+        return;
+    }
+
+    for (std::size_t index = 0; index < recv_count; ++index)
     {
-        m_recv_buffer.emplace_back(std::vector<char>(m_recv_data, m_recv_data + bytes_transferred));
-        if (!m_udp_service->on_recv(shared_from_this()))
+        m_recv_bucket.consume(m_batch.recv_size(index));
+
+        if (m_cookie_echo && UdpPeerCookie::is_cookie(m_batch.recv_data(index), m_batch.recv_size(index)))
+        {
+            /* only the answer to our first datagram is echoed, a cookie arriving later is dropped */
+            if (m_cookie_pending)
+            {
+                m_cookie_pending = false;
+                push_send_data(std::vector<char>(m_batch.recv_data(index), m_batch.recv_data(index) + m_batch.recv_size(index)));
+            }
+            continue;
+        }
+        m_cookie_pending = false;
+
+        if (m_fragment_enable)
+        {
+            const char * message = nullptr;
+            std::size_t message_len = 0;
+            if (m_reassembler.input(m_batch.recv_data(index), m_batch.recv_size(index), message, message_len) && !deliver(message, message_len, m_batch.recv_timestamp(index)))
+            {
+                close();
+                return;
+            }
+        }
+        else if (!deliver(m_batch.recv_data(index), m_batch.recv_size(index), m_batch.recv_timestamp(index)))
         {
             close();
             return;
         }
     }
 
-    recv();
+    if (recv_count == m_batch.batch_count() && !m_recv_bucket.limited())
+    {
+        boost::asio::post(m_io_context, [self = shared_from_this()]() { self->handle_recv(boost::system::error_code()); });
+    }
+    else
+    {
+        recv();
+    }
 }
 
-void UdpActiveConnection::handle_send(const boost::system::error_code & error, std::size_t bytes_transferred)
+bool UdpActiveConnection::deliver(const char * data, std::size_t len, uint64_t timestamp)
 {
-    boost::ignore_unused(bytes_transferred);
+    m_recv_timestamp = timestamp;
+    if (nullptr != m_udp_service && m_datagram_callback)
+    {
+        return m_udp_service->on_datagram(shared_from_this(), data, len);
+    }
+    else if (nullptr != m_udp_service)
+    {
+        m_recv_buffer.emplace_back(data, len);
+        m_recv_buffer.back().set_timestamp(timestamp);
+        return m_udp_service->on_recv(shared_from_this());
+    }
+    return true;
+}
 
-    if (error)
+void UdpActiveConnection::handle_rate_wait(const boost::system::error_code & error, bool send_not_recv)
+{
+    if (error || !m_running)
     {
-        close();
         return;
     }
 
-    BOOST_ASSERT(!m_send_buffer.empty());
+    if (send_not_recv)
+    {
+        send();
+    }
+    else
+    {
+        recv();
+    }
+}
 
-    m_send_buffer.pop_front();
+void UdpActiveConnection::wait_send_timestamps()
+{
+    m_socket.async_wait(
+        socket_type::wait_error,
+        [self = shared_from_this()](const boost::system::error_code & error) {
+            self->handle_send_timestamps(error);
+        }
+    );
+}
 
-    if (m_send_buffer.empty())
+void UdpActiveConnection::handle_send_timestamps(const boost::system::error_code & error)
+{
+    if (error || !m_running)
     {
-        if (nullptr != m_udp_service)
-        {
-            if (!m_udp_service->on_send(shared_from_this()))
-            {
-                close();
-                return;
-            }
-        }
+        return;
     }
-    else
+
+    wait_send_timestamps();
+    m_timestamping.read_send_timestamps(m_socket.native_handle());
+}
+
+void UdpActiveConnection::handle_send(const boost::system::error_code & error)
+{
+    if (error)
     {
-        send();
+        close();
+        return;
     }
+
+    send();
 }
 
 void UdpActiveConnection::get_host_address(std::string & ip, unsigned short & port)
@@ -276,7 +568,7 @@ const void * UdpActiveConnection::recv_buffer_data()
     {
         return nullptr;
     }
-    return reinterpret_cast<const void *>(&m_recv_buffer.front()[0]);
+    return reinterpret_cast<const void *>(m_recv_buffer.front().data());
 }
 
 std::size_t UdpActiveConnection::recv_buffer_size()
@@ -298,14 +590,50 @@ bool UdpActiveConnection::recv_buffer_drop()
     return true;
 }
 
+bool UdpActiveConnection::recv_buffer_timestamp(KernelTimestamp & timestamp)
+{
+    return SocketTimestamping::to_timestamp(m_recv_buffer.empty() ? m_recv_timestamp : m_recv_buffer.front().timestamp(), timestamp);
+}
+
 bool UdpActiveConnection::send_buffer_fill(const void * data, std::size_t len)
 {
     if (nullptr == data && 0 != len)
     {
         return false;
     }
+    if (m_fragment_enable)
+    {
+        if (len > m_fragment_options.max_message_size)
+        {
+            return false;
+        }
+        static thread_local std::vector<char> fragment;
+        static thread_local std::vector<std::size_t> fragment_ends;
+        UdpReassembler::split(m_fragment_options, m_fragment_message_id++, data, len, fragment, fragment_ends);
+        std::size_t fragment_begin = 0;
+        for (std::vector<std::size_t>::const_iterator iter = fragment_ends.begin(); fragment_ends.end() != iter; ++iter)
+        {
+            post_send_data(fragment.data() + fragment_begin, *iter - fragment_begin);
+            fragment_begin = *iter;
+        }
+        return true;
+    }
     post_send_data(data, len);
     return true;
 }
 
+bool UdpActiveConnection::send_timestamp(KernelTimestamp & timestamp, std::size_t & send_count)
+{
+    return m_timestamping.send_timestamp(timestamp, send_count);
+}
+
+void UdpActiveConnection::get_send_statistics(UdpSendStatistics & statistics)
+{
+    statistics.queued_count = m_send_counter->queued_count;
+    statistics.sent_count = m_send_counter->sent_count;
+    statistics.dropped_count = m_send_counter->dropped_count;
+    statistics.error_count = m_send_counter->error_count;
+    statistics.recv_dropped_count = 0;
+}
+
 } // namespace BoostNet end
@@ -0,0 +1,365 @@
+/********************************************************
+ * Description : udp batch send and receive
+ * Data        : 2026-10-19 23:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <boost/core/ignore_unused.hpp>
+#include "udp_batch.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+#ifdef BOOST_NET_UDP_MMSG_SUPPORT
+#ifdef BOOST_NET_TIMESTAMPING_SUPPORT
+static const std::size_t s_recv_control_size = CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(struct scm_timestamping));
+#else
+static const std::size_t s_recv_control_size = CMSG_SPACE(sizeof(int));
+#endif // BOOST_NET_TIMESTAMPING_SUPPORT
+static const std::size_t s_send_control_size = CMSG_SPACE(sizeof(uint16_t));
+#endif // BOOST_NET_UDP_MMSG_SUPPORT
+
+UdpBatch::UdpBatch(std::size_t batch_count, std::size_t payload_size)
+    : m_max_batch_count(0 == batch_count ? 1 : batch_count)
+    , m_recv_budget(m_max_batch_count * payload_size)
+    , m_batch_count(0)
+    , m_payload_size(0)
+    , m_segment_size(0)
+    , m_gso_enable(false)
+    , m_gro_enable(false)
+    , m_timestamp_enable(false)
+    , m_recv_data()
+    , m_recv_segments()
+    , m_recv_endpoints()
+    , m_recv_timestamps()
+    , m_send_buffers()
+    , m_send_endpoints()
+    , m_send_connected()
+#ifdef BOOST_NET_UDP_MMSG_SUPPORT
+    , m_recv_headers()
+    , m_recv_iovecs()
+    , m_recv_controls()
+    , m_send_headers()
+    , m_send_iovecs()
+    , m_send_controls()
+#endif // BOOST_NET_UDP_MMSG_SUPPORT
+{
+    resize(m_max_batch_count, payload_size);
+}
+
+UdpBatch::~UdpBatch()
+{
+
+}
+
+void UdpBatch::resize(std::size_t batch_count, std::size_t payload_size)
+{
+    m_batch_count = batch_count;
+    m_payload_size = payload_size;
+
+    m_recv_data.assign(m_batch_count * m_payload_size, 0x0);
+    m_recv_segments.clear();
+    m_recv_segments.reserve(m_batch_count);
+    m_recv_endpoints.assign(m_batch_count, endpoint_type());
+    m_recv_timestamps.assign(m_batch_count, 0);
+    m_send_buffers.clear();
+    m_send_buffers.reserve(m_batch_count);
+    m_send_endpoints.clear();
+    m_send_endpoints.reserve(m_batch_count);
+    m_send_connected.clear();
+    m_send_connected.reserve(m_batch_count);
+
+#ifdef BOOST_NET_UDP_MMSG_SUPPORT
+    m_recv_headers.resize(m_batch_count);
+    m_recv_iovecs.resize(m_batch_count);
+    m_recv_controls.assign(m_batch_count * s_recv_control_size, 0x0);
+    m_send_headers.resize(m_batch_count);
+    m_send_iovecs.resize(m_batch_count);
+    m_send_controls.assign(m_batch_count * s_send_control_size, 0x0);
+
+    for (std::size_t index = 0; index < m_batch_count; ++index)
+    {
+        m_recv_iovecs[index].iov_base = &m_recv_data[index * m_payload_size];
+        m_recv_iovecs[index].iov_len = m_payload_size;
+        memset(&m_recv_headers[index], 0x0, sizeof(m_recv_headers[index]));
+        m_recv_headers[index].msg_hdr.msg_iov = &m_recv_iovecs[index];
+        m_recv_headers[index].msg_hdr.msg_iovlen = 1;
+    }
+#endif // BOOST_NET_UDP_MMSG_SUPPORT
+}
+
+std::size_t UdpBatch::batch_count() const
+{
+    return m_batch_count;
+}
+
+std::size_t UdpBatch::payload_size() const
+{
+    return m_payload_size;
+}
+
+void UdpBatch::set_segment_offload(socket_type & socket, std::size_t recv_buffer_size, std::size_t segment_size, bool gro_enable)
+{
+    m_segment_size = std::min<std::size_t>(segment_size, max_udp_payload);
+    m_gso_enable = false;
+    m_gro_enable = false;
+
+#ifdef BOOST_NET_UDP_OFFLOAD_SUPPORT
+    if (0 != m_segment_size)
+    {
+        int gso_size = static_cast<int>(m_segment_size);
+        m_gso_enable = 0 == ::setsockopt(socket.native_handle(), SOL_UDP, UDP_SEGMENT, &gso_size, sizeof(gso_size));
+        if (m_gso_enable)
+        {
+            gso_size = 0;
+            ::setsockopt(socket.native_handle(), SOL_UDP, UDP_SEGMENT, &gso_size, sizeof(gso_size));
+        }
+    }
+
+    int gro = gro_enable ? 1 : 0;
+    m_gro_enable = 0 == ::setsockopt(socket.native_handle(), SOL_UDP, UDP_GRO, &gro, sizeof(gro)) && gro_enable;
+#else
+    boost::ignore_unused(socket);
+    boost::ignore_unused(gro_enable);
+#endif // BOOST_NET_UDP_OFFLOAD_SUPPORT
+
+    std::size_t payload_size = m_gro_enable ? static_cast<std::size_t>(max_gro_payload) : std::max<std::size_t>(recv_buffer_size, 1);
+    std::size_t batch_count = std::max<std::size_t>(std::min<std::size_t>(m_recv_budget / payload_size, m_max_batch_count), 1);
+    resize(batch_count, payload_size);
+}
+
+std::size_t UdpBatch::segment_size() const
+{
+    return m_segment_size;
+}
+
+std::size_t UdpBatch::send_unit_size() const
+{
+    if (0 == m_segment_size || !m_gso_enable)
+    {
+        return m_segment_size;
+    }
+    return m_segment_size * std::max<std::size_t>(std::min<std::size_t>(max_udp_payload / m_segment_size, max_gso_segments), 1);
+}
+
+void UdpBatch::set_recv_timestamp(bool enable)
+{
+    m_timestamp_enable = enable;
+}
+
+void UdpBatch::push_segments(std::size_t index, std::size_t len, std::size_t segment_size)
+{
+    if (0 == segment_size || len <= segment_size)
+    {
+        segment_type segment = { index * m_payload_size, len, index };
+        m_recv_segments.push_back(segment);
+        return;
+    }
+
+    for (std::size_t offset = 0; offset < len; offset += segment_size)
+    {
+        segment_type segment = { index * m_payload_size + offset, std::min<std::size_t>(segment_size, len - offset), index };
+        m_recv_segments.push_back(segment);
+    }
+}
+
+std::size_t UdpBatch::recv(socket_type & socket, boost::system::error_code & error)
+{
+    error.clear();
+
+    m_recv_segments.clear();
+
+#ifdef BOOST_NET_UDP_MMSG_SUPPORT
+    for (std::size_t index = 0; index < m_batch_count; ++index)
+    {
+        m_recv_headers[index].msg_hdr.msg_name = m_recv_endpoints[index].data();
+        m_recv_headers[index].msg_hdr.msg_namelen = static_cast<socklen_t>(m_recv_endpoints[index].capacity());
+        m_recv_headers[index].msg_hdr.msg_control = (m_gro_enable || m_timestamp_enable) ? &m_recv_controls[index * s_recv_control_size] : nullptr;
+        m_recv_headers[index].msg_hdr.msg_controllen = (m_gro_enable || m_timestamp_enable) ? s_recv_control_size : 0;
+        m_recv_headers[index].msg_hdr.msg_flags = 0;
+        m_recv_headers[index].msg_len = 0;
+    }
+
+    int recv_count = -1;
+    do
+    {
+        recv_count = ::recvmmsg(socket.native_handle(), &m_recv_headers[0], static_cast<unsigned int>(m_batch_count), MSG_DONTWAIT, nullptr);
+    } while (recv_count < 0 && EINTR == errno);
+
+    if (recv_count < 0)
+    {
+        error = boost::system::error_code(errno, boost::asio::error::get_system_category());
+        return 0;
+    }
+
+    for (int index = 0; index < recv_count; ++index)
+    {
+        m_recv_endpoints[index].resize(m_recv_headers[index].msg_hdr.msg_namelen);
+        std::size_t segment_size = 0;
+#ifdef BOOST_NET_UDP_OFFLOAD_SUPPORT
+        if (m_gro_enable)
+        {
+            struct msghdr & header = m_recv_headers[index].msg_hdr;
+            for (struct cmsghdr * cmsg = CMSG_FIRSTHDR(&header); nullptr != cmsg; cmsg = CMSG_NXTHDR(&header, cmsg))
+            {
+                if (SOL_UDP == cmsg->cmsg_level && UDP_GRO == cmsg->cmsg_type)
+                {
+                    int gso_size = 0;
+                    memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+                    segment_size = static_cast<std::size_t>(gso_size);
+                }
+            }
+        }
+#endif // BOOST_NET_UDP_OFFLOAD_SUPPORT
+#ifdef BOOST_NET_TIMESTAMPING_SUPPORT
+        m_recv_timestamps[index] = m_timestamp_enable ? SocketTimestamping::recv_timestamp(m_recv_headers[index].msg_hdr) : 0;
+#endif // BOOST_NET_TIMESTAMPING_SUPPORT
+        push_segments(static_cast<std::size_t>(index), m_recv_headers[index].msg_len, segment_size);
+    }
+
+    return m_recv_segments.size();
+#else
+    std::size_t recv_count = 0;
+    while (recv_count < m_batch_count)
+    {
+        std::size_t recv_size = socket.receive_from(boost::asio::buffer(&m_recv_data[recv_count * m_payload_size], m_payload_size), m_recv_endpoints[recv_count], 0, error);
+        if (error)
+        {
+            break;
+        }
+        push_segments(recv_count++, recv_size, 0);
+    }
+
+    if (0 != recv_count)
+    {
+        error.clear();
+    }
+
+    return m_recv_segments.size();
+#endif // BOOST_NET_UDP_MMSG_SUPPORT
+}
+
+const char * UdpBatch::recv_data(std::size_t index) const
+{
+    return &m_recv_data[m_recv_segments[index].offset];
+}
+
+std::size_t UdpBatch::recv_size(std::size_t index) const
+{
+    return m_recv_segments[index].size;
+}
+
+const UdpBatch::endpoint_type & UdpBatch::recv_endpoint(std::size_t index) const
+{
+    return m_recv_endpoints[m_recv_segments[index].index];
+}
+
+uint64_t UdpBatch::recv_timestamp(std::size_t index) const
+{
+    return m_recv_timestamps[m_recv_segments[index].index];
+}
+
+bool UdpBatch::send_push(const void * data, std::size_t len, const endpoint_type * endpoint)
+{
+    if (m_send_buffers.size() >= m_batch_count)
+    {
+        return false;
+    }
+
+    m_send_buffers.push_back(boost::asio::const_buffer(data, len));
+    m_send_endpoints.push_back(nullptr == endpoint ? endpoint_type() : *endpoint);
+    m_send_connected.push_back(nullptr == endpoint);
+
+    return true;
+}
+
+std::size_t UdpBatch::send(socket_type & socket, boost::system::error_code & error)
+{
+    error.clear();
+
+    std::size_t send_count = 0;
+
+#ifdef BOOST_NET_UDP_MMSG_SUPPORT
+    for (std::size_t index = 0; index < m_send_buffers.size(); ++index)
+    {
+        m_send_iovecs[index].iov_base = const_cast<void *>(m_send_buffers[index].data());
+        m_send_iovecs[index].iov_len = m_send_buffers[index].size();
+        memset(&m_send_headers[index], 0x0, sizeof(m_send_headers[index]));
+        m_send_headers[index].msg_hdr.msg_iov = &m_send_iovecs[index];
+        m_send_headers[index].msg_hdr.msg_iovlen = 1;
+        if (!m_send_connected[index])
+        {
+            m_send_headers[index].msg_hdr.msg_name = m_send_endpoints[index].data();
+            m_send_headers[index].msg_hdr.msg_namelen = static_cast<socklen_t>(m_send_endpoints[index].size());
+        }
+#ifdef BOOST_NET_UDP_OFFLOAD_SUPPORT
+        if (m_gso_enable && m_send_buffers[index].size() > m_segment_size)
+        {
+            struct msghdr & header = m_send_headers[index].msg_hdr;
+            header.msg_control = &m_send_controls[index * s_send_control_size];
+            header.msg_controllen = s_send_control_size;
+            struct cmsghdr * cmsg = CMSG_FIRSTHDR(&header);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            uint16_t gso_size = static_cast<uint16_t>(m_segment_size);
+            memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+        }
+#endif // BOOST_NET_UDP_OFFLOAD_SUPPORT
+    }
+
+    if (!m_send_buffers.empty())
+    {
+        int sent = -1;
+        do
+        {
+            sent = ::sendmmsg(socket.native_handle(), &m_send_headers[0], static_cast<unsigned int>(m_send_buffers.size()), MSG_DONTWAIT | MSG_NOSIGNAL);
+        } while (sent < 0 && EINTR == errno);
+
+        if (sent < 0)
+        {
+            error = boost::system::error_code(errno, boost::asio::error::get_system_category());
+        }
+        else
+        {
+            send_count = static_cast<std::size_t>(sent);
+        }
+    }
+#else
+    while (send_count < m_send_buffers.size())
+    {
+        if (m_send_connected[send_count])
+        {
+            socket.send(boost::asio::buffer(m_send_buffers[send_count]), 0, error);
+        }
+        else
+        {
+            socket.send_to(boost::asio::buffer(m_send_buffers[send_count]), m_send_endpoints[send_count], 0, error);
+        }
+        if (error)
+        {
+            break;
+        }
+        ++send_count;
+    }
+
+    if (0 != send_count)
+    {
+        error.clear();
+    }
+#endif // BOOST_NET_UDP_MMSG_SUPPORT
+
+    m_send_buffers.clear();
+    m_send_endpoints.clear();
+    m_send_connected.clear();
+
+    return send_count;
+}
+
+} // namespace BoostNet end
@@ -0,0 +1,250 @@
+/********************************************************
+ * Description : pooled udp datagram buffer
+ * Data        : 2026-10-20 01:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <cstring>
+#include <vector>
+#include "udp_datagram.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+class UdpDatagramPool
+{
+public:
+    UdpDatagramPool();
+    ~UdpDatagramPool();
+
+public:
+    UdpDatagramPool(const UdpDatagramPool &) = delete;
+    UdpDatagramPool(UdpDatagramPool &&) = delete;
+    UdpDatagramPool & operator = (const UdpDatagramPool &) = delete;
+    UdpDatagramPool & operator = (UdpDatagramPool &&) = delete;
+
+public:
+    char * acquire(std::size_t len, std::size_t & capacity);
+    void release(char * data, std::size_t capacity);
+
+public:
+    static UdpDatagramPool * instance();
+
+private:
+    static std::size_t slab_index(std::size_t capacity);
+
+private:
+    enum { min_slab_shift = 8, slab_class_count = 9, slab_class_bytes = 1024 * 1024 };
+
+private:
+    std::vector<char *>                             m_free_slabs[slab_class_count];
+};
+
+UdpDatagramPool::UdpDatagramPool()
+    : m_free_slabs()
+{
+
+}
+
+UdpDatagramPool::~UdpDatagramPool()
+{
+    for (std::size_t index = 0; index < slab_class_count; ++index)
+    {
+        for (std::vector<char *>::iterator iter = m_free_slabs[index].begin(); m_free_slabs[index].end() != iter; ++iter)
+        {
+            delete [] *iter;
+        }
+    }
+}
+
+static thread_local UdpDatagramPool * s_datagram_pool = nullptr;
+static thread_local bool s_datagram_pool_exited = false;
+
+struct UdpDatagramPoolHolder
+{
+    ~UdpDatagramPoolHolder()
+    {
+        delete s_datagram_pool;
+        s_datagram_pool = nullptr;
+        s_datagram_pool_exited = true;
+    }
+};
+
+UdpDatagramPool * UdpDatagramPool::instance()
+{
+    if (nullptr == s_datagram_pool && !s_datagram_pool_exited)
+    {
+        static thread_local UdpDatagramPoolHolder s_holder;
+        s_datagram_pool = new UdpDatagramPool;
+    }
+    return s_datagram_pool;
+}
+
+std::size_t UdpDatagramPool::slab_index(std::size_t capacity)
+{
+    std::size_t index = 0;
+    while ((static_cast<std::size_t>(1) << (min_slab_shift + index)) < capacity)
+    {
+        ++index;
+    }
+    return index;
+}
+
+char * UdpDatagramPool::acquire(std::size_t len, std::size_t & capacity)
+{
+    std::size_t index = slab_index(len);
+    if (index >= slab_class_count)
+    {
+        capacity = len;
+        return new char[len];
+    }
+
+    capacity = static_cast<std::size_t>(1) << (min_slab_shift + index);
+
+    std::vector<char *> & free_slabs = m_free_slabs[index];
+    if (free_slabs.empty())
+    {
+        return new char[capacity];
+    }
+
+    char * data = free_slabs.back();
+    free_slabs.pop_back();
+    return data;
+}
+
+void UdpDatagramPool::release(char * data, std::size_t capacity)
+{
+    std::size_t index = slab_index(capacity);
+    if (index >= slab_class_count || (static_cast<std::size_t>(1) << (min_slab_shift + index)) != capacity || m_free_slabs[index].size() * capacity >= slab_class_bytes)
+    {
+        delete [] data;
+        return;
+    }
+
+    m_free_slabs[index].push_back(data);
+}
+
+UdpDatagram::UdpDatagram()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_capacity(0)
+    , m_timestamp(0)
+{
+
+}
+
+UdpDatagram::UdpDatagram(const void * data, std::size_t len)
+    : m_data(nullptr)
+    , m_size(0)
+    , m_capacity(0)
+    , m_timestamp(0)
+{
+    assign(data, len);
+}
+
+UdpDatagram::~UdpDatagram()
+{
+    clear();
+}
+
+UdpDatagram::UdpDatagram(UdpDatagram && other)
+    : m_data(other.m_data)
+    , m_size(other.m_size)
+    , m_capacity(other.m_capacity)
+    , m_timestamp(other.m_timestamp)
+{
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_capacity = 0;
+    other.m_timestamp = 0;
+}
+
+UdpDatagram & UdpDatagram::operator = (UdpDatagram && other)
+{
+    if (&other != this)
+    {
+        clear();
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        m_timestamp = other.m_timestamp;
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_capacity = 0;
+        other.m_timestamp = 0;
+    }
+    return *this;
+}
+
+const char * UdpDatagram::data() const
+{
+    return m_data;
+}
+
+std::size_t UdpDatagram::size() const
+{
+    return m_size;
+}
+
+bool UdpDatagram::empty() const
+{
+    return 0 == m_size;
+}
+
+void UdpDatagram::assign(const void * data, std::size_t len)
+{
+    if (len > m_capacity)
+    {
+        clear();
+        UdpDatagramPool * pool = UdpDatagramPool::instance();
+        if (nullptr != pool)
+        {
+            m_data = pool->acquire(len, m_capacity);
+        }
+        else
+        {
+            m_data = new char[len];
+            m_capacity = len;
+        }
+    }
+    if (0 != len)
+    {
+        memcpy(m_data, data, len);
+    }
+    m_size = len;
+}
+
+void UdpDatagram::clear()
+{
+    if (nullptr != m_data)
+    {
+        UdpDatagramPool * pool = UdpDatagramPool::instance();
+        if (nullptr != pool)
+        {
+            pool->release(m_data, m_capacity);
+        }
+        else
+        {
+            delete [] m_data;
+        }
+        m_data = nullptr;
+    }
+    m_size = 0;
+    m_capacity = 0;
+    m_timestamp = 0;
+}
+
+void UdpDatagram::set_timestamp(uint64_t timestamp)
+{
+    m_timestamp = timestamp;
+}
+
+uint64_t UdpDatagram::timestamp() const
+{
+    return m_timestamp;
+}
+
+} // namespace BoostNet end
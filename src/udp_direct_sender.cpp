@@ -0,0 +1,111 @@
+/********************************************************
+ * Description : udp direct send from the calling thread
+ * Data        : 2026-10-20 02:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <cerrno>
+#include <thread>
+#include "udp_direct_sender.h"
+
+#if !defined(_MSC_VER) && !defined(_WIN32) && !defined(_WIN64)
+    #include <sys/types.h>
+    #include <sys/socket.h>
+#endif // !defined(_MSC_VER) && !defined(_WIN32) && !defined(_WIN64)
+
+namespace BoostNet { // namespace BoostNet begin
+
+UdpDirectSender::UdpDirectSender()
+    : m_opened(false)
+    , m_senders(0)
+    , m_unit_size(0)
+    , m_handle()
+{
+
+}
+
+UdpDirectSender::~UdpDirectSender()
+{
+
+}
+
+void UdpDirectSender::open(socket_type & socket, std::size_t unit_size)
+{
+    close();
+    m_handle = socket.native_handle();
+    m_unit_size = unit_size;
+    m_opened = true;
+}
+
+void UdpDirectSender::set_unit_size(std::size_t unit_size)
+{
+    m_unit_size = unit_size;
+}
+
+void UdpDirectSender::close()
+{
+    m_opened = false;
+    while (0 != m_senders)
+    {
+        std::this_thread::yield();
+    }
+}
+
+bool UdpDirectSender::send(const void * data, std::size_t len, const endpoint_type * endpoint, boost::system::error_code & error)
+{
+    std::size_t unit_size = m_unit_size;
+    if (0 != unit_size && len > unit_size)
+    {
+        return false;
+    }
+
+    ++m_senders;
+
+    if (!m_opened)
+    {
+        --m_senders;
+        return false;
+    }
+
+    error.clear();
+
+#if defined(_MSC_VER) || defined(_WIN32) || defined(_WIN64)
+    int sent = (nullptr == endpoint) ?
+               ::send(m_handle, reinterpret_cast<const char *>(data), static_cast<int>(len), 0) :
+               ::sendto(m_handle, reinterpret_cast<const char *>(data), static_cast<int>(len), 0, endpoint->data(), static_cast<int>(endpoint->size()));
+    if (sent < 0)
+    {
+        error = boost::system::error_code(::WSAGetLastError(), boost::asio::error::get_system_category());
+    }
+#else
+    ssize_t sent = -1;
+    do
+    {
+        sent = (nullptr == endpoint) ?
+               ::send(m_handle, data, len, MSG_DONTWAIT | MSG_NOSIGNAL) :
+               ::sendto(m_handle, data, len, MSG_DONTWAIT | MSG_NOSIGNAL, endpoint->data(), static_cast<socklen_t>(endpoint->size()));
+    } while (sent < 0 && EINTR == errno);
+    if (sent < 0)
+    {
+        int error_value = errno;
+        if (EAGAIN == error_value || EWOULDBLOCK == error_value)
+        {
+            error = boost::asio::error::would_block;
+        }
+        else
+        {
+            error = boost::system::error_code(error_value, boost::asio::error::get_system_category());
+        }
+    }
+#endif // defined(_MSC_VER) || defined(_WIN32) || defined(_WIN64)
+
+    --m_senders;
+
+    return true;
+}
+
+} // namespace BoostNet end
@@ -0,0 +1,230 @@
+/********************************************************
+ * Description : udp message fragmentation and reassembly
+ * Data        : 2026-10-20 03:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include "udp_fragment.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+static inline void encode_u16(char * buffer, uint16_t value)
+{
+    buffer[0] = static_cast<char>(value & 0xff);
+    buffer[1] = static_cast<char>((value >> 8) & 0xff);
+}
+
+static inline void encode_u32(char * buffer, uint32_t value)
+{
+    encode_u16(buffer, static_cast<uint16_t>(value & 0xffff));
+    encode_u16(buffer + 2, static_cast<uint16_t>((value >> 16) & 0xffff));
+}
+
+static inline uint16_t decode_u16(const char * buffer)
+{
+    const unsigned char * bytes = reinterpret_cast<const unsigned char *>(buffer);
+    return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+static inline uint32_t decode_u32(const char * buffer)
+{
+    return static_cast<uint32_t>(decode_u16(buffer)) | (static_cast<uint32_t>(decode_u16(buffer + 2)) << 16);
+}
+
+UdpReassembler::UdpReassembler()
+    : m_options()
+    , m_slots()
+{
+    m_options.mtu = 0;
+    m_options.max_message_size = 0;
+    m_options.slot_count = 0;
+    m_options.timeout_milliseconds = 0;
+}
+
+UdpReassembler::~UdpReassembler()
+{
+
+}
+
+bool UdpReassembler::check_options(const UdpFragmentOptions & options)
+{
+    if (options.mtu <= header_size || options.mtu > 65507 || 0 == options.slot_count || 0 == options.max_message_size || options.max_message_size > 0xffffffffULL)
+    {
+        return false;
+    }
+    std::size_t fragment_count = (options.max_message_size + options.mtu - header_size - 1) / (options.mtu - header_size);
+    return fragment_count <= 0xffff;
+}
+
+bool UdpReassembler::init(const UdpFragmentOptions & options)
+{
+    if (!check_options(options))
+    {
+        return false;
+    }
+
+    m_options = options;
+
+    std::size_t fragment_count = (options.max_message_size + options.mtu - header_size - 1) / (options.mtu - header_size);
+    m_slots.resize(options.slot_count);
+    for (std::vector<slot_type>::iterator iter = m_slots.begin(); m_slots.end() != iter; ++iter)
+    {
+        iter->used = false;
+        iter->message_id = 0;
+        iter->message_size = 0;
+        iter->fragment_count = 0;
+        iter->received_count = 0;
+        iter->start_time = 0;
+        iter->received.assign((fragment_count + 63) / 64, 0);
+    }
+
+    return true;
+}
+
+void UdpReassembler::split(const UdpFragmentOptions & options, uint32_t message_id, const void * data, std::size_t len, std::vector<char> & fragment, std::vector<std::size_t> & fragment_ends)
+{
+    std::size_t payload_size = options.mtu - header_size;
+    std::size_t fragment_count = (0 == len ? 1 : (len + payload_size - 1) / payload_size);
+
+    fragment.resize(fragment_count * header_size + len);
+    fragment_ends.resize(fragment_count);
+
+    const char * bytes = reinterpret_cast<const char *>(data);
+    char * buffer = fragment.data();
+    for (std::size_t index = 0; index < fragment_count; ++index)
+    {
+        std::size_t offset = index * payload_size;
+        std::size_t size = std::min<std::size_t>(payload_size, len - offset);
+        encode_u32(buffer, message_id);
+        encode_u32(buffer + 4, static_cast<uint32_t>(len));
+        encode_u32(buffer + 8, static_cast<uint32_t>(offset));
+        encode_u16(buffer + 12, static_cast<uint16_t>(index));
+        encode_u16(buffer + 14, static_cast<uint16_t>(fragment_count));
+        if (0 != size)
+        {
+            memcpy(buffer + header_size, bytes + offset, size);
+        }
+        buffer += header_size + size;
+        fragment_ends[index] = static_cast<std::size_t>(buffer - fragment.data());
+    }
+}
+
+uint64_t UdpReassembler::current_milliseconds()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+UdpReassembler::slot_type & UdpReassembler::select_slot(uint32_t message_id, uint32_t message_size, uint16_t fragment_count, uint64_t current)
+{
+    std::vector<slot_type>::iterator victim = m_slots.end();
+    for (std::vector<slot_type>::iterator iter = m_slots.begin(); m_slots.end() != iter; ++iter)
+    {
+        if (!iter->used)
+        {
+            if (m_slots.end() == victim || victim->used)
+            {
+                victim = iter;
+            }
+            continue;
+        }
+        if (iter->message_id == message_id && iter->message_size == message_size && iter->fragment_count == fragment_count && iter->start_time + m_options.timeout_milliseconds > current)
+        {
+            return *iter;
+        }
+        if (m_slots.end() == victim || (victim->used && iter->start_time < victim->start_time))
+        {
+            victim = iter;
+        }
+    }
+
+    victim->used = true;
+    victim->message_id = message_id;
+    victim->message_size = message_size;
+    victim->fragment_count = fragment_count;
+    victim->received_count = 0;
+    victim->start_time = current;
+    std::fill(victim->received.begin(), victim->received.begin() + (fragment_count + 63) / 64, 0);
+    victim->buffer.resize(message_size);
+
+    return *victim;
+}
+
+bool UdpReassembler::input(const void * data, std::size_t len, const char *& message, std::size_t & message_len)
+{
+    if (nullptr == data || len < header_size)
+    {
+        return false;
+    }
+
+    const char * buffer = reinterpret_cast<const char *>(data);
+    uint32_t message_id = decode_u32(buffer);
+    uint32_t message_size = decode_u32(buffer + 4);
+    uint32_t fragment_offset = decode_u32(buffer + 8);
+    uint16_t fragment_index = decode_u16(buffer + 12);
+    uint16_t fragment_count = decode_u16(buffer + 14);
+    std::size_t payload_size = len - header_size;
+
+    if (0 == fragment_count || fragment_index >= fragment_count || message_size > m_options.max_message_size)
+    {
+        return false;
+    }
+
+    /* fragments are laid out as split() lays them out: full payloads at index * full_size, the remainder in the last one */
+    std::size_t full_size = m_options.mtu - header_size;
+    std::size_t expected_count = (0 == message_size ? 1 : (message_size + full_size - 1) / full_size);
+    if (fragment_count != expected_count || fragment_offset != fragment_index * full_size)
+    {
+        return false;
+    }
+
+    if (payload_size != std::min<std::size_t>(full_size, message_size - fragment_offset))
+    {
+        return false;
+    }
+
+    if (1 == fragment_count)
+    {
+        message = buffer + header_size;
+        message_len = payload_size;
+        return true;
+    }
+
+    if (static_cast<std::size_t>(fragment_count) > m_slots.front().received.size() * 64)
+    {
+        return false;
+    }
+
+    slot_type & slot = select_slot(message_id, message_size, fragment_count, current_milliseconds());
+    uint64_t & bits = slot.received[fragment_index / 64];
+    uint64_t mask = (static_cast<uint64_t>(1) << (fragment_index % 64));
+    if (0 != (bits & mask))
+    {
+        return false;
+    }
+    bits |= mask;
+
+    if (0 != payload_size)
+    {
+        memcpy(&slot.buffer[fragment_offset], buffer + header_size, payload_size);
+    }
+
+    if (++slot.received_count != slot.fragment_count)
+    {
+        return false;
+    }
+
+    slot.used = false;
+    message = slot.buffer.data();
+    message_len = slot.message_size;
+
+    return true;
+}
+
+} // namespace BoostNet end
@@ -82,4 +82,92 @@ bool UdpManager::create_connection(const std::string & host, unsigned short port
     return nullptr != m_manager_impl && m_manager_impl->create_connection(host, port, sync_connect, identity, bind_ip, bind_port);
 }
 
+bool UdpManager::set_segment_offload(std::size_t segment_size, bool gro_enable, std::size_t recv_buffer_size)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_segment_offload(segment_size, gro_enable, recv_buffer_size);
+}
+
+bool UdpManager::set_peer_limit(std::size_t idle_milliseconds, std::size_t max_peer_count, bool evict_when_full)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_peer_limit(idle_milliseconds, max_peer_count, evict_when_full);
+}
+
+bool UdpManager::set_peer_cookie(bool enable, std::size_t max_replies_per_second)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_peer_cookie(enable, max_replies_per_second);
+}
+
+bool UdpManager::set_peer_dispatch(bool enable)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_peer_dispatch(enable);
+}
+
+bool UdpManager::set_datagram_callback(bool enable)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_datagram_callback(enable);
+}
+
+bool UdpManager::set_send_queue_limit(std::size_t max_packets, std::size_t max_bytes, std::size_t max_peer_packets, std::size_t max_peer_bytes, UdpDropPolicy drop_policy, std::size_t max_age_milliseconds)
+{
+    UdpSendLimit limit;
+    limit.max_packets = max_packets;
+    limit.max_bytes = max_bytes;
+    limit.max_peer_packets = max_peer_packets;
+    limit.max_peer_bytes = max_peer_bytes;
+    limit.drop_policy = drop_policy;
+    limit.max_age_milliseconds = max_age_milliseconds;
+    return nullptr != m_manager_impl && m_manager_impl->set_send_queue_limit(limit);
+}
+
+bool UdpManager::set_direct_send(bool enable)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_direct_send(enable);
+}
+
+bool UdpManager::set_message_fragment(bool enable, std::size_t mtu, std::size_t max_message_size, std::size_t slot_count, std::size_t timeout_milliseconds)
+{
+    UdpFragmentOptions options;
+    options.mtu = mtu;
+    options.max_message_size = max_message_size;
+    options.slot_count = slot_count;
+    options.timeout_milliseconds = timeout_milliseconds;
+    return nullptr != m_manager_impl && m_manager_impl->set_message_fragment(options, enable);
+}
+
+bool UdpManager::join_multicast_group(const char * group_ip, const char * interface_ip)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_multicast_group(group_ip, interface_ip, true);
+}
+
+bool UdpManager::leave_multicast_group(const char * group_ip, const char * interface_ip)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_multicast_group(group_ip, interface_ip, false);
+}
+
+bool UdpManager::set_multicast_options(std::size_t ttl, bool loopback, const char * interface_ip)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_multicast_options(ttl, loopback, interface_ip);
+}
+
+bool UdpManager::set_shared_socket(bool enable, std::size_t socket_count)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_shared_socket(enable, socket_count);
+}
+
+bool UdpManager::set_rate_limit(std::size_t send_bytes_per_second, std::size_t recv_bytes_per_second, std::size_t listener_send_bytes_per_second, std::size_t listener_recv_bytes_per_second, std::size_t burst_bytes)
+{
+    RateLimit limit;
+    limit.send_bytes_per_second = send_bytes_per_second;
+    limit.recv_bytes_per_second = recv_bytes_per_second;
+    limit.listener_send_bytes_per_second = listener_send_bytes_per_second;
+    limit.listener_recv_bytes_per_second = listener_recv_bytes_per_second;
+    limit.burst_bytes = burst_bytes;
+    return nullptr != m_manager_impl && m_manager_impl->set_rate_limit(limit);
+}
+
+bool UdpManager::set_timestamping(bool recv_enable, bool send_enable)
+{
+    return nullptr != m_manager_impl && m_manager_impl->set_timestamping(recv_enable, send_enable);
+}
+
 } // namespace BoostNet end
@@ -18,7 +18,49 @@ UdpManagerImpl::UdpManagerImpl()
     : m_io_context_pool()
     , m_udp_service(nullptr)
     , m_udp_ports()
+    , m_udp_acceptors()
+    , m_shared_mutex()
+    , m_shared_acceptors()
+    , m_shared_index(0)
+    , m_shared_socket(false)
+    , m_recv_buffer_size(1500)
+    , m_segment_size(0)
+    , m_gro_enable(false)
+    , m_datagram_callback(false)
+    , m_cookie_echo(false)
+    , m_send_limit_mutex()
+    , m_send_limit()
+    , m_direct_send(false)
+    , m_fragment_mutex()
+    , m_fragment_options()
+    , m_fragment_enable(false)
+    , m_multicast_mutex()
+    , m_multicast_options()
+    , m_rate_limit_mutex()
+    , m_rate_limit()
+    , m_timestamp_recv(false)
+    , m_timestamp_send(false)
 {
+    m_send_limit.max_packets = 0;
+    m_send_limit.max_bytes = 0;
+    m_send_limit.max_peer_packets = 0;
+    m_send_limit.max_peer_bytes = 0;
+    m_send_limit.drop_policy = udp_drop_newest;
+    m_send_limit.max_age_milliseconds = 0;
+
+    m_fragment_options.mtu = 0;
+    m_fragment_options.max_message_size = 0;
+    m_fragment_options.slot_count = 0;
+    m_fragment_options.timeout_milliseconds = 0;
+
+    m_multicast_options.ttl = 1;
+    m_multicast_options.loopback = true;
+
+    m_rate_limit.send_bytes_per_second = 0;
+    m_rate_limit.recv_bytes_per_second = 0;
+    m_rate_limit.listener_send_bytes_per_second = 0;
+    m_rate_limit.listener_recv_bytes_per_second = 0;
+    m_rate_limit.burst_bytes = 0;
 
 }
 
@@ -75,9 +117,10 @@ bool UdpManagerImpl::init(UdpServiceBase * udp_service, std::size_t thread_count
             }
             else
             {
-                udp_acceptor_ptr udp_acceptor = boost::factory<udp_acceptor_ptr>()(m_io_context_pool.get(), m_udp_service, host, port);
+                udp_acceptor_ptr udp_acceptor = boost::factory<udp_acceptor_ptr>()(m_io_context_pool.get(), m_udp_service, host, port, m_recv_buffer_size);
                 if (udp_acceptor->start())
                 {
+                    m_udp_acceptors.push_back(udp_acceptor);
                     m_udp_ports.push_back(port);
                     break;
                 }
@@ -101,11 +144,12 @@ bool UdpManagerImpl::init(UdpServiceBase * udp_service, std::size_t thread_count
             }
             else
             {
-                udp_acceptor_ptr udp_acceptor = boost::factory<udp_acceptor_ptr>()(m_io_context_pool.get(), m_udp_service, host, port);
+                udp_acceptor_ptr udp_acceptor = boost::factory<udp_acceptor_ptr>()(m_io_context_pool.get(), m_udp_service, host, port, m_recv_buffer_size);
                 if (!udp_acceptor->start())
                 {
                     return false;
                 }
+                m_udp_acceptors.push_back(udp_acceptor);
             }
         }
         m_udp_ports.assign(port_array, port_array + port_count);
@@ -117,6 +161,13 @@ bool UdpManagerImpl::init(UdpServiceBase * udp_service, std::size_t thread_count
 void UdpManagerImpl::exit()
 {
     m_io_context_pool.exit();
+    m_io_context_pool.run(true);
+    m_udp_acceptors.clear();
+    m_shared_socket = false;
+    {
+        std::lock_guard<std::mutex> locker(m_shared_mutex);
+        m_shared_acceptors.clear();
+    }
     m_udp_service = nullptr;
     m_udp_ports.clear();
 }
@@ -133,6 +184,11 @@ void UdpManagerImpl::run(bool blocking)
 
 bool UdpManagerImpl::create_connection(const std::string & host, const std::string & service, bool sync_connect, const void * identity, const char * bind_ip, unsigned short bind_port)
 {
+    if (m_shared_socket)
+    {
+        return shared_create_connection(host, service, sync_connect, identity);
+    }
+
     if (sync_connect)
     {
         return sync_create_connection(host, service, identity, bind_ip, bind_port);
@@ -148,6 +204,426 @@ bool UdpManagerImpl::create_connection(const std::string & host, unsigned short
     return create_connection(host, boost::lexical_cast<std::string>(port), sync_connect, identity, bind_ip, bind_port);
 }
 
+bool UdpManagerImpl::set_segment_offload(std::size_t segment_size, bool gro_enable, std::size_t recv_buffer_size)
+{
+    if (0 == recv_buffer_size || recv_buffer_size > 65535 || segment_size > 65507)
+    {
+        return false;
+    }
+
+    m_recv_buffer_size = recv_buffer_size;
+    m_segment_size = segment_size;
+    m_gro_enable = gro_enable;
+
+    for (std::vector<udp_acceptor_ptr>::iterator iter = m_udp_acceptors.begin(); m_udp_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_segment_offload(recv_buffer_size, segment_size, gro_enable);
+    }
+
+    std::vector<udp_acceptor_ptr> shared_acceptors;
+    get_shared_acceptors(shared_acceptors);
+    for (std::vector<udp_acceptor_ptr>::iterator iter = shared_acceptors.begin(); shared_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_segment_offload(recv_buffer_size, segment_size, gro_enable);
+    }
+
+    return true;
+}
+
+bool UdpManagerImpl::set_peer_limit(std::size_t idle_milliseconds, std::size_t max_peer_count, bool evict_when_full)
+{
+    if (m_udp_acceptors.empty())
+    {
+        return false;
+    }
+
+    for (std::vector<udp_acceptor_ptr>::iterator iter = m_udp_acceptors.begin(); m_udp_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_peer_limit(idle_milliseconds, max_peer_count, evict_when_full);
+    }
+
+    return true;
+}
+
+bool UdpManagerImpl::set_peer_cookie(bool enable, std::size_t max_replies_per_second)
+{
+    if (nullptr == m_udp_service)
+    {
+        return false;
+    }
+
+    m_cookie_echo = enable;
+
+    for (std::vector<udp_acceptor_ptr>::iterator iter = m_udp_acceptors.begin(); m_udp_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_peer_cookie(enable, max_replies_per_second);
+        (*iter)->set_cookie_echo(enable);
+    }
+
+    std::vector<udp_acceptor_ptr> shared_acceptors;
+    get_shared_acceptors(shared_acceptors);
+    for (std::vector<udp_acceptor_ptr>::iterator iter = shared_acceptors.begin(); shared_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_cookie_echo(enable);
+    }
+
+    return true;
+}
+
+bool UdpManagerImpl::set_peer_dispatch(bool enable)
+{
+    if (m_udp_acceptors.empty())
+    {
+        return false;
+    }
+
+    std::vector<io_context_type *> io_contexts;
+    for (std::size_t index = 0; index < m_io_context_pool.size(); ++index)
+    {
+        io_contexts.push_back(&m_io_context_pool.get(index));
+    }
+
+    for (std::vector<udp_acceptor_ptr>::iterator iter = m_udp_acceptors.begin(); m_udp_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_peer_dispatch(io_contexts, enable);
+    }
+
+    return true;
+}
+
+bool UdpManagerImpl::set_datagram_callback(bool enable)
+{
+    m_datagram_callback = enable;
+
+    for (std::vector<udp_acceptor_ptr>::iterator iter = m_udp_acceptors.begin(); m_udp_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_datagram_callback(enable);
+    }
+
+    std::vector<udp_acceptor_ptr> shared_acceptors;
+    get_shared_acceptors(shared_acceptors);
+    for (std::vector<udp_acceptor_ptr>::iterator iter = shared_acceptors.begin(); shared_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_datagram_callback(enable);
+    }
+
+    return true;
+}
+
+bool UdpManagerImpl::set_send_queue_limit(const UdpSendLimit & limit)
+{
+    {
+        std::lock_guard<std::mutex> locker(m_send_limit_mutex);
+        m_send_limit = limit;
+    }
+
+    for (std::vector<udp_acceptor_ptr>::iterator iter = m_udp_acceptors.begin(); m_udp_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_send_queue_limit(limit);
+    }
+
+    std::vector<udp_acceptor_ptr> shared_acceptors;
+    get_shared_acceptors(shared_acceptors);
+    for (std::vector<udp_acceptor_ptr>::iterator iter = shared_acceptors.begin(); shared_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_send_queue_limit(limit);
+    }
+
+    return true;
+}
+
+bool UdpManagerImpl::set_direct_send(bool enable)
+{
+    m_direct_send = enable;
+
+    for (std::vector<udp_acceptor_ptr>::iterator iter = m_udp_acceptors.begin(); m_udp_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_direct_send(enable);
+    }
+
+    std::vector<udp_acceptor_ptr> shared_acceptors;
+    get_shared_acceptors(shared_acceptors);
+    for (std::vector<udp_acceptor_ptr>::iterator iter = shared_acceptors.begin(); shared_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_direct_send(enable);
+    }
+
+    return true;
+}
+
+bool UdpManagerImpl::set_message_fragment(const UdpFragmentOptions & options, bool enable)
+{
+    if (enable && (!UdpReassembler::check_options(options) || options.mtu > m_recv_buffer_size))
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> locker(m_fragment_mutex);
+        m_fragment_options = options;
+        m_fragment_enable = enable;
+    }
+
+    for (std::vector<udp_acceptor_ptr>::iterator iter = m_udp_acceptors.begin(); m_udp_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_message_fragment(options, enable);
+    }
+
+    std::vector<udp_acceptor_ptr> shared_acceptors;
+    get_shared_acceptors(shared_acceptors);
+    for (std::vector<udp_acceptor_ptr>::iterator iter = shared_acceptors.begin(); shared_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_message_fragment(options, enable);
+    }
+
+    return true;
+}
+
+bool UdpManagerImpl::set_multicast_group(const char * group_ip, const char * interface_ip, bool join)
+{
+    if (nullptr == group_ip || m_udp_acceptors.empty())
+    {
+        return false;
+    }
+
+    boost::system::error_code error;
+    boost::asio::ip::address group_address = boost::asio::ip::make_address(group_ip, error);
+    if (error || !group_address.is_multicast())
+    {
+        return false;
+    }
+
+    boost::asio::ip::address interface_address = boost::asio::ip::address_v4::any();
+    if (nullptr != interface_ip && '\0' != *interface_ip)
+    {
+        interface_address = boost::asio::ip::make_address(interface_ip, error);
+        if (error || (group_address.is_v4() && !interface_address.is_v4()))
+        {
+            return false;
+        }
+    }
+
+    for (std::vector<udp_acceptor_ptr>::iterator iter = m_udp_acceptors.begin(); m_udp_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_multicast_group(group_address, interface_address, join);
+    }
+
+    return true;
+}
+
+bool UdpManagerImpl::set_multicast_options(std::size_t ttl, bool loopback, const char * interface_ip)
+{
+    if (ttl > 255)
+    {
+        return false;
+    }
+
+    boost::asio::ip::address interface_address = boost::asio::ip::address_v4::any();
+    if (nullptr != interface_ip && '\0' != *interface_ip)
+    {
+        boost::system::error_code error;
+        interface_address = boost::asio::ip::make_address(interface_ip, error);
+        if (error)
+        {
+            return false;
+        }
+    }
+
+    UdpMulticastOptions options;
+    {
+        std::lock_guard<std::mutex> locker(m_multicast_mutex);
+        m_multicast_options.ttl = ttl;
+        m_multicast_options.loopback = loopback;
+        m_multicast_options.interface_address = interface_address;
+        options = m_multicast_options;
+    }
+
+    std::vector<udp_acceptor_ptr> shared_acceptors;
+    get_shared_acceptors(shared_acceptors);
+    for (std::vector<udp_acceptor_ptr>::iterator iter = shared_acceptors.begin(); shared_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_multicast_options(options);
+    }
+
+    return true;
+}
+
+bool UdpManagerImpl::set_shared_socket(bool enable, std::size_t socket_count)
+{
+    if (nullptr == m_udp_service || (enable && 0 == socket_count))
+    {
+        return false;
+    }
+
+    if (!enable)
+    {
+        m_shared_socket = false;
+        std::vector<udp_acceptor_ptr> shared_acceptors;
+        {
+            std::lock_guard<std::mutex> locker(m_shared_mutex);
+            shared_acceptors.swap(m_shared_acceptors);
+        }
+        stop_acceptors(shared_acceptors);
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> locker(m_shared_mutex);
+        if (!m_shared_acceptors.empty())
+        {
+            m_shared_socket = true;
+            return true;
+        }
+    }
+
+    /* built aside and published whole, a failed start stops the ones already running, the settings are posted behind the start like those of a running listener */
+    std::vector<udp_acceptor_ptr> shared_acceptors;
+    for (std::size_t index = 0; index < m_io_context_pool.size() * socket_count; ++index)
+    {
+        udp_acceptor_ptr udp_acceptor = boost::factory<udp_acceptor_ptr>()(m_io_context_pool.get(index % m_io_context_pool.size()), m_udp_service, "0.0.0.0", 0, m_recv_buffer_size);
+        udp_acceptor->set_accept_peer(false);
+        if (!udp_acceptor->start())
+        {
+            stop_acceptors(shared_acceptors);
+            return false;
+        }
+        configure_connection(udp_acceptor, true);
+        shared_acceptors.push_back(udp_acceptor);
+    }
+
+    {
+        std::lock_guard<std::mutex> locker(m_shared_mutex);
+        if (m_shared_acceptors.empty())
+        {
+            m_shared_acceptors.swap(shared_acceptors);
+        }
+    }
+    stop_acceptors(shared_acceptors);
+
+    m_shared_socket = true;
+
+    return true;
+}
+
+bool UdpManagerImpl::set_rate_limit(const RateLimit & limit)
+{
+    if (0 == limit.burst_bytes)
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> locker(m_rate_limit_mutex);
+        m_rate_limit = limit;
+    }
+
+    for (std::vector<udp_acceptor_ptr>::iterator iter = m_udp_acceptors.begin(); m_udp_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_rate_limit(limit);
+    }
+
+    std::vector<udp_acceptor_ptr> shared_acceptors;
+    get_shared_acceptors(shared_acceptors);
+    for (std::vector<udp_acceptor_ptr>::iterator iter = shared_acceptors.begin(); shared_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_rate_limit(shared_rate_limit(limit));
+    }
+
+    return true;
+}
+
+bool UdpManagerImpl::set_timestamping(bool recv_enable, bool send_enable)
+{
+#ifdef BOOST_NET_TIMESTAMPING_SUPPORT
+    m_timestamp_recv = recv_enable;
+    m_timestamp_send = send_enable;
+
+    for (std::vector<udp_acceptor_ptr>::iterator iter = m_udp_acceptors.begin(); m_udp_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_timestamping(recv_enable, send_enable);
+    }
+
+    std::vector<udp_acceptor_ptr> shared_acceptors;
+    get_shared_acceptors(shared_acceptors);
+    for (std::vector<udp_acceptor_ptr>::iterator iter = shared_acceptors.begin(); shared_acceptors.end() != iter; ++iter)
+    {
+        (*iter)->set_timestamping(recv_enable, send_enable);
+    }
+
+    return true;
+#else
+    return !recv_enable && !send_enable;
+#endif // BOOST_NET_TIMESTAMPING_SUPPORT
+}
+
+RateLimit UdpManagerImpl::shared_rate_limit(const RateLimit & limit)
+{
+    RateLimit shared_limit = limit;
+    shared_limit.listener_send_bytes_per_second = 0;
+    shared_limit.listener_recv_bytes_per_second = 0;
+    return shared_limit;
+}
+
+void UdpManagerImpl::stop_acceptors(std::vector<udp_acceptor_ptr> & udp_acceptors)
+{
+    for (std::vector<udp_acceptor_ptr>::iterator iter = udp_acceptors.begin(); udp_acceptors.end() != iter; ++iter)
+    {
+        udp_acceptor_ptr udp_acceptor = *iter;
+        boost::asio::post(udp_acceptor->io_context(), [udp_acceptor]() { udp_acceptor->stop(); });
+    }
+    udp_acceptors.clear();
+}
+
+void UdpManagerImpl::get_shared_acceptors(std::vector<udp_acceptor_ptr> & udp_acceptors)
+{
+    std::lock_guard<std::mutex> locker(m_shared_mutex);
+    udp_acceptors = m_shared_acceptors;
+}
+
+bool UdpManagerImpl::shared_create_connection(const std::string & host, const std::string & service, bool sync_connect, const void * identity)
+{
+    udp_acceptor_ptr udp_acceptor;
+    {
+        std::lock_guard<std::mutex> locker(m_shared_mutex);
+        if (m_shared_acceptors.empty())
+        {
+            return false;
+        }
+        udp_acceptor = m_shared_acceptors[m_shared_index++ % m_shared_acceptors.size()];
+    }
+
+    if (sync_connect)
+    {
+        boost::asio::ip::udp::resolver resolver(m_io_context_pool.get());
+        boost::system::error_code error;
+        boost::asio::ip::udp::resolver::results_type results = resolver.resolve(host, service, error);
+        if (error)
+        {
+            return false;
+        }
+        udp_acceptor->connect_peer(results, identity);
+        return true;
+    }
+
+    resolver_ptr resolver = boost::factory<resolver_ptr>()(m_io_context_pool.get());
+    UdpServiceBase * udp_service = m_udp_service;
+
+    resolver->async_resolve(
+        host,
+        service,
+        [udp_acceptor, udp_service, identity, resolver](const boost::system::error_code & error, const boost::asio::ip::udp::resolver::results_type & results) {
+            if (error)
+            {
+                udp_service->on_connect(nullptr, identity);
+                return;
+            }
+            udp_acceptor->connect_peer(results, identity);
+        }
+    );
+
+    return true;
+}
+
 bool UdpManagerImpl::sync_create_connection(const std::string & host, const std::string & service, const void * identity, const char * bind_ip, unsigned short bind_port)
 {
     boost::asio::ip::udp::endpoint endpoint;
@@ -160,7 +636,8 @@ bool UdpManagerImpl::sync_create_connection(const std::string & host, const std:
         endpoint = boost::asio::ip::udp::endpoint(boost::asio::ip::make_address(bind_ip), bind_port);
     }
 
-    udp_connection_ptr udp_connection = boost::factory<udp_connection_ptr>()(m_io_context_pool.get(), m_udp_service, identity);
+    udp_connection_ptr udp_connection = boost::factory<udp_connection_ptr>()(m_io_context_pool.get(), m_udp_service, identity, m_recv_buffer_size);
+    configure_connection(udp_connection, false);
     udp_connection_type::socket_type & socket = udp_connection->socket();
 
     boost::asio::ip::udp::resolver resolver(udp_connection->io_context());
@@ -187,6 +664,11 @@ bool UdpManagerImpl::sync_create_connection(const std::string & host, const std:
                 return false;
             }
         }
+        udp_connection->open_multicast(iter->endpoint(), error);
+        if (error)
+        {
+            continue;
+        }
         socket.connect(*iter, error);
     }
 
@@ -212,7 +694,8 @@ bool UdpManagerImpl::async_create_connection(const std::string & host, const std
         endpoint = boost::asio::ip::udp::endpoint(boost::asio::ip::make_address(bind_ip), bind_port);
     }
 
-    udp_connection_ptr udp_connection = boost::factory<udp_connection_ptr>()(m_io_context_pool.get(), m_udp_service, identity);
+    udp_connection_ptr udp_connection = boost::factory<udp_connection_ptr>()(m_io_context_pool.get(), m_udp_service, identity, m_recv_buffer_size);
+    configure_connection(udp_connection, false);
 
     resolver_ptr resolver = boost::factory<resolver_ptr>()(udp_connection->io_context());
 
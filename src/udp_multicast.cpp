@@ -0,0 +1,36 @@
+/********************************************************
+ * Description : udp multicast send options
+ * Data        : 2026-10-20 06:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include "udp_multicast.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+void apply_multicast_options(boost::asio::ip::udp::socket & socket, const UdpMulticastOptions & options, boost::system::error_code & error)
+{
+    socket.set_option(boost::asio::ip::multicast::hops(static_cast<int>(options.ttl)), error);
+    if (error)
+    {
+        return;
+    }
+
+    socket.set_option(boost::asio::ip::multicast::enable_loopback(options.loopback), error);
+    if (error)
+    {
+        return;
+    }
+
+    boost::system::error_code ignore_error_code;
+    if (socket.local_endpoint(ignore_error_code).address().is_v4() && options.interface_address.is_v4() && !options.interface_address.is_unspecified())
+    {
+        socket.set_option(boost::asio::ip::multicast::outbound_interface(options.interface_address.to_v4()), error);
+    }
+}
+
+} // namespace BoostNet end
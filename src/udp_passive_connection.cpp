@@ -13,15 +13,29 @@
 
 namespace BoostNet { // namespace BoostNet begin
 
-UdpPassiveConnection::UdpPassiveConnection(UdpAcceptor & acceptor, UdpServiceBase * udp_service, unsigned short host_port, endpoint_type endpoint)
+UdpPassiveConnection::UdpPassiveConnection(UdpAcceptor & acceptor, UdpServiceBase * udp_service, unsigned short host_port, endpoint_type endpoint, std::size_t worker_index, bool datagram_callback)
     : m_acceptor(acceptor)
     , m_udp_service(udp_service)
     , m_running(false)
     , m_host_port(host_port)
     , m_endpoint(endpoint)
+    , m_worker_index(worker_index)
+    , m_datagram_callback(datagram_callback)
+    , m_outbound(false)
+    , m_cookie_pending(true)
+    , m_identity(nullptr)
     , m_peer_ip()
     , m_peer_port(0)
     , m_recv_buffer()
+    , m_send_counter(std::make_shared<UdpSendCounter>())
+    , m_fragment_enable(false)
+    , m_fragment_options()
+    , m_fragment_message_id(0)
+    , m_reassembler()
+    , m_send_bucket()
+    , m_recv_bucket()
+    , m_recv_dropped_count(0)
+    , m_recv_timestamp(0)
 {
 
 }
@@ -31,6 +45,50 @@ UdpPassiveConnection::~UdpPassiveConnection()
 
 }
 
+void UdpPassiveConnection::set_message_fragment(const UdpFragmentOptions & options, bool enable)
+{
+    m_fragment_enable = enable && m_reassembler.init(options);
+    m_fragment_options = options;
+}
+
+void UdpPassiveConnection::set_outbound(const void * identity)
+{
+    m_outbound = true;
+    m_identity = identity;
+}
+
+bool UdpPassiveConnection::outbound() const
+{
+    return m_outbound;
+}
+
+bool UdpPassiveConnection::take_cookie_pending()
+{
+    const bool cookie_pending = m_cookie_pending;
+    m_cookie_pending = false;
+    return cookie_pending;
+}
+
+void UdpPassiveConnection::set_rate_limit(const RateLimit & limit)
+{
+    m_send_bucket.set_rate(limit.send_bytes_per_second, limit.burst_bytes);
+    m_recv_bucket.set_rate(limit.recv_bytes_per_second, limit.burst_bytes);
+}
+
+bool UdpPassiveConnection::rate_allowed(TokenBucket & bucket, std::size_t len)
+{
+    if (!bucket.limited())
+    {
+        return true;
+    }
+    if (0 != bucket.wait_microseconds())
+    {
+        return false;
+    }
+    bucket.consume(len);
+    return true;
+}
+
 void UdpPassiveConnection::start()
 {
     m_peer_ip = m_endpoint.address().to_string();
@@ -40,7 +98,7 @@ void UdpPassiveConnection::start()
 
     if (nullptr != m_udp_service)
     {
-        if (!m_udp_service->on_accept(shared_from_this(), m_host_port))
+        if (m_outbound ? !m_udp_service->on_connect(shared_from_this(), m_identity) : !m_udp_service->on_accept(shared_from_this(), m_host_port))
         {
             close();
             return;
@@ -62,14 +120,54 @@ void UdpPassiveConnection::stop()
 
 void UdpPassiveConnection::send(const void * data, std::size_t len)
 {
-    m_acceptor.send(m_endpoint, data, len);
+    m_acceptor.send(m_endpoint, data, len, m_send_counter);
 }
 
-void UdpPassiveConnection::recv(const void * data, std::size_t len)
+void UdpPassiveConnection::recv(const void * data, std::size_t len, uint64_t timestamp)
 {
+    if (!rate_allowed(m_recv_bucket, len))
+    {
+        m_recv_dropped_count += 1;
+        return;
+    }
+
+    if (m_fragment_enable)
+    {
+        const char * message = nullptr;
+        std::size_t message_len = 0;
+        if (m_reassembler.input(data, len, message, message_len))
+        {
+            deliver(message, message_len, timestamp);
+        }
+        return;
+    }
+
+    deliver(reinterpret_cast<const char *>(data), len, timestamp);
+}
+
+void UdpPassiveConnection::deliver(const char * data, std::size_t len, uint64_t timestamp)
+{
+    m_recv_timestamp = timestamp;
+    if (nullptr != m_udp_service && m_datagram_callback)
+    {
+        if (!m_udp_service->on_datagram(shared_from_this(), data, len))
+        {
+            close();
+        }
+        return;
+    }
+
+    UdpDatagram datagram(data, len);
+    datagram.set_timestamp(timestamp);
+    deliver(std::move(datagram));
+}
+
+void UdpPassiveConnection::deliver(UdpDatagram datagram)
+{
+    m_recv_timestamp = datagram.timestamp();
     if (nullptr != m_udp_service)
     {
-        m_recv_buffer.emplace_back(std::vector<char>(reinterpret_cast<const char *>(data), reinterpret_cast<const char *>(data) + len));
+        m_recv_buffer.emplace_back(std::move(datagram));
         if (!m_udp_service->on_recv(shared_from_this()))
         {
             close();
@@ -78,6 +176,33 @@ void UdpPassiveConnection::recv(const void * data, std::size_t len)
     }
 }
 
+void UdpPassiveConnection::recv(UdpDatagram datagram)
+{
+    if (m_fragment_enable || m_datagram_callback)
+    {
+        recv(datagram.data(), datagram.size(), datagram.timestamp());
+        return;
+    }
+
+    if (!rate_allowed(m_recv_bucket, datagram.size()))
+    {
+        m_recv_dropped_count += 1;
+        return;
+    }
+
+    deliver(std::move(datagram));
+}
+
+void UdpPassiveConnection::recv_dropped()
+{
+    m_recv_dropped_count += 1;
+}
+
+std::size_t UdpPassiveConnection::worker_index() const
+{
+    return m_worker_index;
+}
+
 void UdpPassiveConnection::close()
 {
     m_acceptor.close(m_endpoint);
@@ -109,7 +234,7 @@ const void * UdpPassiveConnection::recv_buffer_data()
     {
         return nullptr;
     }
-    return reinterpret_cast<const void *>(&m_recv_buffer.front()[0]);
+    return reinterpret_cast<const void *>(m_recv_buffer.front().data());
 }
 
 std::size_t UdpPassiveConnection::recv_buffer_size()
@@ -131,14 +256,54 @@ bool UdpPassiveConnection::recv_buffer_drop()
     return true;
 }
 
+bool UdpPassiveConnection::recv_buffer_timestamp(KernelTimestamp & timestamp)
+{
+    return SocketTimestamping::to_timestamp(m_recv_buffer.empty() ? m_recv_timestamp : m_recv_buffer.front().timestamp(), timestamp);
+}
+
 bool UdpPassiveConnection::send_buffer_fill(const void * data, std::size_t len)
 {
     if (nullptr == data && 0 != len)
     {
         return false;
     }
+    if (!rate_allowed(m_send_bucket, len))
+    {
+        return false;
+    }
+    if (m_fragment_enable)
+    {
+        if (len > m_fragment_options.max_message_size)
+        {
+            return false;
+        }
+        static thread_local std::vector<char> fragment;
+        static thread_local std::vector<std::size_t> fragment_ends;
+        UdpReassembler::split(m_fragment_options, m_fragment_message_id++, data, len, fragment, fragment_ends);
+        std::size_t fragment_begin = 0;
+        for (std::vector<std::size_t>::const_iterator iter = fragment_ends.begin(); fragment_ends.end() != iter; ++iter)
+        {
+            send(fragment.data() + fragment_begin, *iter - fragment_begin);
+            fragment_begin = *iter;
+        }
+        return true;
+    }
     send(data, len);
     return true;
 }
 
+bool UdpPassiveConnection::send_timestamp(KernelTimestamp & timestamp, std::size_t & send_count)
+{
+    return m_acceptor.send_timestamp(timestamp, send_count);
+}
+
+void UdpPassiveConnection::get_send_statistics(UdpSendStatistics & statistics)
+{
+    statistics.queued_count = m_send_counter->queued_count;
+    statistics.sent_count = m_send_counter->sent_count;
+    statistics.dropped_count = m_send_counter->dropped_count;
+    statistics.error_count = m_send_counter->error_count;
+    statistics.recv_dropped_count = m_recv_dropped_count;
+}
+
 } // namespace BoostNet end
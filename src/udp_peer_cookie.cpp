@@ -0,0 +1,108 @@
+/********************************************************
+ * Description : udp peer cookie
+ * Data        : 2026-10-20 00:00:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <cstring>
+#include <chrono>
+#include <openssl/rand.h>
+#include <openssl/hmac.h>
+#include <openssl/crypto.h>
+#include "udp_peer_cookie.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+static const unsigned char s_cookie_magic[8] = { 0xB7, 'B', 'N', 'C', 'O', 'O', 'K', 0x01 };
+
+UdpPeerCookie::UdpPeerCookie()
+    : m_secret()
+{
+    memset(m_secret, 0x0, sizeof(m_secret));
+}
+
+UdpPeerCookie::~UdpPeerCookie()
+{
+    OPENSSL_cleanse(m_secret, sizeof(m_secret));
+}
+
+bool UdpPeerCookie::init()
+{
+    return 1 == RAND_bytes(m_secret, sizeof(m_secret));
+}
+
+uint64_t UdpPeerCookie::current_time_slot()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count()) / slot_seconds;
+}
+
+bool UdpPeerCookie::is_cookie(const void * data, std::size_t len)
+{
+    return nullptr != data && cookie_size == len && 0 == memcmp(data, s_cookie_magic, sizeof(s_cookie_magic));
+}
+
+void UdpPeerCookie::sign(const endpoint_type & endpoint, uint64_t time_slot, unsigned char cookie[cookie_size]) const
+{
+    unsigned char message[16 + 2 + 8] = { 0x0 };
+    if (endpoint.address().is_v4())
+    {
+        boost::asio::ip::address_v6::bytes_type bytes = boost::asio::ip::make_address_v6(boost::asio::ip::v4_mapped, endpoint.address().to_v4()).to_bytes();
+        memcpy(message, bytes.data(), bytes.size());
+    }
+    else
+    {
+        boost::asio::ip::address_v6::bytes_type bytes = endpoint.address().to_v6().to_bytes();
+        memcpy(message, bytes.data(), bytes.size());
+    }
+    message[16] = static_cast<unsigned char>(endpoint.port() >> 8);
+    message[17] = static_cast<unsigned char>(endpoint.port() & 0xFF);
+
+    memcpy(cookie, s_cookie_magic, sizeof(s_cookie_magic));
+    for (std::size_t index = 0; index < 8; ++index)
+    {
+        cookie[8 + index] = static_cast<unsigned char>(time_slot >> (56 - 8 * index));
+        message[18 + index] = cookie[8 + index];
+    }
+
+    unsigned char digest[EVP_MAX_MD_SIZE] = { 0x0 };
+    unsigned int digest_size = 0;
+    HMAC(EVP_sha256(), m_secret, sizeof(m_secret), message, sizeof(message), digest, &digest_size);
+    memcpy(cookie + 16, digest, cookie_size - 16);
+}
+
+void UdpPeerCookie::make(const endpoint_type & endpoint, unsigned char cookie[cookie_size]) const
+{
+    sign(endpoint, current_time_slot(), cookie);
+}
+
+bool UdpPeerCookie::verify(const endpoint_type & endpoint, const void * data, std::size_t len) const
+{
+    if (!is_cookie(data, len))
+    {
+        return false;
+    }
+
+    const unsigned char * cookie = reinterpret_cast<const unsigned char *>(data);
+    uint64_t time_slot = 0;
+    for (std::size_t index = 0; index < 8; ++index)
+    {
+        time_slot = (time_slot << 8) | cookie[8 + index];
+    }
+
+    uint64_t now_slot = current_time_slot();
+    if (time_slot != now_slot && time_slot + 1 != now_slot)
+    {
+        return false;
+    }
+
+    unsigned char expected[cookie_size] = { 0x0 };
+    sign(endpoint, time_slot, expected);
+
+    return 0 == CRYPTO_memcmp(expected, cookie, cookie_size);
+}
+
+} // namespace BoostNet end
@@ -0,0 +1,278 @@
+/********************************************************
+ * Description : udp peer table
+ * Data        : 2026-10-19 23:30:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <cstring>
+#include "udp_peer_table.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+static const std::size_t s_min_slot_count = 16;
+
+UdpPeerTable::UdpPeerTable()
+    : m_slots(s_min_slot_count)
+    , m_mask(s_min_slot_count - 1)
+    , m_size(0)
+    , m_last_slot(0)
+    , m_evict_hand(0)
+{
+
+}
+
+UdpPeerTable::~UdpPeerTable()
+{
+
+}
+
+void UdpPeerTable::pack_key(const endpoint_type & endpoint, key_type & key)
+{
+    memset(&key, 0x0, sizeof(key));
+
+    const struct sockaddr * address = reinterpret_cast<const struct sockaddr *>(endpoint.data());
+    if (AF_INET == address->sa_family)
+    {
+        const struct sockaddr_in * address_v4 = reinterpret_cast<const struct sockaddr_in *>(address);
+        uint32_t ip = 0;
+        memcpy(&ip, &address_v4->sin_addr, sizeof(ip));
+        key.low = (static_cast<uint64_t>(ip) << 16) | address_v4->sin_port;
+        key.extra = AF_INET;
+    }
+    else
+    {
+        const struct sockaddr_in6 * address_v6 = reinterpret_cast<const struct sockaddr_in6 *>(address);
+        memcpy(&key.high, reinterpret_cast<const char *>(&address_v6->sin6_addr), sizeof(key.high));
+        memcpy(&key.low, reinterpret_cast<const char *>(&address_v6->sin6_addr) + sizeof(key.high), sizeof(key.low));
+        key.extra = (static_cast<uint64_t>(address_v6->sin6_scope_id) << 32) | (static_cast<uint64_t>(address_v6->sin6_port) << 16) | AF_INET6;
+    }
+}
+
+uint64_t UdpPeerTable::hash_key(const key_type & key)
+{
+    uint64_t hash = key.high * 0x9e3779b97f4a7c15ULL ^ key.low ^ (key.extra * 0xc2b2ae3d27d4eb4fULL);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+uint64_t UdpPeerTable::hash_endpoint(const endpoint_type & endpoint)
+{
+    key_type key;
+    pack_key(endpoint, key);
+    return hash_key(key);
+}
+
+bool UdpPeerTable::equal_key(const key_type & lhs, const key_type & rhs)
+{
+    return lhs.low == rhs.low && lhs.high == rhs.high && lhs.extra == rhs.extra;
+}
+
+std::size_t UdpPeerTable::find_slot(const key_type & key, uint64_t hash) const
+{
+    std::size_t index = static_cast<std::size_t>(hash) & m_mask;
+    while (m_slots[index].connection && (m_slots[index].hash != hash || !equal_key(m_slots[index].key, key)))
+    {
+        index = (index + 1) & m_mask;
+    }
+    return index;
+}
+
+void UdpPeerTable::rehash(std::size_t slot_count)
+{
+    std::vector<slot_type> slots(slot_count);
+    m_slots.swap(slots);
+    m_mask = slot_count - 1;
+    m_last_slot = 0;
+    m_evict_hand = 0;
+
+    for (std::vector<slot_type>::iterator iter = slots.begin(); slots.end() != iter; ++iter)
+    {
+        if (iter->connection)
+        {
+            std::size_t index = static_cast<std::size_t>(iter->hash) & m_mask;
+            while (m_slots[index].connection)
+            {
+                index = (index + 1) & m_mask;
+            }
+            m_slots[index].key = iter->key;
+            m_slots[index].hash = iter->hash;
+            m_slots[index].active_time = iter->active_time;
+            m_slots[index].connection = std::move(iter->connection);
+        }
+    }
+}
+
+std::size_t UdpPeerTable::size() const
+{
+    return m_size;
+}
+
+const UdpPeerTable::connection_ptr * UdpPeerTable::find(const endpoint_type & endpoint, uint64_t active_time)
+{
+    key_type key;
+    pack_key(endpoint, key);
+
+    slot_type & last_slot = m_slots[m_last_slot];
+    if (last_slot.connection && equal_key(last_slot.key, key))
+    {
+        last_slot.active_time = active_time;
+        return &last_slot.connection;
+    }
+
+    std::size_t index = find_slot(key, hash_key(key));
+    if (!m_slots[index].connection)
+    {
+        return nullptr;
+    }
+
+    m_slots[index].active_time = active_time;
+    m_last_slot = index;
+
+    return &m_slots[index].connection;
+}
+
+bool UdpPeerTable::insert(const endpoint_type & endpoint, connection_ptr connection, uint64_t active_time)
+{
+    if (!connection)
+    {
+        return false;
+    }
+
+    if ((m_size + 1) * 2 > m_slots.size())
+    {
+        rehash(m_slots.size() * 2);
+    }
+
+    key_type key;
+    pack_key(endpoint, key);
+    uint64_t hash = hash_key(key);
+
+    std::size_t index = find_slot(key, hash);
+    if (m_slots[index].connection)
+    {
+        return false;
+    }
+
+    m_slots[index].key = key;
+    m_slots[index].hash = hash;
+    m_slots[index].active_time = active_time;
+    m_slots[index].connection = std::move(connection);
+    m_last_slot = index;
+    ++m_size;
+
+    return true;
+}
+
+void UdpPeerTable::erase_slot(std::size_t hole)
+{
+    m_slots[hole].connection.reset();
+    --m_size;
+
+    for (std::size_t index = (hole + 1) & m_mask; m_slots[index].connection; index = (index + 1) & m_mask)
+    {
+        std::size_t home = static_cast<std::size_t>(m_slots[index].hash) & m_mask;
+        if (((index - home) & m_mask) >= ((index - hole) & m_mask))
+        {
+            m_slots[hole].key = m_slots[index].key;
+            m_slots[hole].hash = m_slots[index].hash;
+            m_slots[hole].active_time = m_slots[index].active_time;
+            m_slots[hole].connection = std::move(m_slots[index].connection);
+            hole = index;
+        }
+    }
+}
+
+bool UdpPeerTable::erase(const endpoint_type & endpoint)
+{
+    key_type key;
+    pack_key(endpoint, key);
+
+    std::size_t index = find_slot(key, hash_key(key));
+    if (!m_slots[index].connection)
+    {
+        return false;
+    }
+
+    erase_slot(index);
+
+    return true;
+}
+
+bool UdpPeerTable::evict(connection_ptr & connection)
+{
+    if (0 == m_size)
+    {
+        return false;
+    }
+
+    std::size_t victim = m_slots.size();
+    std::size_t sample_count = 0;
+    for (std::size_t index = m_evict_hand; sample_count < evict_sample_count && sample_count < m_size; index = (index + 1) & m_mask)
+    {
+        if (m_slots[index].connection)
+        {
+            if (m_slots.size() == victim || m_slots[index].active_time < m_slots[victim].active_time)
+            {
+                victim = index;
+            }
+            ++sample_count;
+        }
+        m_evict_hand = (index + 1) & m_mask;
+    }
+
+    connection = m_slots[victim].connection;
+    erase_slot(victim);
+
+    return true;
+}
+
+void UdpPeerTable::expire(uint64_t active_time, connection_array & connections)
+{
+    connections.clear();
+
+    std::size_t index = 0;
+    while (index < m_slots.size())
+    {
+        if (m_slots[index].connection && m_slots[index].active_time < active_time)
+        {
+            connections.push_back(m_slots[index].connection);
+            erase_slot(index);
+        }
+        else
+        {
+            ++index;
+        }
+    }
+}
+
+void UdpPeerTable::get_connections(connection_array & connections) const
+{
+    connections.clear();
+    connections.reserve(m_size);
+    for (std::vector<slot_type>::const_iterator iter = m_slots.begin(); m_slots.end() != iter; ++iter)
+    {
+        if (iter->connection)
+        {
+            connections.push_back(iter->connection);
+        }
+    }
+}
+
+void UdpPeerTable::clear()
+{
+    std::vector<slot_type>(s_min_slot_count).swap(m_slots);
+    m_mask = s_min_slot_count - 1;
+    m_size = 0;
+    m_last_slot = 0;
+    m_evict_hand = 0;
+}
+
+} // namespace BoostNet end
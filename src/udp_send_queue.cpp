@@ -0,0 +1,198 @@
+/********************************************************
+ * Description : bounded udp send queue
+ * Data        : 2026-10-20 01:30:00
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Blog        : blog.csdn.net/cxxmaker
+ * Version     : 2.0
+ * Copyright(C): 2018 - 2020
+ ********************************************************/
+
+#include <chrono>
+#include "udp_send_queue.h"
+
+namespace BoostNet { // namespace BoostNet begin
+
+UdpSendCounter::UdpSendCounter()
+    : queued_count(0)
+    , sent_count(0)
+    , dropped_count(0)
+    , error_count(0)
+    , posted_count(0)
+    , queue_packets(0)
+    , queue_bytes(0)
+{
+
+}
+
+bool UdpSendCounter::send_idle() const
+{
+    return 0 == posted_count && 0 == queue_packets;
+}
+
+UdpSendQueue::UdpSendQueue()
+    : m_entries()
+    , m_bytes(0)
+    , m_limit()
+{
+    m_limit.max_packets = 0;
+    m_limit.max_bytes = 0;
+    m_limit.max_peer_packets = 0;
+    m_limit.max_peer_bytes = 0;
+    m_limit.drop_policy = udp_drop_newest;
+    m_limit.max_age_milliseconds = 0;
+}
+
+UdpSendQueue::~UdpSendQueue()
+{
+
+}
+
+uint64_t UdpSendQueue::current_milliseconds()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void UdpSendQueue::set_limit(const UdpSendLimit & limit)
+{
+    m_limit = limit;
+}
+
+bool UdpSendQueue::empty() const
+{
+    return m_entries.empty();
+}
+
+void UdpSendQueue::erase(entries_type::iterator iter)
+{
+    m_bytes -= iter->data.size();
+    iter->counter->queue_packets -= 1;
+    iter->counter->queue_bytes -= iter->data.size();
+    m_entries.erase(iter);
+}
+
+void UdpSendQueue::drop_expired()
+{
+    if (udp_drop_expired != m_limit.drop_policy || 0 == m_limit.max_age_milliseconds || m_entries.empty())
+    {
+        return;
+    }
+
+    uint64_t now = current_milliseconds();
+    while (!m_entries.empty() && m_entries.front().enqueue_time + m_limit.max_age_milliseconds < now)
+    {
+        m_entries.front().counter->dropped_count += 1;
+        erase(m_entries.begin());
+    }
+}
+
+bool UdpSendQueue::make_room(std::size_t len, const counter_ptr & counter)
+{
+    if ((0 != m_limit.max_bytes && len > m_limit.max_bytes) || (0 != m_limit.max_peer_bytes && len > m_limit.max_peer_bytes))
+    {
+        return false;
+    }
+
+    while ((0 != m_limit.max_peer_packets && counter->queue_packets + 1 > m_limit.max_peer_packets) || (0 != m_limit.max_peer_bytes && counter->queue_bytes + len > m_limit.max_peer_bytes))
+    {
+        if (udp_drop_oldest != m_limit.drop_policy)
+        {
+            return false;
+        }
+        entries_type::iterator iter = m_entries.begin();
+        while (iter->counter != counter)
+        {
+            ++iter;
+        }
+        iter->counter->dropped_count += 1;
+        erase(iter);
+    }
+
+    while ((0 != m_limit.max_packets && m_entries.size() + 1 > m_limit.max_packets) || (0 != m_limit.max_bytes && m_bytes + len > m_limit.max_bytes))
+    {
+        if (udp_drop_oldest != m_limit.drop_policy)
+        {
+            return false;
+        }
+        m_entries.front().counter->dropped_count += 1;
+        erase(m_entries.begin());
+    }
+
+    return true;
+}
+
+bool UdpSendQueue::push(const endpoint_type * endpoint, std::vector<char> data, const counter_ptr & counter)
+{
+    drop_expired();
+
+    if (!make_room(data.size(), counter))
+    {
+        counter->dropped_count += 1;
+        return false;
+    }
+
+    entry_type entry;
+    entry.endpoint = (nullptr == endpoint ? endpoint_type() : *endpoint);
+    entry.connected = (nullptr == endpoint);
+    entry.counter = counter;
+    entry.enqueue_time = (udp_drop_expired == m_limit.drop_policy ? current_milliseconds() : 0);
+
+    m_bytes += data.size();
+    counter->queue_packets += 1;
+    counter->queue_bytes += data.size();
+    counter->queued_count += 1;
+
+    entry.data = std::move(data);
+    m_entries.emplace_back(std::move(entry));
+
+    return true;
+}
+
+std::size_t UdpSendQueue::fill(UdpBatch & batch)
+{
+    drop_expired();
+
+    std::size_t count = 0;
+    for (entries_type::iterator iter = m_entries.begin(); m_entries.end() != iter; ++iter)
+    {
+        if (!batch.send_push(iter->data.data(), iter->data.size(), iter->connected ? nullptr : &iter->endpoint))
+        {
+            break;
+        }
+        ++count;
+    }
+
+    return count;
+}
+
+std::size_t UdpSendQueue::pop_sent(std::size_t count)
+{
+    std::size_t bytes = 0;
+    for (std::size_t index = 0; index < count && !m_entries.empty(); ++index)
+    {
+        bytes += m_entries.front().data.size();
+        m_entries.front().counter->sent_count += 1;
+        erase(m_entries.begin());
+    }
+    return bytes;
+}
+
+void UdpSendQueue::pop_error()
+{
+    if (!m_entries.empty())
+    {
+        m_entries.front().counter->error_count += 1;
+        erase(m_entries.begin());
+    }
+}
+
+void UdpSendQueue::clear()
+{
+    while (!m_entries.empty())
+    {
+        m_entries.front().counter->dropped_count += 1;
+        erase(m_entries.begin());
+    }
+}
+
+} // namespace BoostNet end
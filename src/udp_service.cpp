@@ -22,4 +22,9 @@ UdpServiceBase::~UdpServiceBase()
 
 }
 
+bool UdpServiceBase::on_datagram(UdpConnectionSharedPtr connection, const void * data, std::size_t len)
+{
+    return true;
+}
+
 } // namespace BoostNet end
@@ -0,0 +1,73 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+
+#include <cstdio>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <functional>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+
+static inline double bench_seconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static inline bool bench_wait_for(const std::function<bool()> & condition, double timeout_seconds)
+{
+    const double deadline = bench_seconds() + timeout_seconds;
+    while (!condition())
+    {
+        if (bench_seconds() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+/* self-signed p-256 certificate for localhost, pem buffers for Certificate with pass_file_not_buffer false */
+static inline bool bench_make_certificate(std::string & cert_pem, std::string & key_pem)
+{
+    EVP_PKEY * key = EVP_EC_gen("P-256");
+    X509 * certificate = X509_new();
+    if (nullptr == key || nullptr == certificate)
+    {
+        EVP_PKEY_free(key);
+        X509_free(certificate);
+        return false;
+    }
+
+    ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+    X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+    X509_gmtime_adj(X509_getm_notAfter(certificate), 3600);
+    X509_set_pubkey(certificate, key);
+    X509_NAME_add_entry_by_txt(X509_get_subject_name(certificate), "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char *>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(certificate, X509_get_subject_name(certificate));
+    X509_sign(certificate, key, EVP_sha256());
+
+    BIO * cert_bio = BIO_new(BIO_s_mem());
+    BIO * key_bio = BIO_new(BIO_s_mem());
+    PEM_write_bio_X509(cert_bio, certificate);
+    PEM_write_bio_PrivateKey(key_bio, key, nullptr, nullptr, 0, nullptr, nullptr);
+
+    char * data = nullptr;
+    long size = BIO_get_mem_data(cert_bio, &data);
+    cert_pem.assign(data, static_cast<std::size_t>(size));
+    size = BIO_get_mem_data(key_bio, &data);
+    key_pem.assign(data, static_cast<std::size_t>(size));
+
+    BIO_free(cert_bio);
+    BIO_free(key_bio);
+    X509_free(certificate);
+    EVP_PKEY_free(key);
+
+    return !cert_pem.empty() && !key_pem.empty();
+}
+
+
+#endif // BENCH_UTIL_H
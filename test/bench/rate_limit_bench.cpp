@@ -0,0 +1,286 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include "boost_net.h"
+#include "bench_util.h"
+
+/*
+ * delivered byte rate of 1000 byte writes offered faster than the configured limit, over loopback;
+ * the rate is taken from the second to the fourth second so the initial burst credit does not count
+ */
+static const std::size_t s_chunk_size = 1000;
+static const double s_warm_seconds = 1.0;
+static const double s_total_seconds = 4.0;
+static const std::size_t s_megabyte = 1000 * 1000;
+
+template <typename ConnectionPtr>
+class ByteCounter
+{
+public:
+    ByteCounter()
+        : m_mutex()
+        , m_connections()
+        , m_recv_bytes(0)
+    {
+
+    }
+
+public:
+    void add(ConnectionPtr connection)
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connections.push_back(connection);
+    }
+
+    void count(std::size_t bytes)
+    {
+        m_recv_bytes += bytes;
+    }
+
+    std::vector<ConnectionPtr> connections()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_connections;
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connections.clear();
+    }
+
+    std::size_t recv_bytes() const
+    {
+        return m_recv_bytes;
+    }
+
+private:
+    std::mutex                                      m_mutex;
+    std::vector<ConnectionPtr>                      m_connections;
+    std::atomic<std::size_t>                        m_recv_bytes;
+};
+
+class TcpCountService : public BoostNet::TcpServiceBase
+{
+public:
+    virtual bool on_connect(BoostNet::TcpConnectionSharedPtr connection, const void *) override
+    {
+        m_counter.add(connection);
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::TcpConnectionSharedPtr, unsigned short) override
+    {
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::TcpConnectionSharedPtr connection) override
+    {
+        const std::size_t size = connection->recv_buffer_size();
+        connection->recv_buffer_drop(size);
+        m_counter.count(size);
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::TcpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::TcpConnectionSharedPtr) override
+    {
+
+    }
+
+    virtual void on_error(BoostNet::TcpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+
+    }
+
+public:
+    ByteCounter<BoostNet::TcpConnectionSharedPtr>   m_counter;
+};
+
+class UdpCountService : public BoostNet::UdpServiceBase
+{
+public:
+    virtual bool on_connect(BoostNet::UdpConnectionSharedPtr connection, const void *) override
+    {
+        m_counter.add(connection);
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::UdpConnectionSharedPtr connection, unsigned short) override
+    {
+        m_counter.add(connection);
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::UdpConnectionSharedPtr connection) override
+    {
+        while (connection->recv_buffer_has_data())
+        {
+            m_counter.count(connection->recv_buffer_size());
+            connection->recv_buffer_drop();
+        }
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::UdpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::UdpConnectionSharedPtr) override
+    {
+
+    }
+
+    virtual void on_error(BoostNet::UdpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+
+    }
+
+public:
+    ByteCounter<BoostNet::UdpConnectionSharedPtr>   m_counter;
+};
+
+/* every connection is offered offered_bytes_per_second in chunks each millisecond, the receiver rate is printed */
+template <typename ConnectionPtr, typename Counter>
+static void drive(const char * name, std::size_t limit_bytes_per_second, std::size_t offered_bytes_per_second, const std::vector<ConnectionPtr> & connections, Counter & counter)
+{
+    const char chunk[s_chunk_size] = { 0x0 };
+    const double start = bench_seconds();
+    std::size_t offered_bytes = 0;
+    std::size_t warm_bytes = 0;
+    bool warm = false;
+    double warm_time = start;
+    for (double now = start; now - start < s_total_seconds; now = bench_seconds())
+    {
+        if (!warm && now - start >= s_warm_seconds)
+        {
+            warm = true;
+            warm_time = now;
+            warm_bytes = counter.recv_bytes();
+        }
+        const std::size_t due_bytes = static_cast<std::size_t>((now - start) * offered_bytes_per_second);
+        while (offered_bytes + s_chunk_size <= due_bytes)
+        {
+            for (typename std::vector<ConnectionPtr>::const_iterator iter = connections.begin(); connections.end() != iter; ++iter)
+            {
+                (*iter)->send_buffer_fill(chunk, s_chunk_size);
+            }
+            offered_bytes += s_chunk_size;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const double seconds = bench_seconds() - warm_time;
+    const std::size_t bytes = counter.recv_bytes() - warm_bytes;
+
+    printf("%-28s limit %5.2f MB/s, offered %5.2f MB/s: delivered %5.2f MB/s\n", name,
+        static_cast<double>(limit_bytes_per_second) / s_megabyte,
+        static_cast<double>(offered_bytes_per_second * connections.size()) / s_megabyte,
+        bytes / seconds / s_megabyte);
+}
+
+/* the client caps the send rate of its connections, the server the receive rate of each accepted connection and of the listening port */
+struct Limits
+{
+    std::size_t client_send;
+    std::size_t server_recv;
+    std::size_t server_listener_recv;
+};
+
+static void run_tcp(const char * name, unsigned short port, std::size_t connection_count, const Limits & limits, std::size_t limit, std::size_t offered)
+{
+    TcpCountService server_service;
+    TcpCountService client_service;
+    BoostNet::TcpManager server_manager;
+    BoostNet::TcpManager client_manager;
+    if (!server_manager.init(&server_service, 1, "127.0.0.1", &port, 1, false) || !client_manager.init(&client_service, 1) ||
+        !server_manager.set_rate_limit(0, limits.server_recv, 0, limits.server_listener_recv) || !client_manager.set_rate_limit(limits.client_send, 0))
+    {
+        printf("%s: init failed\n", name);
+        return;
+    }
+    for (std::size_t index = 0; index < connection_count; ++index)
+    {
+        client_manager.create_connection("127.0.0.1", port, true);
+    }
+    if (!bench_wait_for([&client_service, connection_count]() { return connection_count == client_service.m_counter.connections().size(); }, 5.0))
+    {
+        printf("%s: connect failed\n", name);
+        return;
+    }
+
+    drive(name, limit, offered, client_service.m_counter.connections(), server_service.m_counter);
+
+    client_service.m_counter.release();
+    server_service.m_counter.release();
+    client_manager.exit();
+    server_manager.exit();
+}
+
+static void run_udp(const char * name, unsigned short port, std::size_t connection_count, const Limits & limits, std::size_t limit, std::size_t offered)
+{
+    UdpCountService server_service;
+    UdpCountService client_service;
+    BoostNet::UdpManager server_manager;
+    BoostNet::UdpManager client_manager;
+    if (!server_manager.init(&server_service, 1, "127.0.0.1", &port, 1, true) || !client_manager.init(&client_service, 1) ||
+        !server_manager.set_rate_limit(0, limits.server_recv, 0, limits.server_listener_recv) || !client_manager.set_rate_limit(limits.client_send, 0))
+    {
+        printf("%s: init failed\n", name);
+        return;
+    }
+    for (std::size_t index = 0; index < connection_count; ++index)
+    {
+        client_manager.create_connection("127.0.0.1", port, true);
+    }
+    if (!bench_wait_for([&client_service, connection_count]() { return connection_count == client_service.m_counter.connections().size(); }, 5.0))
+    {
+        printf("%s: connect failed\n", name);
+        return;
+    }
+
+    drive(name, limit, offered, client_service.m_counter.connections(), server_service.m_counter);
+
+    std::size_t recv_dropped_count = 0;
+    const std::vector<BoostNet::UdpConnectionSharedPtr> peers = server_service.m_counter.connections();
+    for (std::vector<BoostNet::UdpConnectionSharedPtr>::const_iterator iter = peers.begin(); peers.end() != iter; ++iter)
+    {
+        BoostNet::UdpSendStatistics statistics;
+        (*iter)->get_send_statistics(statistics);
+        recv_dropped_count += statistics.recv_dropped_count;
+    }
+    printf("%-28s %zu datagrams dropped by accepted peers\n", "", recv_dropped_count);
+
+    client_service.m_counter.release();
+    server_service.m_counter.release();
+    client_manager.exit();
+    server_manager.exit();
+}
+
+int main(int, char *[])
+{
+    const Limits tcp_send = { 1 * s_megabyte, 0, 0 };
+    const Limits tcp_recv = { 0, 1 * s_megabyte, 0 };
+    const Limits tcp_listener = { 0, 0, 2 * s_megabyte };
+    const Limits udp_send = { 1 * s_megabyte, 0, 0 };
+    const Limits udp_peer = { 0, s_megabyte / 2, 0 };
+    const Limits udp_listener = { 0, 0, 1 * s_megabyte };
+
+    run_tcp("tcp send pacing", 24660, 1, tcp_send, 1 * s_megabyte, 4 * s_megabyte);
+    run_tcp("tcp receive", 24661, 1, tcp_recv, 1 * s_megabyte, 4 * s_megabyte);
+    run_tcp("tcp listener, 4 connections", 24662, 4, tcp_listener, 2 * s_megabyte, 1 * s_megabyte);
+    run_udp("udp created send", 24663, 1, udp_send, 1 * s_megabyte, 2 * s_megabyte);
+    run_udp("udp accepted peer policing", 24664, 1, udp_peer, s_megabyte / 2, 2 * s_megabyte);
+    run_udp("udp listener, 4 connections", 24665, 4, udp_listener, 1 * s_megabyte, s_megabyte * 6 / 10);
+
+    return 0;
+}
@@ -0,0 +1,328 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include "boost_net.h"
+#include "bench_util.h"
+
+/*
+ * goodput and round trip tail of 1000 byte messages echoed over loopback, reliable udp against tcp;
+ * loopback loses nothing, for a lossy comparison run it under netem (tc qdisc add dev lo root netem delay 10ms loss 1%)
+ */
+static const std::size_t s_message_size = 1000;
+
+static uint64_t now_nanoseconds()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/* every message starts with its send time, the client keeps the round trip of each echo */
+class LatencyRecorder
+{
+public:
+    LatencyRecorder()
+        : m_mutex()
+        , m_latencies()
+        , m_recv_count(0)
+    {
+
+    }
+
+public:
+    void record(const char * message)
+    {
+        uint64_t sent = 0;
+        memcpy(&sent, message, sizeof(sent));
+        const uint64_t latency = now_nanoseconds() - sent;
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_latencies.push_back(latency);
+        }
+        ++m_recv_count;
+    }
+
+    std::size_t recv_count() const
+    {
+        return m_recv_count;
+    }
+
+    double percentile_microseconds(double percentile)
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        if (m_latencies.empty())
+        {
+            return 0.0;
+        }
+        std::vector<uint64_t> latencies(m_latencies);
+        std::size_t index = std::min<std::size_t>(static_cast<std::size_t>(percentile * latencies.size()), latencies.size() - 1);
+        std::nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+        return latencies[index] / 1000.0;
+    }
+
+private:
+    std::mutex                                      m_mutex;
+    std::vector<uint64_t>                           m_latencies;
+    std::atomic<std::size_t>                        m_recv_count;
+};
+
+class TcpEchoService : public BoostNet::TcpServiceBase
+{
+public:
+    TcpEchoService(bool echo)
+        : m_echo(echo)
+        , m_mutex()
+        , m_connection()
+        , m_recorder()
+    {
+
+    }
+
+public:
+    virtual bool on_connect(BoostNet::TcpConnectionSharedPtr connection, const void *) override
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connection = connection;
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::TcpConnectionSharedPtr, unsigned short) override
+    {
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::TcpConnectionSharedPtr connection) override
+    {
+        char message[s_message_size];
+        while (connection->recv_buffer_size() >= s_message_size)
+        {
+            connection->recv_buffer_move(message, s_message_size);
+            if (m_echo)
+            {
+                connection->send_buffer_fill(message, s_message_size);
+            }
+            else
+            {
+                m_recorder.record(message);
+            }
+        }
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::TcpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::TcpConnectionSharedPtr) override
+    {
+
+    }
+
+    virtual void on_error(BoostNet::TcpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+
+    }
+
+public:
+    BoostNet::TcpConnectionSharedPtr connection()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_connection;
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connection.reset();
+    }
+
+    LatencyRecorder & recorder()
+    {
+        return m_recorder;
+    }
+
+private:
+    const bool                                      m_echo;
+    std::mutex                                      m_mutex;
+    BoostNet::TcpConnectionSharedPtr                m_connection;
+    LatencyRecorder                                 m_recorder;
+};
+
+class RudpEchoService : public BoostNet::UdpServiceBase
+{
+public:
+    RudpEchoService(bool echo)
+        : m_echo(echo)
+        , m_mutex()
+        , m_connection()
+        , m_recorder()
+    {
+
+    }
+
+public:
+    virtual bool on_connect(BoostNet::UdpConnectionSharedPtr connection, const void *) override
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connection = connection;
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::UdpConnectionSharedPtr, unsigned short) override
+    {
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::UdpConnectionSharedPtr connection) override
+    {
+        while (connection->recv_buffer_has_data())
+        {
+            if (s_message_size == connection->recv_buffer_size())
+            {
+                if (m_echo)
+                {
+                    connection->send_buffer_fill(connection->recv_buffer_data(), s_message_size);
+                }
+                else
+                {
+                    m_recorder.record(reinterpret_cast<const char *>(connection->recv_buffer_data()));
+                }
+            }
+            connection->recv_buffer_drop();
+        }
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::UdpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::UdpConnectionSharedPtr) override
+    {
+
+    }
+
+    virtual void on_error(BoostNet::UdpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+
+    }
+
+public:
+    BoostNet::UdpConnectionSharedPtr connection()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_connection;
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connection.reset();
+    }
+
+    LatencyRecorder & recorder()
+    {
+        return m_recorder;
+    }
+
+private:
+    const bool                                      m_echo;
+    std::mutex                                      m_mutex;
+    BoostNet::UdpConnectionSharedPtr                m_connection;
+    LatencyRecorder                                 m_recorder;
+};
+
+/* at most window messages are in flight for two seconds, window 1 shows the bare round trip */
+template <typename ConnectionPtr>
+static void drive(const char * name, std::size_t window, ConnectionPtr connection, LatencyRecorder & recorder)
+{
+    char message[s_message_size] = { 0x0 };
+    std::size_t send_count = 0;
+    const double start = bench_seconds();
+    while (bench_seconds() - start < 2.0)
+    {
+        if (send_count < recorder.recv_count() + window)
+        {
+            const uint64_t sent = now_nanoseconds();
+            memcpy(message, &sent, sizeof(sent));
+            connection->send_buffer_fill(message, s_message_size);
+            ++send_count;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    const double seconds = bench_seconds() - start;
+
+    printf("%-4s window %3zu: %7.1f MB/s goodput, round trip us p50 %8.1f p99 %8.1f p99.9 %8.1f\n", name, window,
+        recorder.recv_count() * s_message_size / seconds / 1000000.0,
+        recorder.percentile_microseconds(0.5), recorder.percentile_microseconds(0.99), recorder.percentile_microseconds(0.999));
+}
+
+static void run_tcp(unsigned short port, std::size_t window)
+{
+    TcpEchoService server_service(true);
+    TcpEchoService client_service(false);
+    BoostNet::TcpManager server_manager;
+    BoostNet::TcpManager client_manager;
+    if (!server_manager.init(&server_service, 1, "127.0.0.1", &port, 1, false) || !client_manager.init(&client_service, 1) || !client_manager.create_connection("127.0.0.1", port, true))
+    {
+        printf("tcp  window %3zu: init failed\n", window);
+        return;
+    }
+    if (!bench_wait_for([&client_service]() { return nullptr != client_service.connection(); }, 5.0))
+    {
+        printf("tcp  window %3zu: connect failed\n", window);
+        return;
+    }
+
+    drive("tcp", window, client_service.connection(), client_service.recorder());
+
+    client_service.release();
+    client_manager.exit();
+    server_manager.exit();
+}
+
+static void run_rudp(unsigned short port, std::size_t window)
+{
+    RudpEchoService server_service(true);
+    RudpEchoService client_service(false);
+    BoostNet::RudpManager server_manager;
+    BoostNet::RudpManager client_manager;
+    if (!server_manager.init(&server_service, 1, "127.0.0.1", &port, 1, true) || !client_manager.init(&client_service, 1) || !client_manager.create_connection("127.0.0.1", port, true))
+    {
+        printf("rudp window %3zu: init failed\n", window);
+        return;
+    }
+    if (!bench_wait_for([&client_service]() { return nullptr != client_service.connection(); }, 5.0))
+    {
+        printf("rudp window %3zu: connect failed\n", window);
+        return;
+    }
+
+    drive("rudp", window, client_service.connection(), client_service.recorder());
+
+    client_service.release();
+    client_manager.exit();
+    server_manager.exit();
+}
+
+int main(int, char *[])
+{
+    const std::size_t windows[] = { 1, 32 };
+    unsigned short port = 24650;
+    for (std::size_t index = 0; index < sizeof(windows) / sizeof(windows[0]); ++index)
+    {
+        run_tcp(port++, windows[index]);
+        run_rudp(port++, windows[index]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,203 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <condition_variable>
+#include "boost_net.h"
+#include "bench_util.h"
+
+/* echoes plain connections, counts finished handshakes of tls ones */
+class HandshakeService : public BoostNet::TcpServiceBase
+{
+public:
+    HandshakeService()
+        : m_mutex()
+        , m_condition()
+        , m_ping_connection()
+        , m_echo_count(0)
+        , m_handshake_count(0)
+    {
+
+    }
+
+public:
+    virtual bool on_connect(BoostNet::TcpConnectionSharedPtr connection, const void * identity) override
+    {
+        if (nullptr == connection)
+        {
+            return true;
+        }
+        if (nullptr == identity)
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_ping_connection = connection;
+            m_condition.notify_all();
+            return true;
+        }
+        ++m_handshake_count;
+        connection->close();
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::TcpConnectionSharedPtr, unsigned short) override
+    {
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::TcpConnectionSharedPtr connection) override
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        if (m_ping_connection != connection)
+        {
+            connection->send_buffer_fill(connection->recv_buffer_data(), connection->recv_buffer_size());
+            connection->recv_buffer_drop(connection->recv_buffer_size());
+            return true;
+        }
+
+        connection->recv_buffer_drop(connection->recv_buffer_size());
+        ++m_echo_count;
+        m_condition.notify_all();
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::TcpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::TcpConnectionSharedPtr) override
+    {
+
+    }
+
+    virtual void on_error(BoostNet::TcpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+
+    }
+
+public:
+    BoostNet::TcpConnectionSharedPtr wait_ping_connection()
+    {
+        std::unique_lock<std::mutex> locker(m_mutex);
+        m_condition.wait_for(locker, std::chrono::seconds(5), [this]() { return nullptr != m_ping_connection; });
+        return m_ping_connection;
+    }
+
+    /* round trip of one 8 bytes message over the plain connection, in microseconds */
+    double ping()
+    {
+        std::unique_lock<std::mutex> locker(m_mutex);
+        const std::size_t echo_count = m_echo_count;
+        const double start = bench_seconds();
+        m_ping_connection->send_buffer_fill("pingping", 8);
+        m_condition.wait_for(locker, std::chrono::seconds(5), [this, echo_count]() { return m_echo_count != echo_count; });
+        return (bench_seconds() - start) * 1000000.0;
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_ping_connection.reset();
+    }
+
+    std::size_t handshake_count() const
+    {
+        return m_handshake_count;
+    }
+
+private:
+    std::mutex                                      m_mutex;
+    std::condition_variable                         m_condition;
+    BoostNet::TcpConnectionSharedPtr                m_ping_connection;
+    std::size_t                                     m_echo_count;
+    std::atomic<std::size_t>                        m_handshake_count;
+};
+
+static void run(std::size_t handshake_threads, unsigned short tls_port, unsigned short plain_port, const BoostNet::Certificate & server_certificate, const BoostNet::Certificate & client_certificate)
+{
+    HandshakeService server_service;
+    HandshakeService flood_service;
+    HandshakeService ping_service;
+    BoostNet::TcpManager server_manager;
+    BoostNet::TcpManager flood_manager;
+    BoostNet::TcpManager ping_manager;
+
+    const BoostNet::Listener plain_listener = { "127.0.0.1", plain_port, nullptr, nullptr, nullptr, nullptr, 0 };
+    if (!server_manager.init(&server_service, 1, "127.0.0.1", &tls_port, 1, false, &server_certificate, nullptr) || !server_manager.add_listener(plain_listener) || !flood_manager.init(&flood_service, 2, nullptr, nullptr, 0, false, nullptr, &client_certificate) || !ping_manager.init(&ping_service, 1))
+    {
+        printf("init failed\n");
+        return;
+    }
+    if (0 != handshake_threads && !server_manager.set_ssl_handshake_pool(handshake_threads))
+    {
+        printf("handshake pool failed\n");
+        return;
+    }
+
+    ping_manager.create_connection("127.0.0.1", plain_port, true);
+    if (nullptr == ping_service.wait_ping_connection())
+    {
+        printf("ping connection failed\n");
+        return;
+    }
+
+    /* keep about 32 handshakes in flight while the plain connection pings the same io thread */
+    std::atomic<bool> flooding(true);
+    std::size_t started_count = 0;
+    std::thread flood_thread([&]() {
+        static const char flood_identity = 0;
+        while (flooding)
+        {
+            if (started_count < flood_service.handshake_count() + 32)
+            {
+                flood_manager.create_connection("127.0.0.1", tls_port, false, &flood_identity);
+                ++started_count;
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    });
+
+    std::vector<double> round_trips;
+    const double start = bench_seconds();
+    while (bench_seconds() - start < 3.0)
+    {
+        round_trips.push_back(ping_service.ping());
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const double seconds = bench_seconds() - start;
+    flooding = false;
+    flood_thread.join();
+
+    std::sort(round_trips.begin(), round_trips.end());
+    printf("handshake threads %zu: %6.0f handshakes/s, ping p50 %7.0f us, p99 %7.0f us, max %7.0f us\n", handshake_threads, flood_service.handshake_count() / seconds, round_trips[round_trips.size() / 2], round_trips[round_trips.size() * 99 / 100], round_trips.back());
+
+    ping_service.release();
+    ping_manager.exit();
+    flood_manager.exit();
+    server_manager.exit();
+}
+
+int main(int, char *[])
+{
+    std::string cert_pem;
+    std::string key_pem;
+    if (!bench_make_certificate(cert_pem, key_pem))
+    {
+        printf("certificate generation failed\n");
+        return 1;
+    }
+
+    const BoostNet::Certificate server_certificate = { false, cert_pem.c_str(), key_pem.c_str(), nullptr, nullptr };
+    const BoostNet::Certificate client_certificate = { false, cert_pem.c_str(), nullptr, nullptr, nullptr };
+
+    run(0, 24610, 24611, server_certificate, client_certificate);
+    run(2, 24612, 24613, server_certificate, client_certificate);
+
+    return 0;
+}
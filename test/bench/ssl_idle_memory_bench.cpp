@@ -0,0 +1,142 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <malloc.h>
+#include "boost_net.h"
+#include "bench_util.h"
+
+/* every client sends one small message once connected, the pair is idle after the server got it */
+class IdleService : public BoostNet::TcpServiceBase
+{
+public:
+    IdleService()
+        : m_recv_count(0)
+    {
+
+    }
+
+public:
+    virtual bool on_connect(BoostNet::TcpConnectionSharedPtr connection, const void *) override
+    {
+        if (nullptr != connection)
+        {
+            connection->send_buffer_fill("hello", 5);
+        }
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::TcpConnectionSharedPtr, unsigned short) override
+    {
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::TcpConnectionSharedPtr connection) override
+    {
+        if (connection->recv_buffer_size() >= 5)
+        {
+            connection->recv_buffer_drop(5);
+            ++m_recv_count;
+        }
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::TcpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::TcpConnectionSharedPtr) override
+    {
+
+    }
+
+    virtual void on_error(BoostNet::TcpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+
+    }
+
+public:
+    std::size_t recv_count() const
+    {
+        return m_recv_count;
+    }
+
+private:
+    std::atomic<std::size_t>                        m_recv_count;
+};
+
+/* bytes the allocator handed out and has not got back, unlike rss it is not hidden by reused free memory */
+static std::size_t heap_bytes()
+{
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+static std::size_t rss_bytes()
+{
+    std::size_t rss_kb = 0;
+    FILE * file = fopen("/proc/self/status", "r");
+    if (nullptr == file)
+    {
+        return 0;
+    }
+    char line[256] = { 0x0 };
+    while (nullptr != fgets(line, sizeof(line), file))
+    {
+        if (0 == strncmp(line, "VmRSS:", 6))
+        {
+            rss_kb = static_cast<std::size_t>(atol(line + 6));
+        }
+    }
+    fclose(file);
+    return rss_kb * 1024;
+}
+
+static void run(const char * name, unsigned short port, const BoostNet::Certificate * server_certificate, const BoostNet::Certificate * client_certificate, std::size_t pair_count)
+{
+    IdleService idle_service;
+    BoostNet::TcpManager idle_manager;
+    if (!idle_manager.init(&idle_service, 1, "127.0.0.1", &port, 1, false, server_certificate, client_certificate))
+    {
+        printf("%-4s init failed\n", name);
+        return;
+    }
+    idle_manager.set_ssl_session_cache(0);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const std::size_t heap_before = heap_bytes();
+    const std::size_t rss_before = rss_bytes();
+
+    idle_manager.create_connections("127.0.0.1", port, pair_count, nullptr, 128);
+    const bool done = bench_wait_for([&idle_service, pair_count]() { return idle_service.recv_count() >= pair_count; }, 60.0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    const std::size_t heap_after = heap_bytes();
+    const std::size_t rss_after = rss_bytes();
+    printf("%-4s %zu idle pairs: %8zu heap bytes per pair, %8zu rss bytes per pair%s\n", name, pair_count, (heap_after - heap_before) / pair_count, (rss_after > rss_before ? rss_after - rss_before : 0) / pair_count, done ? "" : " (timeout)");
+
+    idle_manager.exit();
+}
+
+int main(int, char *[])
+{
+    std::string cert_pem;
+    std::string key_pem;
+    if (!bench_make_certificate(cert_pem, key_pem))
+    {
+        printf("certificate generation failed\n");
+        return 1;
+    }
+
+    const BoostNet::Certificate server_certificate = { false, cert_pem.c_str(), key_pem.c_str(), nullptr, nullptr };
+    const BoostNet::Certificate client_certificate = { false, cert_pem.c_str(), nullptr, nullptr, nullptr };
+
+    run("tcp", 24620, nullptr, nullptr, 1000);
+    run("tls", 24621, &server_certificate, &client_certificate, 1000);
+
+    return 0;
+}
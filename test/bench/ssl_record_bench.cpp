@@ -0,0 +1,120 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <atomic>
+#include "boost_net.h"
+#include "bench_util.h"
+
+/* the server queues message_count small messages at once, tls packs them into 16KB records, plain tcp writes them one by one */
+class RecordService : public BoostNet::TcpServiceBase
+{
+public:
+    RecordService(std::size_t message_count, std::size_t message_size)
+        : m_message(message_size, 'r')
+        , m_message_count(message_count)
+        , m_recv_bytes(0)
+    {
+
+    }
+
+public:
+    virtual bool on_connect(BoostNet::TcpConnectionSharedPtr, const void *) override
+    {
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::TcpConnectionSharedPtr connection, unsigned short) override
+    {
+        for (std::size_t index = 0; index < m_message_count; ++index)
+        {
+            connection->send_buffer_fill(m_message.data(), m_message.size());
+        }
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::TcpConnectionSharedPtr connection) override
+    {
+        m_recv_bytes += connection->recv_buffer_size();
+        connection->recv_buffer_drop(connection->recv_buffer_size());
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::TcpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::TcpConnectionSharedPtr) override
+    {
+
+    }
+
+    virtual void on_error(BoostNet::TcpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+
+    }
+
+public:
+    std::size_t total_bytes() const
+    {
+        return m_message.size() * m_message_count;
+    }
+
+    std::size_t recv_bytes() const
+    {
+        return m_recv_bytes;
+    }
+
+private:
+    const std::string                               m_message;
+    const std::size_t                               m_message_count;
+    std::atomic<std::size_t>                        m_recv_bytes;
+};
+
+static void run(const char * name, unsigned short port, const BoostNet::Certificate * server_certificate, const BoostNet::Certificate * client_certificate, std::size_t message_size)
+{
+    const std::size_t message_count = 32 * 1024 * 1024 / message_size;
+    RecordService record_service(message_count, message_size);
+
+    BoostNet::TcpManager server_manager;
+    BoostNet::TcpManager client_manager;
+    if (!server_manager.init(&record_service, 1, "127.0.0.1", &port, 1, false, server_certificate, nullptr) || !client_manager.init(&record_service, 1, nullptr, nullptr, 0, false, nullptr, client_certificate))
+    {
+        printf("%-4s init failed\n", name);
+        return;
+    }
+
+    const double start = bench_seconds();
+    client_manager.create_connection("127.0.0.1", port, true);
+    const bool done = bench_wait_for([&record_service]() { return record_service.recv_bytes() >= record_service.total_bytes(); }, 60.0);
+    const double seconds = bench_seconds() - start;
+
+    printf("%-4s %5zu byte messages: %8.1f MB/s %10.0f messages/s%s\n", name, message_size, record_service.recv_bytes() / seconds / 1000000.0, record_service.recv_bytes() / message_size / seconds, done ? "" : " (timeout)");
+
+    client_manager.exit();
+    server_manager.exit();
+}
+
+int main(int, char *[])
+{
+    std::string cert_pem;
+    std::string key_pem;
+    if (!bench_make_certificate(cert_pem, key_pem))
+    {
+        printf("certificate generation failed\n");
+        return 1;
+    }
+
+    const BoostNet::Certificate server_certificate = { false, cert_pem.c_str(), key_pem.c_str(), nullptr, nullptr };
+    const BoostNet::Certificate client_certificate = { false, cert_pem.c_str(), nullptr, nullptr, nullptr };
+
+    const std::size_t message_sizes[] = { 32, 256, 4096 };
+    unsigned short port = 24600;
+    for (std::size_t index = 0; index < sizeof(message_sizes) / sizeof(message_sizes[0]); ++index)
+    {
+        run("tcp", port++, nullptr, nullptr, message_sizes[index]);
+        run("tls", port++, &server_certificate, &client_certificate, message_sizes[index]);
+    }
+
+    return 0;
+}
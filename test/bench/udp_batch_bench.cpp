@@ -0,0 +1,151 @@
+#include <cstdio>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include "boost_net.h"
+#include "bench_util.h"
+
+/* the server echoes every datagram, the client counts the echoes */
+class EchoService : public BoostNet::UdpServiceBase
+{
+public:
+    EchoService(bool echo)
+        : m_echo(echo)
+        , m_mutex()
+        , m_connection()
+        , m_recv_count(0)
+    {
+
+    }
+
+public:
+    virtual bool on_connect(BoostNet::UdpConnectionSharedPtr connection, const void *) override
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connection = connection;
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::UdpConnectionSharedPtr, unsigned short) override
+    {
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::UdpConnectionSharedPtr connection) override
+    {
+        while (connection->recv_buffer_has_data())
+        {
+            if (m_echo)
+            {
+                connection->send_buffer_fill(connection->recv_buffer_data(), connection->recv_buffer_size());
+            }
+            connection->recv_buffer_drop();
+            ++m_recv_count;
+        }
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::UdpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::UdpConnectionSharedPtr) override
+    {
+
+    }
+
+    virtual void on_error(BoostNet::UdpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+
+    }
+
+public:
+    BoostNet::UdpConnectionSharedPtr connection()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_connection;
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connection.reset();
+    }
+
+    std::size_t recv_count() const
+    {
+        return m_recv_count;
+    }
+
+private:
+    const bool                                      m_echo;
+    std::mutex                                      m_mutex;
+    BoostNet::UdpConnectionSharedPtr                m_connection;
+    std::atomic<std::size_t>                        m_recv_count;
+};
+
+/* at most window datagrams of 100 bytes are in flight, window 1 is bound by latency, larger ones fill the batches */
+static void run(unsigned short port, std::size_t window)
+{
+    EchoService server_service(true);
+    EchoService client_service(false);
+    BoostNet::UdpManager server_manager;
+    BoostNet::UdpManager client_manager;
+    if (!server_manager.init(&server_service, 1, "127.0.0.1", &port, 1, true) || !client_manager.init(&client_service, 1) || !client_manager.create_connection("127.0.0.1", port, true))
+    {
+        printf("window %4zu: init failed\n", window);
+        return;
+    }
+    if (!bench_wait_for([&client_service]() { return nullptr != client_service.connection(); }, 5.0))
+    {
+        printf("window %4zu: connect failed\n", window);
+        return;
+    }
+
+    BoostNet::UdpConnectionSharedPtr connection = client_service.connection();
+    const char datagram[100] = { 0x0 };
+    std::size_t send_count = 0;
+    std::size_t total_count = 0;
+    std::size_t stall_count = 0;
+    const double start = bench_seconds();
+    while (bench_seconds() - start < 2.0)
+    {
+        const std::size_t recv_count = client_service.recv_count();
+        if (send_count < recv_count + window)
+        {
+            connection->send_buffer_fill(datagram, sizeof(datagram));
+            ++send_count;
+            ++total_count;
+            stall_count = 0;
+        }
+        else if (++stall_count > 100000)
+        {
+            /* a lost datagram would hold the window forever, count it as gone */
+            send_count = recv_count;
+            stall_count = 0;
+        }
+    }
+    const double seconds = bench_seconds() - start;
+
+    printf("window %4zu: %9.0f echoed datagrams/s, server got %zu of %zu\n", window, client_service.recv_count() / seconds, server_service.recv_count(), total_count);
+
+    connection.reset();
+    client_service.release();
+    client_manager.exit();
+    server_manager.exit();
+}
+
+int main(int, char *[])
+{
+    const std::size_t windows[] = { 1, 16, 64, 256 };
+    unsigned short port = 24630;
+    for (std::size_t index = 0; index < sizeof(windows) / sizeof(windows[0]); ++index)
+    {
+        run(port++, windows[index]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include "boost_net.h"
+#include "bench_util.h"
+
+static const std::size_t s_connection_count = 4;
+static const std::size_t s_datagram_size = 200;
+
+/* every datagram carries its sender index and sequence, the server counts deliveries and sequences that went backwards */
+class SequenceService : public BoostNet::UdpServiceBase
+{
+public:
+    SequenceService()
+        : m_mutex()
+        , m_connections()
+        , m_recv_count(0)
+        , m_reorder_count(0)
+    {
+        memset(m_next_sequences, 0x0, sizeof(m_next_sequences));
+    }
+
+public:
+    virtual bool on_connect(BoostNet::UdpConnectionSharedPtr connection, const void *) override
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connections.push_back(connection);
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::UdpConnectionSharedPtr, unsigned short) override
+    {
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::UdpConnectionSharedPtr connection) override
+    {
+        while (connection->recv_buffer_has_data())
+        {
+            if (connection->recv_buffer_size() >= sizeof(uint32_t) + sizeof(uint64_t))
+            {
+                const char * data = reinterpret_cast<const char *>(connection->recv_buffer_data());
+                uint32_t index = 0;
+                uint64_t sequence = 0;
+                memcpy(&index, data, sizeof(index));
+                memcpy(&sequence, data + sizeof(index), sizeof(sequence));
+                if (index < s_connection_count)
+                {
+                    if (sequence < m_next_sequences[index])
+                    {
+                        ++m_reorder_count;
+                    }
+                    else
+                    {
+                        m_next_sequences[index] = sequence + 1;
+                    }
+                    ++m_recv_count;
+                }
+            }
+            connection->recv_buffer_drop();
+        }
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::UdpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::UdpConnectionSharedPtr) override
+    {
+
+    }
+
+    virtual void on_error(BoostNet::UdpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+
+    }
+
+public:
+    std::vector<BoostNet::UdpConnectionSharedPtr> connections()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_connections;
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connections.clear();
+    }
+
+    std::size_t recv_count() const
+    {
+        return m_recv_count;
+    }
+
+    std::size_t reorder_count() const
+    {
+        return m_reorder_count;
+    }
+
+private:
+    std::mutex                                      m_mutex;
+    std::vector<BoostNet::UdpConnectionSharedPtr>   m_connections;
+    std::atomic<std::size_t>                        m_recv_count;
+    std::atomic<std::size_t>                        m_reorder_count;
+    uint64_t                                        m_next_sequences[s_connection_count];
+};
+
+/* one thread per connection sends datagram_count datagrams, resting 1ms after every burst of them (0 never rests) */
+static void run(unsigned short port, bool direct_send, std::size_t datagram_count, std::size_t burst)
+{
+    const char * name = direct_send ? "direct" : "queued";
+    SequenceService server_service;
+    SequenceService client_service;
+    BoostNet::UdpManager server_manager;
+    BoostNet::UdpManager client_manager;
+    if (!server_manager.init(&server_service, 1, "127.0.0.1", &port, 1, true) || !client_manager.init(&client_service, 1) || !client_manager.set_direct_send(direct_send))
+    {
+        printf("%s: init failed\n", name);
+        return;
+    }
+    for (std::size_t index = 0; index < s_connection_count; ++index)
+    {
+        client_manager.create_connection("127.0.0.1", port, true);
+    }
+    if (!bench_wait_for([&client_service]() { return s_connection_count == client_service.connections().size(); }, 5.0))
+    {
+        printf("%s: connect failed\n", name);
+        return;
+    }
+
+    std::vector<BoostNet::UdpConnectionSharedPtr> connections = client_service.connections();
+    std::vector<std::thread> senders;
+    const double start = bench_seconds();
+    for (std::size_t index = 0; index < s_connection_count; ++index)
+    {
+        senders.push_back(std::thread([&connections, index, datagram_count, burst]() {
+            char datagram[s_datagram_size] = { 0x0 };
+            const uint32_t sender_index = static_cast<uint32_t>(index);
+            memcpy(datagram, &sender_index, sizeof(sender_index));
+            for (uint64_t sequence = 0; sequence < datagram_count; ++sequence)
+            {
+                memcpy(datagram + sizeof(sender_index), &sequence, sizeof(sequence));
+                connections[index]->send_buffer_fill(datagram, sizeof(datagram));
+                if (0 != burst && 0 == (sequence + 1) % burst)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        }));
+    }
+    for (std::vector<std::thread>::iterator iter = senders.begin(); senders.end() != iter; ++iter)
+    {
+        iter->join();
+    }
+    const double send_seconds = bench_seconds() - start;
+
+    const std::size_t total_count = s_connection_count * datagram_count;
+    bench_wait_for([&server_service, total_count]() { return server_service.recv_count() >= total_count; }, 2.0);
+
+    printf("%s burst %3zu: %9.0f sends/s from %zu threads, delivered %5.1f%% of %zu, %zu reordered\n", name, burst, total_count / send_seconds, s_connection_count, 100.0 * server_service.recv_count() / total_count, total_count, server_service.reorder_count());
+
+    connections.clear();
+    client_service.release();
+    client_manager.exit();
+    server_manager.exit();
+}
+
+int main(int, char *[])
+{
+    run(24640, false, 50000, 0);
+    run(24641, true, 50000, 0);
+    run(24642, false, 50000, 50);
+    run(24643, true, 50000, 50);
+
+    return 0;
+}
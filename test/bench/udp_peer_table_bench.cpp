@@ -0,0 +1,104 @@
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+#include <unordered_map>
+#include "udp_peer_table.h"
+#include "bench_util.h"
+
+typedef BoostNet::UdpPeerTable::endpoint_type endpoint_type;
+typedef BoostNet::UdpPeerTable::connection_ptr connection_ptr;
+
+struct endpoint_hash
+{
+    std::size_t operator () (const endpoint_type & endpoint) const
+    {
+        return static_cast<std::size_t>(BoostNet::UdpPeerTable::hash_endpoint(endpoint));
+    }
+};
+
+/* the table never touches the connection, one aliasing pointer stands in for every peer */
+static connection_ptr make_connection()
+{
+    static std::shared_ptr<int> s_owner(new int(0));
+    return connection_ptr(s_owner, reinterpret_cast<BoostNet::UdpPassiveConnection *>(s_owner.get()));
+}
+
+/* random peers of 10.0.0.0/8, looked up in random order so neither the last hit slot nor the cpu cache helps */
+static void run(std::size_t peer_count)
+{
+    std::mt19937_64 random(1);
+    std::vector<endpoint_type> endpoints;
+    endpoints.reserve(peer_count);
+    for (std::size_t index = 0; index < peer_count; ++index)
+    {
+        endpoints.push_back(endpoint_type(boost::asio::ip::address_v4(static_cast<uint32_t>(0x0a000000 + random() % 0xffffff)), static_cast<unsigned short>(1024 + index % 50000)));
+    }
+
+    std::vector<std::size_t> lookups(2000000);
+    for (std::vector<std::size_t>::iterator iter = lookups.begin(); lookups.end() != iter; ++iter)
+    {
+        *iter = static_cast<std::size_t>(random() % peer_count);
+    }
+
+    const connection_ptr connection = make_connection();
+    BoostNet::UdpPeerTable peer_table;
+    std::map<endpoint_type, connection_ptr> peer_map;
+    std::unordered_map<endpoint_type, connection_ptr, endpoint_hash> peer_hash_map;
+
+    double start = bench_seconds();
+    for (std::vector<endpoint_type>::const_iterator iter = endpoints.begin(); endpoints.end() != iter; ++iter)
+    {
+        peer_table.insert(*iter, connection, 0);
+    }
+    const double table_insert = bench_seconds() - start;
+
+    start = bench_seconds();
+    for (std::vector<endpoint_type>::const_iterator iter = endpoints.begin(); endpoints.end() != iter; ++iter)
+    {
+        peer_map.insert(std::make_pair(*iter, connection));
+    }
+    const double map_insert = bench_seconds() - start;
+
+    start = bench_seconds();
+    for (std::vector<endpoint_type>::const_iterator iter = endpoints.begin(); endpoints.end() != iter; ++iter)
+    {
+        peer_hash_map.insert(std::make_pair(*iter, connection));
+    }
+    const double hash_map_insert = bench_seconds() - start;
+
+    std::size_t hit_count = 0;
+    start = bench_seconds();
+    for (std::vector<std::size_t>::const_iterator iter = lookups.begin(); lookups.end() != iter; ++iter)
+    {
+        hit_count += (nullptr != peer_table.find(endpoints[*iter], 1) ? 1 : 0);
+    }
+    const double table_find = bench_seconds() - start;
+
+    start = bench_seconds();
+    for (std::vector<std::size_t>::const_iterator iter = lookups.begin(); lookups.end() != iter; ++iter)
+    {
+        hit_count += (peer_map.end() != peer_map.find(endpoints[*iter]) ? 1 : 0);
+    }
+    const double map_find = bench_seconds() - start;
+
+    start = bench_seconds();
+    for (std::vector<std::size_t>::const_iterator iter = lookups.begin(); lookups.end() != iter; ++iter)
+    {
+        hit_count += (peer_hash_map.end() != peer_hash_map.find(endpoints[*iter]) ? 1 : 0);
+    }
+    const double hash_map_find = bench_seconds() - start;
+
+    printf("%7zu peers: insert M/s table %6.1f map %6.1f unordered_map %6.1f, find M/s table %6.1f map %6.1f unordered_map %6.1f (%zu hits)\n", peer_count,
+        endpoints.size() / table_insert / 1000000.0, endpoints.size() / map_insert / 1000000.0, endpoints.size() / hash_map_insert / 1000000.0,
+        lookups.size() / table_find / 1000000.0, lookups.size() / map_find / 1000000.0, lookups.size() / hash_map_find / 1000000.0, hit_count);
+}
+
+int main(int, char *[])
+{
+    run(10000);
+    run(100000);
+    run(1000000);
+
+    return 0;
+}
@@ -5,10 +5,11 @@ int main(int, char *[])
 {
     bool use_tcp = true;
     bool sync_connect = true;
+    bool bulk_connect = false;
     std::size_t send_times = 0;
     std::size_t connection_count = 1000;
 
-    TestClient client(use_tcp, sync_connect, send_times, connection_count);
+    TestClient client(use_tcp, sync_connect, send_times, connection_count, bulk_connect);
 
     client.init();
 
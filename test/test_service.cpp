@@ -8,10 +8,11 @@
 static const char msg_blk[] = "this is a message\n";
 static const std::size_t msg_len = sizeof(msg_blk) / sizeof(msg_blk[0]) - 1;
 
-TestService::TestService(bool use_tcp, bool requester, bool sync_connect, std::size_t send_times, std::size_t connect_count)
+TestService::TestService(bool use_tcp, bool requester, bool sync_connect, std::size_t send_times, std::size_t connect_count, bool bulk_connect)
     : m_use_tcp(use_tcp)
     , m_requester(requester)
     , m_sync_connect(sync_connect)
+    , m_bulk_connect(bulk_connect)
     , m_max_message_count(std::min(use_tcp ? send_times : send_times + 1, (65536 - 2 - 1) / msg_len))
     , m_max_connect_count(connect_count)
     , m_connect_count(0)
@@ -76,6 +77,11 @@ void TestService::on_error(BoostNet::TcpConnectionSharedPtr connection, const ch
 
 }
 
+void TestService::on_connect_summary(const void * identity, std::size_t success_count, std::size_t failure_count)
+{
+    printf("connect summary: %u success, %u failure\n", static_cast<uint32_t>(success_count), static_cast<uint32_t>(failure_count));
+}
+
 bool TestService::insert_connection(BoostNet::TcpConnectionSharedPtr connection)
 {
     if (!connection)
@@ -432,6 +438,10 @@ bool TestService::init()
             {
                 return false;
             }
+            if (m_bulk_connect)
+            {
+                return m_tcp_manager.create_connections("127.0.0.1", 12345, m_max_connect_count);
+            }
             for (std::size_t index = 0; index < m_max_connect_count; ++index)
             {
                 if (!m_tcp_manager.create_connection("127.0.0.1", 12345, m_sync_connect))
@@ -494,8 +504,8 @@ TestServer::TestServer(bool use_tcp, std::size_t send_times)
 
 }
 
-TestClient::TestClient(bool use_tcp, bool sync_connect, std::size_t send_times, std::size_t connect_count)
-    : TestService(use_tcp, true, sync_connect, send_times, connect_count)
+TestClient::TestClient(bool use_tcp, bool sync_connect, std::size_t send_times, std::size_t connect_count, bool bulk_connect)
+    : TestService(use_tcp, true, sync_connect, send_times, connect_count, bulk_connect)
 {
 
 }
@@ -9,7 +9,7 @@
 class TestService : public BoostNet::TcpServiceBase, public BoostNet::UdpServiceBase
 {
 public:
-    TestService(bool use_tcp, bool requester, bool sync_connect, std::size_t send_times, std::size_t connect_count);
+    TestService(bool use_tcp, bool requester, bool sync_connect, std::size_t send_times, std::size_t connect_count, bool bulk_connect = false);
     virtual ~TestService();
 
 public:
@@ -23,6 +23,7 @@ private:
     virtual bool on_send(BoostNet::TcpConnectionSharedPtr connection) override;
     virtual void on_close(BoostNet::TcpConnectionSharedPtr connection) override;
     virtual void on_error(BoostNet::TcpConnectionSharedPtr connection, const char * operater, const char * action, int error, const char * message) override;
+    virtual void on_connect_summary(const void * identity, std::size_t success_count, std::size_t failure_count) override;
 
 private:
     bool insert_connection(BoostNet::TcpConnectionSharedPtr connection);
@@ -58,6 +59,7 @@ private:
     bool                                                        m_use_tcp;
     bool                                                        m_requester;
     bool                                                        m_sync_connect;
+    bool                                                        m_bulk_connect;
     std::size_t                                                 m_max_message_count;
     std::size_t                                                 m_max_connect_count;
     std::atomic_long                                            m_connect_count;
@@ -76,7 +78,7 @@ public:
 class TestClient : public TestService
 {
 public:
-    TestClient(bool use_tcp, bool sync_connect, std::size_t send_times, std::size_t connection_count);
+    TestClient(bool use_tcp, bool sync_connect, std::size_t send_times, std::size_t connection_count, bool bulk_connect = false);
 };
 
 
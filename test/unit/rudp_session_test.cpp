@@ -0,0 +1,370 @@
+#include <map>
+#include <deque>
+#include <string>
+#include <vector>
+#include <random>
+#include <functional>
+#include "rudp_session.h"
+#include "unit_test.h"
+
+typedef BoostNet::RudpSession::buffer_type buffer_type;
+typedef BoostNet::RudpSession::buffer_array buffer_array;
+
+static BoostNet::RudpOptions make_options(std::size_t window_size, std::size_t fast_resend, std::size_t min_rto_milliseconds, std::size_t dead_link)
+{
+    BoostNet::RudpOptions options;
+    options.ordered = true;
+    options.window_size = window_size;
+    options.interval_milliseconds = 10;
+    options.fast_resend = fast_resend;
+    options.min_rto_milliseconds = min_rto_milliseconds;
+    options.congestion_control = true;
+    options.pacing = true;
+    options.mtu = 1400;
+    options.dead_link = dead_link;
+    return options;
+}
+
+static std::string make_message(std::size_t index, std::size_t size)
+{
+    std::string message(size, 0x0);
+    for (std::size_t offset = 0; offset < size; ++offset)
+    {
+        message[offset] = static_cast<char>('a' + (index + offset) % 26);
+    }
+    return message;
+}
+
+/* a push segment on the wire: cmd 1 at byte 0, sn at bytes 12..15 and len at bytes 20..21, little endian */
+static void push_sequences(const buffer_type & datagram, std::vector<uint32_t> & sequences)
+{
+    const unsigned char * bytes = reinterpret_cast<const unsigned char *>(datagram.data());
+    for (std::size_t offset = 0; offset + 22 <= datagram.size(); )
+    {
+        const uint32_t sn = static_cast<uint32_t>(bytes[offset + 12]) | (static_cast<uint32_t>(bytes[offset + 13]) << 8) | (static_cast<uint32_t>(bytes[offset + 14]) << 16) | (static_cast<uint32_t>(bytes[offset + 15]) << 24);
+        const std::size_t len = static_cast<std::size_t>(bytes[offset + 20]) | (static_cast<std::size_t>(bytes[offset + 21]) << 8);
+        if (1 == bytes[offset])
+        {
+            sequences.push_back(sn);
+        }
+        offset += 22 + len;
+    }
+}
+
+/*
+ * two sessions joined by a simulated link on a millisecond clock: every datagram is delayed by latency,
+ * lost with loss_rate, or dropped by the drop callback which sees the push sequences of the sender side
+ */
+class LossyLink
+{
+public:
+    typedef std::function<bool(const std::vector<uint32_t> &)> drop_type;
+
+public:
+    LossyLink(BoostNet::RudpSession & sender, BoostNet::RudpSession & receiver, uint32_t latency, double loss_rate)
+        : m_sender(sender)
+        , m_receiver(receiver)
+        , m_latency(latency)
+        , m_loss_rate(loss_rate)
+        , m_random(7)
+        , m_current(0)
+        , m_to_receiver()
+        , m_to_sender()
+        , m_drop()
+        , m_push_counts()
+        , m_received()
+        , m_pop(true)
+    {
+
+    }
+
+public:
+    void set_drop(const drop_type & drop)
+    {
+        m_drop = drop;
+    }
+
+    void set_pop(bool pop)
+    {
+        m_pop = pop;
+    }
+
+    uint32_t current() const
+    {
+        return m_current;
+    }
+
+    const std::map<uint32_t, std::size_t> & push_counts() const
+    {
+        return m_push_counts;
+    }
+
+    std::vector<std::string> & received()
+    {
+        return m_received;
+    }
+
+    /* steps the clock until done() holds or max_milliseconds pass, tick() runs first on every step */
+    bool run(uint32_t max_milliseconds, const std::function<bool()> & done, const std::function<void(uint32_t)> & tick = std::function<void(uint32_t)>())
+    {
+        const uint32_t deadline = m_current + max_milliseconds;
+        while (m_current < deadline)
+        {
+            if (tick)
+            {
+                tick(m_current);
+            }
+            deliver(m_to_receiver, m_receiver);
+            deliver(m_to_sender, m_sender);
+            if (m_pop)
+            {
+                while (m_receiver.has_message())
+                {
+                    m_received.push_back(std::string(m_receiver.front_message().begin(), m_receiver.front_message().end()));
+                    m_receiver.pop_message();
+                }
+            }
+            if (0 == m_current % 10)
+            {
+                flush(m_sender, m_to_receiver, true);
+                flush(m_receiver, m_to_sender, false);
+            }
+            if (done())
+            {
+                return true;
+            }
+            ++m_current;
+        }
+        return done();
+    }
+
+private:
+    typedef std::deque<std::pair<uint32_t, buffer_type>> queue_type;
+
+    void deliver(queue_type & queue, BoostNet::RudpSession & session)
+    {
+        while (!queue.empty() && queue.front().first <= m_current)
+        {
+            session.input(queue.front().second.data(), queue.front().second.size(), m_current);
+            queue.pop_front();
+        }
+    }
+
+    void flush(BoostNet::RudpSession & session, queue_type & queue, bool from_sender)
+    {
+        buffer_array datagrams;
+        session.flush(m_current, datagrams);
+        for (buffer_array::iterator iter = datagrams.begin(); datagrams.end() != iter; ++iter)
+        {
+            if (from_sender)
+            {
+                std::vector<uint32_t> sequences;
+                push_sequences(*iter, sequences);
+                for (std::vector<uint32_t>::const_iterator sn = sequences.begin(); sequences.end() != sn; ++sn)
+                {
+                    ++m_push_counts[*sn];
+                }
+                if (m_drop && m_drop(sequences))
+                {
+                    continue;
+                }
+            }
+            if (std::uniform_real_distribution<double>(0.0, 1.0)(m_random) < m_loss_rate)
+            {
+                continue;
+            }
+            queue.push_back(std::make_pair(m_current + m_latency, std::move(*iter)));
+        }
+    }
+
+private:
+    BoostNet::RudpSession                         & m_sender;
+    BoostNet::RudpSession                         & m_receiver;
+    const uint32_t                                  m_latency;
+    const double                                    m_loss_rate;
+    std::mt19937                                    m_random;
+    uint32_t                                        m_current;
+    queue_type                                      m_to_receiver;
+    queue_type                                      m_to_sender;
+    drop_type                                       m_drop;
+    std::map<uint32_t, std::size_t>                 m_push_counts;
+    std::vector<std::string>                        m_received;
+    bool                                            m_pop;
+};
+
+static bool in_order(const std::vector<std::string> & received, std::size_t count, std::size_t size)
+{
+    if (count != received.size())
+    {
+        return false;
+    }
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        if (make_message(index, 1 + (index * size) % (4 * size)) != received[index])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* messages of up to four segments survive 20% loss in both directions, whole and in order */
+static void test_retransmit_under_loss()
+{
+    BoostNet::RudpSession sender;
+    BoostNet::RudpSession receiver;
+    UNIT_TEST_CHECK(sender.init(make_options(64, 2, 30, 100)));
+    UNIT_TEST_CHECK(receiver.init(make_options(64, 2, 30, 100)));
+
+    const std::size_t count = 300;
+    const std::size_t size = 1378;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        UNIT_TEST_CHECK(sender.send(make_message(index, 1 + (index * size) % (4 * size)).data(), 1 + (index * size) % (4 * size)));
+    }
+
+    LossyLink link(sender, receiver, 20, 0.2);
+    UNIT_TEST_CHECK(link.run(120000, [&link, &sender, count]() { return count == link.received().size() && sender.idle(); }));
+    UNIT_TEST_CHECK(in_order(link.received(), count, size));
+    UNIT_TEST_CHECK(!sender.dead());
+
+    std::size_t resend_count = 0;
+    for (std::map<uint32_t, std::size_t>::const_iterator iter = link.push_counts().begin(); link.push_counts().end() != iter; ++iter)
+    {
+        resend_count += iter->second - 1;
+    }
+    UNIT_TEST_CHECK(resend_count > 0);
+}
+
+/*
+ * the datagram carrying one push is lost once while later ones keep flowing: with fast resend it is sent again long before the 1s rto,
+ * and the segments after it are selectively acked, so only the segments of that datagram go out twice
+ */
+static void run_single_loss(std::size_t fast_resend, uint32_t & delivered_at, std::size_t & dropped_count, std::size_t & resend_count)
+{
+    BoostNet::RudpSession sender;
+    BoostNet::RudpSession receiver;
+    UNIT_TEST_CHECK(sender.init(make_options(64, fast_resend, 1000, 20)));
+    UNIT_TEST_CHECK(receiver.init(make_options(64, fast_resend, 1000, 20)));
+
+    const std::size_t count = 40;
+    const uint32_t lost_sn = 5;
+    LossyLink link(sender, receiver, 20, 0.0);
+    dropped_count = 0;
+    link.set_drop([&dropped_count, lost_sn](const std::vector<uint32_t> & sequences) {
+        for (std::vector<uint32_t>::const_iterator iter = sequences.begin(); sequences.end() != iter; ++iter)
+        {
+            if (lost_sn == *iter && 0 == dropped_count)
+            {
+                dropped_count = sequences.size();
+                return true;
+            }
+        }
+        return false;
+    });
+
+    /* one small message per flush, so acks of later segments carry later send times */
+    std::size_t sent_count = 0;
+    delivered_at = 0;
+    link.run(5000, [&link, &sender, &delivered_at, count]() {
+        if (0 == delivered_at && link.received().size() > lost_sn)
+        {
+            delivered_at = link.current();
+        }
+        return count == link.received().size() && sender.idle();
+    }, [&sender, &sent_count, count](uint32_t current) {
+        if (0 == current % 10 && sent_count < count)
+        {
+            const std::string message = make_message(sent_count++, 100);
+            sender.send(message.data(), message.size());
+        }
+    });
+
+    UNIT_TEST_CHECK(0 != dropped_count);
+    UNIT_TEST_CHECK(count == link.received().size());
+
+    resend_count = 0;
+    for (std::map<uint32_t, std::size_t>::const_iterator iter = link.push_counts().begin(); link.push_counts().end() != iter; ++iter)
+    {
+        resend_count += iter->second - 1;
+    }
+}
+
+static void test_fast_resend_and_sack()
+{
+    uint32_t fast_delivered_at = 0;
+    std::size_t fast_dropped_count = 0;
+    std::size_t fast_resend_count = 0;
+    run_single_loss(2, fast_delivered_at, fast_dropped_count, fast_resend_count);
+    UNIT_TEST_CHECK(0 != fast_delivered_at && fast_delivered_at < 500);
+    UNIT_TEST_CHECK(fast_dropped_count == fast_resend_count);
+
+    uint32_t timeout_delivered_at = 0;
+    std::size_t timeout_dropped_count = 0;
+    std::size_t timeout_resend_count = 0;
+    run_single_loss(0, timeout_delivered_at, timeout_dropped_count, timeout_resend_count);
+    UNIT_TEST_CHECK(timeout_delivered_at > 1000);
+    UNIT_TEST_CHECK(timeout_dropped_count == timeout_resend_count);
+}
+
+/* a receiver that stops reading closes the window: the sender holds back, and resumes once messages are read */
+static void test_receive_window()
+{
+    const std::size_t window_size = 32;
+    BoostNet::RudpSession sender;
+    BoostNet::RudpSession receiver;
+    UNIT_TEST_CHECK(sender.init(make_options(window_size, 2, 30, 1000)));
+    UNIT_TEST_CHECK(receiver.init(make_options(window_size, 2, 30, 1000)));
+
+    const std::size_t count = 200;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const std::string message = make_message(index, 100);
+        UNIT_TEST_CHECK(sender.send(message.data(), message.size()));
+    }
+
+    LossyLink link(sender, receiver, 5, 0.0);
+    link.set_pop(false);
+    link.run(3000, []() { return false; });
+    UNIT_TEST_CHECK(!sender.idle());
+    UNIT_TEST_CHECK(!sender.dead());
+    UNIT_TEST_CHECK(link.push_counts().size() <= 2 * window_size + 1);
+
+    link.set_pop(true);
+    UNIT_TEST_CHECK(link.run(30000, [&link, &sender, count]() { return count == link.received().size() && sender.idle(); }));
+    for (std::size_t index = 0; index < link.received().size() && index < count; ++index)
+    {
+        UNIT_TEST_CHECK(make_message(index, 100) == link.received()[index]);
+    }
+}
+
+/* a link that stops carrying anything is declared dead after dead_link sends of one segment */
+static void test_dead_link()
+{
+    BoostNet::RudpSession sender;
+    BoostNet::RudpSession receiver;
+    UNIT_TEST_CHECK(sender.init(make_options(64, 2, 30, 5)));
+    UNIT_TEST_CHECK(receiver.init(make_options(64, 2, 30, 5)));
+
+    LossyLink link(sender, receiver, 10, 0.0);
+    const std::string first = make_message(0, 100);
+    UNIT_TEST_CHECK(sender.send(first.data(), first.size()));
+    UNIT_TEST_CHECK(link.run(1000, [&link, &sender]() { return 1 == link.received().size() && sender.idle(); }));
+    UNIT_TEST_CHECK(!sender.dead());
+
+    link.set_drop([](const std::vector<uint32_t> &) { return true; });
+    const std::string second = make_message(1, 100);
+    UNIT_TEST_CHECK(sender.send(second.data(), second.size()));
+    UNIT_TEST_CHECK(link.run(60000, [&sender]() { return sender.dead(); }));
+    UNIT_TEST_CHECK(1 == link.received().size());
+    UNIT_TEST_CHECK(6 == link.push_counts().find(1)->second);
+}
+
+int main(int, char *[])
+{
+    UNIT_TEST_RUN(test_retransmit_under_loss);
+    UNIT_TEST_RUN(test_fast_resend_and_sack);
+    UNIT_TEST_RUN(test_receive_window);
+    UNIT_TEST_RUN(test_dead_link);
+    return UNIT_TEST_RESULT();
+}
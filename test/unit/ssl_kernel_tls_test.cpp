@@ -0,0 +1,289 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <openssl/ssl.h>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+#include "ssl_kernel_tls.h"
+#include "unit_test.h"
+
+static bool make_connection(int & client_fd, int & server_fd)
+{
+    client_fd = -1;
+    server_fd = -1;
+
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0x0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_size = sizeof(address);
+    if (listen_fd < 0 || 0 != bind(listen_fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) || 0 != listen(listen_fd, 1) || 0 != getsockname(listen_fd, reinterpret_cast<struct sockaddr *>(&address), &address_size))
+    {
+        if (listen_fd >= 0)
+        {
+            close(listen_fd);
+        }
+        return false;
+    }
+
+    client_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (client_fd >= 0 && 0 == connect(client_fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)))
+    {
+        server_fd = accept(listen_fd, nullptr, nullptr);
+    }
+    close(listen_fd);
+
+    if (server_fd < 0)
+    {
+        if (client_fd >= 0)
+        {
+            close(client_fd);
+        }
+        client_fd = -1;
+        return false;
+    }
+
+    return true;
+}
+
+static bool tls_ulp_available()
+{
+    int client_fd = -1;
+    int server_fd = -1;
+    if (!make_connection(client_fd, server_fd))
+    {
+        return false;
+    }
+
+    bool available = (0 == setsockopt(client_fd, IPPROTO_TCP, TCP_ULP, "tls", sizeof("tls")));
+    close(client_fd);
+    close(server_fd);
+
+    return available;
+}
+
+static SSL_CTX * make_context(bool passive, int version)
+{
+    SSL_CTX * ssl_context = SSL_CTX_new(passive ? TLS_server_method() : TLS_client_method());
+    SSL_CTX_set_min_proto_version(ssl_context, version);
+    SSL_CTX_set_max_proto_version(ssl_context, version);
+    SSL_CTX_set_cipher_list(ssl_context, "ECDHE-ECDSA-AES128-GCM-SHA256");
+    SSL_CTX_set_ciphersuites(ssl_context, "TLS_AES_128_GCM_SHA256");
+
+    if (passive)
+    {
+        EVP_PKEY * key = EVP_EC_gen("P-256");
+        X509 * certificate = X509_new();
+        ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+        X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+        X509_gmtime_adj(X509_getm_notAfter(certificate), 3600);
+        X509_set_pubkey(certificate, key);
+        X509_NAME_add_entry_by_txt(X509_get_subject_name(certificate), "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char *>("localhost"), -1, -1, 0);
+        X509_set_issuer_name(certificate, X509_get_subject_name(certificate));
+        X509_sign(certificate, key, EVP_sha256());
+        SSL_CTX_use_certificate(ssl_context, certificate);
+        SSL_CTX_use_PrivateKey(ssl_context, key);
+        X509_free(certificate);
+        EVP_PKEY_free(key);
+    }
+
+    return ssl_context;
+}
+
+static std::string kernel_recv(BoostNet::SslKernelTls & kernel_tls, int fd, std::size_t size, int & error)
+{
+    std::string data;
+    while (data.size() < size)
+    {
+        char buffer[256] = { 0x0 };
+        std::size_t recv_size = kernel_tls.recv(fd, buffer, sizeof(buffer), error);
+        if (EAGAIN == error || EWOULDBLOCK == error)
+        {
+            struct pollfd poll_fd = { fd, POLLIN, 0 };
+            poll(&poll_fd, 1, 1000);
+            continue;
+        }
+        if (0 != error || 0 == recv_size)
+        {
+            break;
+        }
+        data.append(buffer, recv_size);
+    }
+    return data;
+}
+
+/* one side offloads to the kernel, the other stays in openssl so each direction is checked against a userspace peer */
+static void test_offload(int version, bool offload_passive)
+{
+    int client_fd = -1;
+    int server_fd = -1;
+    UNIT_TEST_CHECK(make_connection(client_fd, server_fd));
+    if (client_fd < 0)
+    {
+        return;
+    }
+
+    SSL_CTX * client_context = make_context(false, version);
+    SSL_CTX * server_context = make_context(true, version);
+    UNIT_TEST_CHECK(BoostNet::SslKernelTls::enable(offload_passive ? server_context : client_context, true));
+
+    SSL * client_ssl = SSL_new(client_context);
+    SSL * server_ssl = SSL_new(server_context);
+    SSL_set_fd(client_ssl, client_fd);
+    SSL_set_fd(server_ssl, server_fd);
+
+    SSL * offload_ssl = (offload_passive ? server_ssl : client_ssl);
+    SSL * peer_ssl = (offload_passive ? client_ssl : server_ssl);
+    const int offload_fd = (offload_passive ? server_fd : client_fd);
+
+    BoostNet::SslKernelTls kernel_tls;
+    kernel_tls.prepare(offload_ssl);
+
+    int server_ret = 0;
+    std::thread server_thread([server_ssl, &server_ret]() { server_ret = SSL_accept(server_ssl); });
+    const int client_ret = SSL_connect(client_ssl);
+    server_thread.join();
+    UNIT_TEST_CHECK(1 == client_ret && 1 == server_ret);
+
+    UNIT_TEST_CHECK(kernel_tls.install(offload_ssl, offload_fd, offload_passive));
+    UNIT_TEST_CHECK(kernel_tls.send_offload() && kernel_tls.recv_offload());
+    if (kernel_tls.send_offload() && kernel_tls.recv_offload())
+    {
+        char buffer[16] = { 0x0 };
+        int error = 0;
+
+        /* the send sequence follows the tickets a tls 1.3 server has already written */
+        UNIT_TEST_CHECK(4 == send(offload_fd, "ping", 4, 0));
+        UNIT_TEST_CHECK(4 == SSL_read(peer_ssl, buffer, sizeof(buffer)) && 0 == memcmp(buffer, "ping", 4));
+
+        /* a tls 1.3 client receives the tickets first, they are dropped without breaking the stream */
+        UNIT_TEST_CHECK(4 == SSL_write(peer_ssl, "pong", 4));
+        UNIT_TEST_CHECK("pong" == kernel_recv(kernel_tls, offload_fd, 4, error) && 0 == error);
+
+        if (TLS1_3_VERSION == version)
+        {
+            UNIT_TEST_CHECK(1 == SSL_key_update(peer_ssl, SSL_KEY_UPDATE_NOT_REQUESTED));
+            UNIT_TEST_CHECK(4 == SSL_write(peer_ssl, "next", 4));
+            UNIT_TEST_CHECK(kernel_recv(kernel_tls, offload_fd, 4, error).empty() && EPROTO == error);
+        }
+        else
+        {
+            SSL_shutdown(peer_ssl);
+            UNIT_TEST_CHECK(kernel_recv(kernel_tls, offload_fd, 4, error).empty() && 0 == error);
+        }
+    }
+
+    SSL_free(client_ssl);
+    SSL_free(server_ssl);
+    SSL_CTX_free(client_context);
+    SSL_CTX_free(server_context);
+    close(client_fd);
+    close(server_fd);
+}
+
+/* needs no tls ulp, the accounting install() relies on before handing the read side to the kernel */
+static void test_recv_drained(int version)
+{
+    int client_fd = -1;
+    int server_fd = -1;
+    UNIT_TEST_CHECK(make_connection(client_fd, server_fd));
+    if (client_fd < 0)
+    {
+        return;
+    }
+
+    SSL_CTX * client_context = make_context(false, version);
+    SSL_CTX * server_context = make_context(true, version);
+    SSL * client_ssl = SSL_new(client_context);
+    SSL * server_ssl = SSL_new(server_context);
+    SSL_set_fd(client_ssl, client_fd);
+    SSL_set_fd(server_ssl, server_fd);
+
+    int server_ret = 0;
+    std::thread server_thread([server_ssl, &server_ret]() { server_ret = SSL_accept(server_ssl); });
+    const int client_ret = SSL_connect(client_ssl);
+    server_thread.join();
+    UNIT_TEST_CHECK(1 == client_ret && 1 == server_ret);
+
+    /* records still queued in the kernel (tls 1.3 tickets) are not a leftover */
+    UNIT_TEST_CHECK(BoostNet::SslKernelTls::recv_drained(client_ssl, client_fd));
+    UNIT_TEST_CHECK(BoostNet::SslKernelTls::recv_drained(server_ssl, server_fd));
+
+    /* bytes taken off the socket but not given to openssl, as asio keeps them when its bio pair is full */
+    UNIT_TEST_CHECK(4 == SSL_write(client_ssl, "ping", 4));
+    struct pollfd poll_fd = { server_fd, POLLIN, 0 };
+    poll(&poll_fd, 1, 1000);
+    char buffer[3] = { 0x0 };
+    UNIT_TEST_CHECK(static_cast<ssize_t>(sizeof(buffer)) == ::recv(server_fd, buffer, sizeof(buffer), 0));
+    UNIT_TEST_CHECK(!BoostNet::SslKernelTls::recv_drained(server_ssl, server_fd));
+
+    SSL_free(client_ssl);
+    SSL_free(server_ssl);
+    SSL_CTX_free(client_context);
+    SSL_CTX_free(server_context);
+    close(client_fd);
+    close(server_fd);
+}
+
+static void test_tls12_recv_drained()
+{
+    test_recv_drained(TLS1_2_VERSION);
+}
+
+static void test_tls13_recv_drained()
+{
+    test_recv_drained(TLS1_3_VERSION);
+}
+
+static void test_tls12_client_offload()
+{
+    test_offload(TLS1_2_VERSION, false);
+}
+
+static void test_tls12_server_offload()
+{
+    test_offload(TLS1_2_VERSION, true);
+}
+
+static void test_tls13_client_offload()
+{
+    test_offload(TLS1_3_VERSION, false);
+}
+
+static void test_tls13_server_offload()
+{
+    test_offload(TLS1_3_VERSION, true);
+}
+
+int main(int, char *[])
+{
+    if (!BoostNet::SslKernelTls::supported())
+    {
+        printf("skip ssl_kernel_tls_test: no kernel tls support in this build\n");
+        return 0;
+    }
+
+    UNIT_TEST_RUN(test_tls12_recv_drained);
+    UNIT_TEST_RUN(test_tls13_recv_drained);
+
+    if (!tls_ulp_available())
+    {
+        printf("skip offload tests: kernel has no tls ulp\n");
+        return UNIT_TEST_RESULT();
+    }
+
+    UNIT_TEST_RUN(test_tls12_client_offload);
+    UNIT_TEST_RUN(test_tls12_server_offload);
+    UNIT_TEST_RUN(test_tls13_client_offload);
+    UNIT_TEST_RUN(test_tls13_server_offload);
+    return UNIT_TEST_RESULT();
+}
@@ -0,0 +1,108 @@
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <openssl/ssl.h>
+#include "ssl_session_cache.h"
+#include "unit_test.h"
+
+static SSL_SESSION * new_session(unsigned char id)
+{
+    unsigned char session_id[16] = { id };
+    SSL_SESSION * ssl_session = SSL_SESSION_new();
+    SSL_SESSION_set1_id(ssl_session, session_id, sizeof(session_id));
+    SSL_SESSION_set_time(ssl_session, static_cast<long>(time(nullptr)));
+    SSL_SESSION_set_timeout(ssl_session, 300);
+    return ssl_session;
+}
+
+static SSL_SESSION * offered_session(SSL_CTX * ssl_context, BoostNet::SslSessionCache & ssl_session_cache, const std::string & key)
+{
+    SSL * ssl = SSL_new(ssl_context);
+    ssl_session_cache.prepare(ssl, key);
+    SSL_SESSION * ssl_session = SSL_get_session(ssl);
+    SSL_free(ssl);
+    return ssl_session;
+}
+
+static void test_evicts_least_recently_used()
+{
+    SSL_CTX * ssl_context = SSL_CTX_new(TLS_client_method());
+    BoostNet::SslSessionCache ssl_session_cache;
+    ssl_session_cache.set_limit(2);
+    UNIT_TEST_CHECK(ssl_session_cache.attach(ssl_context));
+
+    SSL_SESSION * session_a = new_session('a');
+    SSL_SESSION * session_z = new_session('z');
+    SSL_SESSION * session_m = new_session('m');
+
+    UNIT_TEST_CHECK(ssl_session_cache.insert("a.example:443", session_a));
+    UNIT_TEST_CHECK(ssl_session_cache.insert("z.example:443", session_z));
+
+    /* a sorts first, offering it leaves z as the least recently used */
+    UNIT_TEST_CHECK(session_a == offered_session(ssl_context, ssl_session_cache, "a.example:443"));
+
+    UNIT_TEST_CHECK(ssl_session_cache.insert("m.example:443", session_m));
+    UNIT_TEST_CHECK(nullptr == offered_session(ssl_context, ssl_session_cache, "z.example:443"));
+    UNIT_TEST_CHECK(session_m == offered_session(ssl_context, ssl_session_cache, "m.example:443"));
+    UNIT_TEST_CHECK(session_a == offered_session(ssl_context, ssl_session_cache, "a.example:443"));
+
+    /* a was offered last, shrinking the cache keeps it */
+    ssl_session_cache.set_limit(1);
+    UNIT_TEST_CHECK(nullptr == offered_session(ssl_context, ssl_session_cache, "m.example:443"));
+    UNIT_TEST_CHECK(session_a == offered_session(ssl_context, ssl_session_cache, "a.example:443"));
+
+    ssl_session_cache.detach();
+    SSL_CTX_free(ssl_context);
+}
+
+static void test_replaces_session_of_same_destination()
+{
+    SSL_CTX * ssl_context = SSL_CTX_new(TLS_client_method());
+    BoostNet::SslSessionCache ssl_session_cache;
+    ssl_session_cache.set_limit(2);
+    UNIT_TEST_CHECK(ssl_session_cache.attach(ssl_context));
+
+    SSL_SESSION * session_old = new_session('o');
+    SSL_SESSION * session_new = new_session('n');
+    SSL_SESSION * session_other = new_session('x');
+
+    UNIT_TEST_CHECK(ssl_session_cache.insert("host:443", session_old));
+    UNIT_TEST_CHECK(ssl_session_cache.insert("other:443", session_other));
+    UNIT_TEST_CHECK(ssl_session_cache.insert("host:443", session_new));
+    UNIT_TEST_CHECK(session_new == offered_session(ssl_context, ssl_session_cache, "host:443"));
+    UNIT_TEST_CHECK(session_other == offered_session(ssl_context, ssl_session_cache, "other:443"));
+
+    ssl_session_cache.remove("host:443");
+    UNIT_TEST_CHECK(nullptr == offered_session(ssl_context, ssl_session_cache, "host:443"));
+
+    ssl_session_cache.detach();
+    SSL_CTX_free(ssl_context);
+}
+
+static void test_detach_every_context()
+{
+    SSL_CTX * ssl_context_old = SSL_CTX_new(TLS_client_method());
+    SSL_CTX * ssl_context_new = SSL_CTX_new(TLS_client_method());
+
+    {
+        BoostNet::SslSessionCache ssl_session_cache;
+        UNIT_TEST_CHECK(ssl_session_cache.attach(ssl_context_old));
+        UNIT_TEST_CHECK(ssl_session_cache.attach(ssl_context_new));
+        UNIT_TEST_CHECK(nullptr != SSL_CTX_sess_get_new_cb(ssl_context_old));
+        UNIT_TEST_CHECK(nullptr != SSL_CTX_sess_get_new_cb(ssl_context_new));
+    }
+
+    UNIT_TEST_CHECK(nullptr == SSL_CTX_sess_get_new_cb(ssl_context_old));
+    UNIT_TEST_CHECK(nullptr == SSL_CTX_sess_get_new_cb(ssl_context_new));
+
+    SSL_CTX_free(ssl_context_old);
+    SSL_CTX_free(ssl_context_new);
+}
+
+int main(int, char *[])
+{
+    UNIT_TEST_RUN(test_evicts_least_recently_used);
+    UNIT_TEST_RUN(test_replaces_session_of_same_destination);
+    UNIT_TEST_RUN(test_detach_every_context);
+    return UNIT_TEST_RESULT();
+}
@@ -0,0 +1,178 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <future>
+#include <chrono>
+#include <boost/asio.hpp>
+#include "ssl_ticket_key_ring.h"
+#include "unit_test.h"
+
+typedef BoostNet::SslTicketKeyRing::ticket_keys_type ticket_keys_type;
+
+static std::vector<unsigned char> make_keys(std::size_t key_count, std::size_t key_size)
+{
+    std::vector<unsigned char> keys(key_count * key_size);
+    for (std::size_t index = 0; index < keys.size(); ++index)
+    {
+        keys[index] = static_cast<unsigned char>(index / key_size * 16 + (index % key_size < 16 ? 1 : (index % key_size < 16 + (key_size - 16) / 2 ? 2 : 3)));
+    }
+    return keys;
+}
+
+static bool check_key(const BoostNet::SslTicketKeyRing::ticket_key_type & ticket_key, std::size_t key_index, std::size_t key_size)
+{
+    const std::size_t secret_size = (key_size - 16) / 2;
+    const unsigned char base = static_cast<unsigned char>(key_index * 16);
+    if (secret_size != ticket_key.size)
+    {
+        return false;
+    }
+    for (std::size_t index = 0; index < sizeof(ticket_key.name); ++index)
+    {
+        if (base + 1 != ticket_key.name[index])
+        {
+            return false;
+        }
+    }
+    for (std::size_t index = 0; index < secret_size; ++index)
+    {
+        if (base + 2 != ticket_key.hmac_key[index] || base + 3 != ticket_key.aes_key[index])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_parse_single_key()
+{
+    ticket_keys_type ticket_keys;
+
+    std::vector<unsigned char> keys_48 = make_keys(1, 48);
+    UNIT_TEST_CHECK(BoostNet::SslTicketKeyRing::parse_keys(&keys_48[0], keys_48.size(), 0, ticket_keys));
+    UNIT_TEST_CHECK(1 == ticket_keys.size() && check_key(ticket_keys[0], 0, 48));
+
+    std::vector<unsigned char> keys_80 = make_keys(1, 80);
+    UNIT_TEST_CHECK(BoostNet::SslTicketKeyRing::parse_keys(&keys_80[0], keys_80.size(), 0, ticket_keys));
+    UNIT_TEST_CHECK(1 == ticket_keys.size() && check_key(ticket_keys[0], 0, 80));
+}
+
+static void test_parse_concatenated_keys()
+{
+    ticket_keys_type ticket_keys;
+
+    std::vector<unsigned char> keys_48 = make_keys(3, 48);
+    UNIT_TEST_CHECK(BoostNet::SslTicketKeyRing::parse_keys(&keys_48[0], keys_48.size(), 0, ticket_keys));
+    UNIT_TEST_CHECK(3 == ticket_keys.size() && check_key(ticket_keys[0], 0, 48) && check_key(ticket_keys[2], 2, 48));
+
+    std::vector<unsigned char> keys_80 = make_keys(2, 80);
+    UNIT_TEST_CHECK(BoostNet::SslTicketKeyRing::parse_keys(&keys_80[0], keys_80.size(), 80, ticket_keys));
+    UNIT_TEST_CHECK(2 == ticket_keys.size() && check_key(ticket_keys[1], 1, 80));
+}
+
+static void test_reject_ambiguous_length()
+{
+    ticket_keys_type ticket_keys;
+
+    /* five 48 bytes keys and three 80 bytes keys are both 240 bytes */
+    std::vector<unsigned char> keys_48 = make_keys(5, 48);
+    UNIT_TEST_CHECK(!BoostNet::SslTicketKeyRing::parse_keys(&keys_48[0], keys_48.size(), 0, ticket_keys));
+
+    UNIT_TEST_CHECK(BoostNet::SslTicketKeyRing::parse_keys(&keys_48[0], keys_48.size(), 48, ticket_keys));
+    UNIT_TEST_CHECK(5 == ticket_keys.size() && check_key(ticket_keys[0], 0, 48) && check_key(ticket_keys[4], 4, 48));
+
+    std::vector<unsigned char> keys_80 = make_keys(3, 80);
+    UNIT_TEST_CHECK(!BoostNet::SslTicketKeyRing::parse_keys(&keys_80[0], keys_80.size(), 0, ticket_keys));
+    UNIT_TEST_CHECK(BoostNet::SslTicketKeyRing::parse_keys(&keys_80[0], keys_80.size(), 80, ticket_keys));
+    UNIT_TEST_CHECK(3 == ticket_keys.size() && check_key(ticket_keys[2], 2, 80));
+}
+
+static void test_reject_bad_length()
+{
+    ticket_keys_type ticket_keys;
+    std::vector<unsigned char> keys = make_keys(2, 48);
+
+    UNIT_TEST_CHECK(!BoostNet::SslTicketKeyRing::parse_keys(&keys[0], 0, 0, ticket_keys));
+    UNIT_TEST_CHECK(!BoostNet::SslTicketKeyRing::parse_keys(&keys[0], 47, 0, ticket_keys));
+    UNIT_TEST_CHECK(!BoostNet::SslTicketKeyRing::parse_keys(&keys[0], keys.size() - 1, 0, ticket_keys));
+    UNIT_TEST_CHECK(!BoostNet::SslTicketKeyRing::parse_keys(&keys[0], keys.size(), 80, ticket_keys));
+    UNIT_TEST_CHECK(!BoostNet::SslTicketKeyRing::parse_keys(&keys[0], keys.size(), 32, ticket_keys));
+}
+
+static void test_load_buffer()
+{
+    BoostNet::SslTicketKeyRing ticket_key_ring;
+    std::vector<unsigned char> keys = make_keys(5, 48);
+
+    UNIT_TEST_CHECK(!ticket_key_ring.load(false, reinterpret_cast<const char *>(&keys[0]), keys.size(), 0));
+    UNIT_TEST_CHECK(ticket_key_ring.load(false, reinterpret_cast<const char *>(&keys[0]), keys.size(), 48));
+    UNIT_TEST_CHECK(!ticket_key_ring.load(false, reinterpret_cast<const char *>(&keys[0]), keys.size() - 48, 80));
+    UNIT_TEST_CHECK(ticket_key_ring.load(false, nullptr, 0, 0));
+}
+
+static void test_load_file()
+{
+    BoostNet::SslTicketKeyRing ticket_key_ring;
+    std::vector<unsigned char> keys = make_keys(5, 48);
+    const char * keys_file = "ssl_ticket_key_ring_test.keys";
+
+    FILE * file = fopen(keys_file, "wb");
+    UNIT_TEST_CHECK(nullptr != file);
+    if (nullptr == file)
+    {
+        return;
+    }
+    fwrite(&keys[0], 1, keys.size(), file);
+    fclose(file);
+
+    UNIT_TEST_CHECK(!ticket_key_ring.load(true, keys_file, 0, 0));
+    UNIT_TEST_CHECK(ticket_key_ring.load(true, keys_file, 0, 48));
+    UNIT_TEST_CHECK(!ticket_key_ring.load(true, "ssl_ticket_key_ring_test.missing", 0, 48));
+
+    remove(keys_file);
+}
+
+static void test_restart_rotation()
+{
+    boost::asio::io_context io_context;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_guard(io_context.get_executor());
+    std::thread io_thread([&io_context]() { io_context.run(); });
+
+    {
+        BoostNet::SslTicketKeyRing ticket_key_ring;
+        UNIT_TEST_CHECK(ticket_key_ring.load(false, nullptr, 0, 0));
+
+        /* restarts come from a foreign thread while the io thread owns the timer */
+        for (std::size_t index = 0; index < 1000; ++index)
+        {
+            UNIT_TEST_CHECK(ticket_key_ring.start(io_context, 1 + index % 2));
+            if (0 == index % 3)
+            {
+                ticket_key_ring.stop();
+            }
+        }
+        ticket_key_ring.stop();
+
+        /* let the posted restarts drain before the ring goes away */
+        std::promise<void> drained;
+        boost::asio::post(io_context, [&drained]() { drained.set_value(); });
+        drained.get_future().wait();
+    }
+
+    work_guard.reset();
+    io_context.stop();
+    io_thread.join();
+}
+
+int main(int, char *[])
+{
+    UNIT_TEST_RUN(test_parse_single_key);
+    UNIT_TEST_RUN(test_parse_concatenated_keys);
+    UNIT_TEST_RUN(test_reject_ambiguous_length);
+    UNIT_TEST_RUN(test_reject_bad_length);
+    UNIT_TEST_RUN(test_load_buffer);
+    UNIT_TEST_RUN(test_load_file);
+    UNIT_TEST_RUN(test_restart_rotation);
+    return UNIT_TEST_RESULT();
+}
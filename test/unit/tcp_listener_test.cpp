@@ -0,0 +1,261 @@
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <openssl/ssl.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+#include "boost_net.h"
+#include "tcp_listener.h"
+#include "unit_test.h"
+
+static bool make_certificate(std::string & cert_pem, std::string & key_pem)
+{
+    EVP_PKEY * key = EVP_EC_gen("P-256");
+    X509 * certificate = X509_new();
+    ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+    X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+    X509_gmtime_adj(X509_getm_notAfter(certificate), 3600);
+    X509_set_pubkey(certificate, key);
+    X509_NAME_add_entry_by_txt(X509_get_subject_name(certificate), "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char *>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(certificate, X509_get_subject_name(certificate));
+    X509_sign(certificate, key, EVP_sha256());
+
+    BIO * cert_bio = BIO_new(BIO_s_mem());
+    BIO * key_bio = BIO_new(BIO_s_mem());
+    PEM_write_bio_X509(cert_bio, certificate);
+    PEM_write_bio_PrivateKey(key_bio, key, nullptr, nullptr, 0, nullptr, nullptr);
+
+    char * data = nullptr;
+    long size = BIO_get_mem_data(cert_bio, &data);
+    cert_pem.assign(data, static_cast<std::size_t>(size));
+    size = BIO_get_mem_data(key_bio, &data);
+    key_pem.assign(data, static_cast<std::size_t>(size));
+
+    BIO_free(cert_bio);
+    BIO_free(key_bio);
+    X509_free(certificate);
+    EVP_PKEY_free(key);
+
+    return !cert_pem.empty() && !key_pem.empty();
+}
+
+static std::vector<unsigned char> make_keys()
+{
+    std::vector<unsigned char> keys(80);
+    for (std::size_t index = 0; index < keys.size(); ++index)
+    {
+        keys[index] = static_cast<unsigned char>(index);
+    }
+    return keys;
+}
+
+static void test_session_cache()
+{
+    std::string cert_pem;
+    std::string key_pem;
+    UNIT_TEST_CHECK(make_certificate(cert_pem, key_pem));
+
+    const BoostNet::Certificate certificate = { false, cert_pem.c_str(), key_pem.c_str(), nullptr, nullptr };
+    const BoostNet::Listener listener = { "127.0.0.1", 0, &certificate, nullptr, nullptr, nullptr, 0 };
+    BoostNet::TcpListener tcp_listener;
+    UNIT_TEST_CHECK(tcp_listener.init(listener));
+
+    SSL_CTX * ssl_context = tcp_listener.ssl_context()->native_handle();
+    UNIT_TEST_CHECK(tcp_listener.set_session_cache(0, 60));
+    UNIT_TEST_CHECK(SSL_SESS_CACHE_OFF == SSL_CTX_get_session_cache_mode(ssl_context));
+    UNIT_TEST_CHECK(60 == SSL_CTX_get_timeout(ssl_context));
+
+    UNIT_TEST_CHECK(tcp_listener.set_session_cache(1024, 300));
+    UNIT_TEST_CHECK(SSL_SESS_CACHE_SERVER == SSL_CTX_get_session_cache_mode(ssl_context));
+    UNIT_TEST_CHECK(1024 == SSL_CTX_sess_get_cache_size(ssl_context));
+    UNIT_TEST_CHECK(300 == SSL_CTX_get_timeout(ssl_context));
+}
+
+static void test_ticket_key_ring()
+{
+    std::string cert_pem;
+    std::string key_pem;
+    UNIT_TEST_CHECK(make_certificate(cert_pem, key_pem));
+
+    const BoostNet::Certificate certificate = { false, cert_pem.c_str(), key_pem.c_str(), nullptr, nullptr };
+    const BoostNet::Listener listener = { "127.0.0.1", 0, &certificate, nullptr, nullptr, nullptr, 0 };
+    BoostNet::TcpListener tcp_listener;
+    UNIT_TEST_CHECK(tcp_listener.init(listener));
+
+    std::vector<unsigned char> keys = make_keys();
+    BoostNet::SslTicketKeyRing ticket_key_ring;
+    UNIT_TEST_CHECK(ticket_key_ring.load(false, reinterpret_cast<const char *>(&keys[0]), keys.size(), 0));
+    UNIT_TEST_CHECK(tcp_listener.set_ticket_key_ring(ticket_key_ring));
+    UNIT_TEST_CHECK(ticket_key_ring.attached());
+
+    /* attaching the same context again is a no-op */
+    UNIT_TEST_CHECK(tcp_listener.set_ticket_key_ring(ticket_key_ring));
+    ticket_key_ring.detach();
+    UNIT_TEST_CHECK(!ticket_key_ring.attached());
+}
+
+static void test_plain_listener()
+{
+    const BoostNet::Listener listener = { "127.0.0.1", 0, nullptr, nullptr, nullptr, nullptr, 0 };
+    BoostNet::TcpListener tcp_listener;
+    UNIT_TEST_CHECK(tcp_listener.init(listener));
+    UNIT_TEST_CHECK(!tcp_listener.ssl_enable());
+
+    BoostNet::SslTicketKeyRing ticket_key_ring;
+    UNIT_TEST_CHECK(tcp_listener.set_session_cache(0, 60));
+    UNIT_TEST_CHECK(tcp_listener.set_ticket_key_ring(ticket_key_ring));
+    UNIT_TEST_CHECK(!ticket_key_ring.attached());
+}
+
+static void test_reload_default_context()
+{
+    std::string cert_pem;
+    std::string key_pem;
+    UNIT_TEST_CHECK(make_certificate(cert_pem, key_pem));
+
+    const BoostNet::Certificate certificate = { false, cert_pem.c_str(), key_pem.c_str(), nullptr, nullptr };
+    const BoostNet::SniCertificate sni_certificate = { "www.example.com", &certificate };
+    const BoostNet::Listener listener = { "127.0.0.1", 0, &certificate, nullptr, nullptr, &sni_certificate, 1 };
+    BoostNet::TcpListener tcp_listener;
+    UNIT_TEST_CHECK(tcp_listener.init(listener));
+
+    BoostNet::TcpListener::ssl_context_ptr old_context = tcp_listener.ssl_context();
+    BoostNet::TcpListener::ssl_context_ptr new_context = tcp_listener.create_default_context(&certificate);
+    UNIT_TEST_CHECK(nullptr != new_context);
+    UNIT_TEST_CHECK(old_context == tcp_listener.ssl_context());
+
+    tcp_listener.set_default_context(new_context);
+    UNIT_TEST_CHECK(new_context == tcp_listener.ssl_context());
+
+    const BoostNet::Listener plain_listener = { "127.0.0.1", 0, nullptr, nullptr, nullptr, nullptr, 0 };
+    BoostNet::TcpListener tcp_plain_listener;
+    UNIT_TEST_CHECK(tcp_plain_listener.init(plain_listener));
+    UNIT_TEST_CHECK(nullptr == tcp_plain_listener.create_default_context(&certificate));
+}
+
+class HandshakeService : public BoostNet::TcpServiceBase
+{
+public:
+    HandshakeService()
+        : m_connect_count(0)
+    {
+
+    }
+
+public:
+    virtual bool on_connect(BoostNet::TcpConnectionSharedPtr connection, const void *) override
+    {
+        if (nullptr != connection)
+        {
+            ++m_connect_count;
+            connection->close();
+        }
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::TcpConnectionSharedPtr, unsigned short) override
+    {
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::TcpConnectionSharedPtr connection) override
+    {
+        connection->recv_buffer_drop(connection->recv_buffer_size());
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::TcpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::TcpConnectionSharedPtr) override
+    {
+
+    }
+
+    virtual void on_error(BoostNet::TcpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+
+    }
+
+public:
+    std::size_t connect_count() const
+    {
+        return m_connect_count;
+    }
+
+private:
+    std::atomic<std::size_t>                        m_connect_count;
+};
+
+static bool wait_for(const std::function<bool()> & condition)
+{
+    for (std::size_t count = 0; count < 200; ++count)
+    {
+        if (condition())
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return condition();
+}
+
+/* the client trusts only the current certificate, so a pending accept still holding the old one fails the handshake */
+static void test_reload_next_handshake()
+{
+    std::string old_cert_pem;
+    std::string old_key_pem;
+    std::string new_cert_pem;
+    std::string new_key_pem;
+    UNIT_TEST_CHECK(make_certificate(old_cert_pem, old_key_pem));
+    UNIT_TEST_CHECK(make_certificate(new_cert_pem, new_key_pem));
+
+    const BoostNet::Certificate old_server_certificate = { false, old_cert_pem.c_str(), old_key_pem.c_str(), nullptr, nullptr };
+    const BoostNet::Certificate old_client_certificate = { false, old_cert_pem.c_str(), nullptr, nullptr, nullptr };
+    const BoostNet::Certificate new_server_certificate = { false, new_cert_pem.c_str(), new_key_pem.c_str(), nullptr, nullptr };
+    const BoostNet::Certificate new_client_certificate = { false, new_cert_pem.c_str(), nullptr, nullptr, nullptr };
+
+    unsigned short port = 24550;
+    const unsigned short listener_port = 24551;
+    const BoostNet::Listener listener = { "127.0.0.1", listener_port, &old_server_certificate, nullptr, nullptr, nullptr, 0 };
+
+    HandshakeService server_service;
+    HandshakeService client_service;
+    BoostNet::TcpManager server_manager;
+    BoostNet::TcpManager client_manager;
+    UNIT_TEST_CHECK(server_manager.init(&server_service, 1, "127.0.0.1", &port, 1, false, &old_server_certificate, nullptr));
+    UNIT_TEST_CHECK(server_manager.add_listener(listener));
+    UNIT_TEST_CHECK(client_manager.init(&client_service, 1, nullptr, nullptr, 0, false, nullptr, &old_client_certificate));
+
+    UNIT_TEST_CHECK(client_manager.create_connection("127.0.0.1", port, true));
+    UNIT_TEST_CHECK(client_manager.create_connection("127.0.0.1", listener_port, true));
+    UNIT_TEST_CHECK(wait_for([&client_service]() { return 2 == client_service.connect_count(); }));
+
+    UNIT_TEST_CHECK(server_manager.reload_server_certificate(&new_server_certificate));
+    UNIT_TEST_CHECK(server_manager.reload_listener_certificate(listener_port, &new_server_certificate));
+    UNIT_TEST_CHECK(!server_manager.reload_listener_certificate(port, &new_server_certificate));
+    UNIT_TEST_CHECK(client_manager.reload_client_certificate(&new_client_certificate));
+
+    UNIT_TEST_CHECK(client_manager.create_connection("127.0.0.1", port, true));
+    UNIT_TEST_CHECK(client_manager.create_connection("127.0.0.1", listener_port, true));
+    UNIT_TEST_CHECK(wait_for([&client_service]() { return 4 == client_service.connect_count(); }));
+
+    client_manager.exit();
+    server_manager.exit();
+}
+
+int main(int, char *[])
+{
+    UNIT_TEST_RUN(test_session_cache);
+    UNIT_TEST_RUN(test_ticket_key_ring);
+    UNIT_TEST_RUN(test_plain_listener);
+    UNIT_TEST_RUN(test_reload_default_context);
+    UNIT_TEST_RUN(test_reload_next_handshake);
+    return UNIT_TEST_RESULT();
+}
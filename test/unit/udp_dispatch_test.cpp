@@ -0,0 +1,261 @@
+#include <cstring>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <future>
+#include <vector>
+#include <functional>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <boost/asio.hpp>
+#include "udp_acceptor.h"
+#include "unit_test.h"
+
+class DispatchService : public BoostNet::UdpServiceBase
+{
+public:
+    DispatchService()
+        : m_mutex()
+        , m_connections()
+        , m_recv_count(0)
+    {
+
+    }
+
+public:
+    virtual bool on_connect(BoostNet::UdpConnectionSharedPtr, const void *) override
+    {
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::UdpConnectionSharedPtr connection, unsigned short) override
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connections.push_back(connection);
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::UdpConnectionSharedPtr connection) override
+    {
+        while (connection->recv_buffer_has_data())
+        {
+            connection->recv_buffer_drop();
+            ++m_recv_count;
+        }
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::UdpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::UdpConnectionSharedPtr) override
+    {
+
+    }
+
+    virtual void on_error(BoostNet::UdpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+
+    }
+
+public:
+    std::size_t accept_count()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_connections.size();
+    }
+
+    std::size_t recv_count() const
+    {
+        return m_recv_count;
+    }
+
+    std::size_t recv_dropped_count()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        std::size_t dropped_count = 0;
+        for (std::vector<BoostNet::UdpConnectionSharedPtr>::iterator iter = m_connections.begin(); m_connections.end() != iter; ++iter)
+        {
+            BoostNet::UdpSendStatistics statistics;
+            (*iter)->get_send_statistics(statistics);
+            dropped_count += statistics.recv_dropped_count;
+        }
+        return dropped_count;
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connections.clear();
+    }
+
+private:
+    std::mutex                                      m_mutex;
+    std::vector<BoostNet::UdpConnectionSharedPtr>   m_connections;
+    std::atomic<std::size_t>                        m_recv_count;
+};
+
+static bool wait_for(const std::function<bool()> & condition)
+{
+    for (std::size_t count = 0; count < 500; ++count)
+    {
+        if (condition())
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return condition();
+}
+
+/* sockets on 127.0.0.1 whose endpoint hashes to the second of two dispatch workers */
+static std::vector<int> make_worker_sockets(std::size_t count)
+{
+    std::vector<int> sockets;
+    while (sockets.size() < count)
+    {
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        struct sockaddr_in address;
+        memset(&address, 0x0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t address_size = sizeof(address);
+        if (fd < 0 || 0 != bind(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) || 0 != getsockname(fd, reinterpret_cast<struct sockaddr *>(&address), &address_size))
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+            break;
+        }
+
+        const BoostNet::UdpPeerTable::endpoint_type endpoint(boost::asio::ip::address_v4::loopback(), ntohs(address.sin_port));
+        if (1 == BoostNet::UdpPeerTable::hash_endpoint(endpoint) % 2)
+        {
+            sockets.push_back(fd);
+        }
+        else
+        {
+            close(fd);
+        }
+    }
+    return sockets;
+}
+
+static void send_datagram(int fd, unsigned short port)
+{
+    struct sockaddr_in address;
+    memset(&address, 0x0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    sendto(fd, "datagram", 8, 0, reinterpret_cast<struct sockaddr *>(&address), sizeof(address));
+}
+
+/*
+ * the worker thread is held while one peer floods it and then 600 new peers arrive:
+ * datagrams beyond the ring reserve are dropped and counted, starts wait in the backlog and the acceptor thread keeps running
+ */
+static void test_busy_worker()
+{
+    const unsigned short port = 24560;
+    const std::size_t flood_count = 4000;
+    const std::size_t new_peer_count = 600;
+
+    boost::asio::io_context acceptor_context;
+    boost::asio::io_context worker_context;
+    auto acceptor_guard = boost::asio::make_work_guard(acceptor_context);
+    auto worker_guard = boost::asio::make_work_guard(worker_context);
+    std::thread acceptor_thread([&acceptor_context]() { acceptor_context.run(); });
+    std::thread worker_thread([&worker_context]() { worker_context.run(); });
+
+    DispatchService dispatch_service;
+    std::shared_ptr<BoostNet::UdpAcceptor> udp_acceptor = std::make_shared<BoostNet::UdpAcceptor>(acceptor_context, &dispatch_service, "127.0.0.1", port, 1500);
+    std::vector<BoostNet::UdpAcceptor::io_context_type *> io_contexts;
+    io_contexts.push_back(&acceptor_context);
+    io_contexts.push_back(&worker_context);
+    udp_acceptor->set_peer_dispatch(io_contexts, true);
+    UNIT_TEST_CHECK(udp_acceptor->start());
+
+    std::vector<int> sockets = make_worker_sockets(1 + new_peer_count);
+    UNIT_TEST_CHECK(1 + new_peer_count == sockets.size());
+
+    std::promise<void> worker_gate;
+    std::shared_future<void> worker_wait(worker_gate.get_future());
+    boost::asio::post(worker_context, [worker_wait]() { worker_wait.wait(); });
+
+    for (std::size_t index = 0; index < flood_count; ++index)
+    {
+        send_datagram(sockets[0], port);
+        if (0 == index % 50)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    for (std::size_t index = 1; index < sockets.size(); ++index)
+    {
+        send_datagram(sockets[index], port);
+        if (0 == index % 50)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    /* the acceptor thread must not wait for the worker */
+    std::promise<void> acceptor_ping;
+    std::future<void> acceptor_pong(acceptor_ping.get_future());
+    boost::asio::post(acceptor_context, [&acceptor_ping]() { acceptor_ping.set_value(); });
+    UNIT_TEST_CHECK(std::future_status::ready == acceptor_pong.wait_for(std::chrono::seconds(2)));
+    UNIT_TEST_CHECK(0 == dispatch_service.accept_count());
+
+    worker_gate.set_value();
+
+    /* a slow acceptor thread may overflow the socket buffer, peers whose first datagram the kernel dropped say hello again */
+    std::size_t send_count = flood_count + new_peer_count;
+    UNIT_TEST_CHECK(wait_for([&dispatch_service, &sockets, &send_count, port]() {
+        if (sockets.size() == dispatch_service.accept_count())
+        {
+            return true;
+        }
+        for (std::size_t index = 1; index < sockets.size(); ++index)
+        {
+            send_datagram(sockets[index], port);
+            ++send_count;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return false;
+    }));
+    UNIT_TEST_CHECK(wait_for([&dispatch_service]() { return dispatch_service.recv_count() + dispatch_service.recv_dropped_count() >= 3584; }));
+    UNIT_TEST_CHECK(dispatch_service.recv_dropped_count() > 0);
+    UNIT_TEST_CHECK(dispatch_service.recv_count() + dispatch_service.recv_dropped_count() <= send_count);
+
+    for (std::vector<int>::iterator iter = sockets.begin(); sockets.end() != iter; ++iter)
+    {
+        close(*iter);
+    }
+
+    std::promise<void> stopped;
+    std::future<void> stopped_wait(stopped.get_future());
+    boost::asio::post(acceptor_context, [udp_acceptor]() { udp_acceptor->stop(); });
+    boost::asio::post(acceptor_context, [&stopped]() { stopped.set_value(); });
+    stopped_wait.wait();
+    dispatch_service.release();
+
+    acceptor_guard.reset();
+    worker_guard.reset();
+    acceptor_context.stop();
+    worker_context.stop();
+    acceptor_thread.join();
+    worker_thread.join();
+}
+
+int main(int, char *[])
+{
+    UNIT_TEST_RUN(test_busy_worker);
+    return UNIT_TEST_RESULT();
+}
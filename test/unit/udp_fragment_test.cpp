@@ -0,0 +1,403 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include "boost_net.h"
+#include "udp_fragment.h"
+#include "unit_test.h"
+
+typedef std::vector<std::string> fragments_type;
+
+static BoostNet::UdpFragmentOptions make_options(std::size_t mtu, std::size_t slot_count, std::size_t timeout_milliseconds)
+{
+    BoostNet::UdpFragmentOptions options;
+    options.mtu = mtu;
+    options.max_message_size = 64 * 1024;
+    options.slot_count = slot_count;
+    options.timeout_milliseconds = timeout_milliseconds;
+    return options;
+}
+
+static std::string make_message(std::size_t size, char seed)
+{
+    std::string message(size, '\0');
+    for (std::size_t index = 0; index < size; ++index)
+    {
+        message[index] = static_cast<char>(seed + index % 251);
+    }
+    return message;
+}
+
+static fragments_type split_message(const BoostNet::UdpFragmentOptions & options, uint32_t message_id, const std::string & message)
+{
+    std::vector<char> fragment;
+    std::vector<std::size_t> fragment_ends;
+    BoostNet::UdpReassembler::split(options, message_id, message.data(), message.size(), fragment, fragment_ends);
+
+    fragments_type fragments;
+    std::size_t fragment_begin = 0;
+    for (std::vector<std::size_t>::const_iterator iter = fragment_ends.begin(); fragment_ends.end() != iter; ++iter)
+    {
+        fragments.push_back(std::string(fragment.data() + fragment_begin, *iter - fragment_begin));
+        fragment_begin = *iter;
+    }
+    return fragments;
+}
+
+/* feeds the fragments in the given order, returns the message completed by the last one or nothing */
+static std::string feed(BoostNet::UdpReassembler & reassembler, const fragments_type & fragments, const std::vector<std::size_t> & order)
+{
+    std::string result;
+    for (std::vector<std::size_t>::const_iterator iter = order.begin(); order.end() != iter; ++iter)
+    {
+        const char * message = nullptr;
+        std::size_t message_len = 0;
+        if (reassembler.input(fragments[*iter].data(), fragments[*iter].size(), message, message_len))
+        {
+            result.assign(message, message_len);
+        }
+    }
+    return result;
+}
+
+static std::vector<std::size_t> make_order(std::size_t begin, std::size_t end, bool reverse)
+{
+    std::vector<std::size_t> order;
+    for (std::size_t index = begin; index < end; ++index)
+    {
+        order.push_back(reverse ? end - 1 - (index - begin) : index);
+    }
+    return order;
+}
+
+static void test_check_options()
+{
+    UNIT_TEST_CHECK(BoostNet::UdpReassembler::check_options(make_options(1472, 4, 5000)));
+    UNIT_TEST_CHECK(!BoostNet::UdpReassembler::check_options(make_options(16, 4, 5000)));
+    UNIT_TEST_CHECK(!BoostNet::UdpReassembler::check_options(make_options(65508, 4, 5000)));
+    UNIT_TEST_CHECK(!BoostNet::UdpReassembler::check_options(make_options(1472, 0, 5000)));
+
+    /* more than 65535 fragments cannot be numbered */
+    BoostNet::UdpFragmentOptions options = make_options(17, 4, 5000);
+    options.max_message_size = 0x10000;
+    UNIT_TEST_CHECK(!BoostNet::UdpReassembler::check_options(options));
+}
+
+static void test_single_fragment()
+{
+    const BoostNet::UdpFragmentOptions options = make_options(100, 2, 5000);
+    BoostNet::UdpReassembler reassembler;
+    UNIT_TEST_CHECK(reassembler.init(options));
+
+    const std::string message = make_message(84, 'a');
+    const fragments_type fragments = split_message(options, 1, message);
+    UNIT_TEST_CHECK(1 == fragments.size() && 100 == fragments[0].size());
+
+    /* a message fitting one datagram is handed back from the datagram itself */
+    const char * data = nullptr;
+    std::size_t data_len = 0;
+    UNIT_TEST_CHECK(reassembler.input(fragments[0].data(), fragments[0].size(), data, data_len));
+    UNIT_TEST_CHECK(fragments[0].data() + 16 == data && message == std::string(data, data_len));
+
+    const fragments_type empty_fragments = split_message(options, 2, std::string());
+    UNIT_TEST_CHECK(1 == empty_fragments.size() && 16 == empty_fragments[0].size());
+    UNIT_TEST_CHECK(reassembler.input(empty_fragments[0].data(), empty_fragments[0].size(), data, data_len) && 0 == data_len);
+}
+
+static void test_reassemble_any_order()
+{
+    const BoostNet::UdpFragmentOptions options = make_options(100, 2, 5000);
+    BoostNet::UdpReassembler reassembler;
+    UNIT_TEST_CHECK(reassembler.init(options));
+
+    const std::string message = make_message(1000, 'b');
+    const fragments_type fragments = split_message(options, 7, message);
+    UNIT_TEST_CHECK(12 == fragments.size());
+
+    UNIT_TEST_CHECK(message == feed(reassembler, fragments, make_order(0, fragments.size(), false)));
+    UNIT_TEST_CHECK(message == feed(reassembler, fragments, make_order(0, fragments.size(), true)));
+
+    /* a duplicate fragment neither completes the message early nor corrupts it */
+    std::vector<std::size_t> order = make_order(0, fragments.size() - 1, false);
+    order.push_back(3);
+    UNIT_TEST_CHECK(feed(reassembler, fragments, order).empty());
+    UNIT_TEST_CHECK(message == feed(reassembler, fragments, std::vector<std::size_t>(1, fragments.size() - 1)));
+}
+
+static void test_interleaved_messages()
+{
+    const BoostNet::UdpFragmentOptions options = make_options(100, 2, 5000);
+    BoostNet::UdpReassembler reassembler;
+    UNIT_TEST_CHECK(reassembler.init(options));
+
+    const std::string message_a = make_message(500, 'c');
+    const std::string message_b = make_message(300, 'd');
+    const fragments_type fragments_a = split_message(options, 1, message_a);
+    const fragments_type fragments_b = split_message(options, 2, message_b);
+
+    UNIT_TEST_CHECK(feed(reassembler, fragments_a, make_order(0, 3, false)).empty());
+    UNIT_TEST_CHECK(feed(reassembler, fragments_b, make_order(0, 2, false)).empty());
+    UNIT_TEST_CHECK(message_a == feed(reassembler, fragments_a, make_order(3, fragments_a.size(), false)));
+    UNIT_TEST_CHECK(message_b == feed(reassembler, fragments_b, make_order(2, fragments_b.size(), false)));
+}
+
+static void test_oldest_slot_is_dropped()
+{
+    const BoostNet::UdpFragmentOptions options = make_options(100, 2, 5000);
+    BoostNet::UdpReassembler reassembler;
+    UNIT_TEST_CHECK(reassembler.init(options));
+
+    const fragments_type fragments_a = split_message(options, 1, make_message(300, 'e'));
+    const std::string message_b = make_message(300, 'f');
+    const fragments_type fragments_b = split_message(options, 2, message_b);
+    const std::string message_c = make_message(300, 'g');
+    const fragments_type fragments_c = split_message(options, 3, message_c);
+
+    UNIT_TEST_CHECK(feed(reassembler, fragments_a, make_order(0, 3, false)).empty());
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    UNIT_TEST_CHECK(feed(reassembler, fragments_b, make_order(0, 3, false)).empty());
+
+    /* both slots are busy, the third message takes the slot of the first one */
+    UNIT_TEST_CHECK(message_c == feed(reassembler, fragments_c, make_order(0, fragments_c.size(), false)));
+    UNIT_TEST_CHECK(feed(reassembler, fragments_a, make_order(3, fragments_a.size(), false)).empty());
+    UNIT_TEST_CHECK(message_b == feed(reassembler, fragments_b, make_order(3, fragments_b.size(), false)));
+}
+
+static void test_timeout()
+{
+    const BoostNet::UdpFragmentOptions options = make_options(100, 1, 50);
+    BoostNet::UdpReassembler reassembler;
+    UNIT_TEST_CHECK(reassembler.init(options));
+
+    const std::string message = make_message(500, 'h');
+    const fragments_type fragments = split_message(options, 9, message);
+
+    /* the last fragment arrives after the timeout and starts over instead of completing stale data */
+    UNIT_TEST_CHECK(feed(reassembler, fragments, make_order(0, fragments.size() - 1, false)).empty());
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    UNIT_TEST_CHECK(feed(reassembler, fragments, std::vector<std::size_t>(1, fragments.size() - 1)).empty());
+    UNIT_TEST_CHECK(message == feed(reassembler, fragments, make_order(0, fragments.size() - 1, false)));
+}
+
+static void test_reject_bad_fragments()
+{
+    const BoostNet::UdpFragmentOptions options = make_options(100, 2, 5000);
+    BoostNet::UdpReassembler reassembler;
+    UNIT_TEST_CHECK(reassembler.init(options));
+
+    const fragments_type fragments = split_message(options, 5, make_message(300, 'i'));
+    const char * message = nullptr;
+    std::size_t message_len = 0;
+
+    UNIT_TEST_CHECK(!reassembler.input(fragments[0].data(), 15, message, message_len));
+
+    /* fragment index beyond the fragment count */
+    std::string fragment = fragments[0];
+    fragment[12] = 4;
+    UNIT_TEST_CHECK(!reassembler.input(fragment.data(), fragment.size(), message, message_len));
+
+    /* payload running past the message size */
+    fragment = fragments[0];
+    fragment[8] = static_cast<char>(250);
+    UNIT_TEST_CHECK(!reassembler.input(fragment.data(), fragment.size(), message, message_len));
+
+    /* message larger than max_message_size */
+    fragment = fragments[0];
+    fragment[6] = 0x10;
+    UNIT_TEST_CHECK(!reassembler.input(fragment.data(), fragment.size(), message, message_len));
+}
+
+/* feeds one forged fragment to a fresh reassembler and then the genuine fragments, which must still give back the original message */
+static bool forged_fragment_rejected(const BoostNet::UdpFragmentOptions & options, const fragments_type & fragments, const std::string & original, const std::string & forged)
+{
+    BoostNet::UdpReassembler reassembler;
+    const char * message = nullptr;
+    std::size_t message_len = 0;
+    if (!reassembler.init(options) || reassembler.input(forged.data(), forged.size(), message, message_len))
+    {
+        return false;
+    }
+    return original == feed(reassembler, fragments, make_order(0, fragments.size(), false));
+}
+
+/* a fragment that is not where split() puts it would leave a hole or overlap its neighbours */
+static void test_reject_misplaced_fragments()
+{
+    const BoostNet::UdpFragmentOptions options = make_options(100, 2, 5000);
+    const std::string original = make_message(300, 'j');
+    const fragments_type fragments = split_message(options, 6, original);
+    UNIT_TEST_CHECK(4 == fragments.size());
+
+    /* second fragment moved onto the first one, inside the message but not at index * (mtu - 16) */
+    std::string forged = fragments[1];
+    forged[8] = 0;
+    UNIT_TEST_CHECK(forged_fragment_rejected(options, fragments, original, forged));
+    forged[8] = 80;
+    UNIT_TEST_CHECK(forged_fragment_rejected(options, fragments, original, forged));
+
+    /* a fragment other than the last one carrying less than a full payload */
+    forged = fragments[2].substr(0, 16 + 40);
+    UNIT_TEST_CHECK(forged_fragment_rejected(options, fragments, original, forged));
+
+    /* a fragment count that does not match the message size */
+    forged = fragments[0];
+    forged[14] = 5;
+    forged[12] = 4;
+    UNIT_TEST_CHECK(forged_fragment_rejected(options, fragments, original, forged));
+
+    /* a message of one datagram claiming a non zero offset */
+    const std::string single = make_message(50, 'k');
+    forged = split_message(options, 7, single)[0];
+    forged[8] = 1;
+    forged.resize(forged.size() - 1);
+    BoostNet::UdpReassembler reassembler;
+    const char * message = nullptr;
+    std::size_t message_len = 0;
+    UNIT_TEST_CHECK(reassembler.init(options));
+    UNIT_TEST_CHECK(!reassembler.input(forged.data(), forged.size(), message, message_len));
+}
+
+class FragmentService : public BoostNet::UdpServiceBase
+{
+public:
+    FragmentService()
+        : m_mutex()
+        , m_connection()
+        , m_messages()
+    {
+
+    }
+
+public:
+    virtual bool on_connect(BoostNet::UdpConnectionSharedPtr connection, const void *) override
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connection = connection;
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::UdpConnectionSharedPtr, unsigned short) override
+    {
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::UdpConnectionSharedPtr connection) override
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        while (connection->recv_buffer_has_data())
+        {
+            m_messages.push_back(std::string(static_cast<const char *>(connection->recv_buffer_data()), connection->recv_buffer_size()));
+            connection->recv_buffer_drop();
+        }
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::UdpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::UdpConnectionSharedPtr) override
+    {
+
+    }
+
+    virtual void on_error(BoostNet::UdpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+
+    }
+
+public:
+    BoostNet::UdpConnectionSharedPtr connection()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_connection;
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connection.reset();
+    }
+
+    std::vector<std::string> messages()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_messages;
+    }
+
+private:
+    std::mutex                                      m_mutex;
+    BoostNet::UdpConnectionSharedPtr                m_connection;
+    std::vector<std::string>                        m_messages;
+};
+
+static bool wait_for(const std::function<bool()> & condition)
+{
+    for (std::size_t count = 0; count < 200; ++count)
+    {
+        if (condition())
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return condition();
+}
+
+static void test_loopback_round_trip()
+{
+    FragmentService server_service;
+    BoostNet::UdpManager server_manager;
+    unsigned short ports[] = { 24530, 24531, 24532, 24533 };
+    UNIT_TEST_CHECK(server_manager.init(&server_service, 1, "127.0.0.1", ports, sizeof(ports) / sizeof(ports[0]), true));
+    UNIT_TEST_CHECK(server_manager.set_message_fragment(true, 1200, 64 * 1024));
+
+    std::vector<unsigned short> server_ports;
+    server_manager.get_ports(server_ports);
+
+    FragmentService client_service;
+    BoostNet::UdpManager client_manager;
+    UNIT_TEST_CHECK(client_manager.init(&client_service, 1));
+    UNIT_TEST_CHECK(client_manager.set_message_fragment(true, 1200, 64 * 1024));
+    UNIT_TEST_CHECK(!server_ports.empty() && client_manager.create_connection("127.0.0.1", server_ports[0], true));
+    UNIT_TEST_CHECK(wait_for([&client_service]() { return nullptr != client_service.connection(); }));
+
+    BoostNet::UdpConnectionSharedPtr connection = client_service.connection();
+    if (nullptr != connection)
+    {
+        std::vector<std::string> messages;
+        messages.push_back(make_message(60 * 1024, 'j'));
+        messages.push_back(make_message(100, 'k'));
+        messages.push_back(make_message(5000, 'l'));
+        for (std::vector<std::string>::const_iterator iter = messages.begin(); messages.end() != iter; ++iter)
+        {
+            UNIT_TEST_CHECK(connection->send_buffer_fill(iter->data(), iter->size()));
+        }
+        UNIT_TEST_CHECK(wait_for([&server_service, &messages]() { return messages.size() == server_service.messages().size(); }));
+        UNIT_TEST_CHECK(messages == server_service.messages());
+    }
+
+    connection.reset();
+    client_service.release();
+    client_manager.exit();
+    server_manager.exit();
+}
+
+int main(int, char *[])
+{
+    UNIT_TEST_RUN(test_check_options);
+    UNIT_TEST_RUN(test_single_fragment);
+    UNIT_TEST_RUN(test_reassemble_any_order);
+    UNIT_TEST_RUN(test_interleaved_messages);
+    UNIT_TEST_RUN(test_oldest_slot_is_dropped);
+    UNIT_TEST_RUN(test_timeout);
+    UNIT_TEST_RUN(test_reject_bad_fragments);
+    UNIT_TEST_RUN(test_reject_misplaced_fragments);
+    UNIT_TEST_RUN(test_loopback_round_trip);
+    return UNIT_TEST_RESULT();
+}
@@ -0,0 +1,209 @@
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include "boost_net.h"
+#include "unit_test.h"
+
+/* counts datagrams, and errors reported against the listener */
+class GroupService : public BoostNet::UdpServiceBase
+{
+public:
+    GroupService()
+        : m_mutex()
+        , m_connection()
+        , m_recv_count(0)
+        , m_error_count(0)
+    {
+
+    }
+
+public:
+    virtual bool on_connect(BoostNet::UdpConnectionSharedPtr connection, const void *) override
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connection = connection;
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::UdpConnectionSharedPtr, unsigned short) override
+    {
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::UdpConnectionSharedPtr connection) override
+    {
+        while (connection->recv_buffer_has_data())
+        {
+            connection->recv_buffer_drop();
+            ++m_recv_count;
+        }
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::UdpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::UdpConnectionSharedPtr) override
+    {
+
+    }
+
+    virtual void on_error(BoostNet::UdpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+        ++m_error_count;
+    }
+
+public:
+    BoostNet::UdpConnectionSharedPtr connection()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_connection;
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connection.reset();
+    }
+
+    std::size_t recv_count() const
+    {
+        return m_recv_count;
+    }
+
+    std::size_t error_count() const
+    {
+        return m_error_count;
+    }
+
+private:
+    std::mutex                                      m_mutex;
+    BoostNet::UdpConnectionSharedPtr                m_connection;
+    std::atomic<std::size_t>                        m_recv_count;
+    std::atomic<std::size_t>                        m_error_count;
+};
+
+/* the join and leave run on the io thread, so the sender repeats until the condition holds */
+static bool send_until(BoostNet::UdpConnectionSharedPtr connection, const std::function<bool()> & condition)
+{
+    for (std::size_t count = 0; count < 200; ++count)
+    {
+        connection->send_buffer_fill("group", 5);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (condition())
+        {
+            return true;
+        }
+    }
+    return condition();
+}
+
+/* two listeners on the same any address port join 239.255.0.7 on lo and both get the group traffic, after leaving neither does */
+static void test_join_and_leave()
+{
+    const char * group_ip = "239.255.0.7";
+    const char * interface_ip = "127.0.0.1";
+    unsigned short port = 24580;
+
+    GroupService first_service;
+    GroupService second_service;
+    GroupService sender_service;
+    BoostNet::UdpManager first_manager;
+    BoostNet::UdpManager second_manager;
+    BoostNet::UdpManager sender_manager;
+    UNIT_TEST_CHECK(first_manager.init(&first_service, 1, "0.0.0.0", &port, 1, false));
+    UNIT_TEST_CHECK(second_manager.init(&second_service, 1, "0.0.0.0", &port, 1, false));
+    UNIT_TEST_CHECK(!first_manager.join_multicast_group("127.0.0.1", interface_ip));
+    UNIT_TEST_CHECK(first_manager.join_multicast_group(group_ip, interface_ip));
+    UNIT_TEST_CHECK(second_manager.join_multicast_group(group_ip, interface_ip));
+
+    UNIT_TEST_CHECK(sender_manager.init(&sender_service, 1));
+    UNIT_TEST_CHECK(sender_manager.set_multicast_options(1, true, interface_ip));
+    UNIT_TEST_CHECK(sender_manager.create_connection(group_ip, port, true));
+    for (std::size_t count = 0; count < 200 && nullptr == sender_service.connection(); ++count)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    BoostNet::UdpConnectionSharedPtr connection = sender_service.connection();
+    UNIT_TEST_CHECK(nullptr != connection);
+
+    if (nullptr != connection)
+    {
+        UNIT_TEST_CHECK(send_until(connection, [&first_service, &second_service]() { return first_service.recv_count() > 0 && second_service.recv_count() > 0; }));
+
+        UNIT_TEST_CHECK(first_manager.leave_multicast_group(group_ip, interface_ip));
+        UNIT_TEST_CHECK(second_manager.leave_multicast_group(group_ip, interface_ip));
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        const std::size_t first_count = first_service.recv_count();
+        const std::size_t second_count = second_service.recv_count();
+        for (std::size_t count = 0; count < 20; ++count)
+        {
+            connection->send_buffer_fill("group", 5);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        UNIT_TEST_CHECK(first_count == first_service.recv_count());
+        UNIT_TEST_CHECK(second_count == second_service.recv_count());
+    }
+
+    UNIT_TEST_CHECK(0 == first_service.error_count());
+    UNIT_TEST_CHECK(0 == second_service.error_count());
+
+    connection.reset();
+    sender_service.release();
+    sender_manager.exit();
+    second_manager.exit();
+    first_manager.exit();
+}
+
+/* a connection over a shared socket sends to the group with the same ttl, loopback and interface as a created one */
+static void test_shared_socket_send()
+{
+    const char * group_ip = "239.255.0.8";
+    const char * interface_ip = "127.0.0.1";
+    unsigned short port = 24581;
+
+    GroupService listener_service;
+    GroupService sender_service;
+    BoostNet::UdpManager listener_manager;
+    BoostNet::UdpManager sender_manager;
+    UNIT_TEST_CHECK(listener_manager.init(&listener_service, 1, "0.0.0.0", &port, 1, false));
+    UNIT_TEST_CHECK(listener_manager.join_multicast_group(group_ip, interface_ip));
+
+    UNIT_TEST_CHECK(sender_manager.init(&sender_service, 1));
+    UNIT_TEST_CHECK(sender_manager.set_multicast_options(1, true, interface_ip));
+    UNIT_TEST_CHECK(sender_manager.set_shared_socket(true, 1));
+    UNIT_TEST_CHECK(sender_manager.create_connection(group_ip, port, true));
+    for (std::size_t count = 0; count < 200 && nullptr == sender_service.connection(); ++count)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    BoostNet::UdpConnectionSharedPtr connection = sender_service.connection();
+    UNIT_TEST_CHECK(nullptr != connection);
+
+    if (nullptr != connection)
+    {
+        UNIT_TEST_CHECK(send_until(connection, [&listener_service]() { return listener_service.recv_count() > 0; }));
+    }
+
+    UNIT_TEST_CHECK(0 == listener_service.error_count());
+    UNIT_TEST_CHECK(0 == sender_service.error_count());
+
+    connection.reset();
+    sender_service.release();
+    sender_manager.exit();
+    listener_manager.exit();
+}
+
+int main(int, char *[])
+{
+    UNIT_TEST_RUN(test_join_and_leave);
+    UNIT_TEST_RUN(test_shared_socket_send);
+    return UNIT_TEST_RESULT();
+}
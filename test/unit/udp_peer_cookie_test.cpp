@@ -0,0 +1,369 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "boost_net.h"
+#include "udp_peer_cookie.h"
+#include "unit_test.h"
+
+class CookieService : public BoostNet::UdpServiceBase
+{
+public:
+    CookieService()
+        : m_mutex()
+        , m_connection()
+        , m_datagrams()
+        , m_accept_count(0)
+    {
+
+    }
+
+public:
+    virtual bool on_connect(BoostNet::UdpConnectionSharedPtr connection, const void *) override
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connection = connection;
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::UdpConnectionSharedPtr, unsigned short) override
+    {
+        ++m_accept_count;
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::UdpConnectionSharedPtr connection) override
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        while (connection->recv_buffer_has_data())
+        {
+            m_datagrams.push_back(std::string(static_cast<const char *>(connection->recv_buffer_data()), connection->recv_buffer_size()));
+            connection->recv_buffer_drop();
+        }
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::UdpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::UdpConnectionSharedPtr) override
+    {
+
+    }
+
+    virtual void on_error(BoostNet::UdpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+
+    }
+
+public:
+    BoostNet::UdpConnectionSharedPtr connection()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_connection;
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connection.reset();
+    }
+
+    std::vector<std::string> datagrams()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_datagrams;
+    }
+
+    std::size_t accept_count() const
+    {
+        return m_accept_count;
+    }
+
+private:
+    std::mutex                                      m_mutex;
+    BoostNet::UdpConnectionSharedPtr                m_connection;
+    std::vector<std::string>                        m_datagrams;
+    std::atomic<std::size_t>                        m_accept_count;
+};
+
+static bool wait_for(const std::function<bool()> & condition)
+{
+    for (std::size_t count = 0; count < 200; ++count)
+    {
+        if (condition())
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return condition();
+}
+
+static unsigned short server_port(BoostNet::UdpManager & udp_manager)
+{
+    std::vector<unsigned short> ports;
+    udp_manager.get_ports(ports);
+    return ports.empty() ? 0 : ports[0];
+}
+
+static int raw_socket(unsigned short & port)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0x0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_size = sizeof(address);
+    bind(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address));
+    getsockname(fd, reinterpret_cast<struct sockaddr *>(&address), &address_size);
+    port = ntohs(address.sin_port);
+    return fd;
+}
+
+static void raw_send(int fd, unsigned short port, const void * data, std::size_t len)
+{
+    struct sockaddr_in address;
+    memset(&address, 0x0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    sendto(fd, data, len, 0, reinterpret_cast<struct sockaddr *>(&address), sizeof(address));
+}
+
+static std::string raw_recv(int fd, int timeout_milliseconds, unsigned short * from_port = nullptr)
+{
+    struct pollfd poll_fd = { fd, POLLIN, 0 };
+    if (poll(&poll_fd, 1, timeout_milliseconds) <= 0)
+    {
+        return std::string();
+    }
+
+    char buffer[2048] = { 0x0 };
+    struct sockaddr_in address;
+    socklen_t address_size = sizeof(address);
+    ssize_t recv_size = recvfrom(fd, buffer, sizeof(buffer), 0, reinterpret_cast<struct sockaddr *>(&address), &address_size);
+    if (nullptr != from_port)
+    {
+        *from_port = ntohs(address.sin_port);
+    }
+    return recv_size > 0 ? std::string(buffer, static_cast<std::size_t>(recv_size)) : std::string();
+}
+
+static void test_make_and_verify()
+{
+    BoostNet::UdpPeerCookie peer_cookie;
+    BoostNet::UdpPeerCookie other_cookie;
+    UNIT_TEST_CHECK(peer_cookie.init() && other_cookie.init());
+
+    const BoostNet::UdpPeerCookie::endpoint_type endpoint(boost::asio::ip::make_address("10.0.0.1"), 4000);
+    const BoostNet::UdpPeerCookie::endpoint_type other_endpoint(boost::asio::ip::make_address("10.0.0.1"), 4001);
+    unsigned char cookie[BoostNet::UdpPeerCookie::cookie_size] = { 0x0 };
+    peer_cookie.make(endpoint, cookie);
+
+    UNIT_TEST_CHECK(BoostNet::UdpPeerCookie::is_cookie(cookie, sizeof(cookie)));
+    UNIT_TEST_CHECK(!BoostNet::UdpPeerCookie::is_cookie(cookie, sizeof(cookie) - 1));
+    UNIT_TEST_CHECK(peer_cookie.verify(endpoint, cookie, sizeof(cookie)));
+    UNIT_TEST_CHECK(!peer_cookie.verify(other_endpoint, cookie, sizeof(cookie)));
+    UNIT_TEST_CHECK(!other_cookie.verify(endpoint, cookie, sizeof(cookie)));
+
+    cookie[sizeof(cookie) - 1] ^= 0x01;
+    UNIT_TEST_CHECK(!peer_cookie.verify(endpoint, cookie, sizeof(cookie)));
+}
+
+static void test_round_trip()
+{
+    CookieService server_service;
+    BoostNet::UdpManager server_manager;
+    unsigned short ports[] = { 24510, 24511, 24512, 24513 };
+    UNIT_TEST_CHECK(server_manager.init(&server_service, 1, "127.0.0.1", ports, sizeof(ports) / sizeof(ports[0]), true));
+    UNIT_TEST_CHECK(server_manager.set_peer_cookie(true));
+
+    CookieService client_service;
+    BoostNet::UdpManager client_manager;
+    UNIT_TEST_CHECK(client_manager.init(&client_service, 1));
+    UNIT_TEST_CHECK(client_manager.set_peer_cookie(true));
+    UNIT_TEST_CHECK(client_manager.create_connection("127.0.0.1", server_port(server_manager), true));
+    UNIT_TEST_CHECK(wait_for([&client_service]() { return nullptr != client_service.connection(); }));
+
+    BoostNet::UdpConnectionSharedPtr connection = client_service.connection();
+    if (nullptr != connection)
+    {
+        /* the first datagram only fetches the cookie, so it has to be at least as large as the cookie */
+        const std::string hello(BoostNet::UdpPeerCookie::cookie_size, 'h');
+        UNIT_TEST_CHECK(connection->send_buffer_fill(hello.data(), hello.size()));
+        UNIT_TEST_CHECK(wait_for([&server_service]() { return 1 == server_service.accept_count(); }));
+        UNIT_TEST_CHECK(connection->send_buffer_fill("data", 4));
+        UNIT_TEST_CHECK(wait_for([&server_service]() { return !server_service.datagrams().empty(); }));
+        UNIT_TEST_CHECK(std::vector<std::string>(1, "data") == server_service.datagrams());
+        UNIT_TEST_CHECK(client_service.datagrams().empty());
+    }
+
+    connection.reset();
+    client_service.release();
+    client_manager.exit();
+    server_manager.exit();
+}
+
+static void test_listener_replies()
+{
+    CookieService server_service;
+    BoostNet::UdpManager server_manager;
+    unsigned short ports[] = { 24520, 24521, 24522, 24523 };
+    UNIT_TEST_CHECK(server_manager.init(&server_service, 1, "127.0.0.1", ports, sizeof(ports) / sizeof(ports[0]), true));
+    UNIT_TEST_CHECK(server_manager.set_peer_cookie(true, 2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    unsigned short raw_port = 0;
+    int fd = raw_socket(raw_port);
+    const unsigned short listener_port = server_port(server_manager);
+
+    /* shorter than a cookie, no reply */
+    raw_send(fd, listener_port, "short", 5);
+    UNIT_TEST_CHECK(raw_recv(fd, 200).empty());
+
+    /* a forged cookie is dropped without a reply */
+    std::string forged(BoostNet::UdpPeerCookie::cookie_size, '\0');
+    unsigned char cookie[BoostNet::UdpPeerCookie::cookie_size] = { 0x0 };
+    BoostNet::UdpPeerCookie other_cookie;
+    other_cookie.init();
+    other_cookie.make(BoostNet::UdpPeerCookie::endpoint_type(boost::asio::ip::make_address("127.0.0.1"), raw_port), cookie);
+    forged.assign(reinterpret_cast<const char *>(cookie), sizeof(cookie));
+    raw_send(fd, listener_port, forged.data(), forged.size());
+    UNIT_TEST_CHECK(raw_recv(fd, 200).empty());
+    UNIT_TEST_CHECK(0 == server_service.accept_count());
+
+    /* two replies per second, the bucket may overdraw by the one reply sent while it still held a fraction */
+    const std::string request(BoostNet::UdpPeerCookie::cookie_size, 'r');
+    for (std::size_t index = 0; index < 10; ++index)
+    {
+        raw_send(fd, listener_port, request.data(), request.size());
+    }
+    std::vector<std::string> replies;
+    for (std::string reply = raw_recv(fd, 200); !reply.empty(); reply = raw_recv(fd, 200))
+    {
+        replies.push_back(reply);
+    }
+    UNIT_TEST_CHECK(replies.size() >= 2 && replies.size() <= 3);
+    UNIT_TEST_CHECK(!replies.empty() && BoostNet::UdpPeerCookie::is_cookie(replies[0].data(), replies[0].size()));
+
+    /* echoing the real cookie is accepted and not delivered */
+    if (!replies.empty())
+    {
+        raw_send(fd, listener_port, replies[0].data(), replies[0].size());
+        UNIT_TEST_CHECK(wait_for([&server_service]() { return 1 == server_service.accept_count(); }));
+        UNIT_TEST_CHECK(server_service.datagrams().empty());
+    }
+
+    close(fd);
+    server_manager.exit();
+}
+
+static void test_echo_once(bool cookie_echo, bool data_first)
+{
+    unsigned short raw_port = 0;
+    int fd = raw_socket(raw_port);
+
+    CookieService client_service;
+    BoostNet::UdpManager client_manager;
+    UNIT_TEST_CHECK(client_manager.init(&client_service, 1));
+    UNIT_TEST_CHECK(!cookie_echo || client_manager.set_peer_cookie(true));
+    UNIT_TEST_CHECK(client_manager.create_connection("127.0.0.1", raw_port, true));
+    UNIT_TEST_CHECK(wait_for([&client_service]() { return nullptr != client_service.connection(); }));
+
+    BoostNet::UdpConnectionSharedPtr connection = client_service.connection();
+    if (nullptr != connection)
+    {
+        unsigned short client_port = 0;
+        UNIT_TEST_CHECK(connection->send_buffer_fill("hello", 5));
+        UNIT_TEST_CHECK("hello" == raw_recv(fd, 1000, &client_port));
+
+        if (data_first)
+        {
+            raw_send(fd, client_port, "data", 4);
+            UNIT_TEST_CHECK(wait_for([&client_service]() { return 1 == client_service.datagrams().size(); }));
+        }
+
+        unsigned char cookie[BoostNet::UdpPeerCookie::cookie_size] = { 0x0 };
+        BoostNet::UdpPeerCookie peer_cookie;
+        peer_cookie.init();
+        peer_cookie.make(BoostNet::UdpPeerCookie::endpoint_type(boost::asio::ip::make_address("127.0.0.1"), client_port), cookie);
+        const std::string cookie_data(reinterpret_cast<const char *>(cookie), sizeof(cookie));
+
+        raw_send(fd, client_port, cookie_data.data(), cookie_data.size());
+        raw_send(fd, client_port, cookie_data.data(), cookie_data.size());
+        raw_send(fd, client_port, "tail", 4);
+
+        std::vector<std::string> echoes;
+        for (std::string echo = raw_recv(fd, 200); !echo.empty(); echo = raw_recv(fd, 200))
+        {
+            echoes.push_back(echo);
+        }
+
+        std::vector<std::string> expected_datagrams;
+        if (data_first)
+        {
+            expected_datagrams.push_back("data");
+        }
+        if (!cookie_echo)
+        {
+            expected_datagrams.push_back(cookie_data);
+            expected_datagrams.push_back(cookie_data);
+        }
+        expected_datagrams.push_back("tail");
+        UNIT_TEST_CHECK(wait_for([&client_service, &expected_datagrams]() { return expected_datagrams.size() == client_service.datagrams().size(); }));
+        UNIT_TEST_CHECK(expected_datagrams == client_service.datagrams());
+
+        if (cookie_echo && !data_first)
+        {
+            UNIT_TEST_CHECK(1 == echoes.size() && cookie_data == echoes[0]);
+        }
+        else
+        {
+            UNIT_TEST_CHECK(echoes.empty());
+        }
+    }
+
+    connection.reset();
+    client_service.release();
+    client_manager.exit();
+    close(fd);
+}
+
+static void test_echo_only_first_cookie()
+{
+    test_echo_once(true, false);
+}
+
+static void test_no_echo_after_data()
+{
+    test_echo_once(true, true);
+}
+
+static void test_no_echo_without_opt_in()
+{
+    test_echo_once(false, false);
+}
+
+int main(int, char *[])
+{
+    UNIT_TEST_RUN(test_make_and_verify);
+    UNIT_TEST_RUN(test_round_trip);
+    UNIT_TEST_RUN(test_listener_replies);
+    UNIT_TEST_RUN(test_echo_only_first_cookie);
+    UNIT_TEST_RUN(test_no_echo_after_data);
+    UNIT_TEST_RUN(test_no_echo_without_opt_in);
+    return UNIT_TEST_RESULT();
+}
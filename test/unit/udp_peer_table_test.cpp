@@ -0,0 +1,241 @@
+#include <map>
+#include <string>
+#include <vector>
+#include <random>
+#include "udp_peer_table.h"
+#include "unit_test.h"
+
+typedef BoostNet::UdpPeerTable::endpoint_type endpoint_type;
+typedef BoostNet::UdpPeerTable::connection_ptr connection_ptr;
+
+/* the table never touches the connection, so a distinct pointer sharing the ownership of an int is enough to tell entries apart */
+static connection_ptr make_connection(std::size_t index)
+{
+    static std::shared_ptr<std::vector<int>> s_owner(new std::vector<int>(4096));
+    return connection_ptr(s_owner, reinterpret_cast<BoostNet::UdpPassiveConnection *>(&(*s_owner)[index % s_owner->size()]));
+}
+
+static endpoint_type make_endpoint(std::size_t index)
+{
+    return endpoint_type(boost::asio::ip::address_v4(static_cast<uint32_t>(0x0a000000 + index / 50000)), static_cast<unsigned short>(1024 + index % 50000));
+}
+
+/* endpoints that share the home slot of the first one in a table of slot_count slots */
+static std::vector<endpoint_type> make_colliding_endpoints(std::size_t count, std::size_t slot_count)
+{
+    std::vector<endpoint_type> endpoints;
+    const uint64_t home = BoostNet::UdpPeerTable::hash_endpoint(make_endpoint(0)) & (slot_count - 1);
+    for (std::size_t index = 0; endpoints.size() < count; ++index)
+    {
+        if (home == (BoostNet::UdpPeerTable::hash_endpoint(make_endpoint(index)) & (slot_count - 1)))
+        {
+            endpoints.push_back(make_endpoint(index));
+        }
+    }
+    return endpoints;
+}
+
+static void test_insert_find_erase()
+{
+    BoostNet::UdpPeerTable peer_table;
+    const endpoint_type v4_endpoint(boost::asio::ip::make_address("127.0.0.1"), 9000);
+    const endpoint_type v6_endpoint(boost::asio::ip::make_address("::1"), 9000);
+
+    UNIT_TEST_CHECK(peer_table.insert(v4_endpoint, make_connection(1), 1));
+    UNIT_TEST_CHECK(peer_table.insert(v6_endpoint, make_connection(2), 1));
+    UNIT_TEST_CHECK(!peer_table.insert(v4_endpoint, make_connection(3), 1));
+    UNIT_TEST_CHECK(!peer_table.insert(endpoint_type(boost::asio::ip::make_address("127.0.0.1"), 9001), connection_ptr(), 1));
+    UNIT_TEST_CHECK(2 == peer_table.size());
+
+    const connection_ptr * connection = peer_table.find(v4_endpoint, 2);
+    UNIT_TEST_CHECK(nullptr != connection && make_connection(1) == *connection);
+    connection = peer_table.find(v6_endpoint, 2);
+    UNIT_TEST_CHECK(nullptr != connection && make_connection(2) == *connection);
+    UNIT_TEST_CHECK(nullptr == peer_table.find(endpoint_type(boost::asio::ip::make_address("127.0.0.1"), 9001), 2));
+
+    UNIT_TEST_CHECK(peer_table.erase(v4_endpoint));
+    UNIT_TEST_CHECK(!peer_table.erase(v4_endpoint));
+    UNIT_TEST_CHECK(nullptr == peer_table.find(v4_endpoint, 3));
+    UNIT_TEST_CHECK(1 == peer_table.size());
+}
+
+/* erasing from the head or the middle of a probe chain shifts the rest back, so every survivor stays reachable */
+static void test_erase_back_shift()
+{
+    const std::vector<endpoint_type> endpoints = make_colliding_endpoints(5, 16);
+
+    for (std::size_t erase_index = 0; erase_index < endpoints.size(); ++erase_index)
+    {
+        BoostNet::UdpPeerTable peer_table;
+        for (std::size_t index = 0; index < endpoints.size(); ++index)
+        {
+            UNIT_TEST_CHECK(peer_table.insert(endpoints[index], make_connection(index), 1));
+        }
+
+        UNIT_TEST_CHECK(peer_table.erase(endpoints[erase_index]));
+        for (std::size_t index = 0; index < endpoints.size(); ++index)
+        {
+            const connection_ptr * connection = peer_table.find(endpoints[index], 2);
+            if (erase_index == index)
+            {
+                UNIT_TEST_CHECK(nullptr == connection);
+            }
+            else
+            {
+                UNIT_TEST_CHECK(nullptr != connection && make_connection(index) == *connection);
+            }
+        }
+
+        /* the freed slot is found again by a later insert of the same endpoint */
+        UNIT_TEST_CHECK(peer_table.insert(endpoints[erase_index], make_connection(erase_index), 3));
+        UNIT_TEST_CHECK(endpoints.size() == peer_table.size());
+    }
+}
+
+static void test_growth()
+{
+    BoostNet::UdpPeerTable peer_table;
+    const std::size_t count = 100000;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        UNIT_TEST_CHECK(peer_table.insert(make_endpoint(index), make_connection(index), 1));
+    }
+    UNIT_TEST_CHECK(count == peer_table.size());
+
+    std::size_t found_count = 0;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const connection_ptr * connection = peer_table.find(make_endpoint(index), 2);
+        if (nullptr != connection && make_connection(index) == *connection)
+        {
+            ++found_count;
+        }
+    }
+    UNIT_TEST_CHECK(count == found_count);
+
+    BoostNet::UdpPeerTable::connection_array connections;
+    peer_table.get_connections(connections);
+    UNIT_TEST_CHECK(count == connections.size());
+}
+
+/* random inserts, erases and finds agree with std::map */
+static void test_random_operations()
+{
+    std::mt19937_64 random(1);
+    std::vector<endpoint_type> endpoints;
+    for (std::size_t index = 0; index < 3000; ++index)
+    {
+        if (0 == index % 3)
+        {
+            endpoints.push_back(endpoint_type(boost::asio::ip::make_address("fe80::" + std::to_string(index % 1000)), static_cast<unsigned short>(index)));
+        }
+        else
+        {
+            endpoints.push_back(endpoint_type(boost::asio::ip::address_v4(static_cast<uint32_t>(random() % 500)), static_cast<unsigned short>(random() % 4)));
+        }
+    }
+
+    BoostNet::UdpPeerTable peer_table;
+    std::map<endpoint_type, std::size_t> peer_map;
+    std::size_t mismatch_count = 0;
+    for (std::size_t count = 0; count < 200000; ++count)
+    {
+        const std::size_t index = static_cast<std::size_t>(random() % endpoints.size());
+        const endpoint_type & endpoint = endpoints[index];
+        switch (random() % 3)
+        {
+            case 0:
+            {
+                bool inserted = peer_table.insert(endpoint, make_connection(index), count);
+                mismatch_count += (inserted != peer_map.insert(std::make_pair(endpoint, index)).second ? 1 : 0);
+                break;
+            }
+            case 1:
+            {
+                bool erased = peer_table.erase(endpoint);
+                mismatch_count += (erased != (peer_map.erase(endpoint) > 0) ? 1 : 0);
+                break;
+            }
+            default:
+            {
+                const connection_ptr * connection = peer_table.find(endpoint, count);
+                std::map<endpoint_type, std::size_t>::const_iterator iter = peer_map.find(endpoint);
+                mismatch_count += ((nullptr == connection) != (peer_map.end() == iter) || (nullptr != connection && make_connection(iter->second) != *connection) ? 1 : 0);
+                break;
+            }
+        }
+        mismatch_count += (peer_table.size() != peer_map.size() ? 1 : 0);
+    }
+    UNIT_TEST_CHECK(0 == mismatch_count);
+}
+
+/* the last hit slot is only a hint, an erase or a back shift into that slot must not return a stale entry */
+static void test_last_hit_cache()
+{
+    const std::vector<endpoint_type> endpoints = make_colliding_endpoints(3, 16);
+
+    BoostNet::UdpPeerTable peer_table;
+    for (std::size_t index = 0; index < endpoints.size(); ++index)
+    {
+        UNIT_TEST_CHECK(peer_table.insert(endpoints[index], make_connection(index), 1));
+    }
+
+    /* the cache points at the head of the chain, erasing it shifts the second entry into that slot */
+    UNIT_TEST_CHECK(nullptr != peer_table.find(endpoints[0], 2));
+    UNIT_TEST_CHECK(peer_table.erase(endpoints[0]));
+    UNIT_TEST_CHECK(nullptr == peer_table.find(endpoints[0], 3));
+    const connection_ptr * connection = peer_table.find(endpoints[1], 3);
+    UNIT_TEST_CHECK(nullptr != connection && make_connection(1) == *connection);
+    connection = peer_table.find(endpoints[1], 4);
+    UNIT_TEST_CHECK(nullptr != connection && make_connection(1) == *connection);
+    connection = peer_table.find(endpoints[2], 4);
+    UNIT_TEST_CHECK(nullptr != connection && make_connection(2) == *connection);
+
+    /* growth moves every slot, the cache must not survive it */
+    UNIT_TEST_CHECK(nullptr != peer_table.find(endpoints[2], 5));
+    for (std::size_t index = 100; index < 200; ++index)
+    {
+        peer_table.insert(make_endpoint(index), make_connection(index), 5);
+    }
+    connection = peer_table.find(endpoints[2], 6);
+    UNIT_TEST_CHECK(nullptr != connection && make_connection(2) == *connection);
+    UNIT_TEST_CHECK(nullptr == peer_table.find(endpoints[0], 6));
+}
+
+static void test_expire_and_evict()
+{
+    BoostNet::UdpPeerTable peer_table;
+    for (std::size_t index = 0; index < 100; ++index)
+    {
+        UNIT_TEST_CHECK(peer_table.insert(make_endpoint(index), make_connection(index), index < 50 ? 1 : 10));
+    }
+
+    BoostNet::UdpPeerTable::connection_array connections;
+    peer_table.expire(5, connections);
+    UNIT_TEST_CHECK(50 == connections.size());
+    UNIT_TEST_CHECK(50 == peer_table.size());
+    for (std::size_t index = 50; index < 100; ++index)
+    {
+        UNIT_TEST_CHECK(nullptr != peer_table.find(make_endpoint(index), 10));
+    }
+
+    connection_ptr connection;
+    UNIT_TEST_CHECK(peer_table.evict(connection));
+    UNIT_TEST_CHECK(nullptr != connection);
+    UNIT_TEST_CHECK(49 == peer_table.size());
+
+    peer_table.clear();
+    UNIT_TEST_CHECK(0 == peer_table.size());
+    UNIT_TEST_CHECK(!peer_table.evict(connection));
+}
+
+int main(int, char *[])
+{
+    UNIT_TEST_RUN(test_insert_find_erase);
+    UNIT_TEST_RUN(test_erase_back_shift);
+    UNIT_TEST_RUN(test_growth);
+    UNIT_TEST_RUN(test_random_operations);
+    UNIT_TEST_RUN(test_last_hit_cache);
+    UNIT_TEST_RUN(test_expire_and_evict);
+    return UNIT_TEST_RESULT();
+}
@@ -0,0 +1,204 @@
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <functional>
+#include "boost_net.h"
+#include "unit_test.h"
+
+/* keeps every datagram in arrival order, the message "reply" is answered with reply_size bytes */
+class RecordService : public BoostNet::UdpServiceBase
+{
+public:
+    RecordService(std::size_t reply_size)
+        : m_reply_size(reply_size)
+        , m_mutex()
+        , m_connection()
+        , m_datagrams()
+    {
+
+    }
+
+public:
+    virtual bool on_connect(BoostNet::UdpConnectionSharedPtr connection, const void *) override
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connection = connection;
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::UdpConnectionSharedPtr, unsigned short) override
+    {
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::UdpConnectionSharedPtr connection) override
+    {
+        while (connection->recv_buffer_has_data())
+        {
+            const std::string datagram(reinterpret_cast<const char *>(connection->recv_buffer_data()), connection->recv_buffer_size());
+            connection->recv_buffer_drop();
+            if ("reply" == datagram)
+            {
+                const std::string reply = make_payload(m_reply_size);
+                connection->send_buffer_fill(reply.data(), reply.size());
+            }
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_datagrams.push_back(datagram);
+        }
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::UdpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::UdpConnectionSharedPtr) override
+    {
+
+    }
+
+    virtual void on_error(BoostNet::UdpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+
+    }
+
+public:
+    static std::string make_payload(std::size_t size)
+    {
+        std::string payload(size, 0x0);
+        for (std::size_t index = 0; index < size; ++index)
+        {
+            payload[index] = static_cast<char>('a' + index % 26);
+        }
+        return payload;
+    }
+
+    BoostNet::UdpConnectionSharedPtr connection()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_connection;
+    }
+
+    std::vector<std::string> datagrams()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_datagrams;
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connection.reset();
+    }
+
+private:
+    const std::size_t                               m_reply_size;
+    std::mutex                                      m_mutex;
+    BoostNet::UdpConnectionSharedPtr                m_connection;
+    std::vector<std::string>                        m_datagrams;
+};
+
+static bool wait_for(const std::function<bool()> & condition)
+{
+    for (std::size_t count = 0; count < 500; ++count)
+    {
+        if (condition())
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return condition();
+}
+
+static bool all_within(const std::vector<std::string> & datagrams, std::size_t first, std::size_t last, std::size_t segment_size)
+{
+    for (std::size_t index = first; index < last && index < datagrams.size(); ++index)
+    {
+        if (datagrams[index].size() > segment_size)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::string join(const std::vector<std::string> & datagrams, std::size_t first, std::size_t last)
+{
+    std::string message;
+    for (std::size_t index = first; index < last && index < datagrams.size(); ++index)
+    {
+        message += datagrams[index];
+    }
+    return message;
+}
+
+/*
+ * both ends send directly from the calling thread with gso on: a buffer of one segment takes the direct path,
+ * a longer one must still leave as segment_size datagrams instead of one oversized datagram
+ */
+static void test_direct_send_with_gso()
+{
+    unsigned short port = 24570;
+    const std::size_t segment_size = 1000;
+    const std::size_t message_size = 5000;
+
+    RecordService server_service(message_size);
+    RecordService client_service(0);
+    BoostNet::UdpManager server_manager;
+    BoostNet::UdpManager client_manager;
+    UNIT_TEST_CHECK(server_manager.init(&server_service, 1, "127.0.0.1", &port, 1, true));
+    UNIT_TEST_CHECK(client_manager.init(&client_service, 1));
+    UNIT_TEST_CHECK(server_manager.set_segment_offload(segment_size, false, 1500));
+    UNIT_TEST_CHECK(client_manager.set_segment_offload(segment_size, false, 1500));
+    UNIT_TEST_CHECK(server_manager.set_direct_send(true));
+    UNIT_TEST_CHECK(client_manager.set_direct_send(true));
+    UNIT_TEST_CHECK(client_manager.create_connection("127.0.0.1", port, true));
+    UNIT_TEST_CHECK(wait_for([&client_service]() { return nullptr != client_service.connection(); }));
+
+    BoostNet::UdpConnectionSharedPtr connection = client_service.connection();
+    if (nullptr != connection)
+    {
+        const std::string single = RecordService::make_payload(segment_size);
+        const std::string message = RecordService::make_payload(message_size);
+        const std::size_t server_count = 1 + message_size / segment_size + 1;
+
+        /* each send starts with nothing queued, so the direct path is taken whenever it may be */
+        connection->send_buffer_fill(single.data(), single.size());
+        UNIT_TEST_CHECK(wait_for([&server_service]() { return server_service.datagrams().size() >= 1; }));
+        connection->send_buffer_fill(message.data(), message.size());
+        UNIT_TEST_CHECK(wait_for([&server_service, server_count]() { return server_service.datagrams().size() >= server_count - 1; }));
+        connection->send_buffer_fill("reply", 5);
+
+        UNIT_TEST_CHECK(wait_for([&server_service, server_count]() { return server_service.datagrams().size() >= server_count; }));
+        const std::vector<std::string> server_datagrams = server_service.datagrams();
+        UNIT_TEST_CHECK(server_count == server_datagrams.size());
+        UNIT_TEST_CHECK(all_within(server_datagrams, 0, server_datagrams.size(), segment_size));
+        UNIT_TEST_CHECK(single == join(server_datagrams, 0, 1));
+        UNIT_TEST_CHECK(message == join(server_datagrams, 1, server_count - 1));
+        UNIT_TEST_CHECK(std::string("reply") == join(server_datagrams, server_count - 1, server_count));
+
+        /* the reply is sent by the passive side through the acceptor socket */
+        const std::size_t client_count = message_size / segment_size;
+        UNIT_TEST_CHECK(wait_for([&client_service, client_count]() { return client_service.datagrams().size() >= client_count; }));
+        const std::vector<std::string> client_datagrams = client_service.datagrams();
+        UNIT_TEST_CHECK(client_count == client_datagrams.size());
+        UNIT_TEST_CHECK(all_within(client_datagrams, 0, client_datagrams.size(), segment_size));
+        UNIT_TEST_CHECK(message == join(client_datagrams, 0, client_datagrams.size()));
+    }
+
+    connection.reset();
+    client_service.release();
+    client_manager.exit();
+    server_manager.exit();
+}
+
+int main(int, char *[])
+{
+    UNIT_TEST_RUN(test_direct_send_with_gso);
+    return UNIT_TEST_RESULT();
+}
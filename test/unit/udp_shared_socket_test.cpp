@@ -0,0 +1,165 @@
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <functional>
+#include "boost_net.h"
+#include "unit_test.h"
+
+/* the server echoes, the client keeps its connections and counts echoes and closes */
+class SharedService : public BoostNet::UdpServiceBase
+{
+public:
+    SharedService(bool echo)
+        : m_echo(echo)
+        , m_mutex()
+        , m_connections()
+        , m_recv_count(0)
+        , m_close_count(0)
+    {
+
+    }
+
+public:
+    virtual bool on_connect(BoostNet::UdpConnectionSharedPtr connection, const void *) override
+    {
+        if (nullptr != connection)
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_connections.push_back(connection);
+        }
+        return true;
+    }
+
+    virtual bool on_accept(BoostNet::UdpConnectionSharedPtr, unsigned short) override
+    {
+        return true;
+    }
+
+    virtual bool on_recv(BoostNet::UdpConnectionSharedPtr connection) override
+    {
+        while (connection->recv_buffer_has_data())
+        {
+            if (m_echo)
+            {
+                connection->send_buffer_fill(connection->recv_buffer_data(), connection->recv_buffer_size());
+            }
+            connection->recv_buffer_drop();
+            ++m_recv_count;
+        }
+        return true;
+    }
+
+    virtual bool on_send(BoostNet::UdpConnectionSharedPtr) override
+    {
+        return true;
+    }
+
+    virtual void on_close(BoostNet::UdpConnectionSharedPtr) override
+    {
+        ++m_close_count;
+    }
+
+    virtual void on_error(BoostNet::UdpConnectionSharedPtr, const char *, const char *, int, const char *) override
+    {
+
+    }
+
+public:
+    BoostNet::UdpConnectionSharedPtr connection(std::size_t index)
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return index < m_connections.size() ? m_connections[index] : BoostNet::UdpConnectionSharedPtr();
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_connections.clear();
+    }
+
+    std::size_t recv_count() const
+    {
+        return m_recv_count;
+    }
+
+    std::size_t close_count() const
+    {
+        return m_close_count;
+    }
+
+private:
+    const bool                                      m_echo;
+    std::mutex                                      m_mutex;
+    std::vector<BoostNet::UdpConnectionSharedPtr>   m_connections;
+    std::atomic<std::size_t>                        m_recv_count;
+    std::atomic<std::size_t>                        m_close_count;
+};
+
+static bool wait_for(const std::function<bool()> & condition)
+{
+    for (std::size_t count = 0; count < 300; ++count)
+    {
+        if (condition())
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return condition();
+}
+
+/* connects the next client connection and waits for the echo of one datagram */
+static bool connect_and_echo(BoostNet::UdpManager & client_manager, SharedService & client_service, unsigned short port, std::size_t index)
+{
+    if (!client_manager.create_connection("127.0.0.1", port, true))
+    {
+        return false;
+    }
+    if (!wait_for([&client_service, index]() { return nullptr != client_service.connection(index); }))
+    {
+        return false;
+    }
+    const std::size_t recv_count = client_service.recv_count();
+    client_service.connection(index)->send_buffer_fill("shared", 6);
+    return wait_for([&client_service, recv_count]() { return client_service.recv_count() > recv_count; });
+}
+
+/* disabling the shared sockets closes them and the connections on them, later connections use their own socket, enabling again builds new ones */
+static void test_disable_closes_connections()
+{
+    unsigned short port = 24590;
+    SharedService server_service(true);
+    SharedService client_service(false);
+    BoostNet::UdpManager server_manager;
+    BoostNet::UdpManager client_manager;
+    UNIT_TEST_CHECK(server_manager.init(&server_service, 1, "127.0.0.1", &port, 1, true));
+    UNIT_TEST_CHECK(client_manager.init(&client_service, 2));
+    UNIT_TEST_CHECK(!client_manager.set_shared_socket(true, 0));
+    UNIT_TEST_CHECK(client_manager.set_shared_socket(true, 2));
+
+    UNIT_TEST_CHECK(connect_and_echo(client_manager, client_service, port, 0));
+    UNIT_TEST_CHECK(connect_and_echo(client_manager, client_service, port, 1));
+    UNIT_TEST_CHECK(0 == client_service.close_count());
+
+    UNIT_TEST_CHECK(client_manager.set_shared_socket(false));
+    UNIT_TEST_CHECK(wait_for([&client_service]() { return 2 == client_service.close_count(); }));
+
+    UNIT_TEST_CHECK(connect_and_echo(client_manager, client_service, port, 2));
+
+    UNIT_TEST_CHECK(client_manager.set_shared_socket(true, 1));
+    UNIT_TEST_CHECK(connect_and_echo(client_manager, client_service, port, 3));
+    UNIT_TEST_CHECK(2 == client_service.close_count());
+
+    client_service.release();
+    client_manager.exit();
+    server_manager.exit();
+}
+
+int main(int, char *[])
+{
+    UNIT_TEST_RUN(test_disable_closes_connections);
+    return UNIT_TEST_RESULT();
+}
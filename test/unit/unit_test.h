@@ -0,0 +1,30 @@
+#ifndef UNIT_TEST_H
+#define UNIT_TEST_H
+
+
+#include <cstdio>
+
+static int unit_test_failure_count = 0;
+
+#define UNIT_TEST_CHECK(expression)                                                 \
+    do                                                                              \
+    {                                                                               \
+        if (!(expression))                                                          \
+        {                                                                           \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expression);   \
+            ++unit_test_failure_count;                                              \
+        }                                                                           \
+    } while (false)
+
+#define UNIT_TEST_RUN(test_function)                                                \
+    do                                                                              \
+    {                                                                               \
+        const int failure_count = unit_test_failure_count;                          \
+        test_function();                                                            \
+        printf("%s %s\n", (failure_count == unit_test_failure_count) ? "pass" : "FAIL", #test_function); \
+    } while (false)
+
+#define UNIT_TEST_RESULT() (0 == unit_test_failure_count ? 0 : 1)
+
+
+#endif // UNIT_TEST_H